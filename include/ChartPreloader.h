@@ -0,0 +1,103 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Predictive chart cache preloading
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+
+#ifndef __CHARTPRELOADER_H__
+#define __CHARTPRELOADER_H__
+
+#include <vector>
+
+#include "bbox.h"
+
+//----------------------------------------------------------------------------
+// Fwd Defns
+//----------------------------------------------------------------------------
+
+class ChartBase;
+class ChartCanvas;
+class Route;
+class RoutePoint;
+
+//----------------------------------------------------------------------------
+//      Warms the chart cache for the area own-ship will reach in the next
+//      g_nChartPreloadMinutes, so charts are open before a following canvas
+//      needs them.
+//
+//      The track ahead follows the active route from the active waypoint, or
+//      COG if no route is active, for the distance SOG covers in that time.
+//      Charts in the group and scale range of each following canvas that
+//      cover the track are opened through ChartDB, nearest first.  Tick()
+//      plans on the frame timer; the chart is opened by the following Idle(),
+//      one per tick, and not while the user is panning, zooming or has just
+//      touched a canvas.  S57 charts without a SENC start their background build on
+//      opening; raster charts in OpenGL mode get their compressed textures
+//      scheduled on the texture compression threads.
+//
+//      Preloading stops short of the cache limit, so it never causes a chart
+//      in use to be evicted.
+//----------------------------------------------------------------------------
+
+class ChartPreloader
+{
+public:
+      ChartPreloader();
+
+      void Tick( void );
+      void Idle( void );
+      void Invalidate( void );
+
+private:
+      struct TrackPoint {
+          double lat;
+          double lon;
+      };
+
+      bool BuildTrack( std::vector<TrackPoint> &track );
+      void Plan( void );
+      void PlanCanvas( ChartCanvas *cc, const std::vector<TrackPoint> &track );
+      bool HaveCacheRoom( void );
+      bool IsUserInteracting( void );
+      bool Preload( int dbIndex );
+#ifdef ocpnUSE_GL
+      bool ScheduleTextures( ChartBase *chart );
+#endif
+
+      struct Candidate {
+          int    dbIndex;
+          int    sample;            // index of the first track box the chart covers
+          double scale_error;       // distance from the canvas scale, in octaves
+      };
+
+      std::vector<Candidate>  m_candidates;
+      std::vector<LLBBox>     m_boxes;
+      size_t                  m_next;
+      int                     m_texture_dbIndex;
+      int                     m_ticks;
+      bool                    m_bWantIdle;
+
+      Route                   *m_route;
+      RoutePoint              *m_route_point;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Polygon clipping for latitude and longitude regions
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __LLCLIPPER_H__
+#define __LLCLIPPER_H__
+
+#include <list>
+#include <vector>
+
+#include "LLRegion.h"
+
+//  Which windings are inside the result
+enum LLClipRule
+{
+    LLCLIP_POSITIVE,            // winding > 0, for union, or subtract with the second operand reversed
+    LLCLIP_ABS_GEQ_TWO          // |winding| >= 2, for intersection
+};
+
+//----------------------------------------------------------------------------
+//      Boolean operations on sets of lat/lon contours, in double precision.
+//
+//      A sweep in longitude splits the edges of all the contours where they
+//      cross or touch, so that no two edges cross.  A second sweep finds the
+//      winding on either side of each edge, and the edges with the rule's
+//      inside on one side only are linked into the result contours, outer
+//      ones counter clockwise.
+//      There is no shared state, so regions may be clipped on several threads.
+//----------------------------------------------------------------------------
+class LLClipper
+{
+public:
+    LLClipper() {}
+
+    void AddContours(const std::list<poly_contour> &contours, bool reverse=false);
+    void Execute(int rule, std::list<poly_contour> &result);
+
+private:
+    //  a is the lesser point, by longitude then latitude.  wind is +1 if the
+    //  contour runs from a to b, -1 if from b to a, or the sum of coincident edges.
+    struct edge
+    {
+        contour_pt a, b;
+        int wind;
+    };
+
+    struct split
+    {
+        int edge;
+        double t;
+        contour_pt p;
+        bool operator<(const split &s) const { return edge < s.edge || (edge == s.edge && t < s.t); }
+    };
+
+    struct link
+    {
+        contour_pt from, to;
+    };
+
+    static void AddEdge(std::vector<edge> &edges, const contour_pt &p, const contour_pt &q, int wind);
+    void FindSplits();
+    void SplitAt(int i, const contour_pt &p);
+    void Cross(int i, int j);
+    void Snap();
+    void SplitEdges();
+    void Classify(int rule);
+    void Output(const contour_pt &from, const contour_pt &to);
+    void Link(std::list<poly_contour> &result);
+
+    std::vector<edge> m_edges;
+    std::vector<split> m_splits;
+    std::vector<link> m_links;
+};
+
+#endif
+// __LLCLIPPER_H__
@@ -58,7 +58,15 @@ struct contour_pt
 typedef std::list<contour_pt> poly_contour;
 class LLBBox;
 
-struct work;
+//  Counts of how LLRegion boolean operations were resolved
+struct LLRegionStats
+{
+    long ops;               // Intersect, Union and Subtract calls
+    long trivial;           // settled by the bounding boxes not overlapping
+    long rect;              // settled by one side being a rectangle around the other
+    long clipped;           // ran the polygon clipper
+};
+
 class LLRegion
 {
 public:
@@ -87,13 +95,17 @@ public:
 
     void Reduce(double factor);
 
+    static LLRegionStats GetStats();
+    static void ResetStats();
+
     std::list<poly_contour> contours;
 
 private:
     bool NoIntersection(const LLBBox& box) const;
     bool NoIntersection(const LLRegion& region) const;
-    void PutContours(work &w, const LLRegion& region, bool reverse=false);
-    void Put(const LLRegion& region, int winding_rule, bool reverse=false);
+    bool IsRect(double bounds[4]) const;
+    void GetBounds(double bounds[4]) const;
+    void Put(const LLRegion& region, int rule, bool reverse=false);
     void Combine(const LLRegion& region);
     void InitBox( float minlat, float minlon, float maxlat, float maxlon);
     void InitPoints( size_t n, const double *points );
@@ -28,10 +28,13 @@
 #include "pugixml.hpp"
 #include <wx/string.h>
 #include <wx/checkbox.h>
+#include <string>
+#include <vector>
 
 class Track;
 class TrackList;
 class TrackPoint;
+class TrackPointArray;
 class RouteList;
 class RoutePointList;
 class Route;
@@ -105,6 +108,11 @@ public:
     bool AddGPXWaypoint(RoutePoint *pWP );
     
     bool CreateAllGPXObjects();
+
+    //  CreateAllGPXObjects() in two steps.  The snapshot walks the objects and copies the
+    //  track points, on the GUI thread; the rest may then run on any thread.
+    bool SnapshotAllGPXObjects();
+    void CompleteGPXSnapshot();
     bool LoadAllGPXObjects( bool b_full_viz, int &wpt_duplicates );
     int LoadAllGPXObjectsAsLayer(int layer_id, bool b_layerviz, wxCheckBoxState b_namesviz);
     
@@ -112,28 +120,63 @@ public:
 
     void SetRootGPXNode(void);
     bool IsOpenCPN();
+
+    void SetJournalSeq( wxUint64 seq );
+    wxUint64 GetJournalSeq();
     
     pugi::xml_node      m_gpx_root;
+
+private:
+    struct TrackSnapshot
+    {
+        pugi::xml_node      node;
+        TrackPointArray     *points;            // NULL for a track still holding its GPX text
+        std::string         trksegs;
+    };
+
+    std::vector<TrackSnapshot> m_track_snapshots;
 };
 
+//  Points from the <trkseg> text of a track loaded hidden, see Track::SetPendingPoints()
+void GPXLoadTrackSegs( const std::string &trksegs, TrackPointArray &points );
+
 
+//      The navobj journal.
+//      Route, waypoint and track changes are appended to a binary journal file as they
+//      happen, so saving a change costs O(change) rather than a rewrite of navobj.xml.
+//      Each record carries a sequence number; navobj.xml records the last sequence number
+//      it contains, so a restart replays only the records newer than the snapshot.
 class NavObjectChanges : public NavObjectCollection1
 {
 public:
     NavObjectChanges();
-    NavObjectChanges( wxString file_name );
+    NavObjectChanges( wxString file_name, wxUint64 next_seq = 1 );
     ~NavObjectChanges();
     
     void AddRoute( Route *pr, const char *action );           // support "changes" file set
     void AddTrack( Track *pr, const char *action );
     void AddWP( RoutePoint *pr, const char *action );
-    void AddTrackPoint( TrackPoint *pWP, const char *action, const wxString& parent_GUID );
+    void AddTrackPoint( const TrackPoint &WP, const char *action, const wxString& parent_GUID );
     
-    bool ApplyChanges(void);
+    bool ApplyChanges(void);                                  // legacy XML navobj.xml.changes file
+    static bool ReplayJournal( const wxString &file_name, wxUint64 after_seq, wxUint64 &last_seq );
+
+    bool Rotate( const wxString &retired_file_name );
+    wxUint64 GetLastSeq() const { return m_seq - 1; }
+    int GetRecordCount() const { return m_nRecords; }
+    size_t GetSize() const { return m_size; }
     
     wxString    m_filename;
     FILE *      m_changes_file;
-    
+
+private:
+    bool Open();
+    void AddRecord( int type, const char *action, const void *payload, size_t len );
+    void AddObjectRecord( int type, const char *action, pugi::xml_node object );
+
+    wxUint64    m_seq;                  // sequence number of the next record
+    int         m_nRecords;             // records in the current journal file
+    size_t      m_size;
 };
 
 
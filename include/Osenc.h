@@ -486,6 +486,11 @@ public:
     std::vector<int> &getSENCReadNOCOVRPointCountArray(){ return m_NoCovrCntArray;}
     
     int createSenc200(const wxString& FullPath000, const wxString& SENCFileName, bool b_showProg = true);
+
+    //  The area geometry of a cell, updates applied, as read for SENC creation.
+    //  The caller owns the polygons.  Used by the tesselation benchmark.
+    int readAreaGeometry( const wxString& FullPath000, const wxString& working_dir,
+                          std::vector<OGRPolygon *> &polys );
     
     void CreateSENCVectorEdgeTableRecord200( Osenc_outstream *stream, S57Reader *poReader );
     void CreateSENCVectorConnectedTableRecord200( Osenc_outstream *stream, S57Reader *poReader );
@@ -25,6 +25,11 @@
 #ifndef __QUIT_H__
 #define __QUIT_H__
 
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
 #include "chart1.h"
 #include "LLRegion.h"
 #include "OCPNRegion.h"
@@ -60,11 +65,9 @@ public:
         b_include = false;
         b_eclipsed = false;
         b_locked = false;
-        last_factor = -1;
     }
 
     const LLRegion &GetCandidateRegion();
-    LLRegion &GetReducedCandidateRegion(double factor);
     void SetScale(int scale);
     bool Scale_eq( int b ) const { return abs ( ChartScale - b) <= rounding; }
     bool Scale_ge( int b ) const { return  Scale_eq( b ) || ChartScale > b; }
@@ -75,11 +78,16 @@ public:
     bool b_include;
     bool b_eclipsed;
     bool b_locked;
+};
 
-private:
-    double last_factor;
-    LLRegion reduced_candidate_region;
-
+//  A class of viewports which share chart regions clipped for them, see Quilt::GetViewClass()
+class QuiltViewClass
+{
+public:
+    bool valid;
+    int level;                  // the grid cell is 2^level degrees
+    int ilat, ilon;             // the south west cell
+    LLRegion region;            // two cells on a side
 };
 
 WX_DECLARE_LIST( QuiltPatch, PatchList );
@@ -102,6 +110,7 @@ public:
     
     void UnlockQuilt();
     bool Compose( const ViewPort &vp );
+    void ComposeAhead( const ViewPort &vp_next );
     bool IsComposed() {
         return m_bcomposed;
     }
@@ -145,17 +154,7 @@ public:
     ChartBase *GetOverlayChartAtPix( ViewPort &VPoint, wxPoint p );
     int GetChartdbIndexAtPix( ViewPort &VPoint, wxPoint p );
     void InvalidateAllQuiltPatchs( void );
-    void Invalidate( void )
-    {
-        m_bcomposed = false;
-        m_vp_quilt.Invalidate();
-        m_zout_dbindex = -1;
-
-        //  Quilting of skewed raster charts is allowed for OpenGL only
-        m_bquiltskew = g_bopengl;
-        //  Quilting of different projections is allowed for OpenGL only
-        m_bquiltanyproj = g_bopengl;
-    }
+    void Invalidate( void );
     void AdjustQuiltVP( ViewPort &vp_last, ViewPort &vp_proposed );
 
     LLRegion &GetFullQuiltRegion( void ) {
@@ -225,6 +224,7 @@ public:
     
     LLRegion GetHiliteRegion( );
     static LLRegion GetChartQuiltRegion( const ChartTableEntry &cte, ViewPort &vp );
+    static QuiltViewClass GetViewClass( const LLBBox &box );
 
     int GetNomScaleMin(int scale, ChartTypeEnum type, ChartFamilyEnum family);
     int GetNomScaleMax(int scale, ChartTypeEnum type, ChartFamilyEnum family);
@@ -240,6 +240,10 @@ private:
     void SubstituteClearDC( wxMemoryDC &dc, ViewPort &vp );
     int GetNewRefChart( void );
 
+    const LLRegion &GetReducedCandidateRegion( QuiltCandidate *pqc, double factor );
+    const LLRegion &GetViewClassRegion( QuiltCandidate *pqc, double factor, const QuiltViewClass &vc );
+    void ComposeAheadThread( std::vector<int> charts, double factor, unsigned int generation );
+    void StopComposeAhead( void );
     
     bool IsChartS57Overlay( int db_index );
     
@@ -286,6 +290,14 @@ private:
     bool m_bquiltskew;
     bool m_bquiltanyproj;
     ChartCanvas *m_parent;
+
+    //  Patch regions before the viewport clip, valid while the patch list matches the key
+    std::vector<int> m_patch_region_key;
+    std::vector<LLRegion> m_patch_regions;
+
+    std::thread m_ahead_thread;
+    std::atomic<bool> m_bahead_busy;
+    std::atomic<bool> m_bahead_cancel;
     
 };
 
@@ -0,0 +1,63 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  LLRegion boolean operation benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __REGIONBENCH_H__
+#define __REGIONBENCH_H__
+
+#include <vector>
+
+#include "LLRegion.h"
+
+//----------------------------------------------------------------------------
+//      LLRegion benchmark, run by the --region_bench command line option.
+//
+//      Replays quilt style compositions over the chart database coverage:
+//      for each of <views> deterministic viewports the overlapping chart
+//      regions are clipped to the view, in scale order, with the
+//      Intersect / Subtract / Union sequence Quilt::Compose uses.
+//      Each view is also panned in small steps, as when dragging the canvas.
+//      The views are run twice, the second pass without first use costs,
+//      and then with the chart regions clipped to their view class first,
+//      as Quilt::Compose caches them.
+//      Per operation timings and LLRegion::GetStats() counters are written
+//      to stdout and to the log.
+//----------------------------------------------------------------------------
+
+class RegionBench
+{
+public:
+      RegionBench();
+
+      bool Run( int views );
+
+private:
+      void BuildViews( int views );
+      void RunPass( const char *name, bool view_class );
+
+      std::vector<LLRegion>   m_chart_regions;
+      std::vector<int>        m_chart_scales;
+      std::vector<LLBBox>     m_views;
+};
+
+#endif
@@ -0,0 +1,103 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 render benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __RENDERBENCH_H__
+#define __RENDERBENCH_H__
+
+#include <vector>
+
+#include "s52plib.h"
+
+//----------------------------------------------------------------------------
+// Fwd Defns
+//----------------------------------------------------------------------------
+
+class s57chart;
+class ChartCanvas;
+
+//----------------------------------------------------------------------------
+//      Scripted S52 render benchmark, run by the --render_bench command line option.
+//
+//      The script is a text file, one command per line, '#' starts a comment:
+//
+//          cell <file.000 | file.S57>      load an ENC cell, building its SENC if needed
+//          size <width> <height>           offscreen render size
+//          mode dc | gl                    DC: the loaded cells into a wxMemoryDC
+//                                          GL: the loaded cells into a framebuffer object,
+//                                              in the primary canvas' GL context
+//          view <lat> <lon> <scale>        center and conventional scale, renders one frame
+//          pan <dx> <dy> <frames>          move by dx, dy pixels per frame
+//          zoom <factor> <frames>          multiply the scale by factor per frame
+//          rotate <degrees> <frames>       rotate by degrees per frame
+//          scheme DAY | DUSK | NIGHT       switch the colour scheme, renders one frame
+//
+//      Frame time percentiles and the time spent in each s52plib render stage
+//      are written to stdout and to the log.
+//----------------------------------------------------------------------------
+
+class RenderBench
+{
+public:
+      RenderBench();
+      ~RenderBench();
+
+      bool Run( const wxString &script_file, ChartCanvas *cc );
+
+private:
+      bool RunCommand( const wxString &line );
+      bool LoadCell( const wxString &file );
+      bool RenderFrame( void );
+      ViewPort MakeViewPort( void );
+#ifdef ocpnUSE_GL
+      bool RenderFrameGL( ViewPort &vp );
+      bool BuildFBO( void );
+      void DeleteFBO( void );
+#endif
+      void SetColorScheme( const wxString &name );
+      void Report( void );
+
+      ChartCanvas             *m_cc;
+      std::vector<s57chart *> m_charts;
+
+      bool                    m_bGL;
+      int                     m_width;
+      int                     m_height;
+
+      double                  m_lat;
+      double                  m_lon;
+      double                  m_scale;
+      double                  m_rotation;
+
+      std::vector<double>     m_frame_ms;
+
+#ifdef ocpnUSE_GL
+      unsigned int            m_fbo;
+      unsigned int            m_color_rb;
+      unsigned int            m_depth_rb;
+      int                     m_fbo_width;
+      int                     m_fbo_height;
+#endif
+};
+
+#endif
@@ -183,8 +183,6 @@ public:
 
 #ifdef ocpnUSE_GL
       void DrawGL( ViewPort &vp, ChartCanvas *canvas, bool use_cached_screen_coords=false );
-      unsigned int m_iTextTexture;
-      int m_iTextTextureWidth, m_iTextTextureHeight;
 
       LLBBox m_wpBBox;
       double m_wpBBox_view_scale_ppm, m_wpBBox_rotation;
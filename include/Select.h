@@ -37,7 +37,6 @@
 #define SELTYPE_TRACKSEGMENT         0x0100
 #define SELTYPE_DRAGHANDLE           0x0200
 
-class TrackPoint;
 class Track;
 class Route;
 class RoutePoint;
@@ -57,7 +56,7 @@ public:
             RoutePoint *pRoutePointAdd1, RoutePoint *pRoutePointAdd2, Route *pRoute );
 
     bool AddSelectableTrackSegment( float slat1, float slon1, float slat2, float slon2,
-                                    TrackPoint *pTrackPointAdd1, TrackPoint *pTrackPointAdd2, Track *pTrack );
+                                    int nTrackPoint1, int nTrackPoint2, Track *pTrack );
 
     SelectItem *FindSelection( ChartCanvas *cc, float slat, float slon, int fseltype );
     SelectableItemList FindSelectionList( ChartCanvas *cc, float slat, float slon, int fseltype );
@@ -69,7 +68,7 @@ public:
     bool AddAllSelectableTrackSegments( Track *pr );
     bool AddAllSelectableRoutePoints( Route *pr );
     bool UpdateSelectableRouteSegments( RoutePoint *prp );
-    bool DeletePointSelectableTrackSegments( TrackPoint *pt );
+    bool DeletePointSelectableTrackSegments( Track *pTrack, int nTrackPoint );
     bool IsSegmentSelected( float a, float b, float c, float d, float slat, float slon );
     bool IsSelectableSegmentSelected( ChartCanvas *cc, float slat, float slon, SelectItem *pFindSel );
 
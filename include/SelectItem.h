@@ -46,6 +46,7 @@ public:
       void  *m_pData2;
       void  *m_pData3;
       int   m_Data4;
+      int   m_Data5;
 };
 
 WX_DECLARE_LIST(SelectItem, SelectableItemList);// establish class as list member
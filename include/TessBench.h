@@ -0,0 +1,71 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Area tesselation benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __TESSBENCH_H__
+#define __TESSBENCH_H__
+
+#include <vector>
+
+#include <wx/string.h>
+
+class OGRPolygon;
+class PolyTessGeo;
+
+//----------------------------------------------------------------------------
+//      Area tesselation benchmark, run by the --tess_bench command line option.
+//
+//      Reads the area features of every ENC cell (*.000, updates applied)
+//      under a directory, as SENC creation does, then tesselates them all
+//      with each back-end, GLU and libtess2, on one thread and on a thread
+//      per CPU.  Each run is the best of several passes.  Triangles per
+//      second, and the total triangle area as a check that the back-ends
+//      cover the same ground, are written to stdout and to the log.
+//----------------------------------------------------------------------------
+
+class TessBench
+{
+public:
+      TessBench();
+      ~TessBench();
+
+      bool Run( const wxString &dir );
+
+private:
+      struct Result
+      {
+            double  ms;
+            long    triangles;
+            long    failed;
+            double  area;
+      };
+
+      Result RunPass( int backend, int nThreads );
+      static void Measure( PolyTessGeo *ppg, long &triangles, double &area );
+
+      std::vector<OGRPolygon *>   m_polys;
+      std::vector<double>         m_ref_lat;        // per polygon, its cell's centre
+      std::vector<double>         m_ref_lon;
+};
+
+#endif
@@ -26,6 +26,9 @@
 #ifndef __TEXFONT_H__
 #define __TEXFONT_H__
 
+#include <vector>
+#include <unordered_map>
+
 /* support ascii plus degree symbol for now pack font in a single texture 16x8 */
 #define DEGREE_GLYPH 127
 #define MIN_GLYPH 32
@@ -71,4 +74,63 @@ private:
     bool m_built;
     
 };
+
+/* glyphs of any font and character, packed on demand into shared texture pages */
+#define ATLAS_PAGE_SIZE  1024
+#define ATLAS_MAX_PAGES  4
+
+struct TexAtlasGlyph {
+    int page;                   // -1 for glyphs with nothing to draw
+    int width, height;
+    float advance;
+    float u1, v1, u2, v2;
+};
+
+struct TexAtlasFont {
+    wxFont font;
+    int line_height;
+};
+
+struct TexAtlasPage {
+    unsigned int texobj;
+    int shelf_x, shelf_y, shelf_h;
+
+    std::vector<float> verts;               // x, y, u, v of the queued quads
+    std::vector<unsigned char> colors;      // rgba per vertex
+};
+
+/* Text is queued as coloured quads on the page holding each glyph.
+   Outside of a batch every string is drawn at once, inside a batch the
+   queued quads are drawn with one call per page when the batch ends.
+   The modelview must not change between the start and end of a batch. */
+class TexFontAtlas {
+public:
+    static TexFontAtlas &Get();
+
+    void GetTextExtent( const wxFont &font, const wxString &string, int *width, int *height );
+    void AddString( const wxFont &font, const wxString &string, float x, float y,
+                    const wxColour &colour, float rotation = 0. );
+
+    void BeginBatch(){ m_batch_depth++; }
+    void EndBatch();
+    void Flush();
+
+    void Clear();
+
+private:
+    TexFontAtlas();
+
+    int FindFont( const wxFont &font );
+    const TexAtlasGlyph &GetGlyph( int font, unsigned int c );
+    bool Allocate( int w, int h, int &page, int &x, int &y );
+    void Reset();
+
+    std::vector<TexAtlasFont> m_fonts;
+    int m_last_font;
+
+    std::unordered_map<unsigned long long, TexAtlasGlyph> m_glyphs;    // by font << 32 | character
+    std::vector<TexAtlasPage> m_pages;
+
+    int m_batch_depth;
+};
 #endif  //guard
\ No newline at end of file
@@ -34,10 +34,12 @@
 #include <vector>
 #include <list>
 #include <deque>
+#include <string>
 
 class HyperlinkList;
 class ChartCanvas;
 class ViewPort;
+class TrackGLGeometry;
 
 struct SubTrack
 {
@@ -47,24 +49,55 @@ struct SubTrack
     double            m_scale;
 };
 
+#define TRACKPOINT_NO_TIME      ( -wxLL(0x7fffffffffffffff) - 1 )
+
+//  A single track point.  Tracks keep their points in columns (see TrackPointArray),
+//  a TrackPoint is just the lightweight value handed in and out of a Track.
 class TrackPoint
 {
 public:
+      TrackPoint() : m_lat(0.), m_lon(0.), m_GPXTrkSegNo(1), m_time(TRACKPOINT_NO_TIME) {}
       TrackPoint(double lat, double lon, wxString ts="");
       TrackPoint(double lat, double lon, wxDateTime dt);
-      TrackPoint( TrackPoint* orig );
-      ~TrackPoint();
 
-      wxDateTime GetCreateTime(void);
+      wxDateTime GetCreateTime(void) const;
       void SetCreateTime( wxDateTime dt );
-      void Draw(ChartCanvas *cc, ocpnDC& dc );
-      const char *GetTimeString() { return m_timestring; }
-      
+      bool HasCreateTime() const { return m_time != TRACKPOINT_NO_TIME; }
+      wxString GetTimeString() const;
+      void Draw(ChartCanvas *cc, ocpnDC& dc ) const;
+
       double            m_lat, m_lon;
       int               m_GPXTrkSegNo;
+      wxInt64           m_time;             // create time, wxDateTime milliseconds since the epoch, or TRACKPOINT_NO_TIME
 private:
       void SetCreateTime( wxString ts );
-      char             *m_timestring;
+};
+
+//  Column storage for the points of a track, one contiguous array per field
+class TrackPointArray
+{
+public:
+      TrackPointArray() : changed_from( 0 ) {}
+
+      size_t size() const { return lat.size(); }
+      bool empty() const { return lat.empty(); }
+      void reserve( size_t n );
+      void clear();
+
+      TrackPoint Get( size_t n ) const;
+      void Set( size_t n, const TrackPoint &tp );
+      void push_back( const TrackPoint &tp );
+      void erase( size_t n );
+      void pop_back();
+
+      std::vector<double>     lat;
+      std::vector<double>     lon;
+      std::vector<wxInt64>    time;
+      std::vector<int>        seg;
+
+      //  Points before this index are unchanged since the GL geometry last synced,
+      //  appending does not lower it
+      size_t                  changed_from;
 };
 
 //----------------------------------------------------------------------------
@@ -78,15 +111,25 @@ public:
     virtual ~Track();
 
     void Draw( ChartCanvas *cc, ocpnDC& dc, ViewPort &VP, const LLBBox &box);
-    int GetnPoints(void){ return TrackPoints.size(); }
+    int GetnPoints(void){ return m_pending_trksegs.empty() ? (int) TrackPoints.size() : m_pending_count; }
     
     
-    void SetVisible(bool visible = true) { m_bVisible = visible; }
-    TrackPoint *GetPoint( int nWhichPoint );
-    TrackPoint *GetLastPoint();
-    void AddPoint( TrackPoint *pNewPoint );
-    void AddPointFinalized( TrackPoint *pNewPoint );
-    TrackPoint* AddNewPoint( vector2D point, wxDateTime time );
+    void SetVisible(bool visible = true);
+    TrackPoint GetPoint( int nWhichPoint );
+    TrackPoint GetLastPoint();
+    double GetPointLat( int nWhichPoint ) { LoadPendingPoints(); return TrackPoints.lat[nWhichPoint]; }
+    double GetPointLon( int nWhichPoint ) { LoadPendingPoints(); return TrackPoints.lon[nWhichPoint]; }
+    void Reserve( int nPoints ) { LoadPendingPoints(); TrackPoints.reserve( nPoints ); }
+    const TrackPointArray &GetPoints() { LoadPendingPoints(); return TrackPoints; }
+
+    //  A track loaded hidden keeps its <trkseg> elements as GPX text, parsed into
+    //  points on first use.  Saving writes the text back as it is.
+    void SetPendingPoints( const std::string &trksegs, int count ) { m_pending_trksegs = trksegs; m_pending_count = count; }
+    bool HasPendingPoints() const { return !m_pending_trksegs.empty(); }
+    const std::string &GetPendingPoints() const { return m_pending_trksegs; }
+    void AddPoint( const TrackPoint &NewPoint );
+    void AddPointFinalized( const TrackPoint &NewPoint );
+    TrackPoint AddNewPoint( vector2D point, wxDateTime time );
     
     void SetListed(bool listed = true) { m_bListed = listed; }
     virtual bool IsRunning() { return false; }
@@ -108,11 +151,12 @@ public:
             return m_TrackNameString;
         } else {
             wxString name;
-            TrackPoint *rp = NULL;
-            if((int) TrackPoints.size() > 0)
-                rp = TrackPoints[0];
-            if( rp && rp->GetCreateTime().IsValid() ) name = rp->GetCreateTime().FormatISODate() + _T(" ")
-                + rp->GetCreateTime().FormatISOTime();   //name = rp->m_CreateTime.Format();
+            wxDateTime create_time;
+            const_cast<Track *>( this )->LoadPendingPoints();
+            if( !TrackPoints.empty() )
+                create_time = TrackPoints.Get(0).GetCreateTime();
+            if( create_time.IsValid() ) name = create_time.FormatISODate() + _T(" ")
+                + create_time.FormatISOTime();   //name = rp->m_CreateTime.Format();
             else
                 name = _("(Unnamed Track)");
             return name;
@@ -136,26 +180,32 @@ public:
     bool m_bVisible;
     bool        m_bListed;
     bool        m_btemp;
+    bool        m_bSelectablePending;   // loaded hidden, selectable segments built when first shown
 
     int               m_CurrentTrackSeg;
 
     HyperlinkList     *m_HyperlinkList;
     int m_HighlightedTrackPoint;
 
+    TrackGLGeometry   *m_pGLGeometry;
+
     void Clone( Track *psourcetrack, int start_nPoint, int end_nPoint, const wxString & suffix);
 
 protected:
     void Segments( ChartCanvas *cc, std::list< std::list<wxPoint> > &pointlists, const LLBBox &box, double scale);
-    void DouglasPeuckerReducer( std::vector<TrackPoint*>& list,
-                                std::vector<bool> & keeplist,
+    void DouglasPeuckerReducer( std::vector<bool> & keeplist,
                                 int from, int to, double delta );
-    double GetXTE(TrackPoint *fm1, TrackPoint *fm2, TrackPoint *to);
+    double GetXTE( int fm1, int fm2, int to );
     double GetXTE( double fm1Lat, double fm1Lon, double fm2Lat, double fm2Lon, double toLat, double toLon  );
             
-    std::vector<TrackPoint*>     TrackPoints;
+    TrackPointArray     TrackPoints;
     std::vector<std::vector <SubTrack> > SubTracks;
 
+    void LoadPendingPoints() { if( !m_pending_trksegs.empty() ) ParsePendingPoints(); }
+
 private:
+    void ParsePendingPoints();
+    bool DrawGLGeometry( ChartCanvas *cc, const wxColour &col, int width, const LLBBox &box );
     void GetPointLists(ChartCanvas *cc, std::list< std::list<wxPoint> > &pointlists,
                        ViewPort &VP, const LLBBox &box );
     void Finalize();
@@ -168,6 +218,9 @@ private:
     void Assemble( ChartCanvas *cc, std::list< std::list<wxPoint> > &pointlists, const LLBBox &box, double scale, int &last, int level, int pos);
     
     wxString    m_TrackNameString;
+
+    std::string m_pending_trksegs;
+    int         m_pending_count;
 };
 
 WX_DECLARE_LIST(Track, TrackList); // establish class Route as list member
@@ -186,7 +239,7 @@ class ActiveTrack : public wxEvtHandler, public Track
             Track *DoExtendDaily();
             bool IsRunning(){ return m_bRunning; }
             
-            void AdjustCurrentTrackPoint( TrackPoint *prototype );
+            void AdjustCurrentTrackPoint( const TrackPoint &prototype );
             
       private:
             void OnTimerTrack(wxTimerEvent& event);
@@ -204,10 +257,11 @@ class ActiveTrack : public wxEvtHandler, public Track
             double            m_prev_dist;
             wxDateTime        m_prev_time;
 
-            TrackPoint        *m_lastStoredTP;
-            TrackPoint        *m_removeTP;
-            TrackPoint        *m_prevFixedTP;
-            TrackPoint        *m_fixedTP;
+            //  Indices into TrackPoints, -1 if none
+            int               m_lastStoredTP;
+            int               m_removeTP;
+            int               m_prevFixedTP;
+            int               m_fixedTP;
             int               m_track_run;
             double            m_minTrackpoint_delta;
             
@@ -60,6 +60,7 @@
 #endif
 
 #include "LinkPropDlg.h"
+#include "Track.h"
 
 #define ID_RCLK_MENU_COPY_TEXT 7013
 
@@ -89,7 +90,7 @@ private:
                       const wxPoint& pos, const wxSize& size,
                       long style ); 
         
-        TrackPoint *m_pExtendPoint;
+        TrackPoint m_ExtendPoint;
         Track      *m_pExtendTrack;
         TrackPoint *m_pEntrackPoint;
         bool        m_bStartNow;
@@ -74,6 +74,7 @@ void ApplyLocale( void );
 void LoadS57();
 
 class NMEA_Msg_Container;
+class ChartPreloader;
 WX_DECLARE_STRING_HASH_MAP( NMEA_Msg_Container*, MsgPriorityHash );
 
 //    Fwd definitions
@@ -311,6 +312,7 @@ class MyApp: public wxApp
 {
   public:
     bool OnInit();
+    int OnRun();
     int OnExit();
     void OnInitCmdLine(wxCmdLineParser& parser);
     bool OnCmdLineParsed(wxCmdLineParser& parser);
@@ -352,6 +354,7 @@ class MyFrame: public wxFrame
     void OnMove(wxMoveEvent& event);
     void OnInitTimer(wxTimerEvent& event);
     void OnFrameTimer1(wxTimerEvent& event);
+    void OnIdle(wxIdleEvent& event);
     bool DoChartUpdate(void);
     void OnEvtTHREADMSG(OCPN_ThreadMessageEvent& event);
     void OnEvtOCPN_NMEA(OCPN_DataStreamEvent & event);
@@ -359,6 +362,9 @@ class MyFrame: public wxFrame
     void OnMemFootTimer(wxTimerEvent& event);
     void OnRecaptureTimer(wxTimerEvent& event);
     void OnSENCEvtThread( OCPN_BUILDSENC_ThreadEvent & event);
+#ifdef USE_S57
+    void OnCM93CellLoaded( wxCommandEvent& event );
+#endif
     void OnIconize(wxIconizeEvent& event);
     void OnBellsFinished(wxCommandEvent& event);
 
@@ -380,6 +386,7 @@ class MyFrame: public wxFrame
     void applySettingsString( wxString settings);
     void setStringVP(wxString VPS);
     void InvalidateAllGL();
+    void InvalidateAllQuilts();
     void RefreshAllCanvas( bool bErase = true);
     void CancelAllMouseRoute();
     
@@ -611,6 +618,8 @@ class MyFrame: public wxFrame
     wxTimer             ToolbarAnimateTimer;
     int                 m_nMasterToolCountShown;
     wxTimer             m_recaptureTimer;
+
+    ChartPreloader      *m_pChartPreloader;
     
     DECLARE_EVENT_TABLE()
 };
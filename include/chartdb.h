@@ -33,6 +33,8 @@
 
 #include <wx/xml/xml.h>
 
+#include <vector>
+
 #include "chartbase.h"
 #include "chartdbs.h"
 
@@ -88,6 +90,18 @@ public:
       int         dbIndex;
       bool        b_in_use;
       int         n_lock;
+      double      open_ms;          // time Init() took, the cost of opening it again
+      int         mem_kb;           // estimated memory the open chart holds
+};
+
+//    Chart cache counters, since the database was created
+struct ChartCacheStats
+{
+      long        hits;
+      long        misses;
+      long        evictions;
+      long        mem_kb;           // accounted memory of the charts in the cache
+      double      open_ms;          // total time spent opening charts
 };
 
 
@@ -155,6 +169,8 @@ public:
       void PurgeCacheUnusedCharts( double factor );
 
       bool IsBusy(){ return m_b_busy; }
+
+      ChartCacheStats GetCacheStats();
 protected:
       virtual ChartBase *GetChart(const wxChar *theFilePath, ChartClassDescriptor &chart_desc) const;
 
@@ -165,7 +181,12 @@ private:
       bool CreateS57SENCChartTableEntry(wxString full_name, ChartTableEntry *pEntry, Extent *pext);
       bool CheckPositionWithinChart(int index, float lat, float lon);
       ChartBase *OpenChartUsingCache(int dbindex, ChartInitFlag init_flag);
-      CacheEntry *FindOldestDeleteCandidate( bool blog );
+      CacheEntry *FindDeleteCandidate( bool blog );
+      double EvictionScore( CacheEntry *pce, const std::vector<LLBBox> &views );
+      bool IsCacheEntryShown( CacheEntry *pce );
+      int EstimateChartFootprintKB( const wxString &path, ChartTypeEnum type, ChartFamilyEnum family );
+      void EvictCacheEntry( CacheEntry *pce, bool bDelTexture, const wxString &msg, int &mem_used );
+      void LogCacheStats( const ChartCacheStats &stats, int nCharts );
       void DeleteCacheEntry(int i, bool bDelTexture = false, const wxString &msg = wxEmptyString);
       void DeleteCacheEntry(CacheEntry *pce, bool bDelTexture = false, const wxString &msg = wxEmptyString);
       
@@ -176,6 +197,8 @@ private:
       bool              m_b_locked;
       bool              m_b_busy;
 
+      ChartCacheStats   m_cache_stats;
+
       wxCriticalSection m_critSect;
       wxMutex           m_cache_mutex;
 };
@@ -28,6 +28,8 @@
 
 #include <map>
 #include <vector>
+#include <mutex>
+#include <atomic>
 
 #include "ocpn_types.h"
 #include "bbox.h"
@@ -339,6 +341,14 @@ public:
     inline ChartTable &GetChartTable(){ return active_chartTable; }
     
     bool IsValid() const { return bValid; }
+
+    //  The chart table is changing.  Threads other than the GUI thread read the
+    //  table only while holding GetTableMutex(), taken with try_lock, and give up
+    //  when they cannot.  The generation moves on after each change.
+    bool IsUpdating() const { return m_b_updating; }
+    unsigned int GetTableGeneration() const { return m_table_generation; }
+    std::mutex &GetTableMutex() { return m_table_mutex; }
+
     int DisableChart(wxString& PathToDisable);
     bool GetCentroidOfLargestScaleChart(double *clat, double *clon, ChartFamilyEnum family);
     int GetDBChartType(int dbIndex);
@@ -386,6 +396,7 @@ private:
                    int isearch, bool bthis_dir_in_dB );
 
     bool Check_CM93_Structure(wxString dir_name);
+    bool UpdateTable(ArrayOfCDI& dir_array, bool bForce, wxGenericProgressDialog *pprog);
 
     bool          bValid;
     wxArrayString m_chartDirs;
@@ -400,6 +411,10 @@ private:
     int         m_nentries;
 
     LLBBox m_dummy_bbox;
+
+    std::mutex                  m_table_mutex;
+    std::atomic<bool>           m_b_updating;
+    std::atomic<unsigned int>   m_table_generation;
 };
 
 
@@ -227,6 +227,7 @@ public:
       void UpdateAlerts();                          // pjotrc 2010.02.22
 
       bool IsMeasureActive(){ return m_bMeasure_Active; }
+      bool IsUserInteracting( long quiet_ms );
       wxBitmap &GetTideBitmap(){ return m_cTideBitmap; }
       
       void UnlockQuilt();
@@ -815,6 +816,7 @@ private:
 
 
       wxDateTime m_last_movement_time;
+      wxLongLong m_last_input_time;             // ms, last mouse button, wheel or key event
 
       
       int         m_AISRollover_MMSI;
@@ -31,6 +31,10 @@
 #include    "s57chart.h"
 #include    "cutil.h"               // for types
 
+#include <atomic>
+#include <deque>
+#include <thread>
+
 //    Some constants
 #define     INDEX_m_sor       217                // cm93 dictionary index for object type _m_sor
 
@@ -39,9 +43,16 @@
 //    Static functions
 int Get_CM93_CellIndex(double lat, double lon, int scale);
 void Get_CM93_Cell_Origin(int cellindex, int scale, double *lat, double *lon);
+bool CM93DecodeBench(const wxString &dir);
+
+//    Event posted to gFrame when the background cell loader has decoded more cells
+extern const wxEventType wxEVT_OCPN_CM93CELLLOADED;
 
 //    Fwd definitions
 class covr_set;
+class cm93_cell_loader;
+class cm93_cell_data;
+class cm93_survey_timer;
 class wxSpinCtrl;
 class ChartCanvas;
 
@@ -289,6 +300,9 @@ public:
 
     cm93_dictionary   *m_pcm93Dict;
 
+    //  Background reader/decoder and cache of cm93 cells, shared by all cm93chart scales
+    cm93_cell_loader  *m_pcell_loader;
+
     //  Member variables used to record the calling of cm93chart::CreateHeaderDataFromCM93Cell()
     //  for each available scale value.  This allows that routine to return quickly with no error
     //  for all cells other than the first, at each scale....
@@ -333,6 +347,7 @@ class cm93chart : public s57chart
             void SetCM93Manager(cm93manager *pManager){m_pManager = pManager;}
 
             bool UpdateCovrSet(ViewPort *vpt);
+            bool SurveyCovrStep(void);
             bool IsPointInLoadedM_COVR(double xc, double yc);
             covr_set *GetCoverSet(){ return m_pcovr_set; }
             LLRegion GetValidRegion();
@@ -365,13 +380,14 @@ class cm93chart : public s57chart
 
             int CreateObjChain(int cell_index, int subcell, double view_scale_ppm);
 
-            void Unload_CM93_Cell(void);
+            void Attach_CM93_Cell(const Cell_Info_Block *pCIB);
 
             //    cm93 point manipulation methods
             void Transform(cm93_point *s, double trans_x, double trans_y, double *lat, double *lon);
 
-            int loadcell_in_sequence(int, char);
-            int loadsubcell(int, wxChar);
+            cm93_cell_data *GetDecodedCell(int cell_index, bool *pb_nofiles, bool b_survey = false);
+            bool UpdateCellCovr(int cell_index, bool b_survey);
+            bool locatesubcell(int cellindex, wxChar sub_char, wxString &file, wxString &compfile);
             void ProcessVectorEdges(void);
 
             wxPoint2DDouble FindM_COVROffset(double lat, double lon);
@@ -406,6 +422,13 @@ class cm93chart : public s57chart
 
             LLRegion            m_region;
             wxArrayString       m_noFindArray;
+
+            //    Whole dataset coverage survey, see SurveyCovrStep()
+            std::thread         m_survey_thread;
+            std::atomic<bool>   m_bsurvey_listed;
+            std::atomic<bool>   m_bsurvey_cancel;
+            bool                m_bsurvey_done;
+            std::deque<int>     m_survey_cells;
 };
 
 //----------------------------------------------------------------------------
@@ -474,6 +497,7 @@ class cm93compchart : public s57chart
             void CloseandReopenCurrentSubchart(void);
 
             void InvalidateCache();
+            void SurveyCoverage(void);
       private:
             void UpdateRenderRegions ( const ViewPort& VPoint );
             OCPNRegion GetValidScreenCanvasRegion(const ViewPort& VPoint, const OCPNRegion &ScreenRegion);
@@ -518,6 +542,9 @@ class cm93compchart : public s57chart
 
 
             cm93chart *m_last_cell_adjustvp;
+
+            cm93_survey_timer *m_psurvey_timer;
+            int               m_survey_scale;
 };
 
 
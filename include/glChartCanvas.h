@@ -98,6 +98,8 @@ public:
     
     bool m_GLPolygonSmoothing;
     bool m_GLLineSmoothing;
+
+    bool m_bUseChartTileCache;
 };
 
 
@@ -114,9 +116,12 @@ class ocpnDC;
 class emboss_data;
 class Route;
 class ChartBaseBSB;
+class glChartTileCache;
 
 class glChartCanvas : public wxGLCanvas
 {
+    friend class glChartTileCache;
+
 public:
     static bool CanClipViewport(const ViewPort &vp);
     static ViewPort ClippedViewport(const ViewPort &vp, const LLRegion &region);
@@ -143,6 +148,7 @@ public:
     ~glChartCanvas();
 
     void SetContext(wxGLContext *pcontext) { m_pcontext = pcontext; }
+    wxGLContext *GetContext() { return m_pcontext; }
 
     void OnPaint(wxPaintEvent& event);
     void OnEraseBG(wxEraseEvent& evt);
@@ -200,6 +206,7 @@ protected:
     
 //    void ComputeRenderQuiltViewGLRegion( ViewPort &vp, OCPNRegion &Region );
     void RenderCharts(ocpnDC &dc, const OCPNRegion &rect_region);
+    void RenderCharts(ocpnDC &dc, const OCPNRegion &rect_region, ViewPort &vp);
     void RenderNoDTA(ViewPort &vp, const LLRegion &region, int transparency = 255);
     void RenderNoDTA(ViewPort &vp, ChartBase *chart);
     void RenderWorldChart(ocpnDC &dc, ViewPort &vp, wxRect &rect, bool &world_view);
@@ -252,6 +259,11 @@ protected:
     float       m_fbo_offsety;
     float       m_fbo_swidth;
     float       m_fbo_sheight;
+
+    //    Tiled cache of the chart layers, composed into the FBO
+    glChartTileCache *m_pTileCache;
+    bool        m_btiles_composed;
+
     bool        m_binPinch;
     bool        m_binPan;
     bool        m_bfogit;
@@ -0,0 +1,130 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Tiled framebuffer cache of rendered chart layers
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************
+ */
+
+#ifndef __GLCHARTTILECACHE_H__
+#define __GLCHARTTILECACHE_H__
+
+#include <vector>
+
+#include <wx/glcanvas.h>
+
+#include "viewport.h"
+
+class glChartCanvas;
+class ChartBase;
+class ocpnDC;
+
+//  Everything, besides the tile position, that the rendered chart pixels depend on
+struct glChartTileKey
+{
+    double      view_scale_ppm;
+    int         projection;
+    int         color_scheme;
+    int         ref_index;              // quilt reference chart, -1 in single chart mode
+    ChartBase   *chart;                 // single chart, NULL when quilting
+
+    //  Close enough for one to stand in, stretched, for the other
+    bool SameLayers( const glChartTileKey &k ) const {
+        return projection == k.projection && color_scheme == k.color_scheme && chart == k.chart;
+    }
+    bool operator==( const glChartTileKey &k ) const {
+        return view_scale_ppm == k.view_scale_ppm && ref_index == k.ref_index && SameLayers( k );
+    }
+};
+
+struct glChartTile
+{
+    glChartTileKey  key;
+    int             ix, iy;             // tile index in world pixels / TILE_SIZE
+    GLuint          tex;
+    unsigned int    generation;         // cache generation the tile was rendered in
+    unsigned int    last_used;          // frame the tile was last drawn
+    double          valid[8];           // world pixel quad the content is complete in
+};
+
+//----------------------------------------------------------------------------
+//      glChartTileCache
+//
+//      Chart layers are rendered north up into fixed size textures laid out on
+//      a grid of absolute Mercator pixels at the view scale, so the same tile is
+//      reused wherever the view pans to, and under any view rotation.
+//      Each frame only tiles that are missing, out of date or incomplete for the
+//      visible area are rendered, within a time budget. Tiles left over are drawn
+//      from their stale content, or stretched from the previous scale, and
+//      refined on the following frames.  With too many tiles missing and nothing
+//      to stand in for them, the canvas renders the frame directly instead.
+//----------------------------------------------------------------------------
+
+class glChartTileCache
+{
+public:
+    glChartTileCache( glChartCanvas *glcc );
+    ~glChartTileCache();
+
+    bool CanCache( ViewPort &vp );
+    bool Update( ocpnDC &dc, ViewPort &vp );
+    void Compose( ViewPort &vp, double sdx = 0., double sdy = 0. );
+
+    void Invalidate() { m_generation++; }
+    void Clear();
+
+    bool IsComplete() { return m_bcomplete; }
+    bool HasTiles() { return m_bkey && m_tiles.size() > 0; }
+
+private:
+    bool BuildFBO();
+    glChartTileKey MakeKey( ViewPort &vp );
+    void GetScreenQuad( ViewPort &vp, double sdx, double sdy, double *q, double &cx, double &cy );
+    void GetTileRange( const double *q, int &ix0, int &iy0, int &ix1, int &iy1 );
+    ViewPort TileViewPort( ViewPort &vp, int ix, int iy );
+
+    glChartTile *FindTile( const glChartTileKey &key, int ix, int iy );
+    glChartTile *NewTile( int ix, int iy, int nvisible );
+    void RenderTile( ocpnDC &dc, ViewPort &vp, glChartTile *tile );
+    void DrawTile( glChartTile *tile, double scale, double cx, double cy,
+                   const ViewPort &vp, bool blinear );
+
+    glChartCanvas               *m_glcc;
+
+    GLuint                      m_fbo;
+    GLuint                      m_renderbuffer;
+    bool                        m_bfbo_failed;
+
+    std::vector<glChartTile *>  m_tiles;
+
+    glChartTileKey              m_key;
+    bool                        m_bkey;
+    glChartTileKey              m_fallback_key;
+    bool                        m_bfallback;
+
+    unsigned int                m_generation;
+    unsigned int                m_frame;
+    bool                        m_bcomplete;
+
+    bool                        m_bdirect;          // last frame rendered directly, too many tiles missing
+    double                      m_direct_q[8];      // its screen quad
+};
+
+#endif
@@ -36,6 +36,8 @@
 
 #include "dychart.h"
 
+#include <vector>
+
 class OGRGeometry;
 class OGRPolygon;
 
@@ -44,6 +46,10 @@ class OGRPolygon;
 
 #define EQUAL_EPS 1.0e-7                        // tolerance value
 
+//  Tesselator back-ends, selected at runtime by g_nTessBackend
+#define TESS_BACKEND_GLU        0
+#define TESS_BACKEND_LIBTESS2   1
+
 
 //  nota bene  These definitions are identical to OpenGL prototypes
 #define PTG_TRIANGLES                      0x0004
@@ -198,6 +204,7 @@ class PolyTessGeo
         bool IsOk(){ return m_bOK;}
 
         int BuildDeferredTess(void);
+        static void BuildDeferredTessBatch( std::vector<PolyTessGeo *> &list, int nThreads );
 
         double Get_xmin(){ return xmin;}
         double Get_xmax(){ return xmax;}
@@ -241,7 +248,11 @@ class PolyTessGeo
         bool           m_bcm93;
         
 private:
+        int Tesselate(void);
         int BuildTess(void);
+        int BuildTessFan( float *ring, int npt );
+        void SetTriPrimBox( TriPrim *pTPG );
+        void FinishTriGroup( TriPrim *pTPG_Head, float *vbuf, int vbuf_size );
         //int BuildTessGL2(void);
         //int PolyTessGeoGL(OGRPolygon *poly, bool bSENC_SM, double ref_lat, double ref_lon);
         int BuildTessGLU( void );
@@ -32,6 +32,9 @@
 #include <wx/fileconf.h>
 #include <wx/sound.h>
 
+#include <atomic>
+#include <thread>
+
 #ifdef __WXMSW__
 #include <wx/msw/regconf.h>
 #include <wx/msw/iniconf.h>
@@ -156,7 +159,7 @@ public:
       virtual void AddNewWayPoint(RoutePoint *pWP, int ConfigRouteNum = -1);
       virtual void UpdateWayPoint(RoutePoint *pWP);
       virtual void DeleteWayPoint(RoutePoint *pWP);
-      virtual void AddNewTrackPoint( TrackPoint *pWP, const wxString& parent_GUID );
+      virtual void AddNewTrackPoint( const TrackPoint &WP, const wxString& parent_GUID );
 
       virtual void CreateConfigGroups ( ChartGroupArray *pGroupArray );
       virtual void DestroyConfigGroups ( void );
@@ -176,14 +179,24 @@ public:
       int LoadMyConfigRaw( bool bAsTemplate = false );
       
       void CreateRotatingNavObjBackup();
-      virtual void UpdateNavObj();
+      virtual void UpdateNavObj( bool bBackground = false );
+      void CheckNavObjJournal();
+      void WaitNavObjCompaction();
       
       wxString                m_sNavObjSetFile;
-      wxString                m_sNavObjSetChangesFile;
+      wxString                m_sNavObjSetChangesFile;          // legacy XML change log
+      wxString                m_sNavObjSetJournalFile;
 
       NavObjectChanges        *m_pNavObjectChangesSet;
       NavObjectCollection1    *m_pNavObjectInputSet;
       bool                    m_bSkipChangeSetUpdate;
+
+private:
+      wxUint64                m_NavObjSeq;                      // last journal record in navobj.xml
+      long                    m_NavObjCompactTime;
+      std::thread             m_NavObjThread;
+      std::atomic<bool>       m_bNavObjThreadBusy;
+      std::atomic<bool>       m_bNavObjSaveOK;
       
 };
 
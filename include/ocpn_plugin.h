@@ -1329,4 +1329,9 @@ enum SDDMFORMAT
 
 extern DECL_EXP int GetLatLonFormat(void);
 
+//  Chart cache counters, since the chart database was loaded
+//  mem_kb is the estimated memory held by the charts now in the cache
+extern DECL_EXP bool GetChartCacheStats( long *hits, long *misses, long *evictions,
+                                         long *mem_kb, double *open_ms );
+
 #endif //_PLUGIN_H_
@@ -98,6 +98,8 @@ public:
      void DrawBitmap(const wxBitmap &bitmap, wxCoord x, wxCoord y, bool usemask);
 
      void DrawText(const wxString &text, wxCoord x, wxCoord y);
+     void BeginTextBatch();                  // GL: defer text drawing to EndTextBatch()
+     void EndTextBatch();
      void GetTextExtent(const wxString &string, wxCoord *w, wxCoord *h, wxCoord *descent = NULL,
                         wxCoord *externalLeading = NULL, wxFont *font = NULL);
 
@@ -122,9 +124,6 @@ protected:
      wxColour m_textforegroundcolour;
      wxFont m_font;
 
-#ifdef ocpnUSE_GL     
-     TexFont m_texfont;
-#endif
      bool m_buseTex;
 
 #if  wxUSE_GRAPHICS_CONTEXT
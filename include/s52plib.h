@@ -27,6 +27,7 @@
 #define _S52PLIB_H_
 
 #include <vector>
+#include <unordered_map>
 
 #include "s52s57.h"                 //types
 
@@ -59,6 +60,9 @@ struct CARC_Buffer {
 WX_DECLARE_STRING_HASH_MAP( CARC_Buffer, CARC_Hash );
 WX_DECLARE_STRING_HASH_MAP( int, CARC_DL_Hash );
 
+//      Dynamic CS LUPs, keyed by object class, display category and INST string
+WX_DECLARE_STRING_HASH_MAP( LUPrec*, CSLUPHash );
+
 class ViewPort;
 class PixelCache;
 
@@ -96,7 +100,136 @@ private:
     LUPArrayIndexHash           IndexHash;
 };
 
-    
+
+//-----------------------------------------------------------------------------
+//      Screen space grid of placed text rectangles, for label declutter.
+//      Rectangles are copied in, so the text objects may be freed while listed.
+//-----------------------------------------------------------------------------
+class S52TextRectGrid {
+public:
+    void Clear( void );
+    void Insert( S52_TextC *owner, const wxRect &rect );
+    bool Intersects( const wxRect &rect, S52_TextC *except ) const;
+
+private:
+    class Entry {
+    public:
+        wxRect rect;
+        S52_TextC *owner;               // NULL once superseded
+    };
+
+    void CellRange( const wxRect &rect, int &cx0, int &cy0, int &cx1, int &cy1 ) const;
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<long long, std::vector<int> > m_cells;
+    std::unordered_map<S52_TextC *, int> m_owner_entry;
+};
+
+//-----------------------------------------------------------------------------
+//      One area fill of the software (DC) rasterizer.
+//      Rules, patterns and tesselation are resolved on the main thread,
+//      so the fills may then be scan converted by band concurrently.
+//-----------------------------------------------------------------------------
+class S52BufferFill {
+public:
+    ObjRazRules         *rzRules;
+    S52color            color;
+    bool                b_pattern;
+    render_canvas_parms patt;           // copy, with this object's reference point
+    double              x_origin_shift; // for objects drawn again across the dateline
+};
+
+//-----------------------------------------------------------------------------
+//      Render command of one object, for one plib state, see ResolveRenderCommand().
+//      The rules are the object's own with the conditional symbology expanded,
+//      and the display filter is reduced to what depends on the view.
+//-----------------------------------------------------------------------------
+enum {
+    S52_CMD_UNRESOLVED = 0,
+    S52_CMD_HIDDEN,                     // filtered out by display category or noshow
+    S52_CMD_SHOWN,                      // shown at any scale
+    S52_CMD_SCAMIN,                     // shown subject to SCAMIN
+    S52_CMD_DYNAMIC                     // rules rebuilt on each render (soundings), drawn the long way
+};
+
+enum {
+    S52_PASS_AREA = 0,                  // AC and AP, GL only
+    S52_PASS_OBJECT,                    // lines, symbols and text
+    S52_PASS_TEXT                       // TX and TE only
+};
+
+class S52RenderCommand {
+public:
+    ObjRazRules         *rzRules;
+    int                 filter;         // S52_CMD_SHOWN, _SCAMIN or _DYNAMIC
+    Rules               **rules;
+    int                 nrules;
+};
+
+//-----------------------------------------------------------------------------
+//      Render time accumulated by stage, for benchmarking.
+//-----------------------------------------------------------------------------
+enum {
+    S52_STAGE_RULES = 0,                // conditional symbology procedures
+    S52_STAGE_AREAS,
+    S52_STAGE_LINES,
+    S52_STAGE_SYMBOLS,
+    S52_STAGE_TEXT,
+    S52_STAGE_NUM
+};
+
+class S52RenderStats {
+public:
+    S52RenderStats(){ Clear(); }
+    void Clear( void );
+
+    double usec[S52_STAGE_NUM];
+    long   calls[S52_STAGE_NUM];
+    int    depth;                       // nested stages count toward the outermost
+};
+
+//-----------------------------------------------------------------------------
+//      GL render batches.  While a batch is open (s52plib::BeginGLBatch),
+//      simple lines, plain area fills and atlas symbols are accumulated here
+//      by render state, and submitted together by s52plib::FlushGLBatch().
+//-----------------------------------------------------------------------------
+class S52GLLineBatch {
+public:
+    unsigned int vbo;                   // chart line VBO, or 0 for client memory
+    float *vertex_buffer;
+    unsigned char R, G, B;
+    float line_width;
+    bool b_smooth;
+    unsigned short stipple;             // glLineStipple pattern, 0 for solid
+    double x_origin, y_origin, x_rate, y_rate;
+    double easting_vp_center, northing_vp_center;
+    std::vector<unsigned int> indices;  // GL_LINES vertex pairs, or GL_LINE_STRIPs if stippled
+    std::vector<unsigned int> strips;   // first index of each strip, if stippled
+};
+
+//      The visible triangles of one area object, as indices into its own VBO
+class S52GLAreaVBORange {
+public:
+    unsigned int vbo;
+    float x_origin, y_origin, x_rate, y_rate;
+    size_t first, count;                // in S52GLAreaBatch::vbo_indices
+};
+
+class S52GLAreaBatch {
+public:
+    unsigned char R, G, B;
+    double easting_vp_center, northing_vp_center;
+    std::vector<float> vertices;        // GL_TRIANGLES, SM meters
+    std::vector<S52GLAreaVBORange> vbo_ranges;
+    std::vector<unsigned int> vbo_indices;      // GL_TRIANGLES
+};
+
+class S52GLSymbolBatch {
+public:
+    unsigned int texture;
+    std::vector<float> vertices;        // GL_TRIANGLES, x, y, s, t in screen pixels
+};
+
 //-----------------------------------------------------------------------------
 //    s52plib definition
 //-----------------------------------------------------------------------------
@@ -117,17 +250,25 @@ public:
         S57Obj *pObj, bool bStrict = 0 );
     int _LUP2rules( LUPrec *LUP, S57Obj *pObj );
     S52color* getColor( const char *colorName );
+    S52color* getRuleColor( Rules *rules, const char *colorName );
     wxColour getwxColour( const wxString &colorName );
 
     void UpdateMarinerParams( void );
     void ClearCNSYLUPArray( void );
 
     void GenerateStateHash();
+    void UpdateStateHash();
     long GetStateHash() { return m_state_hash;  }
+    long GetPrepareHash() { return m_prepare_hash;  }
+
+//    Conditional symbology, evaluated ahead of rendering
+    long GetCSParamKey( void );
+    void PrepareCSRules( std::vector<ObjRazRules *> &list, int nThreads );
 
     void SetPLIBColorScheme( wxString scheme );
     void SetPLIBColorScheme( ColorScheme cs );
     wxString GetPLIBColorScheme( void ) { return m_ColorScheme; }
+    int GetColorTableIndex( void ) { return m_colortable_index; }
 
     void SetGLRendererString(const wxString &renderer);
     void SetGLOptions(bool b_useStencil,
@@ -142,8 +283,12 @@ public:
     bool ObjectRenderCheckPos( ObjRazRules *rzRules, ViewPort *vp );
     bool ObjectRenderCheckCat( ObjRazRules *rzRules, ViewPort *vp );
     bool ObjectRenderCheckCS( ObjRazRules *rzRules, ViewPort *vp );
+    int ObjectCategoryFilter( ObjRazRules *rzRules );
+    bool ObjectRenderCheckScamin( ObjRazRules *rzRules, ViewPort *vp );
+    int ResolveRenderCommand( ObjRazRules *rzRules, std::vector<Rules *> &rules );
 
     static void DestroyLUP( LUPrec *pLUP );
+    static void CompileLUPAttributes( LUPrec *LUP );
     static void ClearRulesCache( Rule *pR );
     DisCat findLUPDisCat(const char *objectName, LUPname TNAM);
     
@@ -152,10 +297,13 @@ public:
     void SaveColorScheme( void ) { m_colortable_index_save = m_colortable_index;}
     void RestoreColorScheme( void ) {}
 
+//    Per stage render timing, off unless enabled
+    void EnableRenderStats( bool enable ){ m_pRenderStats = enable ? &m_render_stats : NULL; }
+    S52RenderStats &GetRenderStats( void ){ return m_render_stats; }
+
 //    Rendering stuff
     void PrepareForRender( ViewPort *vp );
     void PrepareForRender( void );
-    void AdjustTextList( int dx, int dy, int screenw, int screenh );
     void ClearTextList( void );
     int SetLineFeaturePriority( ObjRazRules *rzRules, int npriority );
     void FlushSymbolCaches();
@@ -163,14 +311,19 @@ public:
     //    For DC's
     int RenderObjectToDC( wxDC *pdc, ObjRazRules *rzRules, ViewPort *vp );
     int RenderObjectToDCText( wxDC *pdc, ObjRazRules *rzRules, ViewPort *vp );
+    int RenderCommandToDC( wxDC *pdc, const S52RenderCommand &cmd, ViewPort *vp, int pass );
     int RenderAreaToDC( wxDC *pdc, ObjRazRules *rzRules, ViewPort *vp, render_canvas_parms *pb_spec );
+    int CollectAreaFills( wxDC *pdc, ObjRazRules *rzRules, ViewPort *vp,
+                          std::vector<S52BufferFill> &fills );
+    void RenderAreaFillsToBuffer( std::vector<S52BufferFill> &fills, ViewPort *vp,
+                                  render_canvas_parms *pb_spec, int nThreads );
 
     // Accessors
     bool GetShowSoundings() { return m_bShowSoundg; }
-    void SetShowSoundings( bool f ) { m_bShowSoundg = f; GenerateStateHash(); }
+    void SetShowSoundings( bool f ) { m_bShowSoundg = f; UpdateStateHash(); }
 
     bool GetShowS57Text() { return m_bShowS57Text;  }
-    void SetShowS57Text( bool f ) { m_bShowS57Text = f;  GenerateStateHash(); }
+    void SetShowS57Text( bool f ) { m_bShowS57Text = f;  UpdateStateHash(); }
 
     bool GetShowS57ImportantTextOnly() { return m_bShowS57ImportantTextOnly; }
     void SetShowS57ImportantTextOnly( bool f ) { m_bShowS57ImportantTextOnly = f; GenerateStateHash(); }
@@ -212,8 +365,13 @@ public:
     int RenderObjectToGL( const wxGLContext &glcc, ObjRazRules *rzRules, ViewPort *vp );
     int RenderAreaToGL( const wxGLContext &glcc, ObjRazRules *rzRules, ViewPort *vp );
     int RenderObjectToGLText( const wxGLContext &glcc, ObjRazRules *rzRules, ViewPort *vp );
+    int RenderCommandToGL( const wxGLContext &glcc, const S52RenderCommand &cmd, ViewPort *vp, int pass );
     
     void RenderPolytessGL( ObjRazRules *rzRules, ViewPort *vp,double z_clip_geom, wxPoint *ptp );
+
+    void BeginGLBatch( void );
+    void FlushGLBatch( ViewPort *vp );
+    void EndGLBatch( ViewPort *vp );
     
     bool EnableGLLS(bool benable);
 
@@ -222,7 +380,7 @@ public:
     void RemoveObjNoshow( const char *objcl);
     void ClearNoshow(void);
     void SaveObjNoshow() { m_saved_noshow = m_noshow_array; };
-    void RestoreObjNoshow() { m_noshow_array = m_saved_noshow; };
+    void RestoreObjNoshow() { m_noshow_array = m_saved_noshow; UpdateStateHash(); };
     
     //Todo accessors
     LUPname m_nSymbolStyle;
@@ -283,14 +441,20 @@ private:
 
     int DoRenderObject( wxDC *pdcin, ObjRazRules *rzRules, ViewPort *vp );
     int DoRenderObjectTextOnly( wxDC *pdcin, ObjRazRules *rzRules, ViewPort *vp );
+    int DoRenderCommand( wxDC *pdcin, const S52RenderCommand &cmd, ViewPort *vp, int pass );
     
     //    Area Renderers
     int RenderToBufferAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp,
-        render_canvas_parms *pb_spec );
+        std::vector<S52BufferFill> &fills );
     int RenderToBufferAP( ObjRazRules *rzRules, Rules *rules, ViewPort *vp,
-	render_canvas_parms *pb_spec );
+        std::vector<S52BufferFill> &fills );
     int RenderToGLAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp );
     int RenderToGLAP( ObjRazRules *rzRules, Rules *rules, ViewPort *vp );
+    S52GLAreaBatch *GetGLAreaBatch( S52color *c, sm_parms *sm );
+    bool AddGLAreaBatch( ObjRazRules *rzRules, S52color *c, const LLBBox &BBView );
+    bool AddGLAreaVBOBatch( ObjRazRules *rzRules, S52color *c, const LLBBox &BBView );
+    void AddGLSymbolBatch( unsigned int texture, const wxRect &texrect, const wxPoint &r,
+                           int pivot_x, int pivot_y, double scale_factor, ViewPort *vp );
 
     //    Object Renderers
     int RenderTX( ObjRazRules *rzRules, Rules *rules, ViewPort *vp );
@@ -320,9 +484,8 @@ private:
     render_canvas_parms* CreatePatternBufferSpec( ObjRazRules *rzRules,
         Rules *rules, ViewPort *vp, bool b_revrgb, bool b_pot = false );
 
-    void RenderToBufferFilledPolygon( ObjRazRules *rzRules, S57Obj *obj,
-        S52color *c, render_canvas_parms *pb_spec,
-        render_canvas_parms *patt_spec, ViewPort *vp );
+    void RenderToBufferFilledPolygon( const S52BufferFill &fill, const LLBBox &BBView,
+        render_canvas_parms *pb_spec, ViewPort *vp );
 
     void draw_lc_poly( wxDC *pdc, wxColor &color, int width, wxPoint *ptp,
         int npt, float sym_len, float sym_factor, Rule *draw_rule,
@@ -360,6 +523,7 @@ private:
     
     Rules *StringToRules( const wxString& str_in );
     void GetAndAddCSRules( ObjRazRules *rzRules, Rules *rules );
+    void AddCSRules( ObjRazRules *rzRules, const wxString &cs_string );
 
     void DestroyPattRules( RuleHash *rh );
     void DestroyRules( RuleHash *rh );
@@ -369,7 +533,8 @@ private:
     bool inter_tri_rect( wxPoint *ptp, render_canvas_parms *pb_spec );
 
     bool GetPointPixArray( ObjRazRules *rzRules, wxPoint2DDouble* pd, wxPoint *pp, int nv, ViewPort *vp );
-    bool GetPointPixSingle( ObjRazRules *rzRules, float north, float east, wxPoint *r, ViewPort *vp );
+    bool GetPointPixSingle( ObjRazRules *rzRules, float north, float east, wxPoint *r, ViewPort *vp,
+                            double x_origin_shift = 0. );
     void GetPixPointSingle( int pixx, int pixy, double *plat, double *plon, ViewPort *vp );
     void GetPixPointSingleNoRotate( int pixx, int pixy, double *plat, double *plon, ViewPort *vpt );
     
@@ -390,13 +555,10 @@ private:
     wxGLContext *m_glcc;
 //#endif
 
-    int *ledge;
-    int *redge;
-
     int m_colortable_index;
     int m_colortable_index_save;
 
-    TextObjList m_textObjList;
+    S52TextRectGrid m_textGrid;
 
     wxString m_ColorScheme;
 
@@ -404,13 +566,17 @@ private:
     bool m_anchorOn;
     bool m_qualityOfDataOn;
 
-    long m_state_hash;
+    long m_state_hash;                          // all settings, as last configured by a canvas
+    long m_prepare_hash;                        // the settings charts prepare their rules for
+    int m_state_epoch;                          // bumped by GenerateStateHash()
 
     bool m_txf_ready;
     int m_txf_avg_char_width;
     int m_txf_avg_char_height;
     CARC_Hash m_CARC_hashmap;
     CARC_DL_Hash m_CARC_DL_hashmap;
+    CSLUPHash m_CSLUP_hash;
+    long m_CSLUP_generation;                    // bumped whenever the CS LUPs are destroyed
     RenderFromHPGL* HPGL;
 
     TexFont *m_txf;
@@ -433,6 +599,14 @@ private:
     int  m_TextureFormat;
     bool m_GLLineSmoothing;
     bool m_GLPolygonSmoothing;
+
+    S52RenderStats *m_pRenderStats;
+    S52RenderStats m_render_stats;
+
+    bool m_bGLBatch;
+    std::vector<S52GLLineBatch> m_line_batches;
+    std::vector<S52GLAreaBatch> m_area_batches;
+    std::vector<S52GLSymbolBatch> m_symbol_batches;
 };
 
 
@@ -179,11 +179,29 @@ typedef struct _Rules{
    int     n_sequence;        // sequence number in list, used to identify a particular rule
    bool    b_private_razRule; // marker indicating that razRule should be free'd on Rules destroy
    struct _Rules *next;
+   S52color *color;           // resolved colour of a colour-bearing rule, cached for
+   int     color_table;       // this colour table index
 }Rules;
 
 
 // LOOKUP MODULE CLASS
 
+//  LUP attribute conditions, compiled from ATTArray by s52plib::CompileLUPAttributes()
+enum {
+   LUP_ATT_IGNORE = 0,              // malformed, never counts as a match
+   LUP_ATT_ANY,                     // ' ', any value of a present attribute matches
+   LUP_ATT_UNDEF,                   // '?', counts only if the attribute is absent (not scored)
+   LUP_ATT_VALUE                    // compare against the typed value below
+};
+
+typedef struct _LUPAttCond{
+   unsigned long long key;          // attribute acronym, packed by S52_AttrKey()
+   int            kind;
+   int            ival;             // value as OGR_INT
+   float          fval;             // value as OGR_REAL
+   char           *sval;            // value as OGR_STR, points into ATTArray
+}LUPAttCond;
+
 class LUPrec{
 public:
    int            RCID;             // record identifier
@@ -200,6 +218,8 @@ public:
    int            nSequence;        // A sequence number, indicating order of encounter in
                                     //  the PLIB file
    Rules          *ruleList;        // rasterization rule list
+   LUPAttCond     *ATTCond;         // compiled ATTArray, nATTCond entries
+   int            nATTCond;
 };
 
 // Conditional Symbology
@@ -294,6 +314,9 @@ class PolyTessGeo;
 class line_segment_element;
 class PI_line_segment_element;
 
+#define LINE_LOD_LEVELS     3               // precomputed simplifications of each edge
+#define LINE_LOD_PIXELS     0.5             // largest deviation of a simplified line, in pixels
+
 typedef struct _chart_context{
     void                    *m_pvc_hash;
     void                    *m_pve_hash;
@@ -304,6 +327,7 @@ typedef struct _chart_context{
     s57chart                *chart;
     double                  safety_contour; 
     float                   *vertex_buffer;
+    float                   line_lod_tolerance[LINE_LOD_LEVELS];   // in vertex_buffer units, 0 if not built
     
 }chart_context;
 
@@ -490,13 +514,19 @@ public:
 class VE_Element
 {
 public:
+      VE_Element() { for( int i = 0; i < LINE_LOD_LEVELS; i++ ){ lod_index[i] = NULL; lod_count[i] = 0; } }
+
       unsigned int index;
       unsigned int nCount;
       float      *pPoints;
       int         max_priority;
       size_t      vbo_offset;
       LLBBox      edgeBBox;
-      
+
+      //  Vertices kept at each level of detail, relative to vbo_offset, NULL if none is coarser
+      //  The storage belongs to the chart, see s57chart::BuildLineLOD()
+      const unsigned int *lod_index[LINE_LOD_LEVELS];
+      unsigned int lod_count[LINE_LOD_LEVELS];
 };
 
 class VC_Element
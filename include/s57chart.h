@@ -45,6 +45,7 @@
 #include "S57Light.h"
 #include "S57Sector.h"
 #include "s52s57.h"                 //types
+#include "s52plib.h"
 #include "OCPNRegion.h"
 #include "ocpndc.h"
 #include "viewport.h"
@@ -104,6 +105,72 @@ WX_DECLARE_LIST(S57Obj, ListOfS57Obj);
 
 WX_DECLARE_LIST(ObjRazRules, ListOfObjRazRules);
 
+//----------------------------------------------------------------------------
+// Uniform lat/lon grid over one razRules list, used to cull render walks
+// to the objects whose BBObj may touch the viewport.  Query results keep
+// the original list order, so display priority within a list is preserved.
+//----------------------------------------------------------------------------
+class RazRulesIndex
+{
+public:
+      RazRulesIndex();
+
+      void Clear();
+      void ClearCommands() { m_command_sets.clear(); }
+      bool IsCurrent( ObjRazRules *top ) const { return m_bbuilt && ( top == m_top ); }
+      void Build( ObjRazRules *top );
+      void Query( const LLBBox &box, std::vector<ObjRazRules *> &result );
+      void QueryCommands( const LLBBox &box, long state_hash, int scheme,
+                          std::vector<S52RenderCommand> &result );
+
+private:
+      //  Render commands of the objects by ordinal, resolved as they are first
+      //  queried, for one s52plib state and colour scheme
+      class CommandSet
+      {
+      public:
+            long                        state_hash;
+            int                         scheme;
+            unsigned int                last_used;
+            std::vector<unsigned char>  filter;         // S52_CMD_*
+            std::vector<int>            first;          // into rules
+            std::vector<int>            count;
+            std::vector<Rules *>        rules;
+      };
+
+      bool QueryOrdinals( const LLBBox &box );
+      CommandSet &GetCommandSet( long state_hash, int scheme );
+      bool CollectRange( double minlat, double minlon, double maxlat, double maxlon );
+      void CellRange( double lat, double lon, int &ix, int &iy ) const;
+
+      ObjRazRules *m_top;
+      bool        m_bbuilt;
+      std::vector<ObjRazRules *> m_objs;        // in list order
+      std::vector<int> m_always;                // ordinals never culled
+      std::vector<int> m_cell_start;            // nx*ny+1 offsets into m_cell_items
+      std::vector<int> m_cell_items;
+      std::vector<unsigned int> m_mark;
+      std::vector<int> m_hits;
+      unsigned int m_generation;
+      int         m_nx, m_ny;
+      double      m_minlat, m_minlon, m_dlat, m_dlon;
+      std::vector<CommandSet> m_command_sets;
+      unsigned int m_command_clock;
+};
+
+//----------------------------------------------------------------------------
+// Conditional symbology results for one set of mariner parameters,
+// as prepared by s57chart::PrepareCSRules()
+//----------------------------------------------------------------------------
+class S57CSResultSet
+{
+public:
+      long                    key;              // s52plib::GetCSParamKey()
+      std::vector<S57Obj *>   objs;
+      std::vector<Rules *>    CSrules;
+      std::vector<DisCat>     DisplayCat;
+};
+
 //----------------------------------------------------------------------------
 // s57 Chart object class
 //----------------------------------------------------------------------------
@@ -245,10 +312,22 @@ protected:
       void AssembleLineGeometry( void );
 
       ObjRazRules *razRules[PRIO_NUM][LUPNAME_NUM];
+      const std::vector<ObjRazRules *> &GetVisibleRazRules( int prio, int lup_type, ViewPort &vp );
+      const std::vector<S52RenderCommand> &GetVisibleRenderCommands( int prio, int lup_type, ViewPort &vp );
     
 private:
+      RazRulesIndex m_raz_index[PRIO_NUM][LUPNAME_NUM];
+      std::vector<ObjRazRules *> m_raz_visible;
+      std::vector<S52RenderCommand> m_raz_commands;
+
+      wxString GetLineGeometryCacheName( void );
+      bool LoadLineGeometryCache( void );
+      void SaveLineGeometryCache( void );
+      void BuildLineLOD( void );
+
       int GetLineFeaturePointArray(S57Obj *obj, void **ret_array);
       void SetSafetyContour(void);
+      void PrepareCSRules(void);
     
       bool DoRenderViewOnDC(wxMemoryDC& dc, const ViewPort& VPoint, RenderTypeEnum option, bool force_new_view);
 
@@ -332,11 +411,13 @@ private:
       bool        m_blastS57TextRender;
       wxString    m_lastColorScheme;
       wxRect      m_last_vprect;
-      long        m_plib_state_hash;
+      long        m_plib_state_hash;            // s52plib settings of the cached DC render
+      long        m_plib_prepare_hash;          // s52plib settings the rules are prepared for
       bool        m_btex_mem;
       char        m_usage_char;
       
       double      m_next_safe_cnt;
+      std::vector<S57CSResultSet> m_CS_results;   // most recently used first
 
       int         m_LineVBO_name;
       
@@ -344,6 +425,8 @@ private:
       VC_Hash     m_vc_hash;
       std::vector<connector_segment *> m_pcs_vector;
       std::vector<VE_Element *> m_pve_vector;
+      std::vector<unsigned int> m_line_lod_indices;      // edge vertex runs, see BuildLineLOD()
+      double      m_line_lod_tolerance[LINE_LOD_LEVELS];
       
       wxString    m_TempFilePath;
       bool        m_disableBackgroundSENC;
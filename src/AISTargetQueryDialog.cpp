@@ -142,8 +142,7 @@ void AISTargetQueryDialog::OnIdTrkCreateClick( wxCommandEvent& event )
             }
             else
             {
-                TrackPoint *tp = NULL;
-                TrackPoint *tp1 = NULL;
+                TrackPoint tp;
 
                 Track *t = new Track();
 
@@ -153,11 +152,12 @@ void AISTargetQueryDialog::OnIdTrkCreateClick( wxCommandEvent& event )
                 {
                     AISTargetTrackPoint *ptrack_point = node->GetData();
                     vector2D point( ptrack_point->m_lon, ptrack_point->m_lat );
-                    tp1 = t->AddNewPoint( point, wxDateTime(ptrack_point->m_time).ToUTC() );
-                    if( tp )
+                    TrackPoint tp1 = t->AddNewPoint( point, wxDateTime(ptrack_point->m_time).ToUTC() );
+                    int n = t->GetnPoints();
+                    if( n > 1 )
                     {
-                        pSelect->AddSelectableTrackSegment( tp->m_lat, tp->m_lon, tp1->m_lat,
-                            tp1->m_lon, tp, tp1, t );
+                        pSelect->AddSelectableTrackSegment( tp.m_lat, tp.m_lon, tp1.m_lat,
+                            tp1.m_lon, n - 2, n - 1, t );
                     }
                     tp = tp1;
                     node = node->GetNext();
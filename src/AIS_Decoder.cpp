@@ -2048,13 +2048,14 @@ void AIS_Decoder::UpdateOneTrack( AIS_Target_Data *ptarget )
         {
             t = m_persistent_tracks[ptarget->MMSI];
         }
-        TrackPoint *tp = t->GetLastPoint();
+        int n = t->GetnPoints();
+        TrackPoint tp = t->GetLastPoint();
         vector2D point( ptrackpoint->m_lon, ptrackpoint->m_lat );
-        TrackPoint *tp1 = t->AddNewPoint( point, wxDateTime(ptrackpoint->m_time).ToUTC() );        
-        if( tp )
+        TrackPoint tp1 = t->AddNewPoint( point, wxDateTime(ptrackpoint->m_time).ToUTC() );        
+        if( n )
         {
-            pSelect->AddSelectableTrackSegment( tp->m_lat, tp->m_lon, tp1->m_lat,
-                tp1->m_lon, tp, tp1, t );
+            pSelect->AddSelectableTrackSegment( tp.m_lat, tp.m_lon, tp1.m_lat,
+                tp1.m_lon, n - 1, n, t );
         }
         
 //We do not want dependency on the GUI here, do we?
@@ -0,0 +1,403 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Predictive chart cache preloading
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+  #include "wx/wx.h"
+#endif //precompiled headers
+
+#include <algorithm>
+#include <cmath>
+
+#include "dychart.h"
+#include "ChartPreloader.h"
+#include "chartdb.h"
+#include "chartimg.h"
+#include "chart1.h"
+#include "chcanv.h"
+#include "georef.h"
+#include "routeman.h"
+#include "Route.h"
+#include "RoutePoint.h"
+
+#ifdef ocpnUSE_GL
+#include "glChartCanvas.h"
+#include "glTexCache.h"
+#include "glTextureManager.h"
+#endif
+
+WX_DEFINE_ARRAY_PTR(ChartCanvas*, arrayofCanvasPtr);
+
+extern ChartDB           *ChartData;
+extern Routeman          *g_pRouteMan;
+extern arrayofCanvasPtr  g_canvasArray;
+extern double            gLat, gLon, gCog, gSog;
+extern bool              bGPSValid;
+extern int               g_nChartPreloadMinutes;
+extern int               g_nCacheLimit;
+extern int               g_memCacheLimit;
+extern bool              g_bopengl;
+extern ColorScheme       global_color_scheme;
+
+extern bool GetMemoryStatus( int *mem_total, int *mem_used );
+
+#ifdef ocpnUSE_GL
+extern glTextureManager  *g_glTextureManager;
+extern ocpnGLOptions     g_GLOptions;
+extern GLuint            g_raster_format;
+extern bool              b_inCompressAllCharts;
+#endif
+
+#define PRELOAD_PLAN_TICKS              10      // re-plan the track ahead every n frame timer ticks
+#define PRELOAD_MIN_SOG                 0.5     // knots, below this there is nothing ahead
+#define PRELOAD_MAX_SAMPLES             64      // track boxes per canvas
+#define PRELOAD_MEM_PERCENT             70      // of g_memCacheLimit, ChartDB evicts at 80
+#define PRELOAD_SCALE_MIN_FACTOR        0.25    // chart native scale range, relative to the canvas
+#define PRELOAD_SCALE_MAX_FACTOR        16.
+#define PRELOAD_TEXTURE_JOBS            4       // compression jobs scheduled per tick
+#define PRELOAD_QUIET_MS                2000    // no preloading this soon after user input
+
+//----------------------------------------------------------------------------------
+//      ChartPreloader Implementation
+//----------------------------------------------------------------------------------
+
+ChartPreloader::ChartPreloader()
+{
+    m_next = 0;
+    m_texture_dbIndex = -1;
+    m_ticks = 0;
+    m_bWantIdle = false;
+    m_route = NULL;
+    m_route_point = NULL;
+}
+
+void ChartPreloader::Invalidate( void )
+{
+    m_candidates.clear();
+    m_boxes.clear();
+    m_next = 0;
+    m_texture_dbIndex = -1;
+    m_ticks = 0;
+    m_bWantIdle = false;
+}
+
+void ChartPreloader::Tick( void )
+{
+    if( g_nChartPreloadMinutes <= 0 || !ChartData || !ChartData->IsValid() )
+        return;
+    if( ChartData->IsBusy() || ChartData->IsCacheLocked() )
+        return;
+
+    //  Re-plan now and then, and at once when the route leg changes
+    Route *route = g_pRouteMan ? g_pRouteMan->GetpActiveRoute() : NULL;
+    RoutePoint *route_point = g_pRouteMan ? g_pRouteMan->GetpActivePoint() : NULL;
+    if( ( m_ticks++ % PRELOAD_PLAN_TICKS ) == 0 || route != m_route || route_point != m_route_point ) {
+        m_route = route;
+        m_route_point = route_point;
+        Plan();
+    }
+
+    //  The opening itself waits for the next idle event, after any paint this
+    //  tick asked for
+    m_bWantIdle = m_texture_dbIndex >= 0 || m_next < m_candidates.size();
+}
+
+//  Opening a chart blocks the GUI thread, so it is done at most once per frame
+//  timer tick, once the event queue is drained and only while nobody is
+//  working the canvases.
+void ChartPreloader::Idle( void )
+{
+    if( !m_bWantIdle )
+        return;
+    if( !ChartData || !ChartData->IsValid() || ChartData->IsBusy() || ChartData->IsCacheLocked() )
+        return;
+    if( IsUserInteracting() )
+        return;                                     // try again next idle event
+
+    m_bWantIdle = false;
+
+#ifdef ocpnUSE_GL
+    //  Finish scheduling the textures of the last raster chart first
+    if( m_texture_dbIndex >= 0 ) {
+        ChartBase *chart = NULL;
+        if( ChartData->IsChartInCache( m_texture_dbIndex ) )
+            chart = ChartData->OpenChartFromDB( m_texture_dbIndex, FULL_INIT );
+        if( chart && ScheduleTextures( chart ) )
+            return;
+        m_texture_dbIndex = -1;
+    }
+#endif
+
+    while( m_next < m_candidates.size() ) {
+        int dbIndex = m_candidates[m_next].dbIndex;
+        if( ChartData->IsChartInCache( dbIndex ) ) {
+            m_next++;
+            continue;
+        }
+
+        if( !HaveCacheRoom() )
+            return;
+
+        m_next++;
+        if( Preload( dbIndex ) )
+            return;                                 // one chart per tick
+    }
+}
+
+bool ChartPreloader::IsUserInteracting( void )
+{
+    for( unsigned int i = 0; i < g_canvasArray.GetCount(); i++ ) {
+        ChartCanvas *cc = g_canvasArray.Item( i );
+        if( cc && cc->IsUserInteracting( PRELOAD_QUIET_MS ) )
+            return true;
+    }
+    return false;
+}
+
+//  The track own-ship will sail in the next g_nChartPreloadMinutes, as a polyline
+bool ChartPreloader::BuildTrack( std::vector<TrackPoint> &track )
+{
+    track.clear();
+    if( !bGPSValid || std::isnan( gSog ) || std::isnan( gCog ) || gSog < PRELOAD_MIN_SOG )
+        return false;
+
+    double remaining = gSog * g_nChartPreloadMinutes / 60.;      // NMi
+    TrackPoint p = { gLat, gLon };
+    track.push_back( p );
+
+    if( m_route && m_route_point ) {
+        int n = m_route->GetnPoints();
+        for( int i = m_route->GetIndexOf( m_route_point ); i > 0 && i <= n && remaining > 0.; i++ ) {
+            RoutePoint *rp = m_route->GetPoint( i );
+            double brg, dist;
+            DistanceBearingMercator( rp->m_lat, rp->m_lon, p.lat, p.lon, &brg, &dist );
+            if( dist > remaining ) {
+                ll_gc_ll( p.lat, p.lon, brg, remaining, &p.lat, &p.lon );
+                remaining = 0.;
+            } else {
+                p.lat = rp->m_lat;
+                p.lon = rp->m_lon;
+                remaining -= dist;
+            }
+            track.push_back( p );
+        }
+        //  The vessel stops at the end of the route
+        return true;
+    }
+
+    ll_gc_ll( p.lat, p.lon, gCog, remaining, &p.lat, &p.lon );
+    track.push_back( p );
+    return true;
+}
+
+void ChartPreloader::Plan( void )
+{
+    m_candidates.clear();
+    m_boxes.clear();
+    m_next = 0;
+
+    std::vector<TrackPoint> track;
+    if( !BuildTrack( track ) )
+        return;
+
+    for( unsigned int i = 0; i < g_canvasArray.GetCount(); i++ ) {
+        ChartCanvas *cc = g_canvasArray.Item( i );
+        if( cc && cc->m_bFollow )
+            PlanCanvas( cc, track );
+    }
+
+    //  The same chart wanted by several canvases keeps its earliest slot
+    std::sort( m_candidates.begin(), m_candidates.end(), []( const Candidate &a, const Candidate &b ) {
+        if( a.dbIndex != b.dbIndex )
+            return a.dbIndex < b.dbIndex;
+        return a.sample < b.sample;
+    } );
+    m_candidates.erase( std::unique( m_candidates.begin(), m_candidates.end(),
+                                     []( const Candidate &a, const Candidate &b ) { return a.dbIndex == b.dbIndex; } ),
+                        m_candidates.end() );
+
+    //  Nearest first, then nearest the canvas scale
+    std::sort( m_candidates.begin(), m_candidates.end(), []( const Candidate &a, const Candidate &b ) {
+        if( a.sample != b.sample )
+            return a.sample < b.sample;
+        return a.scale_error < b.scale_error;
+    } );
+}
+
+void ChartPreloader::PlanCanvas( ChartCanvas *cc, const std::vector<TrackPoint> &track )
+{
+    ViewPort &vp = cc->GetVP();
+    if( !vp.IsValid() || vp.chart_scale <= 0. )
+        return;
+
+    //  Boxes the size of the canvas view, every half view height along the track
+    LLBBox view = vp.GetBBox();
+    double dlat = ( view.GetMaxLat() - view.GetMinLat() ) / 2.;
+    double dlon = ( view.GetMaxLon() - view.GetMinLon() ) / 2.;
+    double spacing = wxMax( dlat * 60., 0.1 );                      // NMi
+
+    size_t first = m_boxes.size();
+    LLBBox track_box;
+    for( size_t i = 1; i < track.size() && m_boxes.size() - first < PRELOAD_MAX_SAMPLES; i++ ) {
+        double brg, dist;
+        DistanceBearingMercator( track[i].lat, track[i].lon, track[i - 1].lat, track[i - 1].lon, &brg, &dist );
+        int n = wxMax( (int) ceil( dist / spacing ), 1 );
+        for( int k = ( i == 1 ) ? 0 : 1; k <= n && m_boxes.size() - first < PRELOAD_MAX_SAMPLES; k++ ) {
+            double lat, lon;
+            ll_gc_ll( track[i - 1].lat, track[i - 1].lon, brg, dist * k / n, &lat, &lon );
+
+            LLBBox box;
+            box.Set( wxMax( lat - dlat, -90. ), lon - dlon, wxMin( lat + dlat, 90. ), lon + dlon );
+            m_boxes.push_back( box );
+            if( track_box.GetValid() )
+                track_box.Expand( box );
+            else
+                track_box = box;
+        }
+    }
+
+    double scale_min = vp.chart_scale * PRELOAD_SCALE_MIN_FACTOR;
+    double scale_max = vp.chart_scale * PRELOAD_SCALE_MAX_FACTOR;
+
+    for( int i = 0; i < ChartData->GetChartTableEntries(); i++ ) {
+        const ChartTableEntry &cte = ChartData->GetChartTableEntry( i );
+        if( cte.GetLatMax() > 90. )                                 // disabled
+            continue;
+
+        //  cm93 manages its own cells
+        int type = cte.GetChartType();
+        if( type == CHART_TYPE_CM93 || type == CHART_TYPE_CM93COMP )
+            continue;
+
+        int scale = cte.GetScale();
+        if( scale < scale_min || scale > scale_max )
+            continue;
+
+        const LLBBox &chart_box = ChartData->GetDBBoundingBox( i );
+        if( chart_box.IntersectOut( track_box ) )
+            continue;
+
+        if( !ChartData->IsChartInGroup( i, cc->m_groupIndex ) )
+            continue;
+
+        for( size_t j = first; j < m_boxes.size(); j++ ) {
+            if( !chart_box.IntersectOut( m_boxes[j] ) ) {
+                Candidate c;
+                c.dbIndex = i;
+                c.sample = j - first;
+                c.scale_error = fabs( log( scale / vp.chart_scale ) / log( 2. ) );
+                m_candidates.push_back( c );
+                break;
+            }
+        }
+    }
+}
+
+//  Stop short of the limits at which ChartDB starts evicting charts
+bool ChartPreloader::HaveCacheRoom( void )
+{
+    if( g_memCacheLimit ) {
+        int mem_used;
+        GetMemoryStatus( 0, &mem_used );
+        return mem_used < g_memCacheLimit / 100 * PRELOAD_MEM_PERCENT;
+    }
+
+    return (int) ChartData->GetChartCache()->GetCount() < g_nCacheLimit - 1;
+}
+
+bool ChartPreloader::Preload( int dbIndex )
+{
+    wxString msg;
+    msg.Printf( _T("ChartPreloader: opening %s"), ChartData->GetDBChartFileName( dbIndex ).c_str() );
+    wxLogMessage( msg );
+
+    ChartBase *chart = ChartData->OpenChartFromDB( dbIndex, FULL_INIT );
+    if( !chart )
+        return false;
+
+#ifdef ocpnUSE_GL
+    if( ScheduleTextures( chart ) )
+        m_texture_dbIndex = dbIndex;
+#endif
+
+    return true;
+}
+
+#ifdef ocpnUSE_GL
+//  Queue compression of the raster tiles along the track that are not in the
+//  compressed cache yet, a few per tick, only while the compressor is idle so
+//  on screen tiles keep priority.  Returns true while tiles remain.
+bool ChartPreloader::ScheduleTextures( ChartBase *chart )
+{
+    if( !g_bopengl || !g_glTextureManager || b_inCompressAllCharts )
+        return false;
+    if( !g_GLOptions.m_bTextureCompression || !g_GLOptions.m_bTextureCompressionCaching )
+        return false;
+    if( g_raster_format == GL_COMPRESSED_RGB_FXT1_3DFX )            // compressed on the GPU, in this thread
+        return false;
+
+    ChartBaseBSB *pBSBChart = dynamic_cast<ChartBaseBSB*>( chart );
+    if( !pBSBChart || g_canvasArray.GetCount() == 0 )
+        return false;
+
+    if( g_glTextureManager->GetJobCount() )
+        return true;                                                // try again next tick
+
+    //  The same factory the canvas renders from
+    wxString key = chart->GetHashKey();
+    ChartPathHashTexfactType &hash = g_glTextureManager->m_chart_texfactory_hash;
+    if( hash.find( key ) == hash.end() ) {
+        hash[key] = new glTexFactory( chart, g_raster_format );
+        hash[key]->SetHashKey( key );
+    }
+    glTexFactory *pTexFact = hash[key];
+
+    ViewPort &vp = g_canvasArray.Item( 0 )->GetVP();
+    bool use_norm_vp = glChartCanvas::HasNormalizedViewPort( vp ) && pBSBChart->GetPPM() < 1;
+    pTexFact->PrepareTiles( vp, use_norm_vp, pBSBChart );
+
+    int njobs = 0;
+    int numtiles;
+    glTexTile **tiles = pTexFact->GetTiles( numtiles );
+    for( int i = 0; i < numtiles; i++ ) {
+        glTexTile *tile = tiles[i];
+        if( pTexFact->IsLevelInCache( 0, tile->rect, global_color_scheme ) )
+            continue;
+
+        for( size_t j = 0; j < m_boxes.size(); j++ ) {
+            if( !tile->box.IntersectOut( m_boxes[j] ) ) {
+                if( njobs == PRELOAD_TEXTURE_JOBS )
+                    return true;
+                g_glTextureManager->ScheduleJob( pTexFact, tile->rect, 0, true, false, true, false );
+                njobs++;
+                break;
+            }
+        }
+    }
+
+    return false;
+}
+#endif
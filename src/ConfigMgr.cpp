@@ -1477,6 +1477,7 @@ bool ConfigMgr::CheckTemplate( wxString fileName)
 #ifdef ocpnUSE_GL
     CHECK_INT( _T ( "OpenGLExpert" ), &g_bGLexpert );
     CHECK_INT( _T ( "UseAcceleratedPanning" ), &g_GLOptions.m_bUseAcceleratedPanning );
+    CHECK_INT( _T ( "UseChartTileCache" ), &g_GLOptions.m_bUseChartTileCache );
     CHECK_INT( _T ( "GPUTextureCompression" ), &g_GLOptions.m_bTextureCompression);
     CHECK_INT( _T ( "GPUTextureCompressionCaching" ), &g_GLOptions.m_bTextureCompressionCaching);
     CHECK_INT( _T ( "PolygonSmoothing" ), &g_GLOptions.m_GLPolygonSmoothing);
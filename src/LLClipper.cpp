@@ -0,0 +1,444 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Polygon clipping for latitude and longitude regions
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "LLClipper.h"
+
+//  Distance in degrees within which a point is taken to be on an edge.
+//  Far below the 6e-6 LLRegion::Optimize rounds the results to.
+#define LLCLIP_TOLERANCE        1e-10
+
+static inline bool Less(const contour_pt &p, const contour_pt &q)
+{
+    return p.x < q.x || (p.x == q.x && p.y < q.y);
+}
+
+static inline bool Equal(const contour_pt &p, const contour_pt &q)
+{
+    return p.x == q.x && p.y == q.y;
+}
+
+static inline bool Inside(int rule, int wind)
+{
+    if(rule == LLCLIP_ABS_GEQ_TWO)
+        return abs(wind) >= 2;
+    return wind > 0;
+}
+
+void LLClipper::AddEdge(std::vector<edge> &edges, const contour_pt &p, const contour_pt &q, int wind)
+{
+    if(Equal(p, q))
+        return;
+
+    edge e;
+    if(Less(p, q))
+        e.a = p, e.b = q, e.wind = wind;
+    else
+        e.a = q, e.b = p, e.wind = -wind;
+    edges.push_back(e);
+}
+
+void LLClipper::AddContours(const std::list<poly_contour> &contours, bool reverse)
+{
+    for(std::list<poly_contour>::const_iterator i = contours.begin(); i != contours.end(); i++) {
+        if(i->size() < 3)
+            continue;
+
+        contour_pt l = *i->rbegin();
+        for(poly_contour::const_iterator j = i->begin(); j != i->end(); j++) {
+            AddEdge(m_edges, l, *j, reverse ? -1 : 1);
+            l = *j;
+        }
+    }
+}
+
+void LLClipper::Execute(int rule, std::list<poly_contour> &result)
+{
+    FindSplits();
+    SplitEdges();
+    Classify(rule);
+    Link(result);
+
+    m_edges.clear();
+    m_splits.clear();
+    m_links.clear();
+}
+
+// position of p along e, 0 at a and 1 at b
+static inline double Param(const contour_pt &a, const contour_pt &b, const contour_pt &p)
+{
+    double dx = b.x - a.x, dy = b.y - a.y;
+    return ((p.x - a.x)*dx + (p.y - a.y)*dy) / (dx*dx + dy*dy);
+}
+
+// signed distance of p from the line through a and b, positive on the left
+static inline double Side(const contour_pt &a, const contour_pt &b, const contour_pt &p)
+{
+    double dx = b.x - a.x, dy = b.y - a.y;
+    return (dx*(p.y - a.y) - dy*(p.x - a.x)) / sqrt(dx*dx + dy*dy);
+}
+
+// latitude of the line through e at longitude x
+static inline double LatAt(const contour_pt &a, const contour_pt &b, double x)
+{
+    if(x == a.x)
+        return a.y;
+    if(x == b.x)
+        return b.y;
+    return a.y + (x - a.x) * (b.y - a.y) / (b.x - a.x);
+}
+
+// note that edge i is to be split at p, if p falls inside it
+void LLClipper::SplitAt(int i, const contour_pt &p)
+{
+    const edge &e = m_edges[i];
+    if(Equal(p, e.a) || Equal(p, e.b))
+        return;
+
+    double t = Param(e.a, e.b, p);
+    if(t <= 0 || t >= 1)
+        return;
+
+    split s;
+    s.edge = i, s.t = t, s.p = p;
+    m_splits.push_back(s);
+}
+
+void LLClipper::Cross(int i, int j)
+{
+    const edge &e = m_edges[i], &f = m_edges[j];
+    double s1 = Side(e.a, e.b, f.a), s2 = Side(e.a, e.b, f.b);
+    double s3 = Side(f.a, f.b, e.a), s4 = Side(f.a, f.b, e.b);
+    bool on1 = fabs(s1) <= LLCLIP_TOLERANCE, on2 = fabs(s2) <= LLCLIP_TOLERANCE;
+    bool on3 = fabs(s3) <= LLCLIP_TOLERANCE, on4 = fabs(s4) <= LLCLIP_TOLERANCE;
+
+    // collinear or touching: the edges are split at the ends of the other,
+    // so overlaps become coincident edges
+    if(on1 || on2 || on3 || on4) {
+        if(on1) SplitAt(i, f.a);
+        if(on2) SplitAt(i, f.b);
+        if(on3) SplitAt(j, e.a);
+        if(on4) SplitAt(j, e.b);
+        return;
+    }
+
+    if((s1 > 0) == (s2 > 0) || (s3 > 0) == (s4 > 0))
+        return;
+
+    // proper crossing, both edges are split at the same point,
+    // which stays exactly on either if it is a meridian or a parallel
+    double t = s3 / (s3 - s4);
+    contour_pt p;
+    p.x = e.a.x + t*(e.b.x - e.a.x);
+    p.y = e.a.y + t*(e.b.y - e.a.y);
+    if(f.a.x == f.b.x)
+        p.x = f.a.x;
+    if(f.a.y == f.b.y)
+        p.y = f.a.y;
+    SplitAt(i, p);
+    SplitAt(j, p);
+}
+
+// sweep in longitude, testing each edge against those its longitudes overlap
+void LLClipper::FindSplits()
+{
+    std::vector<std::pair<double, int> > order;
+    order.reserve(m_edges.size());
+    for(size_t i = 0; i < m_edges.size(); i++)
+        order.push_back(std::make_pair(m_edges[i].a.x, (int)i));
+    std::sort(order.begin(), order.end());
+
+    std::vector<int> active;
+    for(size_t k = 0; k < order.size(); k++) {
+        int i = order[k].second;
+        const edge &e = m_edges[i];
+        double miny = std::min(e.a.y, e.b.y) - LLCLIP_TOLERANCE;
+        double maxy = std::max(e.a.y, e.b.y) + LLCLIP_TOLERANCE;
+
+        size_t n = 0;
+        for(size_t j = 0; j < active.size(); j++) {
+            const edge &f = m_edges[active[j]];
+            if(f.b.x < e.a.x - LLCLIP_TOLERANCE)
+                continue;                       // ended
+            active[n++] = active[j];
+
+            if(std::max(f.a.y, f.b.y) < miny || std::min(f.a.y, f.b.y) > maxy)
+                continue;
+            Cross(active[j], i);
+        }
+        active.resize(n);
+        active.push_back(i);
+    }
+}
+
+static size_t Root(std::vector<size_t> &parent, size_t i)
+{
+    while(parent[i] != i)
+        i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+// Join the points closer than the tolerance.  Edges which overlap are each
+// crossed by a third edge at points a rounding apart, as are edges crossing
+// at one point.  Joined points keep the longitude of any on a meridian edge
+// and the latitude of any on a parallel one, so those edges stay straight.
+void LLClipper::Snap()
+{
+    struct snap_pt
+    {
+        contour_pt *p;
+        bool meridian, parallel;
+    };
+
+    std::vector<snap_pt> pts;
+    pts.reserve(2*m_edges.size() + m_splits.size());
+    for(size_t i = 0; i < m_edges.size(); i++) {
+        edge &e = m_edges[i];
+        snap_pt a = {&e.a, e.a.x == e.b.x, e.a.y == e.b.y}, b = {&e.b, a.meridian, a.parallel};
+        pts.push_back(a), pts.push_back(b);
+    }
+    for(size_t i = 0; i < m_splits.size(); i++) {
+        const edge &e = m_edges[m_splits[i].edge];
+        snap_pt s = {&m_splits[i].p, e.a.x == e.b.x, e.a.y == e.b.y};
+        pts.push_back(s);
+    }
+
+    std::sort(pts.begin(), pts.end(), [](const snap_pt &p, const snap_pt &q) {
+            return Less(*p.p, *q.p);
+        });
+
+    std::vector<size_t> parent(pts.size());
+    for(size_t i = 0; i < pts.size(); i++) {
+        parent[i] = i;
+        const contour_pt &p = *pts[i].p;
+        for(size_t j = i; j-- > 0;) {
+            const contour_pt &q = *pts[j].p;
+            if(p.x - q.x > LLCLIP_TOLERANCE)
+                break;
+            if(fabs(p.y - q.y) <= LLCLIP_TOLERANCE)
+                parent[Root(parent, i)] = Root(parent, j);
+        }
+    }
+
+    // the point of each group, its first member unless another is on a meridian or parallel
+    std::vector<contour_pt> joined(pts.size());
+    std::vector<int> fixed(pts.size(), 0);
+    for(size_t i = 0; i < pts.size(); i++) {
+        size_t r = Root(parent, i);
+        const contour_pt &p = *pts[i].p;
+        if(r == i)
+            joined[r] = p;
+        if(pts[i].meridian && !(fixed[r] & 1))
+            joined[r].x = p.x, fixed[r] |= 1;
+        if(pts[i].parallel && !(fixed[r] & 2))
+            joined[r].y = p.y, fixed[r] |= 2;
+    }
+
+    for(size_t i = 0; i < pts.size(); i++)
+        *pts[i].p = joined[Root(parent, i)];
+}
+
+// replace the edges by their parts between splits, and merge coincident parts
+void LLClipper::SplitEdges()
+{
+    std::sort(m_splits.begin(), m_splits.end());
+    Snap();
+
+    std::vector<edge> parts;
+    parts.reserve(m_edges.size() + m_splits.size());
+    size_t s = 0;
+    for(size_t i = 0; i < m_edges.size(); i++) {
+        const edge &e = m_edges[i];
+        contour_pt p = e.a;
+        for(; s < m_splits.size() && m_splits[s].edge == (int)i; s++) {
+            AddEdge(parts, p, m_splits[s].p, e.wind);
+            p = m_splits[s].p;
+        }
+        AddEdge(parts, p, e.b, e.wind);
+    }
+
+    std::sort(parts.begin(), parts.end(), [](const edge &e, const edge &f) {
+            if(!Equal(e.a, f.a))
+                return Less(e.a, f.a);
+            return Less(e.b, f.b);
+        });
+
+    m_edges.clear();
+    for(size_t i = 0; i < parts.size(); i++) {
+        if(!m_edges.empty() && Equal(m_edges.back().a, parts[i].a) && Equal(m_edges.back().b, parts[i].b)) {
+            m_edges.back().wind += parts[i].wind;
+            if(!m_edges.back().wind)
+                m_edges.pop_back();             // cancelled out, as in a spike or an edge subtracted from itself
+        } else
+            m_edges.push_back(parts[i]);
+    }
+}
+
+void LLClipper::Output(const contour_pt &from, const contour_pt &to)
+{
+    link l;
+    l.from = from, l.to = to;
+    m_links.push_back(l);
+}
+
+// Sweep again in longitude.  Edges no longer cross, so between two
+// consecutive vertex longitudes the active edges are ordered in latitude,
+// and the winding under an edge is the sum of the edges below it.
+// Edges going east add their wind, so a counter clockwise contour winds +1.
+void LLClipper::Classify(int rule)
+{
+    std::vector<double> xs;
+    xs.reserve(2*m_edges.size());
+    for(size_t i = 0; i < m_edges.size(); i++)
+        xs.push_back(m_edges[i].a.x), xs.push_back(m_edges[i].b.x);
+    std::sort(xs.begin(), xs.end());
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+
+    // the edges are in order of a.x after SplitEdges
+    std::vector<int> active;
+    size_t next = 0;
+    for(size_t i = 0; i < xs.size(); i++) {
+        double x = xs[i];
+        size_t first = next;
+        while(next < m_edges.size() && m_edges[next].a.x == x)
+            next++;
+
+        // winding west of the meridian edges, from the edges of the last interval
+        std::vector<int> west;
+        for(size_t k = first; k < next; k++) {
+            const edge &e = m_edges[k];
+            if(e.b.x != x)
+                continue;
+            double y = (e.a.y + e.b.y) / 2;
+            int wind = 0;
+            for(size_t j = 0; j < active.size(); j++) {
+                const edge &f = m_edges[active[j]];
+                if(LatAt(f.a, f.b, x) < y)
+                    wind += f.wind;
+            }
+            west.push_back(wind);
+        }
+
+        size_t n = 0;
+        for(size_t j = 0; j < active.size(); j++)
+            if(m_edges[active[j]].b.x > x)
+                active[n++] = active[j];
+        active.resize(n);
+        for(size_t k = first; k < next; k++)
+            if(m_edges[k].b.x != x)
+                active.push_back(k);
+
+        // and east of them, meridian edges run north from a
+        size_t w = 0;
+        for(size_t k = first; k < next; k++) {
+            const edge &e = m_edges[k];
+            if(e.b.x != x)
+                continue;
+            double y = (e.a.y + e.b.y) / 2;
+            int wind = 0;
+            for(size_t j = 0; j < active.size(); j++) {
+                const edge &f = m_edges[active[j]];
+                if(LatAt(f.a, f.b, x) < y)
+                    wind += f.wind;
+            }
+            bool in_west = Inside(rule, west[w++]), in_east = Inside(rule, wind);
+            if(in_west && !in_east)
+                Output(e.a, e.b);
+            else if(in_east && !in_west)
+                Output(e.b, e.a);
+        }
+
+        if(i + 1 == xs.size())
+            break;
+
+        // the new edges, compared in the middle of the interval,
+        // or by slope for those from the same point
+        double xm = (x + xs[i+1]) / 2;
+        for(size_t k = first; k < next; k++) {
+            const edge &e = m_edges[k];
+            if(e.b.x == x)
+                continue;
+            double ey = LatAt(e.a, e.b, xm);
+            int wind = 0;
+            for(size_t j = 0; j < active.size(); j++) {
+                if(active[j] == (int)k)
+                    continue;
+                const edge &f = m_edges[active[j]];
+                bool below;
+                if(Equal(f.a, e.a))
+                    below = (f.b.y - f.a.y) * (e.b.x - e.a.x) < (e.b.y - e.a.y) * (f.b.x - f.a.x);
+                else
+                    below = LatAt(f.a, f.b, xm) < ey;
+                if(below)
+                    wind += f.wind;
+            }
+            bool in_south = Inside(rule, wind), in_north = Inside(rule, wind + e.wind);
+            if(in_north && !in_south)
+                Output(e.a, e.b);
+            else if(in_south && !in_north)
+                Output(e.b, e.a);
+        }
+    }
+}
+
+// join the kept edges end to start into closed contours
+void LLClipper::Link(std::list<poly_contour> &result)
+{
+    std::sort(m_links.begin(), m_links.end(), [](const link &l, const link &m) {
+            return Less(l.from, m.from);
+        });
+
+    std::vector<bool> used(m_links.size(), false);
+    for(size_t s = 0; s < m_links.size(); s++) {
+        if(used[s])
+            continue;
+        used[s] = true;
+
+        poly_contour contour;
+        contour.push_back(m_links[s].from);
+        contour_pt start = m_links[s].from, p = m_links[s].to;
+        while(!Equal(p, start)) {
+            link key;
+            key.from = p;
+            std::vector<link>::iterator it = std::lower_bound(m_links.begin(), m_links.end(), key,
+                [](const link &l, const link &m) { return Less(l.from, m.from); });
+            size_t k = it - m_links.begin();
+            while(k < m_links.size() && Equal(m_links[k].from, p) && used[k])
+                k++;
+            if(k == m_links.size() || !Equal(m_links[k].from, p))
+                break;                          // not closed, only from rounding: keep what there is
+
+            used[k] = true;
+            contour.push_back(p);
+            p = m_links[k].to;
+        }
+
+        if(contour.size() >= 3)
+            result.push_back(contour);
+    }
+}
@@ -29,7 +29,12 @@
 #include <string.h>
 #include <math.h>
 
+#include <atomic>
+
 #include "LLRegion.h"
+#include "LLClipper.h"
+
+static std::atomic<long> s_ops, s_trivial, s_rect, s_clipped;
 
 static inline double cross(const contour_pt &v1, const contour_pt &v2)
 {
@@ -241,103 +246,143 @@ bool LLRegion::Contains(float lat, float lon) const
     return cnt&1;
 }
 
-struct work
+// bounds are min lon, max lon, min lat, max lat
+static inline bool BoundsContain(const double outer[4], const double inner[4])
 {
-    work(LLRegion &r) : region(r) {
-        tobj = gluNewTess();
-    }
+    return outer[0] <= inner[0] && inner[1] <= outer[1] &&
+           outer[2] <= inner[2] && inner[3] <= outer[3];
+}
 
-    ~work() {
-        gluDeleteTess(tobj);
-        for(std::list<double*>::iterator i = data.begin(); i!=data.end(); i++)
-            delete [] *i;
-        data.clear();
+void LLRegion::Intersect(const LLRegion& region)
+{
+    s_ops++;
+    if(NoIntersection(region)) {
+        s_trivial++;
+        Clear();
+        return;
     }
 
-    double *NewData() {
-        double *d = new double[3];
-        data.push_back(d);
-        return d;
+    // either side may be a rectangle around the other, typically the viewport
+    double bounds[4], rbounds[4];
+    if(region.IsRect(rbounds)) {
+        GetBounds(bounds);
+        if(BoundsContain(rbounds, bounds)) {
+            s_rect++;
+            return;
+        }
     }
-
-    void PutVertex(const contour_pt &j) {
-        double *p = NewData();
-        p[0] = j.x, p[1] = j.y, p[2] = 0;
-        gluTessVertex(tobj, p, p);
+    if(IsRect(bounds)) {
+        region.GetBounds(rbounds);
+        if(BoundsContain(bounds, rbounds)) {
+            s_rect++;
+            contours = region.contours;
+            m_box = region.m_box;
+            return;
+        }
     }
 
-    std::list<double*> data;
-    poly_contour contour;
-    GLUtesselator *tobj;
-    LLRegion &region;
-};
-
+    Put(region, LLCLIP_ABS_GEQ_TWO, false);
+}
 
-static void /*APIENTRY*/ LLvertexCallback(GLvoid *vertex, void *user_data)
+void LLRegion::Union(const LLRegion& region)
 {
-    work *w = (work*)user_data;
-    const GLdouble *pointer = (GLdouble *)vertex;
-    contour_pt p;
-    p.x = pointer[0], p.y = pointer[1];
-    w->contour.push_back(p);
-}
+    s_ops++;
+    if(NoIntersection(region)) {
+        s_trivial++;
+        Combine(region);
+        return;
+    }
 
-static void /*APIENTRY*/ LLbeginCallback(GLenum which) {
+    double bounds[4], rbounds[4];
+    if(region.IsRect(rbounds)) {
+        GetBounds(bounds);
+        if(BoundsContain(rbounds, bounds)) {
+            s_rect++;
+            contours = region.contours;
+            m_box = region.m_box;
+            return;
+        }
+    }
+    if(IsRect(bounds)) {
+        region.GetBounds(rbounds);
+        if(BoundsContain(bounds, rbounds)) {
+            s_rect++;
+            return;
+        }
+    }
+
+    Put(region, LLCLIP_POSITIVE, false);
 }
 
-static void /*APIENTRY*/ LLendCallback(void *user_data)
+void LLRegion::Subtract(const LLRegion& region)
 {
-    work *w = (work*)user_data;
-    if(w->contour.size()) {
-        w->region.contours.push_back(w->contour);
-        w->contour.clear();
-    }    
+    s_ops++;
+    if(NoIntersection(region)) {
+        s_trivial++;
+        return;
+    }
+
+    double bounds[4], rbounds[4];
+    if(region.IsRect(rbounds)) {
+        GetBounds(bounds);
+        if(BoundsContain(rbounds, bounds)) {
+            s_rect++;
+            Clear();
+            return;
+        }
+    }
+
+    Put(region, LLCLIP_POSITIVE, true);
 }
 
-static void /*APIENTRY*/ LLcombineCallback( GLdouble coords[3], GLdouble *vertex_data[4], GLfloat weight[4],
-                      GLdouble **dataOut, void *user_data )
+LLRegionStats LLRegion::GetStats()
 {
-    work *w = (work*)user_data;
-    GLdouble *vertex = w->NewData(); 
-    memcpy(vertex, coords, 3*(sizeof *coords)); 
-    *dataOut = vertex;    
+    LLRegionStats stats;
+    stats.ops = s_ops;
+    stats.trivial = s_trivial;
+    stats.rect = s_rect;
+    stats.clipped = s_clipped;
+    return stats;
 }
 
-static void /*APIENTRY*/ LLerrorCallback(GLenum errorCode)
+void LLRegion::ResetStats()
 {
-    const GLubyte *estring;
-    estring = gluErrorString(errorCode);
-    fprintf (stderr, "Tessellation Error: %s\n", estring);
-    wxLogMessage( _T("Tessellation Error: %s"), (char *)estring );
-    //exit (0);
+    s_ops = s_trivial = s_rect = s_clipped = 0;
 }
 
-void LLRegion::Intersect(const LLRegion& region)
+// true for a single axis aligned rectangle, whose bounds are returned
+bool LLRegion::IsRect(double bounds[4]) const
 {
-    if(NoIntersection(region)) {
-        Clear();
-        return;
-    }
+    if(contours.size() != 1 || contours.front().size() != 4)
+        return false;
 
-    Put(region, GLU_TESS_WINDING_ABS_GEQ_TWO, false);
-}
+    GetBounds(bounds);
+    if(bounds[0] >= bounds[1] || bounds[2] >= bounds[3])
+        return false;
 
-void LLRegion::Union(const LLRegion& region)
-{
-    if(NoIntersection(region)) {
-        Combine(region);
-        return;
+    // every point must be a different corner of the bounds
+    const poly_contour &c = contours.front();
+    int corners = 0;
+    for(poly_contour::const_iterator j = c.begin(); j != c.end(); j++) {
+        if((j->x != bounds[0] && j->x != bounds[1]) || (j->y != bounds[2] && j->y != bounds[3]))
+            return false;
+        corners |= 1 << ((j->x == bounds[1]) * 2 + (j->y == bounds[3]));
     }
-
-    Put(region, GLU_TESS_WINDING_POSITIVE, false);
+    return corners == 0xf;
 }
 
-void LLRegion::Subtract(const LLRegion& region)
+// bounds of the contour coordinates as stored, without resolving the date line like GetBox
+void LLRegion::GetBounds(double bounds[4]) const
 {
-    if(NoIntersection(region))
-        return;
-    
-    Put(region, GLU_TESS_WINDING_POSITIVE, true);
+    bounds[0] = bounds[2] = INFINITY;
+    bounds[1] = bounds[3] = -INFINITY;
+    for(std::list<poly_contour>::const_iterator i = contours.begin(); i != contours.end(); i++)
+        for(poly_contour::const_iterator j = i->begin(); j != i->end(); j++) {
+            bounds[0] = wxMin(bounds[0], j->x);
+            bounds[1] = wxMax(bounds[1], j->x);
+            bounds[2] = wxMin(bounds[2], j->y);
+            bounds[3] = wxMax(bounds[3], j->y);
+        }
 }
 
 void LLRegion::Reduce(double factor)
@@ -463,41 +508,15 @@ bool LLRegion::NoIntersection(const LLRegion& region) const
     return box.IntersectOut(rbox) || NoIntersection(rbox) || region.NoIntersection(box);
 }
 
-void LLRegion::PutContours(work &w, const LLRegion& region, bool reverse)
+void LLRegion::Put( const LLRegion& region, int rule, bool reverse)
 {
-    for(std::list<poly_contour>::const_iterator i = region.contours.begin(); i != region.contours.end(); i++) {
-        gluTessBeginContour(w.tobj);
-        if(reverse)
-            for(poly_contour::const_reverse_iterator j = i->rbegin(); j != i->rend(); j++)
-                w.PutVertex(*j);
-        else
-            for(poly_contour::const_iterator j = i->begin(); j != i->end(); j++)
-                w.PutVertex(*j);
-        gluTessEndContour(w.tobj);
-    }
-}
-
-void LLRegion::Put( const LLRegion& region, int winding_rule, bool reverse)
-{
-    work w(*this);
-   
-    gluTessCallback( w.tobj, GLU_TESS_VERTEX_DATA, (_GLUfuncptr) &LLvertexCallback );
-    gluTessCallback( w.tobj, GLU_TESS_BEGIN, (_GLUfuncptr) &LLbeginCallback );
-    gluTessCallback( w.tobj, GLU_TESS_COMBINE_DATA, (_GLUfuncptr) &LLcombineCallback );
-    gluTessCallback( w.tobj, GLU_TESS_END_DATA, (_GLUfuncptr) &LLendCallback );
-    gluTessCallback( w.tobj, GLU_TESS_ERROR, (_GLUfuncptr) &LLerrorCallback );
-    gluTessProperty(w.tobj, GLU_TESS_WINDING_RULE, winding_rule);
-    gluTessProperty(w.tobj, GLU_TESS_BOUNDARY_ONLY, GL_TRUE);
-//    gluTessProperty(w.tobj, GLU_TESS_TOLERANCE, 1e-5);
-
-    gluTessNormal( w.tobj, 0, 0, 1);
-
-    gluTessBeginPolygon(w.tobj, &w);
+    s_clipped++;
 
-    PutContours(w, *this);
-    PutContours(w, region, reverse);
+    LLClipper clipper;
+    clipper.AddContours(contours);
+    clipper.AddContours(region.contours, reverse);
     contours.clear();
-    gluTessEndPolygon( w.tobj ); 
+    clipper.Execute(rule, contours);
 
     Optimize();
     m_box.Invalidate();
@@ -22,6 +22,17 @@
  ***************************************************************************
  */
 
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <wx/hashmap.h>
+#include <wx/thread.h>
+
 #include "NavObjectCollection.h"
 #include "routeman.h"
 #include "navutil.h"
@@ -39,6 +50,7 @@ extern Select *pSelect;
 //extern bool g_bIsNewLayer;
 //extern bool g_bLayerViz;
 
+extern int g_nCPUCount;
 extern int g_iWaypointRangeRingsNumber;
 extern float g_fWaypointRangeRingsStep;
 extern int g_iWaypointRangeRingsStepUnits;
@@ -50,6 +62,8 @@ NavObjectCollection1::NavObjectCollection1()
 
 NavObjectCollection1::~NavObjectCollection1()
 {
+    for( size_t i = 0; i < m_track_snapshots.size(); i++ )
+        delete m_track_snapshots[i].points;
 }
 
 
@@ -292,34 +306,146 @@ static RoutePoint * GPXLoadWaypoint1( pugi::xml_node &wpt_node,
     return pWP ;
 }
 
-static TrackPoint * GPXLoadTrackPoint1( pugi::xml_node &wpt_node )
+//  Local time offset of the last hour converted, see GPXParseTrackTime()
+struct GPXTimeCache
 {
-    wxString TimeString;
+    GPXTimeCache() : hour_key( -1 ), offset( 0 ) {}
 
-    double rlat = wpt_node.attribute( "lat" ).as_double();
-    double rlon = wpt_node.attribute( "lon" ).as_double();
+    long        hour_key;
+    time_t      offset;
+};
 
-    for( pugi::xml_node child = wpt_node.first_child(); child != 0; child = child.next_sibling() ) {
-        const char *pcn = child.name();
-        if( !strcmp( pcn, "time") ) 
-            TimeString = wxString::FromUTF8( child.first_child().value() );
+static inline int GPXDigits( const char *p, int n )
+{
+    int v = 0;
+    for( int i = 0; i < n; i++ ) {
+        if( p[i] < '0' || p[i] > '9' )
+            return -1;
+        v = v * 10 + p[i] - '0';
+    }
+    return v;
+}
 
-    //    OpenCPN Extensions....
-        else
-        if( !strcmp( pcn, "extensions") ) {
-            for( pugi::xml_node ext_child = child.first_child(); ext_child; ext_child = ext_child.next_sibling() ) {
-                wxString ext_name = wxString::FromUTF8( ext_child.name() );
-                if( ext_name == _T ( "opencpn:action" ) ) {
-                }
-             }// for 
-        } //extensions
-    }   // for
+//  Parse a track point time straight from the GPX text into TrackPoint::m_time.
+//  Handles the usual "YYYY-MM-DDTHH:MM:SS[.sss][Z]" form without wxString/wxDateTime;
+//  anything else goes through ParseGPXDateTime().  Like ParseGPXDateTime(), the fields
+//  are taken as local time, so each hour goes through mktime() once, then is cached.
+static wxInt64 GPXParseTrackTime( const char *ts, GPXTimeCache &cache )
+{
+    const char *p = ts;
+    while( isspace( *p ) )
+        p++;
+    if( *p == '-' )
+        p++;
+
+    //  Check the layout before reading any field.  The scan stops at the first
+    //  mismatch, at the latest the terminating NUL, so short strings are never overrun
+    static const char layout[] = "dddd-dd-ddTdd:dd:dd";
+    bool bfast = true;
+    for( int i = 0; layout[i]; i++ ) {
+        if( layout[i] == 'd' ? ( p[i] < '0' || p[i] > '9' ) : ( p[i] != layout[i] ) ) {
+            bfast = false;
+            break;
+        }
+    }
 
-    // Create waypoint
-    return new TrackPoint( rlat, rlon, TimeString );
+    int year = 0, month = 0, day = 0, hour = 0, min = 0, sec = 0;
+    if( bfast ) {
+        year = GPXDigits( p, 4 );
+        month = GPXDigits( p + 5, 2 );
+        day = GPXDigits( p + 8, 2 );
+        hour = GPXDigits( p + 11, 2 );
+        min = GPXDigits( p + 14, 2 );
+        sec = GPXDigits( p + 17, 2 );
+
+        bfast = ( year >= 1970 ) && ( year <= 2037 ) && ( month >= 1 ) && ( month <= 12 ) && ( day >= 1 )
+                && ( day <= wxDateTime::GetNumberOfDays( (wxDateTime::Month) ( month - 1 ), year ) )
+                && ( hour <= 23 ) && ( min <= 59 ) && ( sec <= 59 )
+                && ( p[19] == 0 || p[19] == 'Z' || p[19] == '.' );
+    }
+
+    if( !bfast ) {
+        TrackPoint tp( 0., 0., wxString::FromUTF8( ts ) );
+        return tp.m_time;
+    }
+
+    //  Days since the epoch, proleptic Gregorian
+    int y = year - ( month <= 2 );
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = ( 153 * ( month + ( month > 2 ? -3 : 9 ) ) + 2 ) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    long days = era * 146097L + doe - 719468L;
+
+    long hour_key = days * 24 + hour;
+    if( hour_key != cache.hour_key ) {
+        struct tm tm;
+        memset( &tm, 0, sizeof(tm) );
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        tm.tm_isdst = -1;
+        cache.offset = mktime( &tm ) - (time_t) hour_key * 3600;
+        cache.hour_key = hour_key;
+    }
+
+    wxInt64 t = (wxInt64) hour_key * 3600 + min * 60 + sec + cache.offset;
+    return t * 1000;
 }
 
-static Track *GPXLoadTrack1( pugi::xml_node &trk_node, bool b_fullviz,
+static TrackPoint GPXLoadTrackPoint1( pugi::xml_node &wpt_node, GPXTimeCache &time_cache )
+{
+    TrackPoint tp;
+
+    tp.m_lat = wpt_node.attribute( "lat" ).as_double();
+    tp.m_lon = wpt_node.attribute( "lon" ).as_double();
+
+    pugi::xml_node time_node = wpt_node.child( "time" );
+    const char *ts = time_node.first_child().value();
+    if( *ts )
+        tp.m_time = GPXParseTrackTime( ts, time_cache );
+
+    return tp;
+}
+
+static TrackPoint GPXLoadTrackPoint1( pugi::xml_node &wpt_node )
+{
+    GPXTimeCache time_cache;
+    return GPXLoadTrackPoint1( wpt_node, time_cache );
+}
+
+struct GPXStringWriter : pugi::xml_writer
+{
+    virtual void write( const void *data, size_t size )
+    {
+        text.append( (const char *) data, size );
+    }
+
+    std::string text;
+};
+
+void GPXLoadTrackSegs( const std::string &trksegs, TrackPointArray &points )
+{
+    pugi::xml_document doc;
+    if( !doc.load_buffer( trksegs.data(), trksegs.size(), pugi::parse_default | pugi::parse_fragment ) )
+        return;
+
+    GPXTimeCache time_cache;
+    unsigned short int GPXSeg = 0;
+    for( pugi::xml_node tschild = doc.child( "trkseg" ); tschild; tschild = tschild.next_sibling( "trkseg" ) ) {
+        GPXSeg += 1;
+        for( pugi::xml_node tpchild = tschild.child( "trkpt" ); tpchild; tpchild = tpchild.next_sibling( "trkpt" ) ) {
+            TrackPoint Wp = ::GPXLoadTrackPoint1( tpchild, time_cache );
+            Wp.m_GPXTrkSegNo = GPXSeg;
+            points.push_back( Wp );
+        }
+    }
+}
+
+//  Fill pTentTrack from a <trk> node.  Touches nothing but the track itself,
+//  so the tracks of a file can be loaded on several threads.
+static void GPXLoadTrackInto1( Track *pTentTrack, pugi::xml_node &trk_node, bool b_fullviz,
                       bool b_layer,
                       bool b_layerviz,
                       int layer_id )
@@ -329,30 +455,16 @@ static Track *GPXLoadTrack1( pugi::xml_node &trk_node, bool b_fullviz,
     unsigned short int GPXSeg;            
     bool b_propviz = false;
     bool b_viz = true;
-    Track *pTentTrack = NULL;
     HyperlinkList *linklist = NULL;
+    GPXTimeCache time_cache;
     
-    wxString Name = wxString::FromUTF8( trk_node.name() );
-    if( Name == _T ( "trk" ) ) {
-        pTentTrack = new Track();
+    {
         GPXSeg = 0;   
         
-        TrackPoint *pWp = NULL;
-        
         for( pugi::xml_node tschild = trk_node.first_child(); tschild; tschild = tschild.next_sibling() ) {
             wxString ChildName = wxString::FromUTF8( tschild.name() );
             if( ChildName == _T ( "trkseg" ) ) {
-                GPXSeg += 1;                
-                
-                //    Official GPX spec calls for trkseg to have children trkpt
-                for( pugi::xml_node tpchild = tschild.first_child(); tpchild; tpchild = tpchild.next_sibling() ) {
-                    wxString tpChildName = wxString::FromUTF8( tpchild.name() );
-                    if( tpChildName == _T("trkpt") ) {
-                        pWp = ::GPXLoadTrackPoint1(tpchild);
-                        pTentTrack->AddPoint( pWp );          // defer BBox calculation
-                        pWp->m_GPXTrkSegNo = GPXSeg;
-                    }
-                }
+                GPXSeg += 1;                            // points are read below, once visibility is known
             }
             else
             if( ChildName == _T ( "name" ) )
@@ -453,12 +565,48 @@ static Track *GPXLoadTrack1( pugi::xml_node &trk_node, bool b_fullviz,
         pTentTrack->SetCurrentTrackSeg( GPXSeg );
                 
     }
+
+    //  A hidden track keeps its <trkseg> text and builds the points when first needed
+    if( !pTentTrack->IsVisible() ) {
+        GPXStringWriter writer;
+        int count = 0;
+        for( pugi::xml_node tschild = trk_node.child( "trkseg" ); tschild; tschild = tschild.next_sibling( "trkseg" ) ) {
+            tschild.print( writer, "", pugi::format_raw );
+            for( pugi::xml_node tpchild = tschild.child( "trkpt" ); tpchild; tpchild = tpchild.next_sibling( "trkpt" ) )
+                count++;
+        }
+        pTentTrack->SetPendingPoints( writer.text, count );
+    }
+    else {
+        GPXSeg = 0;
+        for( pugi::xml_node tschild = trk_node.child( "trkseg" ); tschild; tschild = tschild.next_sibling( "trkseg" ) ) {
+            GPXSeg += 1;
+
+            //    Official GPX spec calls for trkseg to have children trkpt
+            for( pugi::xml_node tpchild = tschild.child( "trkpt" ); tpchild; tpchild = tpchild.next_sibling( "trkpt" ) ) {
+                TrackPoint Wp = ::GPXLoadTrackPoint1( tpchild, time_cache );
+                Wp.m_GPXTrkSegNo = GPXSeg;
+                pTentTrack->AddPoint( Wp );          // defer BBox calculation
+            }
+        }
+    }
     
     if( linklist ) {
         delete pTentTrack->m_HyperlinkList;                    // created in TrackPoint ctor
         pTentTrack->m_HyperlinkList = linklist;
     }
+}
 
+static Track *GPXLoadTrack1( pugi::xml_node &trk_node, bool b_fullviz,
+                      bool b_layer,
+                      bool b_layerviz,
+                      int layer_id )
+{
+    if( strcmp( trk_node.name(), "trk" ) )
+        return NULL;
+
+    Track *pTentTrack = new Track();
+    GPXLoadTrackInto1( pTentTrack, trk_node, b_fullviz, b_layer, b_layerviz, layer_id );
     return pTentTrack;
 }
 
@@ -815,26 +963,51 @@ static bool GPXCreateWpt( pugi::xml_node node, RoutePoint *pr, unsigned int flag
     return true;
 }
 
-static bool GPXCreateTrkpt( pugi::xml_node node, TrackPoint *pt, unsigned int flags )
+static bool GPXCreateTrkpt( pugi::xml_node node, const TrackPoint &pt, unsigned int flags )
 {
     wxString s;
     pugi::xml_node child;
     pugi::xml_attribute attr;
     
-    s.Printf(_T("%.9f"), pt->m_lat);
+    s.Printf(_T("%.9f"), pt.m_lat);
     node.append_attribute("lat") = s.mb_str();
-    s.Printf(_T("%.9f"), pt->m_lon);
+    s.Printf(_T("%.9f"), pt.m_lon);
     node.append_attribute("lon") = s.mb_str();
  
     if(flags & OUT_TIME) {
         child = node.append_child("time");
-        if( pt->GetTimeString() )
-            child.append_child(pugi::node_pcdata).set_value(pt->GetTimeString());
+        if( pt.HasCreateTime() )
+            child.append_child(pugi::node_pcdata).set_value(pt.GetTimeString().mb_str());
     }
     
     return true;
 }
 
+static void GPXCreateTrkSegs( pugi::xml_node node, const TrackPointArray &points )
+{
+    size_t node2 = 0;
+    TrackPoint prp;
+        
+    unsigned short int GPXTrkSegNo1 = 1;
+        
+    do {
+        unsigned short int GPXTrkSegNo2 = GPXTrkSegNo1;
+        
+        pugi::xml_node seg = node.append_child("trkseg");
+        
+        while( node2 < points.size() ) {
+            prp = points.Get(node2);
+            GPXTrkSegNo1 = prp.m_GPXTrkSegNo;
+            if(GPXTrkSegNo1 != GPXTrkSegNo2)
+                break;
+            
+            GPXCreateTrkpt(seg.append_child("trkpt"), prp, OPT_TRACKPT);
+            
+            node2++;
+        }
+    } while( node2 < points.size() );
+}
+
 static bool GPXCreateTrk( pugi::xml_node node, Track *pTrack, unsigned int flags )
 {
     pugi::xml_node child;
@@ -926,28 +1099,12 @@ static bool GPXCreateTrk( pugi::xml_node node, Track *pTrack, unsigned int flags
     if(flags & RT_OUT_NO_RTPTS)
         return true;
     
-    int node2 = 0;
-    TrackPoint *prp;
-        
-    unsigned short int GPXTrkSegNo1 = 1;
-        
-    do {
-        unsigned short int GPXTrkSegNo2 = GPXTrkSegNo1;
-        
-        pugi::xml_node seg = node.append_child("trkseg");
-        
-        while( node2 < pTrack->GetnPoints() ) {
-            prp = pTrack->GetPoint(node2);
-            GPXTrkSegNo1 = prp->m_GPXTrkSegNo;
-            if(GPXTrkSegNo1 != GPXTrkSegNo2)
-                break;
-            
-            GPXCreateTrkpt(seg.append_child("trkpt"), prp, OPT_TRACKPT);
-            
-            node2++;
-        }
-    } while( node2 < pTrack->GetnPoints() );
-        
+    //  A track loaded hidden and never shown writes its points back as it read them
+    if( pTrack->HasPendingPoints() ) {
+        const std::string &trksegs = pTrack->GetPendingPoints();
+        node.append_buffer( trksegs.data(), trksegs.size(), pugi::parse_default | pugi::parse_fragment );
+    } else
+        GPXCreateTrkSegs( node, pTrack->GetPoints() );
         
     return true;
 }
@@ -1165,20 +1322,11 @@ void InsertTrack( Track *pTentTrack, bool bApplyChanges = false )
 //        pTentTrack->FinalizeForRendering();
             
         //    Add the selectable points and segments
-                
-        float prev_rlat = 0., prev_rlon = 0.;
-        TrackPoint *prev_pConfPoint = NULL;
-                
-        for(int i=0; i<pTentTrack->GetnPoints(); i++) {
-            TrackPoint *prp = pTentTrack->GetPoint(i);
-            
-            if( i ) pSelect->AddSelectableTrackSegment( prev_rlat, prev_rlon, prp->m_lat,
-                                                        prp->m_lon, prev_pConfPoint, prp, pTentTrack );
-                    
-            prev_rlat = prp->m_lat;
-            prev_rlon = prp->m_lon;
-            prev_pConfPoint = prp;
-        }
+        //    A hidden track cannot be selected, so it waits until first shown
+        if( pTentTrack->IsVisible() )
+            pSelect->AddAllSelectableTrackSegments( pTentTrack );
+        else
+            pTentTrack->m_bSelectablePending = true;
     } else
         delete pTentTrack;
 }                       
@@ -1325,6 +1473,51 @@ bool NavObjectCollection1::CreateAllGPXObjects()
     return true;
 }
 
+bool NavObjectCollection1::SnapshotAllGPXObjects()
+{
+    SetRootGPXNode();
+    
+    CreateNavObjGPXPoints();
+    CreateNavObjGPXRoutes();
+
+    //  Tracks get their header now and their points, by far the bulk of the
+    //  document, from a copy in CompleteGPXSnapshot()
+    wxTrackListNode *node1 = pTrackList->GetFirst();
+    while( node1 ) {
+        Track *pTrack = node1->GetData();
+        
+        if( pTrack->GetnPoints() && !pTrack->m_bIsInLayer && !pTrack->m_btemp ) {
+            pugi::xml_node node = m_gpx_root.append_child("trk");
+            GPXCreateTrk(node, pTrack, RT_OUT_NO_RTPTS);
+            TrackSnapshot snapshot;
+            snapshot.node = node;
+            if( pTrack->HasPendingPoints() ) {
+                snapshot.points = NULL;
+                snapshot.trksegs = pTrack->GetPendingPoints();
+            } else
+                snapshot.points = new TrackPointArray( pTrack->GetPoints() );
+            m_track_snapshots.push_back( snapshot );
+        }
+        node1 = node1->GetNext();
+    }
+    
+    return true;
+}
+
+void NavObjectCollection1::CompleteGPXSnapshot()
+{
+    for( size_t i = 0; i < m_track_snapshots.size(); i++ ) {
+        TrackSnapshot &snapshot = m_track_snapshots[i];
+        if( snapshot.points ) {
+            GPXCreateTrkSegs( snapshot.node, *snapshot.points );
+            delete snapshot.points;
+        } else
+            snapshot.node.append_buffer( snapshot.trksegs.data(), snapshot.trksegs.size(),
+                                         pugi::parse_default | pugi::parse_fragment );
+    }
+    m_track_snapshots.clear();
+}
+
 bool NavObjectCollection1::AddGPXRoute(Route *pRoute)
 {
     SetRootGPXNode();
@@ -1408,24 +1601,127 @@ bool NavObjectCollection1::IsOpenCPN()
     return false;
 }
             
+//  The last navobj journal sequence number contained in this collection,
+//  kept in the root <extensions> node, which GPX places after all objects
+void NavObjectCollection1::SetJournalSeq( wxUint64 seq )
+{
+    SetRootGPXNode();
+
+    pugi::xml_node xchild = m_gpx_root.child("extensions");
+    if( !xchild )
+        xchild = m_gpx_root.append_child("extensions");
+    xchild.remove_child("opencpn:journal_seq");
+
+    char buf[32];
+    snprintf( buf, sizeof(buf), "%llu", (unsigned long long) seq );
+    pugi::xml_node child = xchild.append_child("opencpn:journal_seq");
+    child.append_child(pugi::node_pcdata).set_value(buf);
+}
+
+wxUint64 NavObjectCollection1::GetJournalSeq()
+{
+    pugi::xml_node child = this->child("gpx").child("extensions").child("opencpn:journal_seq");
+    if( !child )
+        return 0;
+    return strtoull( child.first_child().value(), NULL, 10 );
+}
+
 bool NavObjectCollection1::SaveFile( const wxString filename )
 {
     save_file(filename.fn_str(), "  ");
     return true;
 }
 
+//  Name index over the waypoint list, the same test as WaypointExists( name, lat, lon )
+//  without a walk over every waypoint for each one loaded.
+//  Waypoints appended to the list, by this load or by the routes it inserts, are indexed as they appear.
+class WaypointNameIndex
+{
+public:
+    WaypointNameIndex() : m_last( NULL ) {}
+
+    RoutePoint *Find( const wxString &name, double lat, double lon )
+    {
+        Update();
+        WaypointMap::iterator it = m_map.find( name );
+        if( it == m_map.end() )
+            return NULL;
+        for( size_t i = 0; i < it->second.size(); i++ ) {
+            RoutePoint *pr = it->second[i];
+            if( fabs( lat - pr->m_lat ) < 1.e-6 && fabs( lon - pr->m_lon ) < 1.e-6 )
+                return pr;
+        }
+        return NULL;
+    }
+
+private:
+    void Update()
+    {
+        wxRoutePointListNode *node = m_last ? m_last->GetNext() : pWayPointMan->GetWaypointList()->GetFirst();
+        while( node ) {
+            RoutePoint *pr = node->GetData();
+            m_map[pr->GetName()].push_back( pr );
+            m_last = node;
+            node = node->GetNext();
+        }
+    }
+
+    typedef std::unordered_map<wxString, std::vector<RoutePoint *>, wxStringHash, wxStringEqual> WaypointMap;
+
+    WaypointMap             m_map;
+    wxRoutePointListNode    *m_last;
+};
+
+//  Build the tracks of a file on all cores.  The Track objects are created here,
+//  since their GUIDs come from the waypoint manager, then filled in parallel.
+static void GPXLoadTracks1( std::vector<pugi::xml_node> &trk_nodes, std::vector<Track *> &tracks,
+                            bool b_fullviz, bool b_layer, bool b_layerviz, int layer_id, int &nthreads )
+{
+    tracks.resize( trk_nodes.size() );
+    for( size_t i = 0; i < trk_nodes.size(); i++ )
+        tracks[i] = new Track();
+
+    std::atomic<size_t> next( 0 );
+    auto worker = [&]() {
+        size_t i;
+        while( ( i = next++ ) < trk_nodes.size() )
+            GPXLoadTrackInto1( tracks[i], trk_nodes[i], b_fullviz, b_layer, b_layerviz, layer_id );
+    };
+
+    nthreads = wxThread::GetCPUCount();
+    if( g_nCPUCount > 0 )
+        nthreads = g_nCPUCount;
+    nthreads = wxMin( nthreads, (int) trk_nodes.size() );
+    nthreads = wxMax( nthreads, 1 );
+
+    std::vector<std::thread> threads;
+    for( int i = 1; i < nthreads; i++ )
+        threads.push_back( std::thread( worker ) );
+    worker();
+    for( size_t i = 0; i < threads.size(); i++ )
+        threads[i].join();
+}
+
 bool NavObjectCollection1::LoadAllGPXObjects( bool b_full_viz, int &wpt_duplicates )
 {
     wpt_duplicates = 0;
     pugi::xml_node objects = this->child("gpx");
     
+    WaypointNameIndex wpt_index;
+    std::vector<pugi::xml_node> trk_nodes;
+    long wpt_ms = 0, rte_ms = 0;
+    int n_wpt = 0, n_rte = 0;
+    wxStopWatch sw;
+
+    //  Tracks stand alone, so they are collected here and loaded together below
     for (pugi::xml_node object = objects.first_child(); object; object = object.next_sibling())
     {
         if( !strcmp(object.name(), "wpt") ) {
+            sw.Start();
             RoutePoint *pWp = ::GPXLoadWaypoint1( object, _T("circle"), _T(""), b_full_viz, false, false, 0 );
             
             pWp->m_bIsolatedMark = true;      // This is an isolated mark
-            RoutePoint *pExisting = WaypointExists( pWp->GetName(), pWp->m_lat, pWp->m_lon );
+            RoutePoint *pExisting = wpt_index.Find( pWp->GetName(), pWp->m_lat, pWp->m_lon );
             if( !pExisting ) {
                     if( NULL != pWayPointMan )
                         pWayPointMan->AddRoutePoint( pWp );
@@ -1435,21 +1731,41 @@ bool NavObjectCollection1::LoadAllGPXObjects( bool b_full_viz, int &wpt_duplicat
                 delete pWp;
                 wpt_duplicates++;
             }
+            wpt_ms += sw.Time();
+            n_wpt++;
         }
         else
             if( !strcmp(object.name(), "trk") ) {
-                Track *pTrack = GPXLoadTrack1( object, b_full_viz, false, false, 0);
-                InsertTrack( pTrack );
-                //delete pTrack
+                trk_nodes.push_back( object );
             }
             else
                 if( !strcmp(object.name(), "rte") ) {
+                    sw.Start();
                     Route *pRoute = GPXLoadRoute1( object, b_full_viz, false, false, 0, false );
                     InsertRouteA( pRoute );
+                    rte_ms += sw.Time();
+                    n_rte++;
                 }
                 
                 
     }
+
+    sw.Start();
+    std::vector<Track *> tracks;
+    int nthreads = 0;
+    GPXLoadTracks1( trk_nodes, tracks, b_full_viz, false, false, 0, nthreads );
+    long trk_ms = sw.Time();
+
+    sw.Start();
+    long n_trkpt = 0;
+    for( size_t i = 0; i < tracks.size(); i++ ) {
+        n_trkpt += tracks[i]->GetnPoints();
+        InsertTrack( tracks[i] );
+    }
+    long insert_ms = sw.Time();
+
+    wxLogMessage( wxString::Format( _T("GPX load: %d waypoints %ld ms, %d routes %ld ms, %d tracks (%ld points, %d threads) %ld ms, track insert %ld ms"),
+                                    n_wpt, wpt_ms, n_rte, rte_ms, (int) tracks.size(), n_trkpt, nthreads, trk_ms, insert_ms ) );
     
     return true;
 }
@@ -1498,22 +1814,220 @@ int NavObjectCollection1::LoadAllGPXObjectsAsLayer(int layer_id, bool b_layerviz
 
 
 
+//----------------------------------------------------------------------------------
+//      The binary navobj journal
+//
+//      File:   NAVOBJ_JOURNAL_MAGIC, then records
+//      Record: uint32 body length, uint32 body checksum, then the body
+//      Body:   uint64 sequence number, uint8 object type, uint8 action, payload
+//
+//      Track points, by far the most frequent change, are stored as raw
+//      lat, lon (double) and time (int64), followed by the track GUID.
+//      Routes, tracks and waypoints are stored as their GPX node, unindented.
+//      Values are in host byte order; the journal never leaves the machine.
+//----------------------------------------------------------------------------------
+
+#define NAVOBJ_JOURNAL_MAGIC    "OCPNJNL1"
+#define NAVOBJ_JOURNAL_HEADER   8
+#define NAVOBJ_RECORD_HEADER    8
+#define NAVOBJ_RECORD_BODY      10
+#define NAVOBJ_TRKPT_PAYLOAD    24
+
+enum {
+    JOURNAL_WPT = 1,
+    JOURNAL_RTE,
+    JOURNAL_TRK,
+    JOURNAL_TRKPT
+};
+
+enum {
+    JOURNAL_ADD = 1,
+    JOURNAL_UPDATE,
+    JOURNAL_DELETE
+};
+
+static int JournalAction( const char *action )
+{
+    if( !strcmp( action, "add" ) ) return JOURNAL_ADD;
+    if( !strcmp( action, "update" ) ) return JOURNAL_UPDATE;
+    if( !strcmp( action, "delete" ) ) return JOURNAL_DELETE;
+    return 0;
+}
+
+static const char *JournalActionName( int action )
+{
+    switch( action ) {
+        case JOURNAL_ADD: return "add";
+        case JOURNAL_UPDATE: return "update";
+        case JOURNAL_DELETE: return "delete";
+        default: return "";
+    }
+}
+
+//  32 bit FNV-1a, enough to find a record torn by a crash at the end of the file
+static wxUint32 JournalChecksum( const unsigned char *p, size_t n )
+{
+    wxUint32 h = 2166136261u;
+    for( size_t i = 0; i < n; i++ ) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+struct xml_string_writer : pugi::xml_writer
+{
+    std::string result;
+
+    virtual void write( const void *data, size_t size )
+    {
+        result.append( static_cast<const char *>( data ), size );
+    }
+};
+
+//  Remove tracks left with less than 2 points after applying changes
+static void RemoveShortTracks( void )
+{
+    wxTrackListNode *node1 = pTrackList->GetFirst();
+    while( node1 ) {
+        Track *pTrack = node1->GetData();
+        if( pTrack->GetnPoints() < 2 ) {
+            wxTrackListNode *tnode = node1->GetNext();
+            delete pTrack;
+            pTrackList->DeleteNode(node1);
+            node1 = tnode;
+        } else
+            node1 = node1->GetNext();
+    }
+}
+
+static void ApplyTrackPointChange( TrackPoint &Wp, const char *action, const wxString &track_GUID )
+{
+    Track *pExistingTrack = TrackExists( track_GUID );
+
+    if(!strcmp(action, "add") && pExistingTrack ) {
+        Wp.m_GPXTrkSegNo = pExistingTrack->GetCurrentTrackSeg() + 1;
+        pExistingTrack->AddPoint( Wp );
+    }
+}
+
+static void ApplyChange( pugi::xml_node object, const char *action )
+{
+    if( !strcmp(object.name(), "wpt") && pWayPointMan) {
+        RoutePoint *pWp = ::GPXLoadWaypoint1( object, _T("circle"), _T(""), false, false, false, 0 );
+        
+        pWp->m_bIsolatedMark = true;
+        RoutePoint *pExisting = WaypointExists( pWp->m_GUID );
+            
+        if(!strcmp(action, "add") ){
+            if( !pExisting )
+                pWayPointMan->AddRoutePoint( pWp );
+            pSelect->AddSelectableRoutePoint( pWp->m_lat, pWp->m_lon, pWp );
+        }
+            
+        else if(!strcmp(action, "update") ){
+            if( pExisting )
+                pWayPointMan->RemoveRoutePoint( pExisting );
+            pWayPointMan->AddRoutePoint( pWp );
+            pSelect->AddSelectableRoutePoint( pWp->m_lat, pWp->m_lon, pWp );
+        }
+
+        else if(!strcmp(action, "delete") ){
+            if( pExisting )
+                pWayPointMan->DestroyWaypoint( pExisting, false );
+        }
+        else
+            delete pWp;
+    }
+    else
+        if( !strcmp(object.name(), "trk") && g_pRouteMan) {
+            Track * pTrack = GPXLoadTrack1( object, false, false, false, 0);
+
+            if(pTrack ) {
+                Track *pExisting = TrackExists( pTrack->m_GUID );
+                if(!strcmp(action, "update") ){
+                     if( pExisting ) {
+                         pExisting->SetName(pTrack->GetName());
+                         pExisting->m_TrackStartString = pTrack->m_TrackStartString;
+                         pExisting->m_TrackEndString = pTrack->m_TrackEndString;
+                    }
+                }
+
+                else if(!strcmp(action, "delete") ){
+                    if( pExisting )
+                        g_pRouteMan->DeleteTrack( pExisting );
+                }
+
+                else if(!strcmp(action, "add") ){
+                    if( !pExisting )
+                        ::InsertTrack( pTrack, true );
+                }
+
+                else
+                    delete pTrack;
+            }
+        }
+        
+        else
+            if( !strcmp(object.name(), "rte") && g_pRouteMan) {
+                Route *pRoute = GPXLoadRoute1( object, true, false, false, 0, true );
+                
+                if(pRoute ) {
+                    if(!strcmp(action, "add") ){
+                        ::UpdateRouteA( pRoute );
+                    }                    
+                
+                    else if(!strcmp(action, "update") ){
+                        ::UpdateRouteA( pRoute );
+                    }
+
+                    else if(!strcmp(action, "delete") ){
+                        Route *pExisting = RouteExists( pRoute->m_GUID );
+                        if(pExisting){
+                            pConfig->m_bSkipChangeSetUpdate = true;
+                            g_pRouteMan->DeleteRoute( pExisting );
+                            pConfig->m_bSkipChangeSetUpdate = false;
+                        }
+                    }
+                
+                    else
+                        delete pRoute;
+                }
+            }
+        else
+            if( !strcmp(object.name(), "tkpt") && pWayPointMan) {
+                TrackPoint Wp = ::GPXLoadTrackPoint1( object );
+                
+                pugi::xml_node xchild = object.child("extensions");
+                pugi::xml_node guid_child = xchild.child("opencpn:track_GUID");
+                wxString track_GUID(guid_child.first_child().value(), wxConvUTF8);
+
+                ApplyTrackPointChange( Wp, action, track_GUID );
+            }
+}
+
+
 NavObjectChanges::NavObjectChanges()
 : NavObjectCollection1()
 {
     m_changes_file = 0;
+    m_seq = 1;
+    m_nRecords = 0;
+    m_size = 0;
 }
 
 
 
-NavObjectChanges::NavObjectChanges(wxString file_name)
+NavObjectChanges::NavObjectChanges(wxString file_name, wxUint64 next_seq)
     : NavObjectCollection1()
 {
     m_filename = file_name;
+    m_changes_file = 0;
+    m_seq = next_seq;
+    m_nRecords = 0;
+    m_size = 0;
     
-    m_changes_file = fopen(m_filename.mb_str(), "a");
-    
-    
+    Open();
 }
 
 NavObjectChanges::~NavObjectChanges()
@@ -1521,11 +2035,110 @@ NavObjectChanges::~NavObjectChanges()
     if(m_changes_file)
         fclose(m_changes_file);
 
-    if( ::wxFileExists( m_filename ) )
+    //  A journal still holding records has not made it into navobj.xml yet
+    if( !m_nRecords && ::wxFileExists( m_filename ) )
         ::wxRemoveFile( m_filename );
         
 }
 
+bool NavObjectChanges::Open()
+{
+    m_changes_file = fopen(m_filename.mb_str(), "ab");
+    if( !m_changes_file )
+        return false;
+
+    fseek( m_changes_file, 0, SEEK_END );
+    long pos = ftell( m_changes_file );
+    if( pos <= 0 ) {
+        fwrite( NAVOBJ_JOURNAL_MAGIC, 1, NAVOBJ_JOURNAL_HEADER, m_changes_file );
+        fflush( m_changes_file );
+        pos = NAVOBJ_JOURNAL_HEADER;
+    }
+    m_size = pos;
+    return true;
+}
+
+//  Start a new journal file.  The records written so far are moved to retired_file_name,
+//  appended to it if an earlier generation is still there, its snapshot never having completed.
+bool NavObjectChanges::Rotate( const wxString &retired_file_name )
+{
+    if( m_changes_file ) {
+        fclose( m_changes_file );
+        m_changes_file = 0;
+    }
+
+    bool bret = true;
+    if( m_nRecords ) {
+        if( ::wxFileExists( retired_file_name ) ) {
+            FILE *src = fopen( m_filename.mb_str(), "rb" );
+            FILE *dst = fopen( retired_file_name.mb_str(), "ab" );
+            if( src && dst ) {
+                char buf[65536];
+                size_t n;
+                fseek( src, NAVOBJ_JOURNAL_HEADER, SEEK_SET );
+                while( ( n = fread( buf, 1, sizeof(buf), src ) ) > 0 ) {
+                    if( fwrite( buf, 1, n, dst ) != n ) {
+                        bret = false;
+                        break;
+                    }
+                }
+            } else
+                bret = false;
+            if( src ) fclose( src );
+            if( dst ) fclose( dst );
+            if( bret )
+                ::wxRemoveFile( m_filename );
+        } else
+            bret = ::wxRenameFile( m_filename, retired_file_name, true );
+    }
+    else if( ::wxFileExists( m_filename ) )
+        ::wxRemoveFile( m_filename );
+
+    if( !bret )
+        wxLogMessage( _T("Navobj journal: could not retire ") + m_filename );
+
+    m_nRecords = 0;
+    Open();
+
+    return bret;
+}
+
+void NavObjectChanges::AddRecord( int type, const char *action, const void *payload, size_t len )
+{
+    if( !m_changes_file )
+        return;
+
+    std::vector<unsigned char> rec( NAVOBJ_RECORD_HEADER + NAVOBJ_RECORD_BODY + len );
+    unsigned char *body = &rec[NAVOBJ_RECORD_HEADER];
+
+    wxUint64 seq = m_seq++;
+    memcpy( body, &seq, 8 );
+    body[8] = type;
+    body[9] = JournalAction( action );
+    if( len )
+        memcpy( body + NAVOBJ_RECORD_BODY, payload, len );
+
+    wxUint32 body_len = NAVOBJ_RECORD_BODY + len;
+    wxUint32 sum = JournalChecksum( body, body_len );
+    memcpy( &rec[0], &body_len, 4 );
+    memcpy( &rec[4], &sum, 4 );
+
+    fwrite( &rec[0], 1, rec.size(), m_changes_file );
+    fflush( m_changes_file );
+
+    m_nRecords++;
+    m_size += rec.size();
+}
+
+void NavObjectChanges::AddObjectRecord( int type, const char *action, pugi::xml_node object )
+{
+    xml_string_writer writer;
+    object.print( writer, "", pugi::format_raw );
+    AddRecord( type, action, writer.result.data(), writer.result.size() );
+
+    m_gpx_root.remove_child( object );
+}
+
 void NavObjectChanges::AddRoute( Route *pr, const char *action )
 {
     SetRootGPXNode();
@@ -1533,30 +2146,18 @@ void NavObjectChanges::AddRoute( Route *pr, const char *action )
     pugi::xml_node object = m_gpx_root.append_child("rte");
     GPXCreateRoute(object, pr );
     
-    pugi::xml_node xchild = object.child("extensions");
-    //FIXME  What if extensions do not exist?
-    pugi::xml_node child = xchild.append_child("opencpn:action");
-    child.append_child(pugi::node_pcdata).set_value(action);
-
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
+    AddObjectRecord( JOURNAL_RTE, action, object );
 }
 
 void NavObjectChanges::AddTrack( Track *pr, const char *action )
 {
     SetRootGPXNode();
     
+    //  A new track carries its points, later points follow as track point records
     pugi::xml_node object = m_gpx_root.append_child("trk");
-    GPXCreateTrk(object, pr, RT_OUT_NO_RTPTS );         // emit a void track, no waypoints
+    GPXCreateTrk(object, pr, strcmp( action, "add" ) ? RT_OUT_NO_RTPTS : 0 );
     
-    pugi::xml_node xchild = object.child("extensions");
-    pugi::xml_node child = xchild.append_child("opencpn:action");
-    child.append_child(pugi::node_pcdata).set_value(action);
-
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
+    AddObjectRecord( JOURNAL_TRK, action, object );
 }
 
 void NavObjectChanges::AddWP( RoutePoint *pWP, const char *action )
@@ -1566,35 +2167,96 @@ void NavObjectChanges::AddWP( RoutePoint *pWP, const char *action )
     pugi::xml_node object = m_gpx_root.append_child("wpt");
     GPXCreateWpt(object, pWP, OPT_WPT);
 
-    pugi::xml_node xchild = object.child("extensions");
-    pugi::xml_node child = xchild.append_child("opencpn:action");
-    child.append_child(pugi::node_pcdata).set_value(action);
-
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
+    AddObjectRecord( JOURNAL_WPT, action, object );
 }
 
-void NavObjectChanges::AddTrackPoint( TrackPoint *pWP, const char *action, const wxString& parent_GUID )
+void NavObjectChanges::AddTrackPoint( const TrackPoint &WP, const char *action, const wxString& parent_GUID )
 {
-    SetRootGPXNode();
-    
-    pugi::xml_node object = m_gpx_root.append_child("tkpt");
-    GPXCreateTrkpt(object, pWP, OPT_TRACKPT);
+    wxCharBuffer guid = parent_GUID.ToUTF8();
+    size_t guid_len = strlen( guid.data() );
 
-    pugi::xml_node xchild = object.append_child("extensions");
-    
-    pugi::xml_node child = xchild.append_child("opencpn:action");
-    child.append_child(pugi::node_pcdata).set_value(action);
-    
-    pugi::xml_node gchild = xchild.append_child("opencpn:track_GUID");
-    gchild.append_child(pugi::node_pcdata).set_value(parent_GUID.mb_str());
+    std::vector<unsigned char> payload( NAVOBJ_TRKPT_PAYLOAD + guid_len );
+    memcpy( &payload[0], &WP.m_lat, 8 );
+    memcpy( &payload[8], &WP.m_lon, 8 );
+    memcpy( &payload[16], &WP.m_time, 8 );
+    memcpy( &payload[NAVOBJ_TRKPT_PAYLOAD], guid.data(), guid_len );
 
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
+    AddRecord( JOURNAL_TRKPT, action, &payload[0], payload.size() );
 }
 
+//  Apply the records of a journal file newer than after_seq, in order.
+//  Returns true if any record was applied; last_seq is raised to the newest record seen.
+bool NavObjectChanges::ReplayJournal( const wxString &file_name, wxUint64 after_seq, wxUint64 &last_seq )
+{
+    FILE *f = fopen( file_name.mb_str(), "rb" );
+    if( !f )
+        return false;
+
+    std::vector<unsigned char> buf;
+    char chunk[65536];
+    size_t n;
+    while( ( n = fread( chunk, 1, sizeof(chunk), f ) ) > 0 )
+        buf.insert( buf.end(), chunk, chunk + n );
+    fclose( f );
+
+    if( buf.size() < NAVOBJ_JOURNAL_HEADER || memcmp( &buf[0], NAVOBJ_JOURNAL_MAGIC, NAVOBJ_JOURNAL_HEADER ) ) {
+        wxLogMessage( _T("Navobj journal: ") + file_name + _T(" is not a journal file") );
+        return false;
+    }
+
+    int nApplied = 0;
+    size_t pos = NAVOBJ_JOURNAL_HEADER;
+    while( pos + NAVOBJ_RECORD_HEADER <= buf.size() ) {
+        wxUint32 body_len, sum;
+        memcpy( &body_len, &buf[pos], 4 );
+        memcpy( &sum, &buf[pos + 4], 4 );
+
+        const unsigned char *body = &buf[pos + NAVOBJ_RECORD_HEADER];
+        if( body_len < NAVOBJ_RECORD_BODY || pos + NAVOBJ_RECORD_HEADER + body_len > buf.size()
+            || JournalChecksum( body, body_len ) != sum ) {
+            wxLogMessage( _T("Navobj journal: ignoring damaged tail of ") + file_name );
+            break;
+        }
+        pos += NAVOBJ_RECORD_HEADER + body_len;
+
+        wxUint64 seq;
+        memcpy( &seq, body, 8 );
+        if( seq > last_seq )
+            last_seq = seq;
+        if( seq <= after_seq )
+            continue;
+
+        int type = body[8];
+        const char *action = JournalActionName( body[9] );
+        const unsigned char *payload = body + NAVOBJ_RECORD_BODY;
+        size_t len = body_len - NAVOBJ_RECORD_BODY;
+
+        if( type == JOURNAL_TRKPT ) {
+            if( len < NAVOBJ_TRKPT_PAYLOAD )
+                continue;
+            TrackPoint Wp;
+            memcpy( &Wp.m_lat, payload, 8 );
+            memcpy( &Wp.m_lon, payload + 8, 8 );
+            memcpy( &Wp.m_time, payload + 16, 8 );
+            wxString track_GUID( (const char *) payload + NAVOBJ_TRKPT_PAYLOAD, wxConvUTF8,
+                                 len - NAVOBJ_TRKPT_PAYLOAD );
+            ApplyTrackPointChange( Wp, action, track_GUID );
+        } else {
+            pugi::xml_document doc;
+            if( !doc.load_buffer( payload, len ) )
+                continue;
+            ApplyChange( doc.first_child(), action );
+        }
+        nApplied++;
+    }
+
+    if( nApplied ) {
+        RemoveShortTracks();
+        wxLogMessage( wxString::Format( _T("Navobj journal: applied %d changes from "), nApplied ) + file_name );
+    }
+
+    return nApplied > 0;
+}
 
 bool NavObjectChanges::ApplyChanges(void)
 {
@@ -1604,132 +2266,15 @@ bool NavObjectChanges::ApplyChanges(void)
     
     while(strlen(object.name()))
     {
-        if( !strcmp(object.name(), "wpt") && pWayPointMan) {
-            RoutePoint *pWp = ::GPXLoadWaypoint1( object, _T("circle"), _T(""), false, false, false, 0 );
-            
-            pWp->m_bIsolatedMark = true;
-            RoutePoint *pExisting = WaypointExists( pWp->m_GUID );
-                
-            pugi::xml_node xchild = object.child("extensions");
-            pugi::xml_node child = xchild.child("opencpn:action");
-                
-            if(!strcmp(child.first_child().value(), "add") ){
-                if( !pExisting )
-                    pWayPointMan->AddRoutePoint( pWp );
-                pSelect->AddSelectableRoutePoint( pWp->m_lat, pWp->m_lon, pWp );
-            }
-                
-            else if(!strcmp(child.first_child().value(), "update") ){
-                if( pExisting )
-                    pWayPointMan->RemoveRoutePoint( pExisting );
-                pWayPointMan->AddRoutePoint( pWp );
-                pSelect->AddSelectableRoutePoint( pWp->m_lat, pWp->m_lon, pWp );
-            }
-
-            else if(!strcmp(child.first_child().value(), "delete") ){
-                if( pExisting )
-                    pWayPointMan->DestroyWaypoint( pExisting, false );
-            }
-            else
-                delete pWp;
-        }
-        else
-            if( !strcmp(object.name(), "trk") && g_pRouteMan) {
-                Track * pTrack = GPXLoadTrack1( object, false, false, false, 0);
-
-                if(pTrack ) {
-                    pugi::xml_node xchild = object.child("extensions");
-                    pugi::xml_node child = xchild.child("opencpn:action");
-                    
-                    Track *pExisting = TrackExists( pTrack->m_GUID );
-                    if(!strcmp(child.first_child().value(), "update") ){
-                         if( pExisting ) {
-                             pExisting->SetName(pTrack->GetName());
-                             pExisting->m_TrackStartString = pTrack->m_TrackStartString;
-                             pExisting->m_TrackEndString = pTrack->m_TrackEndString;
-                        }
-                    }
-
-                    else if(!strcmp(child.first_child().value(), "delete") ){
-                        if( pExisting )
-                            g_pRouteMan->DeleteTrack( pExisting );
-                    }
+        pugi::xml_node xchild = object.child("extensions");
+        pugi::xml_node child = xchild.child("opencpn:action");
 
-                    else if(!strcmp(child.first_child().value(), "add") ){
-                        if( !pExisting )
-                            ::InsertTrack( pTrack, true );
-                    }
-
-                    else
-                        delete pTrack;
-                }
-            }
-            
-            else
-                if( !strcmp(object.name(), "rte") && g_pRouteMan) {
-                    Route *pRoute = GPXLoadRoute1( object, true, false, false, 0, true );
-                    
-                    if(pRoute ) {
-                        pugi::xml_node xchild = object.child("extensions");
-                        pugi::xml_node child = xchild.child("opencpn:action");
-
-                        if(!strcmp(child.first_child().value(), "add") ){
-                            ::UpdateRouteA( pRoute );
-                        }                    
-                    
-                        else if(!strcmp(child.first_child().value(), "update") ){
-                            ::UpdateRouteA( pRoute );
-                        }
-
-                        else if(!strcmp(child.first_child().value(), "delete") ){
-                            Route *pExisting = RouteExists( pRoute->m_GUID );
-                            if(pExisting){
-                                pConfig->m_bSkipChangeSetUpdate = true;
-                                g_pRouteMan->DeleteRoute( pExisting );
-                                pConfig->m_bSkipChangeSetUpdate = false;
-                            }
-                        }
-                    
-                        else
-                            delete pRoute;
-                    }
-                }
-            else
-                if( !strcmp(object.name(), "tkpt") && pWayPointMan) {
-                    TrackPoint *pWp = ::GPXLoadTrackPoint1( object );
-                    
-//                        RoutePoint *pExisting = WaypointExists( pWp->GetName(), pWp->m_lat, pWp->m_lon );
-                        
-                    pugi::xml_node xchild = object.child("extensions");
-                    pugi::xml_node child = xchild.child("opencpn:action");
-
-                    pugi::xml_node guid_child = xchild.child("opencpn:track_GUID");
-                    wxString track_GUID(guid_child.first_child().value(), wxConvUTF8);
-
-                    Track *pExistingTrack = TrackExists( track_GUID );
-                        
-                    if(!strcmp(child.first_child().value(), "add") && pExistingTrack ) {
-                        pExistingTrack->AddPoint( pWp );
-                        pWp->m_GPXTrkSegNo = pExistingTrack->GetCurrentTrackSeg() + 1;
-                    }
-                    else
-                        delete pWp;
-                }
+        ApplyChange( object, child.first_child().value() );
 
         object = object.next_sibling();
     }
     // Check to make sure we haven't loaded tracks with less than 2 points
-    wxTrackListNode *node1 = pTrackList->GetFirst();
-    while( node1 ) {
-        Track *pTrack = node1->GetData();
-        if( pTrack->GetnPoints() < 2 ) {
-            wxTrackListNode *tnode = node1->GetNext();
-            delete pTrack;
-            pTrackList->DeleteNode(node1);
-            node1 = tnode;
-        } else
-            node1 = node1->GetNext();
-    }
+    RemoveShortTracks();
     
     return true;
 }
@@ -1769,6 +1769,57 @@ int Osenc::createSenc200(const wxString& FullPath000, const wxString& SENCFileNa
 
 }
 
+int Osenc::readAreaGeometry( const wxString& FullPath000, const wxString& working_dir,
+                             std::vector<OGRPolygon *> &polys )
+{
+    lockCR.lock();
+
+    m_FullPath000 = FullPath000;
+
+    if(!m_poRegistrar){
+        m_poRegistrar = new S57ClassRegistrar();
+        m_poRegistrar->LoadInfo( g_csv_locn.mb_str(), FALSE );
+        m_bPrivateRegistrar = true;
+    }
+
+    if(!GetBaseFileAttr( FullPath000 ) ){
+        lockCR.unlock();
+        return ERROR_BASEFILE_ATTRIBUTES;
+    }
+
+    OGRS57DataSource S57DS;
+    OGRS57DataSource *poS57DS = &S57DS;
+    poS57DS->SetS57Registrar( m_poRegistrar );
+
+    int ret_code = SENC_NO_ERROR;
+
+    if(ingestCell( poS57DS, FullPath000, working_dir )){
+        errorMessage = _T("Error ingesting: ") + FullPath000;
+        ret_code = ERROR_INGESTING000;
+    }
+    else {
+        S57Reader *poReader = poS57DS->GetModule( 0 );
+        poReader->Rewind();
+
+        OGRFeature *objectDef;
+        while( (objectDef = poReader->ReadNextFeature()) != NULL ) {
+            OGRGeometry *pGeo = objectDef->GetGeometryRef();
+            if( pGeo && (pGeo->getGeometryType() == wkbPolygon) && ((OGRPolygon *)pGeo)->getExteriorRing() )
+                polys.push_back( (OGRPolygon *)pGeo->clone() );
+
+            delete objectDef;
+        }
+    }
+
+    for( unsigned int iff = 0; iff < m_tmpup_array.GetCount(); iff++ )
+        remove( m_tmpup_array[iff].mb_str() );
+    m_tmpup_array.Clear();
+
+    lockCR.unlock();
+
+    return ret_code;
+}
+
 bool Osenc::CreateCovrRecords(Osenc_outstream *stream)
 {
     // First, create the Extent record
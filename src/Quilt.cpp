@@ -32,6 +32,7 @@
 #include "chartimg.h"
 
 #include <algorithm>
+#include <tuple>
 
 #ifdef USE_S57
 #include "s57chart.h"
@@ -68,6 +69,45 @@ extern bool g_bopengl;
 #define NOCOVR_PLY_PERF_LIMIT 500
 #define AUX_PLY_PERF_LIMIT 500
 
+//  Cached reduced regions are all dropped past this many entries
+#define QUILT_REDUCED_REGION_CACHE_MAX 4096
+
+//  Views wider than this are not given a view class, and views smaller than
+//  2^QUILT_VIEW_CLASS_MIN_LEVEL degrees share the class of that size,
+//  whose bounds are still exact in the float LLRegion box constructor
+#define QUILT_VIEW_CLASS_MAX_DEGREES 8.
+#define QUILT_VIEW_CLASS_MIN_LEVEL -14
+
+//  Guards the lazily built ChartTableEntry::quilt_candidate_region, which the
+//  compose-ahead thread may build as well.  Regions are built unlocked, and only
+//  checked and published under it.
+static std::mutex s_candidate_region_mutex;
+
+//  Reduced candidate regions by (dbIndex, reduction factor), kept across compositions and
+//  shared by the quilts of all canvases, as they depend on the chart only.
+//  Entries are only ever added, or all cleared, so references stay valid during Compose.
+//  The generation is bumped on each clear, so compose-ahead results begun before are dropped.
+static std::map<std::pair<int, double>, LLRegion> s_reduced_regions;
+
+//  The reduced candidate regions clipped to a view class, by (dbIndex, reduction factor,
+//  class level, class latitude and longitude), under the same rules as s_reduced_regions.
+static std::map<std::tuple<int, double, int, int, int>, LLRegion> s_view_class_regions;
+static std::mutex s_region_mutex;
+static unsigned int s_region_generation;
+static unsigned int s_region_table_generation;
+
+//  Drop the reduced regions if the chart table changed since they were built.
+//  Called with s_region_mutex held.
+static void CheckReducedRegionTable( void )
+{
+    if( ChartData && ChartData->GetTableGeneration() != s_region_table_generation ) {
+        s_reduced_regions.clear();
+        s_view_class_regions.clear();
+        s_region_generation++;
+        s_region_table_generation = ChartData->GetTableGeneration();
+    }
+}
+
 
 static int CompareScales( int i1, int i2 )
 {
@@ -106,21 +146,16 @@ static int CompareQuiltCandidateScales( QuiltCandidate *qc1, QuiltCandidate *qc2
     return CompareScales(qc1->dbIndex, qc2->dbIndex);
 }
 
-const LLRegion &QuiltCandidate::GetCandidateRegion()
+//  Build a chart's candidate region from its chart table entry, without locks
+static LLRegion BuildCandidateRegion( int dbIndex, const ChartTableEntry &cte )
 {
-    const ChartTableEntry &cte = ChartData->GetChartTableEntry( dbIndex );
-    LLRegion &candidate_region = const_cast<LLRegion &>(cte.quilt_candidate_region);
-
-    if( !candidate_region.Empty() )
-        return candidate_region;
-
+    LLRegion candidate_region;
     LLRegion world_region(-90, -180, 90, 180);
 
     // for cm93 charts use their valid canvas region (should this apply to all vector charts?)
     if(ChartData->GetDBChartType( dbIndex ) == CHART_TYPE_CM93COMP) {
         double cm93_ll_bounds[8] = {-80, -180, -80, 180, 80, 180, 80, -180};
-        candidate_region = LLRegion(4, cm93_ll_bounds);
-        return candidate_region;
+        return LLRegion(4, cm93_ll_bounds);
     }
 
     //    If the chart has an aux ply table, use it for finer region precision
@@ -180,15 +215,24 @@ const LLRegion &QuiltCandidate::GetCandidateRegion()
     return candidate_region;
 }
 
-LLRegion &QuiltCandidate::GetReducedCandidateRegion(double factor)
+const LLRegion &QuiltCandidate::GetCandidateRegion()
 {
-    if(factor != last_factor) {
-        reduced_candidate_region = GetCandidateRegion();
-        reduced_candidate_region.Reduce(factor);
-        last_factor = factor;
+    const ChartTableEntry &cte = ChartData->GetChartTableEntry( dbIndex );
+    LLRegion &candidate_region = const_cast<LLRegion &>(cte.quilt_candidate_region);
+
+    {
+        std::lock_guard<std::mutex> lock( s_candidate_region_mutex );
+        if( !candidate_region.Empty() )
+            return candidate_region;
     }
 
-    return reduced_candidate_region;
+    //  Build outside the lock, another thread may publish the same region first
+    LLRegion region = BuildCandidateRegion( dbIndex, cte );
+
+    std::lock_guard<std::mutex> lock( s_candidate_region_mutex );
+    if( candidate_region.Empty() )
+        candidate_region = region;
+    return candidate_region;
 }
 
 void QuiltCandidate::SetScale( int scale )
@@ -232,10 +276,15 @@ Quilt::Quilt( ChartCanvas *parent)
     m_bquiltskew = g_bopengl;
     //  Quilting of different projections is allowed for OpenGL only
     m_bquiltanyproj = g_bopengl;
+
+    m_bahead_busy = false;
+    m_bahead_cancel = false;
 }
 
 Quilt::~Quilt()
 {
+    StopComposeAhead();
+
     m_PatchList.DeleteContents( true );
     m_PatchList.Clear();
 
@@ -247,6 +296,187 @@ Quilt::~Quilt()
     delete m_pBM;
 }
 
+void Quilt::Invalidate( void )
+{
+    m_bcomposed = false;
+    m_vp_quilt.Invalidate();
+    m_zout_dbindex = -1;
+
+    //  Quilting of skewed raster charts is allowed for OpenGL only
+    m_bquiltskew = g_bopengl;
+    //  Quilting of different projections is allowed for OpenGL only
+    m_bquiltanyproj = g_bopengl;
+
+    //  The chart database may be about to change under the cached regions
+    StopComposeAhead();
+    {
+        std::lock_guard<std::mutex> lock( s_region_mutex );
+        s_reduced_regions.clear();
+        s_view_class_regions.clear();
+        s_region_generation++;
+    }
+    m_patch_region_key.clear();
+    m_patch_regions.clear();
+}
+
+//  Quilted regions can be simplified to reduce the cost of region operations, allowing
+//  a maximum error of 8 pixels (the rendered display is much better, this is only for
+//  composing the quilt).  The factor is rounded down to a power of two, so the reduced
+//  regions can be reused across pans and small zooms.
+static double QuiltReduceFactor( double view_scale_ppm )
+{
+    const double z = 111274.96299695622; ////WGS84_semimajor_axis_meters * mercator_k0 * DEGREE;
+    double factor = 8.0 / (view_scale_ppm * z);
+    return pow( 2., floor( log2( factor ) ) );
+}
+
+const LLRegion &Quilt::GetReducedCandidateRegion( QuiltCandidate *pqc, double factor )
+{
+    std::pair<int, double> key( pqc->dbIndex, factor );
+    {
+        std::lock_guard<std::mutex> lock( s_region_mutex );
+        std::map<std::pair<int, double>, LLRegion>::iterator it = s_reduced_regions.find( key );
+        if( it != s_reduced_regions.end() )
+            return it->second;
+    }
+
+    LLRegion region = pqc->GetCandidateRegion();
+    region.Reduce( factor );
+
+    std::lock_guard<std::mutex> lock( s_region_mutex );
+    return s_reduced_regions.insert( std::make_pair( key, region ) ).first->second;
+}
+
+//  The view class of a view box: the square two cells on a side, on the grid of the
+//  smallest power of two degrees the view fits in, that starts in the cell of its
+//  south west corner.  So the box lies in its class, and views panned less than a
+//  cell, or zoomed within a power of two, mostly share one.
+QuiltViewClass Quilt::GetViewClass( const LLBBox &box )
+{
+    QuiltViewClass vc;
+    vc.valid = false;
+    if( !box.GetValid() )
+        return vc;
+
+    double span = wxMax( box.GetMaxLat() - box.GetMinLat(), box.GetMaxLon() - box.GetMinLon() );
+    if( span <= 0. || span > QUILT_VIEW_CLASS_MAX_DEGREES )
+        return vc;
+
+    vc.level = wxMax( (int) ceil( log2( span ) ), QUILT_VIEW_CLASS_MIN_LEVEL );
+    double cell = ldexp( 1., vc.level );
+    vc.ilat = (int) floor( box.GetMinLat() / cell );
+    vc.ilon = (int) floor( box.GetMinLon() / cell );
+    vc.region = LLRegion( wxMax( vc.ilat * cell, -90. ), vc.ilon * cell,
+                          wxMin( ( vc.ilat + 2 ) * cell, 90. ), ( vc.ilon + 2 ) * cell );
+    vc.valid = true;
+    return vc;
+}
+
+//  The reduced candidate region clipped to a view class.  Within any view of the class
+//  it is the same as the whole reduced region, and it is cut to the few edges near the
+//  view, or to the class square itself where the chart covers it, which the LLRegion
+//  rectangle fast paths then settle.
+const LLRegion &Quilt::GetViewClassRegion( QuiltCandidate *pqc, double factor, const QuiltViewClass &vc )
+{
+    const LLRegion &chart_region = GetReducedCandidateRegion( pqc, factor );
+    if( !vc.valid )
+        return chart_region;
+
+    std::tuple<int, double, int, int, int> key( pqc->dbIndex, factor, vc.level, vc.ilat, vc.ilon );
+    {
+        std::lock_guard<std::mutex> lock( s_region_mutex );
+        std::map<std::tuple<int, double, int, int, int>, LLRegion>::iterator it = s_view_class_regions.find( key );
+        if( it != s_view_class_regions.end() )
+            return it->second;
+    }
+
+    LLRegion region = chart_region;
+    if( !region.Empty() )
+        region.Intersect( vc.region );
+
+    std::lock_guard<std::mutex> lock( s_region_mutex );
+    return s_view_class_regions.insert( std::make_pair( key, region ) ).first->second;
+}
+
+//  Build the reduced candidate regions for a viewport the canvas is expected to show next,
+//  on a worker thread, so that the following Compose() finds them ready.
+//  Candidate selection stays on this thread, as it consults the chart groups.
+void Quilt::ComposeAhead( const ViewPort &vp_next )
+{
+    if( !ChartData || ChartData->IsBusy() || ChartData->IsUpdating() || m_bahead_busy || !vp_next.IsValid() )
+        return;
+
+    if( m_ahead_thread.joinable() )
+        m_ahead_thread.join();
+
+    double factor = QuiltReduceFactor( vp_next.view_scale_ppm );
+    ViewPort vp_local = vp_next;
+    LLBBox viewbox = vp_local.GetBBox();
+    int groupIndex = m_parent->m_groupIndex;
+
+    std::vector<int> charts;
+    unsigned int generation;
+    {
+        std::lock_guard<std::mutex> lock( s_region_mutex );
+        CheckReducedRegionTable();
+        generation = s_region_generation;
+        int n_all_charts = ChartData->GetChartTableEntries();
+        for( int i = 0; i < n_all_charts; i++ ) {
+            const ChartTableEntry &cte = ChartData->GetChartTableEntry( i );
+            if( cte.GetChartFamily() != m_reference_family )
+                continue;
+            if( cte.GetChartType() == CHART_TYPE_CM93COMP || cte.GetChartType() == CHART_TYPE_MBTILES )
+                continue;
+            if( viewbox.IntersectOut( cte.GetBBox() ) )
+                continue;
+            if( ( groupIndex > 0 ) && ( !ChartData->IsChartInGroup( i, groupIndex ) ) )
+                continue;
+            if( s_reduced_regions.count( std::make_pair( i, factor ) ) )
+                continue;
+            charts.push_back( i );
+        }
+    }
+
+    if( charts.empty() )
+        return;
+
+    m_bahead_busy = true;
+    m_bahead_cancel = false;
+    m_ahead_thread = std::thread( &Quilt::ComposeAheadThread, this, charts, factor, generation );
+}
+
+void Quilt::ComposeAheadThread( std::vector<int> charts, double factor, unsigned int generation )
+{
+    for( size_t i = 0; i < charts.size() && !m_bahead_cancel; i++ ) {
+        //  Stay out of the chart table while it is being changed
+        std::unique_lock<std::mutex> table( ChartData->GetTableMutex(), std::try_to_lock );
+        if( !table.owns_lock() || ChartData->IsUpdating() )
+            break;
+
+        QuiltCandidate qc;
+        qc.dbIndex = charts[i];
+        LLRegion region = qc.GetCandidateRegion();
+        table.unlock();
+
+        region.Reduce( factor );
+
+        std::lock_guard<std::mutex> lock( s_region_mutex );
+        if( generation != s_region_generation )
+            break;
+        s_reduced_regions.insert( std::make_pair( std::make_pair( charts[i], factor ), region ) );
+    }
+
+    m_bahead_busy = false;
+}
+
+void Quilt::StopComposeAhead( void )
+{
+    m_bahead_cancel = true;
+    if( m_ahead_thread.joinable() )
+        m_ahead_thread.join();
+    m_bahead_cancel = false;
+}
+
 bool Quilt::IsVPBlittable( ViewPort &VPoint, int dx, int dy, bool b_allow_vector )
 {
     if( !m_vp_rendered.IsValid() )
@@ -1605,28 +1835,37 @@ bool Quilt::Compose( const ViewPort &vp_in )
         }
     }
 
-    // Quilted regions can be simplified to reduce the cost of region operations, in this case
-    // allow a maximum error of 8 pixels (the rendered display is much better, this is only for composing the quilt)
-    const double z = 111274.96299695622; ////WGS84_semimajor_axis_meters * mercator_k0 * DEGREE;
-    double factor = 8.0 / (vp_local.view_scale_ppm * z);
-    
+    double factor = QuiltReduceFactor( vp_local.view_scale_ppm );
+    QuiltViewClass view_class = GetViewClass( vp_local.GetBBox() );
+    {
+        std::lock_guard<std::mutex> lock( s_region_mutex );
+        CheckReducedRegionTable();
+        if( s_reduced_regions.size() > QUILT_REDUCED_REGION_CACHE_MAX
+            || s_view_class_regions.size() > QUILT_REDUCED_REGION_CACHE_MAX ) {
+            s_reduced_regions.clear();
+            s_view_class_regions.clear();
+            s_region_generation++;
+        }
+    }
+
     if( pqc_ref ) {
         const ChartTableEntry &cte_ref = ChartData->GetChartTableEntry( m_refchart_dbIndex );
 
         LLRegion vpu_region( cvp_region );
 
         //LLRegion chart_region = pqc_ref->GetCandidateRegion();
-        LLRegion &chart_region = pqc_ref->GetReducedCandidateRegion(factor);
+        const LLRegion &chart_region = GetReducedCandidateRegion( pqc_ref, factor );
         
         if(cte_ref.GetChartType() != CHART_TYPE_MBTILES){
             if( !chart_region.Empty() ){
-                vpu_region.Intersect( chart_region );
+                const LLRegion &view_chart_region = GetViewClassRegion( pqc_ref, factor, view_class );
+                vpu_region.Intersect( view_chart_region );
 
                 if( vpu_region.Empty() )
                     pqc_ref->b_include = false;   // skip this chart, no true overlap
                 else {
                     pqc_ref->b_include = true;
-                    vp_region.Subtract( chart_region );          // adding this chart
+                    vp_region.Subtract( view_chart_region );          // adding this chart
                 }
             }
             else
@@ -1681,16 +1920,17 @@ bool Quilt::Compose( const ViewPort &vp_in )
                     LLRegion vpu_region( cvp_region );
 
                     //LLRegion chart_region = pqc->GetCandidateRegion( );  //quilt_region;
-                    LLRegion &chart_region = pqc->GetReducedCandidateRegion(factor);
+                    const LLRegion &chart_region = GetReducedCandidateRegion( pqc, factor );
                     
                     if( !chart_region.Empty() ) {
-                        vpu_region.Intersect( chart_region );
+                        const LLRegion &view_chart_region = GetViewClassRegion( pqc, factor, view_class );
+                        vpu_region.Intersect( view_chart_region );
 
                         if( vpu_region.Empty() )
                             pqc->b_include = false; // skip this chart, no true overlap
                         else {
                             pqc->b_include = true;
-                            vp_region.Subtract( chart_region );          // adding this chart
+                            vp_region.Subtract( view_chart_region );          // adding this chart
                         }
                     } else
                         pqc->b_include = false;   // skip this chart, empty region
@@ -1733,10 +1973,10 @@ bool Quilt::Compose( const ViewPort &vp_in )
                     LLRegion vpu_region( cvp_region );
 
                     //LLRegion chart_region = pqc->GetCandidateRegion( );
-                    LLRegion &chart_region = pqc->GetReducedCandidateRegion(factor);
+                    const LLRegion &chart_region = GetReducedCandidateRegion( pqc, factor );
                     
                     if( !chart_region.Empty() )
-                        vpu_region.Intersect( chart_region );
+                        vpu_region.Intersect( GetViewClassRegion( pqc, factor, view_class ) );
 
                     if( vpu_region.Empty() )
                         pqc->b_include = false; // skip this chart, no true overlap
@@ -1840,9 +2080,9 @@ bool Quilt::Compose( const ViewPort &vp_in )
             LLRegion vpck_region( vp_local.GetBBox() );
 
             //LLRegion chart_region = pqc->GetCandidateRegion();
-            LLRegion &chart_region = pqc->GetReducedCandidateRegion(factor);
+            const LLRegion &chart_region = GetReducedCandidateRegion( pqc, factor );
             
-            if( !chart_region.Empty() ) vpck_region.Intersect( chart_region );
+            if( !chart_region.Empty() ) vpck_region.Intersect( GetViewClassRegion( pqc, factor, view_class ) );
 
             if( !vpck_region.Empty() ) {
                 if( add_scale ) {
@@ -1925,8 +2165,23 @@ bool Quilt::Compose( const ViewPort &vp_in )
     }
 
     //    Generate the final render regions for the patches, one by one
+    //    Until the viewport clip these depend only on the patch list, so when it is the
+    //    same as in the last composition the previous regions are reused
 
-    m_covered_region.Clear();
+    std::vector<int> region_key;
+    for( unsigned int i = 0; i < m_PatchList.GetCount(); i++ ) {
+        QuiltPatch *piqp = m_PatchList.Item(i)->GetData();
+        region_key.push_back( piqp->b_Valid ? piqp->dbIndex : -1 );
+    }
+    region_key.push_back( b_has_overlays );
+    region_key.push_back( m_reference_type );
+
+    bool b_reuse_regions = ( region_key == m_patch_region_key );
+    if( !b_reuse_regions ) {
+        m_patch_region_key = region_key;
+        m_patch_regions.assign( m_PatchList.GetCount(), LLRegion() );
+        m_covered_region.Clear();
+    }
 #if 1 // this does the same as before with a lot less operations if there are many charts
     
     //  If the reference chart is cm93, we need to render it first.
@@ -1944,11 +2199,14 @@ bool Quilt::Compose( const ViewPort &vp_in )
         
             if(m.GetChartType() == CHART_TYPE_CM93COMP){
                 //    Start with the chart's full region coverage.
-                piqp->ActiveRegion = piqp->quilt_region;
+                if( !b_reuse_regions ) {
+                    m_patch_regions[i] = piqp->quilt_region;
+
+                    //    Update the next pass full region to remove the region just allocated
+                    m_covered_region.Union( piqp->quilt_region );
+                }
+                piqp->ActiveRegion = m_patch_regions[i];
                 piqp->ActiveRegion.Intersect(cvp_region);
-            
-                //    Update the next pass full region to remove the region just allocated
-                m_covered_region.Union( piqp->quilt_region );
                 
                 b_skipCM93 = true;      // did this already...
                 break;
@@ -1972,11 +2230,14 @@ bool Quilt::Compose( const ViewPort &vp_in )
         }
             
         //    Start with the chart's full region coverage.
-        piqp->ActiveRegion = piqp->quilt_region;
-        
-        // this operation becomes expensive with lots of charts
-        if(!b_has_overlays && m_PatchList.GetCount() < 25)
-            piqp->ActiveRegion.Subtract(m_covered_region);
+        if( !b_reuse_regions ) {
+            m_patch_regions[i] = piqp->quilt_region;
+
+            // this operation becomes expensive with lots of charts
+            if(!b_has_overlays && m_PatchList.GetCount() < 25)
+                m_patch_regions[i].Subtract(m_covered_region);
+        }
+        piqp->ActiveRegion = m_patch_regions[i];
 
         piqp->ActiveRegion.Intersect(cvp_region);
 
@@ -1990,10 +2251,11 @@ bool Quilt::Compose( const ViewPort &vp_in )
             piqp->b_overlay = s57chart::IsCellOverlayType(cte.GetpFullPath());
         }
                 
-        if(!piqp->b_overlay)    
+        if(!piqp->b_overlay && !b_reuse_regions)
             m_covered_region.Union( piqp->quilt_region );
     }
 #else
+    m_covered_region.Clear();
     // this is the old algorithm does the same thing in n^2/2 operations instead of 2*n-1
     for( unsigned int i = 0; i < m_PatchList.GetCount(); i++ ) {
         wxPatchListNode *pcinode = m_PatchList.Item(i);
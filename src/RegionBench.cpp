@@ -0,0 +1,203 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  LLRegion boolean operation benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+  #include "wx/wx.h"
+#endif //precompiled headers
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <tuple>
+
+#include "RegionBench.h"
+#include "chartdb.h"
+#include "Quilt.h"
+
+extern ChartDB           *ChartData;
+
+#define BENCH_MAX_CHARTS_PER_VIEW       64
+
+//  Each view is followed by this many, panned east by 1/BENCH_PAN_FRACTION of its width
+#define BENCH_PANS_PER_VIEW             8
+#define BENCH_PAN_FRACTION              32.
+
+//----------------------------------------------------------------------------------
+//      RegionBench Implementation
+//----------------------------------------------------------------------------------
+
+RegionBench::RegionBench()
+{
+}
+
+bool RegionBench::Run( int views )
+{
+    if( !ChartData || !ChartData->IsValid() || !ChartData->GetChartTableEntries() ) {
+        wxLogMessage( _T("RegionBench: the chart database is empty") );
+        return false;
+    }
+
+    //  The chart coverage, built once outside the timed passes
+    for( int i = 0; i < ChartData->GetChartTableEntries(); i++ ) {
+        const ChartTableEntry &cte = ChartData->GetChartTableEntry( i );
+        int n = cte.GetnPlyEntries();
+        if( n < 3 )
+            continue;
+
+        m_chart_regions.push_back( LLRegion( n, cte.GetpPlyTable() ) );
+        m_chart_scales.push_back( cte.GetScale() );
+    }
+
+    //  cm93 and MBTiles charts carry no ply table
+    if( m_chart_regions.empty() ) {
+        wxLogMessage( _T("RegionBench: no chart in the database has a coverage table") );
+        return false;
+    }
+
+    BuildViews( views );
+
+    printf( "RegionBench: %d charts, %d views\n", (int) m_chart_regions.size(), (int) m_views.size() );
+
+    //  The first pass also computes the cached boxes of the chart regions,
+    //  the second is the one to compare with the view class pass
+    RunPass( "first", false );
+    RunPass( "second", false );
+    RunPass( "class", true );
+
+    fflush( stdout );
+    return true;
+}
+
+//  Views centred on the charts in turn, each the size of the chart it is
+//  centred on, alternately panned by a quarter of that, so the views
+//  straddle chart boundaries the way a moving quilt does.  Each is then
+//  panned in small steps, as a drag of the canvas composes the quilt.
+void RegionBench::BuildViews( int views )
+{
+    m_views.clear();
+    size_t nc = m_chart_regions.size();
+    for( int i = 0; i < views; i++ ) {
+        LLBBox box = m_chart_regions[( i * 7919 ) % nc].GetBox();
+        double dlat = ( box.GetMaxLat() - box.GetMinLat() ) / 2.;
+        double dlon = ( box.GetMaxLon() - box.GetMinLon() ) / 2.;
+        double clat = ( box.GetMaxLat() + box.GetMinLat() ) / 2. + ( i & 1 ? dlat / 2. : 0. );
+        double clon = ( box.GetMaxLon() + box.GetMinLon() ) / 2. + ( i & 2 ? dlon / 2. : 0. );
+
+        for( int j = 0; j < BENCH_PANS_PER_VIEW; j++ ) {
+            double pan = j * 2. * dlon / BENCH_PAN_FRACTION;
+            LLBBox view;
+            view.Set( wxMax( clat - dlat, -89. ), clon - dlon + pan, wxMin( clat + dlat, 89. ), clon + dlon + pan );
+            m_views.push_back( view );
+        }
+    }
+}
+
+//  With view_class, the chart regions are first clipped to the view class,
+//  once for each chart and class, as Quilt::Compose does
+void RegionBench::RunPass( const char *name, bool view_class )
+{
+    std::map<std::tuple<size_t, int, int, int>, LLRegion> class_regions;
+
+    double intersect_ms = 0., subtract_ms = 0., union_ms = 0.;
+    long nintersect = 0, nsubtract = 0, nunion = 0;
+
+    LLRegion::ResetStats();
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    for( size_t v = 0; v < m_views.size(); v++ ) {
+        LLRegion vp_region( m_views[v] );
+
+        //  Overlapping charts, largest scale first, as the quilt stacks them
+        std::vector<size_t> stack;
+        for( size_t i = 0; i < m_chart_regions.size(); i++ )
+            if( !m_chart_regions[i].IntersectOut( m_views[v] ) )
+                stack.push_back( i );
+        std::sort( stack.begin(), stack.end(), [this]( size_t a, size_t b )
+                   { return m_chart_scales[a] < m_chart_scales[b]; } );
+        if( stack.size() > BENCH_MAX_CHARTS_PER_VIEW )
+            stack.resize( BENCH_MAX_CHARTS_PER_VIEW );
+
+        QuiltViewClass vc;
+        vc.valid = false;
+        if( view_class )
+            vc = Quilt::GetViewClass( m_views[v] );
+
+        LLRegion covered;
+        for( size_t i = 0; i < stack.size(); i++ ) {
+            std::chrono::steady_clock::time_point ta = std::chrono::steady_clock::now();
+            const LLRegion *chart_region = &m_chart_regions[stack[i]];
+            if( vc.valid ) {
+                std::tuple<size_t, int, int, int> key( stack[i], vc.level, vc.ilat, vc.ilon );
+                std::map<std::tuple<size_t, int, int, int>, LLRegion>::iterator it = class_regions.find( key );
+                if( it == class_regions.end() ) {
+                    LLRegion region = *chart_region;
+                    region.Intersect( vc.region );
+                    it = class_regions.insert( std::make_pair( key, region ) ).first;
+                }
+                chart_region = &it->second;
+            }
+            LLRegion patch = *chart_region;
+            patch.Intersect( vp_region );
+            std::chrono::steady_clock::time_point tb = std::chrono::steady_clock::now();
+            patch.Subtract( covered );
+            std::chrono::steady_clock::time_point tc = std::chrono::steady_clock::now();
+            covered.Union( patch );
+            std::chrono::steady_clock::time_point td = std::chrono::steady_clock::now();
+
+            intersect_ms += std::chrono::duration<double, std::milli>( tb - ta ).count();
+            subtract_ms += std::chrono::duration<double, std::milli>( tc - tb ).count();
+            union_ms += std::chrono::duration<double, std::milli>( td - tc ).count();
+            nintersect++; nsubtract++; nunion++;
+        }
+    }
+
+    std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - t0;
+    LLRegionStats stats = LLRegion::GetStats();
+
+    wxString report;
+    report.Printf( _T("RegionBench: %-8s total %9.2f ms  per view %7.3f ms\n"),
+                   wxString( name, wxConvUTF8 ).c_str(), total.count(),
+                   m_views.size() ? total.count() / m_views.size() : 0. );
+
+    wxString s;
+    s.Printf( _T("  intersect %9.2f ms  %6ld calls  %8.4f ms/call\n"), intersect_ms, nintersect,
+              nintersect ? intersect_ms / nintersect : 0. );
+    report += s;
+    s.Printf( _T("  subtract  %9.2f ms  %6ld calls  %8.4f ms/call\n"), subtract_ms, nsubtract,
+              nsubtract ? subtract_ms / nsubtract : 0. );
+    report += s;
+    s.Printf( _T("  union     %9.2f ms  %6ld calls  %8.4f ms/call\n"), union_ms, nunion,
+              nunion ? union_ms / nunion : 0. );
+    report += s;
+    s.Printf( _T("  ops %ld  trivial %ld  rect %ld  clipped %ld\n"),
+              stats.ops, stats.trivial, stats.rect, stats.clipped );
+    report += s;
+
+    printf( "%s", (const char *) report.mb_str() );
+    wxLogMessage( report );
+}
@@ -0,0 +1,468 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 render benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+  #include "wx/wx.h"
+#endif //precompiled headers
+
+#include <wx/textfile.h>
+#include <wx/tokenzr.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "dychart.h"
+#include "georef.h"
+#include "RenderBench.h"
+#include "s57chart.h"
+#include "chart1.h"
+#include "chcanv.h"
+#include "OCPNRegion.h"
+
+#ifdef ocpnUSE_GL
+#include "glChartCanvas.h"
+#endif
+
+extern s52plib           *ps52plib;
+extern ColorScheme       global_color_scheme;
+
+#ifdef ocpnUSE_GL
+extern PFNGLGENFRAMEBUFFERSEXTPROC         s_glGenFramebuffers;
+extern PFNGLGENRENDERBUFFERSEXTPROC        s_glGenRenderbuffers;
+extern PFNGLBINDFRAMEBUFFEREXTPROC         s_glBindFramebuffer;
+extern PFNGLFRAMEBUFFERRENDERBUFFEREXTPROC s_glFramebufferRenderbuffer;
+extern PFNGLRENDERBUFFERSTORAGEEXTPROC     s_glRenderbufferStorage;
+extern PFNGLBINDRENDERBUFFEREXTPROC        s_glBindRenderbuffer;
+extern PFNGLDELETEFRAMEBUFFERSEXTPROC      s_glDeleteFramebuffers;
+extern PFNGLDELETERENDERBUFFERSEXTPROC     s_glDeleteRenderbuffers;
+#endif
+
+#define BENCH_DEFAULT_WIDTH     1280
+#define BENCH_DEFAULT_HEIGHT    800
+#define BENCH_DEFAULT_PPM       3779.5          // display pixels per meter at 96 dpi, with no canvas
+
+//----------------------------------------------------------------------------------
+//      RenderBench Implementation
+//----------------------------------------------------------------------------------
+
+RenderBench::RenderBench()
+{
+    m_cc = NULL;
+    m_bGL = false;
+    m_width = BENCH_DEFAULT_WIDTH;
+    m_height = BENCH_DEFAULT_HEIGHT;
+    m_lat = m_lon = 0.;
+    m_scale = 50000.;
+    m_rotation = 0.;
+#ifdef ocpnUSE_GL
+    m_fbo = m_color_rb = m_depth_rb = 0;
+    m_fbo_width = m_fbo_height = 0;
+#endif
+}
+
+RenderBench::~RenderBench()
+{
+#ifdef ocpnUSE_GL
+    DeleteFBO();
+#endif
+    for( size_t i = 0; i < m_charts.size(); i++ )
+        delete m_charts[i];
+}
+
+bool RenderBench::Run( const wxString &script_file, ChartCanvas *cc )
+{
+    if( !ps52plib || !ps52plib->m_bOK ) {
+        wxLogMessage( _T("RenderBench: S52 presentation library is not available") );
+        return false;
+    }
+
+    wxTextFile script;
+    if( !script.Open( script_file ) ) {
+        wxLogMessage( _T("RenderBench: cannot open script ") + script_file );
+        return false;
+    }
+
+    m_cc = cc;
+    m_frame_ms.clear();
+    ps52plib->GetRenderStats().Clear();
+    ps52plib->EnableRenderStats( true );
+
+    bool bret = true;
+    for( size_t i = 0; i < script.GetLineCount(); i++ ) {
+        wxString line = script[i].BeforeFirst( '#' ).Trim().Trim( false );
+        if( line.IsEmpty() )
+            continue;
+
+        if( !RunCommand( line ) ) {
+            wxLogMessage( _T("RenderBench: failed at \"") + line + _T("\"") );
+            bret = false;
+            break;
+        }
+    }
+
+    ps52plib->EnableRenderStats( false );
+
+#ifdef ocpnUSE_GL
+    //  While the canvas context is still current
+    DeleteFBO();
+#endif
+
+    Report();
+
+    return bret;
+}
+
+bool RenderBench::RunCommand( const wxString &line )
+{
+    wxArrayString args = wxStringTokenize( line, _T(" \t") );
+    wxString cmd = args[0].Lower();
+
+    if( cmd == _T("cell") ) {
+        if( args.GetCount() < 2 )
+            return false;
+        return LoadCell( line.AfterFirst( ' ' ).Trim( false ) );
+    }
+
+    if( cmd == _T("mode") ) {
+        if( args.GetCount() < 2 )
+            return false;
+        m_bGL = args[1].Lower() == _T("gl");
+#ifdef ocpnUSE_GL
+        if( m_bGL && ( !m_cc || !m_cc->GetglCanvas() || !m_cc->GetglCanvas()->GetContext() ) ) {
+            wxLogMessage( _T("RenderBench: OpenGL is not active") );
+            return false;
+        }
+        if( m_bGL && !s_glGenFramebuffers ) {
+            wxLogMessage( _T("RenderBench: OpenGL framebuffer objects are not available") );
+            return false;
+        }
+#else
+        if( m_bGL )
+            return false;
+#endif
+        return true;
+    }
+
+    if( cmd == _T("scheme") ) {
+        if( args.GetCount() < 2 )
+            return false;
+        SetColorScheme( args[1].Upper() );
+        return RenderFrame();
+    }
+
+    double a = 0., b = 0., c = 0.;
+    if( args.GetCount() > 1 ) args[1].ToDouble( &a );
+    if( args.GetCount() > 2 ) args[2].ToDouble( &b );
+    if( args.GetCount() > 3 ) args[3].ToDouble( &c );
+
+    if( cmd == _T("size") ) {
+        if( ( a < 1. ) || ( b < 1. ) )
+            return false;
+        m_width = (int) a;
+        m_height = (int) b;
+        return true;
+    }
+
+    if( cmd == _T("view") ) {
+        if( c <= 0. )
+            return false;
+        m_lat = a;
+        m_lon = b;
+        m_scale = c;
+        return RenderFrame();
+    }
+
+    if( cmd == _T("pan") || cmd == _T("zoom") || cmd == _T("rotate") ) {
+        int frames = (int) ( ( cmd == _T("pan") ) ? c : b );
+        for( int i = 0; i < frames; i++ ) {
+            if( cmd == _T("pan") ) {
+                //  Screen pixels to degrees, at the current scale
+                double ppm = ( m_cc ? m_cc->GetCanvasScaleFactor() : BENCH_DEFAULT_PPM ) / m_scale;
+                double dlat = ( b / ppm ) / ( 1852. * 60. );
+                m_lat -= dlat;
+                m_lon += ( a / ppm ) / ( 1852. * 60. * cos( m_lat * PI / 180. ) );
+            } else if( cmd == _T("zoom") ) {
+                if( a <= 0. )
+                    return false;
+                m_scale /= a;
+            } else
+                m_rotation += a;
+
+            if( !RenderFrame() )
+                return false;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool RenderBench::LoadCell( const wxString &file )
+{
+    if( !wxFileName::FileExists( file ) )
+        return false;
+
+    //  Read the header first, for the extents a fresh SENC build needs
+    s57chart hdr;
+    if( hdr.Init( file, HEADER_ONLY ) != INIT_OK )
+        return false;
+
+    Extent ext;
+    hdr.GetChartExtent( &ext );
+
+    s57chart *chart = new s57chart;
+    chart->SetNativeScale( hdr.GetNativeScale() );
+    chart->SetFullExtent( ext );
+    chart->DisableBackgroundSENC();             // build the SENC now, on this thread
+
+    wxStopWatch sw;
+    if( chart->Init( file, FULL_INIT ) != INIT_OK ) {
+        delete chart;
+        return false;
+    }
+    chart->SetColorScheme( global_color_scheme );
+
+    wxString msg;
+    msg.Printf( _T("RenderBench: loaded %s in %ld ms"), file.c_str(), sw.Time() );
+    wxLogMessage( msg );
+
+    m_charts.push_back( chart );
+
+    if( m_charts.size() == 1 ) {
+        m_lat = ( ext.NLAT + ext.SLAT ) / 2.;
+        m_lon = ( ext.WLON + ext.ELON ) / 2.;
+        m_scale = hdr.GetNativeScale();
+    }
+
+    return true;
+}
+
+void RenderBench::SetColorScheme( const wxString &name )
+{
+    ColorScheme cs = GLOBAL_COLOR_SCHEME_DAY;
+    if( name == _T("DUSK") )
+        cs = GLOBAL_COLOR_SCHEME_DUSK;
+    else if( name == _T("NIGHT") )
+        cs = GLOBAL_COLOR_SCHEME_NIGHT;
+
+    ps52plib->SetPLIBColorScheme( cs );
+    for( size_t i = 0; i < m_charts.size(); i++ )
+        m_charts[i]->SetColorScheme( cs );
+}
+
+ViewPort RenderBench::MakeViewPort( void )
+{
+    ViewPort vp;
+    vp.clat = m_lat;
+    vp.clon = m_lon;
+    vp.chart_scale = m_scale;
+    vp.ref_scale = m_scale;
+    vp.view_scale_ppm = ( m_cc ? m_cc->GetCanvasScaleFactor() : BENCH_DEFAULT_PPM ) / m_scale;
+    vp.skew = 0.;
+    vp.rotation = m_rotation * PI / 180.;
+    vp.pix_width = m_width;
+    vp.pix_height = m_height;
+    vp.rv_rect = wxRect( 0, 0, m_width, m_height );
+    vp.b_quilt = false;
+    vp.m_projection_type = PROJECTION_MERCATOR;
+    vp.SetBoxes();
+    vp.Validate();
+    return vp;
+}
+
+bool RenderBench::RenderFrame( void )
+{
+    ViewPort vp = MakeViewPort();
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+#ifdef ocpnUSE_GL
+    if( m_bGL ) {
+        if( !RenderFrameGL( vp ) )
+            return false;
+    }
+    else
+#endif
+    {
+        wxBitmap bmp( m_width, m_height );
+        wxMemoryDC dc( bmp );
+        OCPNRegion region( 0, 0, m_width, m_height );
+
+        for( size_t i = 0; i < m_charts.size(); i++ )
+            m_charts[i]->RenderRegionViewOnDC( dc, vp, region );
+
+        dc.SelectObject( wxNullBitmap );
+    }
+
+    std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - t0;
+    m_frame_ms.push_back( t.count() );
+    return true;
+}
+
+#ifdef ocpnUSE_GL
+//  The loaded cells into the offscreen framebuffer, as glChartCanvas renders a single chart
+bool RenderBench::RenderFrameGL( ViewPort &vp )
+{
+    glChartCanvas *glcc = m_cc->GetglCanvas();
+    wxGLContext *context = glcc->GetContext();
+    glcc->SetCurrent( *context );
+
+    if( ( m_fbo_width != m_width || m_fbo_height != m_height ) && !BuildFBO() )
+        return false;
+
+    GLint viewport_save[4];
+    glGetIntegerv( GL_VIEWPORT, viewport_save );
+    ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, m_fbo );
+
+    glViewport( 0, 0, m_width, m_height );
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho( 0, m_width, m_height, 0, -1, 1 );
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+
+    GLbitfield mask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+    if( glChartCanvas::s_b_useStencil ) {
+        glStencilMask( 0xff );
+        mask |= GL_STENCIL_BUFFER_BIT;
+    }
+    glClear( mask );
+
+    OCPNRegion rect_region( 0, 0, m_width, m_height );
+    LLRegion region( vp.GetBBox() );
+    for( size_t i = 0; i < m_charts.size(); i++ )
+        m_charts[i]->RenderRegionViewOnGL( *context, vp, rect_region, region );
+
+    glFinish();
+
+    ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, 0 );
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+    glPopMatrix();
+    glViewport( viewport_save[0], viewport_save[1], viewport_save[2], viewport_save[3] );
+    return true;
+}
+
+//  Color and depth/stencil renderbuffers of the script size
+bool RenderBench::BuildFBO( void )
+{
+    DeleteFBO();
+
+    glGetError();       // clear any earlier error
+
+    ( s_glGenFramebuffers )( 1, &m_fbo );
+    ( s_glGenRenderbuffers )( 1, &m_color_rb );
+    ( s_glGenRenderbuffers )( 1, &m_depth_rb );
+
+    ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, m_fbo );
+
+    ( s_glBindRenderbuffer )( GL_RENDERBUFFER_EXT, m_color_rb );
+    ( s_glRenderbufferStorage )( GL_RENDERBUFFER_EXT, GL_RGBA8, m_width, m_height );
+    ( s_glFramebufferRenderbuffer )( GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
+                                     GL_RENDERBUFFER_EXT, m_color_rb );
+
+    ( s_glBindRenderbuffer )( GL_RENDERBUFFER_EXT, m_depth_rb );
+    if( glChartCanvas::s_b_useStencil ) {
+        ( s_glRenderbufferStorage )( GL_RENDERBUFFER_EXT, GL_DEPTH24_STENCIL8_EXT, m_width, m_height );
+        ( s_glFramebufferRenderbuffer )( GL_FRAMEBUFFER_EXT, GL_STENCIL_ATTACHMENT_EXT,
+                                         GL_RENDERBUFFER_EXT, m_depth_rb );
+    } else
+        ( s_glRenderbufferStorage )( GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT24, m_width, m_height );
+    ( s_glFramebufferRenderbuffer )( GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT,
+                                     GL_RENDERBUFFER_EXT, m_depth_rb );
+
+    ( s_glBindRenderbuffer )( GL_RENDERBUFFER_EXT, 0 );
+    ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, 0 );
+
+    int err = glGetError();
+    if( err ) {
+        wxString msg;
+        msg.Printf( _T("RenderBench: framebuffer error %08X at %dx%d"), err, m_width, m_height );
+        wxLogMessage( msg );
+        DeleteFBO();
+        return false;
+    }
+
+    m_fbo_width = m_width;
+    m_fbo_height = m_height;
+    return true;
+}
+
+void RenderBench::DeleteFBO( void )
+{
+    if( !m_fbo )
+        return;
+
+    ( s_glDeleteFramebuffers )( 1, &m_fbo );
+    ( s_glDeleteRenderbuffers )( 1, &m_color_rb );
+    ( s_glDeleteRenderbuffers )( 1, &m_depth_rb );
+    m_fbo = m_color_rb = m_depth_rb = 0;
+    m_fbo_width = m_fbo_height = 0;
+}
+#endif
+
+void RenderBench::Report( void )
+{
+    static const char *stage_names[S52_STAGE_NUM] = { "rules", "areas", "lines", "symbols", "text" };
+
+    wxString report;
+    size_t n = m_frame_ms.size();
+    report.Printf( _T("RenderBench: %s, %d cells, %d frames\n"),
+                   m_bGL ? _T("GL") : _T("DC"), (int) m_charts.size(), (int) n );
+
+    if( n ) {
+        std::vector<double> sorted = m_frame_ms;
+        std::sort( sorted.begin(), sorted.end() );
+
+        double total = 0.;
+        for( size_t i = 0; i < n; i++ )
+            total += sorted[i];
+
+        wxString s;
+        s.Printf( _T("  frame ms: mean %.2f  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n"),
+                  total / n, sorted[n / 2], sorted[( n * 90 ) / 100], sorted[( n * 99 ) / 100],
+                  sorted[n - 1] );
+        report += s;
+
+        S52RenderStats &stats = ps52plib->GetRenderStats();
+        for( int i = 0; i < S52_STAGE_NUM; i++ ) {
+            s.Printf( _T("  %-8s total %9.2f ms  per frame %7.2f ms  calls %ld\n"),
+                      wxString( stage_names[i], wxConvUTF8 ).c_str(),
+                      stats.usec[i] / 1000., stats.usec[i] / 1000. / n, stats.calls[i] );
+            report += s;
+        }
+    }
+
+    printf( "%s", (const char *) report.mb_str() );
+    fflush( stdout );
+
+    wxLogMessage( report );
+}
@@ -39,6 +39,10 @@
 #include "Select.h"
 #include "chart1.h"
 
+#ifdef ocpnUSE_GL
+#include "TexFont.h"
+#endif
+
 extern WayPointman  *pWayPointMan;
 extern bool         g_bIsNewLayer;
 extern int          g_LayerIdx;
@@ -95,8 +99,6 @@ RoutePoint::RoutePoint()
     m_SelectNode = NULL;
     m_ManagerNode = NULL;
 
-    m_iTextTexture = 0;
-
     m_HyperlinkList = new HyperlinkList;
 
     m_GUID = pWayPointMan->CreateGUID( this );
@@ -438,12 +440,6 @@ void RoutePoint::SetCreateTime( wxDateTime dt )
 
 void RoutePoint::SetName(const wxString & name)
 {
-#ifdef ocpnUSE_GL
-    if(m_iTextTexture){
-        glDeleteTextures(1,&m_iTextTexture);
-        m_iTextTexture = 0;
-    }
-#endif
     m_MarkName = name;
     CalculateNameExtents();
 }
@@ -503,8 +499,6 @@ void RoutePoint::ReLoadIcon( void )
 
 #ifdef ocpnUSE_GL
     m_wpBBox_view_scale_ppm = -1;
-
-    m_iTextTexture = 0;
 #endif
 
     m_IconScaleFactor = -1;             // Force scaled icon reload
@@ -873,64 +867,8 @@ void RoutePoint::DrawGL( ViewPort &vp, ChartCanvas *canvas, bool use_cached_scre
     }
 
     if( m_bShowName && m_pMarkFont ) {
-        int w = m_NameExtents.x, h = m_NameExtents.y;
-        if(!m_iTextTexture && w && h) {
-            wxBitmap tbm(w, h); /* render text on dc */
-            wxMemoryDC dc;
-            dc.SelectObject( tbm );
-            dc.SetBackground( wxBrush( *wxBLACK ) );
-            dc.Clear();
-            dc.SetFont( *m_pMarkFont );
-            dc.SetTextForeground( *wxWHITE );
-            dc.DrawText( m_MarkName, 0, 0);
-            dc.SelectObject( wxNullBitmap );
-
-            /* make alpha texture for text */
-            wxImage image = tbm.ConvertToImage();
-            unsigned char *d = image.GetData();
-            unsigned char *e = new unsigned char[w * h];
-            if(d && e){
-                for( int p = 0; p < w*h; p++)
-                    e[p] = d[3*p + 0];
-            }
-
-            /* create texture for rendered text */
-            glGenTextures(1, &m_iTextTexture);
-            glBindTexture(GL_TEXTURE_2D, m_iTextTexture);
-
-            glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-            glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
-
-            m_iTextTextureWidth = NextPow2(w);
-            m_iTextTextureHeight = NextPow2(h);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_iTextTextureWidth, m_iTextTextureHeight,
-                         0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h,
-                            GL_ALPHA, GL_UNSIGNED_BYTE, e);
-            delete [] e;
-        }
-
-        if(m_iTextTexture) {
-            /* draw texture with text */
-            glBindTexture(GL_TEXTURE_2D, m_iTextTexture);
-
-            glEnable(GL_TEXTURE_2D);
-            glEnable(GL_BLEND);
-
-            glColor3ub(m_FontColor.Red(), m_FontColor.Green(), m_FontColor.Blue());
-
-            int x = r.x + m_NameLocationOffsetX, y = r.y + m_NameLocationOffsetY;
-            float u = (float)w/m_iTextTextureWidth, v = (float)h/m_iTextTextureHeight;
-            glBegin(GL_QUADS);
-            glTexCoord2f(0, 0); glVertex2f(x, y);
-            glTexCoord2f(u, 0); glVertex2f(x+w, y);
-            glTexCoord2f(u, v); glVertex2f(x+w, y+h);
-            glTexCoord2f(0, v); glVertex2f(x, y+h);
-            glEnd();
-
-            glDisable(GL_BLEND);
-            glDisable(GL_TEXTURE_2D);
-        }
+        int x = r.x + m_NameLocationOffsetX, y = r.y + m_NameLocationOffsetY;
+        TexFontAtlas::Get().AddString( *m_pMarkFont, m_MarkName, x, y, m_FontColor );
     }
 
     // Draw waypoint radar rings if activated
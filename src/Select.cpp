@@ -220,20 +220,17 @@ bool Select::AddAllSelectableTrackSegments( Track *pr )
     float slat1, slon1, slat2, slon2;
 
     if( pr->GetnPoints() ) {
-        TrackPoint *prp0 = pr->GetPoint(0);
-        slat1 = prp0->m_lat;
-        slon1 = prp0->m_lon;
+        slat1 = pr->GetPointLat(0);
+        slon1 = pr->GetPointLon(0);
 
         for(int i=1; i<pr->GetnPoints(); i++) {
-            TrackPoint *prp = pr->GetPoint(i);
-            slat2 = prp->m_lat;
-            slon2 = prp->m_lon;
+            slat2 = pr->GetPointLat(i);
+            slon2 = pr->GetPointLon(i);
 
-            AddSelectableTrackSegment( slat1, slon1, slat2, slon2, prp0, prp, pr );
+            AddSelectableTrackSegment( slat1, slon1, slat2, slon2, i - 1, i, pr );
 
             slat1 = slat2;
             slon1 = slon2;
-            prp0 = prp;
         }
         return true;
     } else
@@ -397,8 +394,9 @@ bool Select::ModifySelectablePoint( float lat, float lon, void *data, int Seltyp
     return false;
 }
 
+//  Track segments refer to their end points by index into the track, in m_Data4 and m_Data5
 bool Select::AddSelectableTrackSegment( float slat1, float slon1, float slat2, float slon2,
-        TrackPoint *pTrackPointAdd1, TrackPoint *pTrackPointAdd2, Track *pTrack )
+        int nTrackPoint1, int nTrackPoint2, Track *pTrack )
 {
     SelectItem *pSelItem = new SelectItem;
     pSelItem->m_slat = slat1;
@@ -407,9 +405,11 @@ bool Select::AddSelectableTrackSegment( float slat1, float slon1, float slat2, f
     pSelItem->m_slon2 = slon2;
     pSelItem->m_seltype = SELTYPE_TRACKSEGMENT;
     pSelItem->m_bIsSelected = false;
-    pSelItem->m_pData1 = pTrackPointAdd1;
-    pSelItem->m_pData2 = pTrackPointAdd2;
+    pSelItem->m_pData1 = NULL;
+    pSelItem->m_pData2 = NULL;
     pSelItem->m_pData3 = pTrack;
+    pSelItem->m_Data4 = nTrackPoint1;
+    pSelItem->m_Data5 = nTrackPoint2;
 
     if( pTrack->m_bIsInLayer ) pSelectList->Append( pSelItem );
     else
@@ -441,7 +441,7 @@ bool Select::DeleteAllSelectableTrackSegments( Track *pt )
     return true;
 }
 
-bool Select::DeletePointSelectableTrackSegments( TrackPoint *pt )
+bool Select::DeletePointSelectableTrackSegments( Track *pTrack, int nTrackPoint )
 {
     SelectItem *pFindSel;
 
@@ -450,9 +450,9 @@ bool Select::DeletePointSelectableTrackSegments( TrackPoint *pt )
 
     while( node ) {
         pFindSel = node->GetData();
-        if( pFindSel->m_seltype == SELTYPE_TRACKSEGMENT &&
-            ( (TrackPoint *) pFindSel->m_pData1 == pt ||
-              (TrackPoint *) pFindSel->m_pData2 == pt ) ) {
+        if( pFindSel->m_seltype == SELTYPE_TRACKSEGMENT && (Track *) pFindSel->m_pData3 == pTrack &&
+            ( pFindSel->m_Data4 == nTrackPoint ||
+              pFindSel->m_Data5 == nTrackPoint ) ) {
                 delete pFindSel;
                 wxSelectableItemListNode *d = node;
                 node = node->GetNext();
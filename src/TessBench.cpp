@@ -0,0 +1,230 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Area tesselation benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+  #include "wx/wx.h"
+#endif //precompiled headers
+
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <wx/thread.h>
+
+#include <math.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "TessBench.h"
+#include "Osenc.h"
+#include "mygeom.h"
+
+extern int               g_nTessBackend;
+extern int               g_nCPUCount;
+
+#define BENCH_PASSES            3
+
+//----------------------------------------------------------------------------------
+//      TessBench Implementation
+//----------------------------------------------------------------------------------
+
+TessBench::TessBench()
+{
+}
+
+TessBench::~TessBench()
+{
+    for( size_t i = 0; i < m_polys.size(); i++ )
+        delete m_polys[i];
+}
+
+bool TessBench::Run( const wxString &dir )
+{
+    wxArrayString files;
+    if( !wxDir::Exists( dir ) || !wxDir::GetAllFiles( dir, &files, _T("*.000") ) ) {
+        wxLogMessage( _T("TessBench: no ENC cells in ") + dir );
+        return false;
+    }
+
+    //  The area geometry of all cells, read once outside the timed passes
+    wxString working_dir = wxFileName::GetTempDir();
+    long nvertex = 0;
+    for( unsigned int i = 0; i < files.GetCount(); i++ ) {
+        std::vector<OGRPolygon *> polys;
+        Osenc senc;
+        if( senc.readAreaGeometry( files[i], working_dir, polys ) != SENC_NO_ERROR ) {
+            wxLogMessage( _T("TessBench: cannot read ") + files[i] );
+            continue;
+        }
+
+        //  SENC creation tesselates relative to the cell centre
+        OGREnvelope cell_env;
+        for( size_t j = 0; j < polys.size(); j++ ) {
+            OGREnvelope env;
+            polys[j]->getEnvelope( &env );
+            cell_env.Merge( env );
+
+            nvertex += polys[j]->getExteriorRing()->getNumPoints();
+            for( int k = 0; k < polys[j]->getNumInteriorRings(); k++ )
+                nvertex += polys[j]->getInteriorRing( k )->getNumPoints();
+        }
+
+        for( size_t j = 0; j < polys.size(); j++ ) {
+            m_polys.push_back( polys[j] );
+            m_ref_lat.push_back( ( cell_env.MinY + cell_env.MaxY ) / 2. );
+            m_ref_lon.push_back( ( cell_env.MinX + cell_env.MaxX ) / 2. );
+        }
+    }
+
+    if( m_polys.empty() ) {
+        wxLogMessage( _T("TessBench: no area features in ") + dir );
+        return false;
+    }
+
+    int nCPU = wxMax( 1, wxThread::GetCPUCount() );
+    if( g_nCPUCount > 0 )
+        nCPU = g_nCPUCount;
+
+    wxString report;
+    report.Printf( _T("TessBench: %d cells, %d area features, %ld vertices\n"),
+                   (int) files.GetCount(), (int) m_polys.size(), nvertex );
+
+    static const int backends[2] = { TESS_BACKEND_GLU, TESS_BACKEND_LIBTESS2 };
+    static const char *backend_names[2] = { "GLU", "libtess2" };
+    int current_backend = g_nTessBackend;
+    double reference_area = 0.;
+
+    for( int b = 0; b < 2; b++ ) {
+        int threads[2] = { 1, nCPU };
+        for( int t = 0; t < ( nCPU > 1 ? 2 : 1 ); t++ ) {
+            Result best = RunPass( backends[b], threads[t] );
+            for( int pass = 1; pass < BENCH_PASSES; pass++ ) {
+                Result r = RunPass( backends[b], threads[t] );
+                if( r.ms < best.ms )
+                    best = r;
+            }
+
+            if( b == 0 && t == 0 )
+                reference_area = best.area;
+
+            wxString s;
+            s.Printf( _T("  %-8s %2d threads  %9.2f ms  %8ld triangles  %10.0f triangles/s  failed %ld  area %+.4f%%\n"),
+                      wxString( backend_names[b], wxConvUTF8 ).c_str(), threads[t], best.ms, best.triangles,
+                      best.ms > 0. ? best.triangles * 1000. / best.ms : 0., best.failed,
+                      reference_area > 0. ? ( best.area - reference_area ) * 100. / reference_area : 0. );
+            report += s;
+        }
+    }
+    g_nTessBackend = current_backend;
+
+    printf( "%s", (const char *) report.mb_str() );
+    fflush( stdout );
+
+    wxLogMessage( report );
+
+    return true;
+}
+
+//  One pass over all the area features, as SENC creation builds them.
+//  Only the tesselation is timed, the results are measured and freed after.
+TessBench::Result TessBench::RunPass( int backend, int nThreads )
+{
+    g_nTessBackend = backend;
+
+    size_t n = m_polys.size();
+    std::vector<PolyTessGeo *> tess( n );
+
+    std::atomic<size_t> next( 0 );
+    auto worker = [this, &tess, &next, n]() {
+        size_t i;
+        while( ( i = next++ ) < n )
+            tess[i] = new PolyTessGeo( m_polys[i], true, m_ref_lat[i], m_ref_lon[i], 0 );
+    };
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for( int i = 1; i < nThreads; i++ )
+        pool.push_back( std::thread( worker ) );
+    worker();
+    for( size_t i = 0; i < pool.size(); i++ )
+        pool[i].join();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - t0;
+
+    Result r;
+    r.ms = elapsed.count();
+    r.triangles = 0;
+    r.failed = 0;
+    r.area = 0.;
+    for( size_t i = 0; i < n; i++ ) {
+        if( tess[i]->ErrorCode || !tess[i]->Get_PolyTriGroup_head() )
+            r.failed++;
+        else
+            Measure( tess[i], r.triangles, r.area );
+        delete tess[i];
+    }
+
+    return r;
+}
+
+//  Triangle count and area of a tesselated feature, in SENC (SM metre) units
+void TessBench::Measure( PolyTessGeo *ppg, long &triangles, double &area )
+{
+    PolyTriGroup *ppt = ppg->Get_PolyTriGroup_head();
+    bool b_double = ( ppt->data_type == DATA_TYPE_DOUBLE );
+
+    for( TriPrim *p_tp = ppt->tri_prim_head; p_tp; p_tp = p_tp->p_next ) {
+        int nv = p_tp->nVert;
+        std::vector<double> v( nv * 2 );
+        for( int i = 0; i < nv * 2; i++ )
+            v[i] = b_double ? p_tp->p_vertex[i] : ( (float *) p_tp->p_vertex )[i];
+
+        int ntri = 0;
+        switch( p_tp->type ) {
+            case PTG_TRIANGLES:         ntri = nv / 3; break;
+            case PTG_TRIANGLE_STRIP:
+            case PTG_TRIANGLE_FAN:      ntri = wxMax( nv - 2, 0 ); break;
+        }
+
+        for( int k = 0; k < ntri; k++ ) {
+            int a, b, c;
+            if( p_tp->type == PTG_TRIANGLES ) {
+                a = 3 * k; b = a + 1; c = a + 2;
+            } else if( p_tp->type == PTG_TRIANGLE_STRIP ) {
+                a = k; b = k + 1; c = k + 2;
+            } else {
+                a = 0; b = k + 1; c = k + 2;
+            }
+
+            double cross = ( v[b * 2] - v[a * 2] ) * ( v[c * 2 + 1] - v[a * 2 + 1] )
+                         - ( v[c * 2] - v[a * 2] ) * ( v[b * 2 + 1] - v[a * 2 + 1] );
+            area += fabs( cross ) / 2.;
+        }
+        triangles += ntri;
+    }
+}
@@ -274,4 +274,299 @@ void TexFont::RenderString( const wxString &string, int x, int y )
     RenderString((const char*)string.ToUTF8(), x, y);
 }
 
+//----------------------------------------------------------------------------
+//      TexFontAtlas Implementation
+//----------------------------------------------------------------------------
+
+TexFontAtlas &TexFontAtlas::Get()
+{
+    /* never destroyed, the textures go away with the GL context */
+    static TexFontAtlas *s_atlas = new TexFontAtlas;
+    return *s_atlas;
+}
+
+TexFontAtlas::TexFontAtlas()
+{
+    m_last_font = -1;
+    m_batch_depth = 0;
+}
+
+int TexFontAtlas::FindFont( const wxFont &font )
+{
+    if( m_last_font >= 0 && m_fonts[m_last_font].font == font )
+        return m_last_font;
+
+    for( size_t i = 0; i < m_fonts.size(); i++ ) {
+        if( m_fonts[i].font == font ) {
+            m_last_font = i;
+            return m_last_font;
+        }
+    }
+
+    TexAtlasFont f;
+    f.font = font;
+
+    wxScreenDC sdc;
+    wxCoord w, h;
+    sdc.GetTextExtent( _T("A"), &w, &h, NULL, NULL, &f.font );
+    f.line_height = h;
+
+    m_fonts.push_back( f );
+    m_last_font = m_fonts.size() - 1;
+    return m_last_font;
+}
+
+bool TexFontAtlas::Allocate( int w, int h, int &page, int &x, int &y )
+{
+    /* simple shelf packing, glyphs of a font are close in height */
+    if( m_pages.size() ) {
+        TexAtlasPage &p = m_pages.back();
+        if( p.shelf_x + w > ATLAS_PAGE_SIZE ) {
+            p.shelf_y += p.shelf_h;
+            p.shelf_x = 0;
+            p.shelf_h = 0;
+        }
+
+        if( p.shelf_y + h <= ATLAS_PAGE_SIZE ) {
+            page = m_pages.size() - 1;
+            x = p.shelf_x;
+            y = p.shelf_y;
+            p.shelf_x += w;
+            p.shelf_h = wxMax( p.shelf_h, h );
+            return true;
+        }
+    }
+
+    if( m_pages.size() == ATLAS_MAX_PAGES )
+        return false;
+
+    TexAtlasPage p;
+    p.shelf_x = p.shelf_y = p.shelf_h = 0;
+
+    std::vector<unsigned char> blank( ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE, 0 );
+
+    glGenTextures( 1, &p.texobj );
+    glBindTexture( GL_TEXTURE_2D, p.texobj );
+
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_ALPHA, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, 0,
+                  GL_ALPHA, GL_UNSIGNED_BYTE, &blank[0] );
+
+    m_pages.push_back( p );
+
+    return Allocate( w, h, page, x, y );
+}
+
+const TexAtlasGlyph &TexFontAtlas::GetGlyph( int font, unsigned int c )
+{
+    unsigned long long key = ( (unsigned long long) font << 32 ) | c;
+    std::unordered_map<unsigned long long, TexAtlasGlyph>::iterator it = m_glyphs.find( key );
+    if( it != m_glyphs.end() )
+        return it->second;
+
+    wxFont &wfont = m_fonts[font].font;
+    wxString text( (wxUniChar) c );
+
+    wxScreenDC sdc;
+    wxCoord gw, gh;
+    sdc.GetTextExtent( text, &gw, &gh, NULL, NULL, &wfont );
+
+    TexAtlasGlyph g;
+    g.page = -1;
+    g.width = gw;
+    g.height = gh;
+    g.advance = gw;
+    g.u1 = g.v1 = g.u2 = g.v2 = 0;
+
+    /* one pixel border between glyphs */
+    int x, y;
+    if( c != ' ' && gw > 0 && gh > 0 && gw < ATLAS_PAGE_SIZE && gh < ATLAS_PAGE_SIZE ) {
+        if( !Allocate( gw + 1, gh + 1, g.page, x, y ) ) {
+            Reset();                                    // all pages full, start over
+            Allocate( gw + 1, gh + 1, g.page, x, y );
+        }
+
+        wxBitmap bmp( gw, gh );
+        wxMemoryDC dc;
+        dc.SelectObject( bmp );
+        dc.SetFont( wfont );
+
+        /* white text on black, which becomes the alpha channel */
+        dc.SetBackground( wxBrush( wxColour( 0, 0, 0 ) ) );
+        dc.Clear();
+        dc.SetTextForeground( wxColour( 255, 255, 255 ) );
+        dc.DrawText( text, 0, 0 );
+        dc.SelectObject( wxNullBitmap );
+
+        wxImage image = bmp.ConvertToImage();
+        unsigned char *imgdata = image.GetData();
+        if( imgdata ) {
+            std::vector<unsigned char> alpha( gw * gh );
+            for( int j = 0; j < gw * gh; j++ )
+                alpha[j] = imgdata[3 * j];
+
+            glBindTexture( GL_TEXTURE_2D, m_pages[g.page].texobj );
+            glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+            glTexSubImage2D( GL_TEXTURE_2D, 0, x, y, gw, gh, GL_ALPHA, GL_UNSIGNED_BYTE, &alpha[0] );
+            glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+        }
+
+        g.u1 = (float) x / ATLAS_PAGE_SIZE;
+        g.v1 = (float) y / ATLAS_PAGE_SIZE;
+        g.u2 = (float) ( x + gw ) / ATLAS_PAGE_SIZE;
+        g.v2 = (float) ( y + gh ) / ATLAS_PAGE_SIZE;
+    }
+
+    return m_glyphs[key] = g;
+}
+
+void TexFontAtlas::GetTextExtent( const wxFont &font, const wxString &string, int *width, int *height )
+{
+    int f = FindFont( font );
+    int w = 0, h = 0, line_w = 0;
+
+    for( wxString::const_iterator it = string.begin(); it != string.end(); ++it ) {
+        wxUniChar c = *it;
+        if( c == '\n' ) {
+            h += m_fonts[f].line_height;
+            line_w = 0;
+            continue;
+        }
+
+        const TexAtlasGlyph &g = GetGlyph( f, c.GetValue() );
+        line_w += g.advance;
+        w = wxMax( w, line_w );
+        if( g.height > h )
+            h = g.height;
+    }
+
+    if( width ) *width = w;
+    if( height ) *height = h;
+}
+
+void TexFontAtlas::AddString( const wxFont &font, const wxString &string, float x, float y,
+                              const wxColour &colour, float rotation )
+{
+    int f = FindFont( font );
+
+    /* turn by -rotation about x, y, which levels text drawn in a view rotated by rotation */
+    float cr = cosf( rotation ), sr = sinf( rotation );
+    float pen_x = 0, pen_y = 0;
+
+    for( wxString::const_iterator it = string.begin(); it != string.end(); ++it ) {
+        wxUniChar c = *it;
+        if( c == '\n' ) {
+            pen_x = 0;
+            pen_y += m_fonts[f].line_height;
+            continue;
+        }
+
+        const TexAtlasGlyph &g = GetGlyph( f, c.GetValue() );
+
+        if( g.page >= 0 ) {
+            TexAtlasPage &p = m_pages[g.page];
+
+            float qx[4] = { pen_x, pen_x + g.width, pen_x + g.width, pen_x };
+            float qy[4] = { pen_y, pen_y, pen_y + g.height, pen_y + g.height };
+            float qu[4] = { g.u1, g.u2, g.u2, g.u1 };
+            float qv[4] = { g.v1, g.v1, g.v2, g.v2 };
+
+            for( int k = 0; k < 4; k++ ) {
+                p.verts.push_back( x + qx[k] * cr + qy[k] * sr );
+                p.verts.push_back( y - qx[k] * sr + qy[k] * cr );
+                p.verts.push_back( qu[k] );
+                p.verts.push_back( qv[k] );
+
+                p.colors.push_back( colour.Red() );
+                p.colors.push_back( colour.Green() );
+                p.colors.push_back( colour.Blue() );
+                p.colors.push_back( 255 );
+            }
+        }
+
+        pen_x += g.advance;
+    }
+
+    if( !m_batch_depth )
+        Flush();
+}
+
+void TexFontAtlas::EndBatch()
+{
+    if( m_batch_depth && !--m_batch_depth )
+        Flush();
+}
+
+void TexFontAtlas::Flush()
+{
+    bool bpending = false;
+    for( size_t i = 0; i < m_pages.size(); i++ )
+        if( m_pages[i].verts.size() )
+            bpending = true;
+
+    if( !bpending )
+        return;
+
+    glEnable( GL_BLEND );
+    glEnable( GL_TEXTURE_2D );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glEnableClientState( GL_COLOR_ARRAY );
+
+    for( size_t i = 0; i < m_pages.size(); i++ ) {
+        TexAtlasPage &p = m_pages[i];
+        if( p.verts.empty() )
+            continue;
+
+        glBindTexture( GL_TEXTURE_2D, p.texobj );
+
+        glVertexPointer( 2, GL_FLOAT, 4 * sizeof(float), &p.verts[0] );
+        glTexCoordPointer( 2, GL_FLOAT, 4 * sizeof(float), &p.verts[2] );
+        glColorPointer( 4, GL_UNSIGNED_BYTE, 0, &p.colors[0] );
+
+        glDrawArrays( GL_QUADS, 0, p.verts.size() / 4 );
+
+        p.verts.clear();
+        p.colors.clear();
+    }
+
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+
+    glDisable( GL_TEXTURE_2D );
+    glDisable( GL_BLEND );
+}
+
+void TexFontAtlas::Reset()
+{
+    /* queued quads refer to the pages about to be recycled */
+    Flush();
+
+    for( size_t i = 0; i < m_pages.size(); i++ )
+        glDeleteTextures( 1, &m_pages[i].texobj );
+    m_pages.clear();
+    m_glyphs.clear();
+}
+
+void TexFontAtlas::Clear()
+{
+    for( size_t i = 0; i < m_pages.size(); i++ ) {
+        m_pages[i].verts.clear();
+        m_pages[i].colors.clear();
+    }
+
+    Reset();
+
+    m_fonts.clear();
+    m_last_font = -1;
+}
+
 #endif     //#ifdef ocpnUSE_GL
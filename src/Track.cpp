@@ -83,6 +83,7 @@ millions of points.
 #include "chartbase.h"
 #include "navutil.h"
 #include "Select.h"
+#include "NavObjectCollection.h"
 #include "chcanv.h"
 
 #ifdef ocpnUSE_GL
@@ -127,60 +128,53 @@ private:
 WX_DEFINE_LIST ( TrackList );
 
 TrackPoint::TrackPoint(double lat, double lon, wxString ts)
-    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1), m_timestring(NULL)
+    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1), m_time(TRACKPOINT_NO_TIME)
 {
     SetCreateTime(ts);
 }
 
 TrackPoint::TrackPoint(double lat, double lon, wxDateTime dt)
-    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1), m_timestring(NULL)
+    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1), m_time(TRACKPOINT_NO_TIME)
 {
     SetCreateTime(dt);
 }
 
-// Copy Constructor
-TrackPoint::TrackPoint( TrackPoint* orig )
-    : m_lat(orig->m_lat), m_lon(orig->m_lon), m_GPXTrkSegNo(1), m_timestring(NULL)
+wxDateTime TrackPoint::GetCreateTime() const
 {
-    SetCreateTime(orig->GetCreateTime());
+    wxDateTime CreateTimeX;
+
+    if( HasCreateTime() )
+        CreateTimeX = wxDateTime( wxLongLong( m_time ) );
+    return CreateTimeX;
 }
 
-TrackPoint::~TrackPoint()
+//  The time is kept to the second, as it was when stored in GPX form
+void TrackPoint::SetCreateTime( wxDateTime dt )
 {
-    delete [] m_timestring;
+    if(dt.IsValid())
+        m_time = dt.GetValue().GetValue() / 1000 * 1000;
+    else
+        m_time = TRACKPOINT_NO_TIME;
 }
 
-wxDateTime TrackPoint::GetCreateTime()
+void TrackPoint::SetCreateTime( wxString ts )
 {
-    wxDateTime CreateTimeX;
-    
-    if(m_timestring) {
-        wxString ts = m_timestring;
-        ParseGPXDateTime( CreateTimeX, ts );
-    }
-    return CreateTimeX;
+    wxDateTime dt;
+    if(ts.Length())
+        ParseGPXDateTime( dt, ts );
+    SetCreateTime(dt);
 }
 
-void TrackPoint::SetCreateTime( wxDateTime dt )
+wxString TrackPoint::GetTimeString() const
 {
     wxString ts;
+    wxDateTime dt = GetCreateTime();
     if(dt.IsValid())
         ts = dt.FormatISODate().Append(_T("T")).Append(dt.FormatISOTime()).Append(_T("Z"));
-
-    SetCreateTime(ts);
-}
-
-void TrackPoint::SetCreateTime( wxString ts )
-{
-    delete [] m_timestring;
-    if(ts.Length()) {
-        m_timestring = new char[ts.Length()+1];
-        strcpy(m_timestring, ts.mb_str());
-    } else
-        m_timestring = NULL;
+    return ts;
 }
 
-void TrackPoint::Draw(ChartCanvas *cc, ocpnDC& dc )
+void TrackPoint::Draw(ChartCanvas *cc, ocpnDC& dc ) const
 {
     wxPoint r;
     wxRect hilitebox;
@@ -213,6 +207,403 @@ void TrackPoint::Draw(ChartCanvas *cc, ocpnDC& dc )
 
 
 
+//---------------------------------------------------------------------------------
+//    TrackPointArray Implementation
+//---------------------------------------------------------------------------------
+
+void TrackPointArray::reserve( size_t n )
+{
+    lat.reserve( n );
+    lon.reserve( n );
+    time.reserve( n );
+    seg.reserve( n );
+}
+
+void TrackPointArray::clear()
+{
+    lat.clear();
+    lon.clear();
+    time.clear();
+    seg.clear();
+    changed_from = 0;
+}
+
+TrackPoint TrackPointArray::Get( size_t n ) const
+{
+    TrackPoint tp;
+    tp.m_lat = lat[n];
+    tp.m_lon = lon[n];
+    tp.m_time = time[n];
+    tp.m_GPXTrkSegNo = seg[n];
+    return tp;
+}
+
+void TrackPointArray::Set( size_t n, const TrackPoint &tp )
+{
+    lat[n] = tp.m_lat;
+    lon[n] = tp.m_lon;
+    time[n] = tp.m_time;
+    seg[n] = tp.m_GPXTrkSegNo;
+    changed_from = wxMin( changed_from, n );
+}
+
+void TrackPointArray::push_back( const TrackPoint &tp )
+{
+    lat.push_back( tp.m_lat );
+    lon.push_back( tp.m_lon );
+    time.push_back( tp.m_time );
+    seg.push_back( tp.m_GPXTrkSegNo );
+}
+
+void TrackPointArray::erase( size_t n )
+{
+    lat.erase( lat.begin() + n );
+    lon.erase( lon.begin() + n );
+    time.erase( time.begin() + n );
+    seg.erase( seg.begin() + n );
+    changed_from = wxMin( changed_from, n );
+}
+
+void TrackPointArray::pop_back()
+{
+    lat.pop_back();
+    lon.pop_back();
+    time.pop_back();
+    seg.pop_back();
+    changed_from = wxMin( changed_from, lat.size() );
+}
+
+#ifdef ocpnUSE_GL
+//---------------------------------------------------------------------------------
+//    TrackGLGeometry Implementation
+//
+//    A GL copy of a track, kept in buffer objects between frames.  The track is split
+//    into blocks of TRACK_GL_CHUNK line segments, each with its own origin, the first
+//    point of the block, and the vertices of a block are float mercator meters relative
+//    to that origin.  The modelview matrix for a block is built in double from its
+//    origin, so the floats stay small whatever the distance from the start of the track
+//    and panning and zooming upload nothing.  The point shared by two blocks is stored
+//    once in each.  Points appended to the track are added to the end of the buffers,
+//    points edited or deleted truncate them back to the change.
+//
+//    Level 0 draws every vertex.  Each coarser level is an index list keeping only the
+//    vertices at least TRACK_GL_LOD_BASE_METERS * 4^(level-1) from the previous kept
+//    one, and the block end points, and is used once that spacing is under
+//    TRACK_GL_LOD_PIXELS on screen.  Blocks outside the view are skipped.
+//---------------------------------------------------------------------------------
+
+#define TRACK_GL_LOD_LEVELS             6
+#define TRACK_GL_LOD_BASE_METERS        10.
+#define TRACK_GL_LOD_PIXELS             1.
+#define TRACK_GL_CHUNK                  256
+
+extern PFNGLGENBUFFERSPROC              s_glGenBuffers;
+extern PFNGLBINDBUFFERPROC              s_glBindBuffer;
+extern PFNGLBUFFERDATAPROC              s_glBufferData;
+extern PFNGLBUFFERSUBDATAPROC           s_glBufferSubData;
+extern PFNGLDELETEBUFFERSPROC           s_glDeleteBuffers;
+extern bool                             g_b_EnableVBO;
+
+static double TrackMercatorY( double lat )
+{
+    return toSMcache_y30( wxMax( -89.9, wxMin( 89.9, lat ) ) );
+}
+
+class TrackGLGeometry
+{
+public:
+    TrackGLGeometry();
+    ~TrackGLGeometry();
+
+    void Sync( TrackPointArray &points );
+    void Draw( ViewPort &vp, const LLBBox &box );
+
+private:
+    struct Block
+    {
+        double                  lon, y;         // origin, unwrapped degrees and mercator meters
+        LLBBox                  box;            // the segments ending in this block
+    };
+
+    struct Level
+    {
+        Level() : ibo( 0 ), ibo_capacity( 0 ), ibo_uploaded( 0 ) {}
+
+        std::vector<GLuint>     indices;        // vertex slots, empty for level 0
+        std::vector<size_t>     starts;         // first index of each block
+        GLuint                  ibo;
+        size_t                  ibo_capacity, ibo_uploaded;
+    };
+
+    //  Block b holds points b * TRACK_GL_CHUNK to (b + 1) * TRACK_GL_CHUNK
+    static size_t BlockCount( size_t n ) { return n ? ( n - 1 ) / TRACK_GL_CHUNK + 1 : 0; }
+    static size_t SlotCount( size_t n ) { return n ? n + ( n - 1 ) / TRACK_GL_CHUNK : 0; }
+    static size_t Slot( size_t b, size_t i ) { return b * ( TRACK_GL_CHUNK + 1 ) + i - b * TRACK_GL_CHUNK; }
+
+    size_t VertexCount() const { return m_vertices.size() / 2; }
+
+    void Truncate( size_t n, TrackPointArray &points );
+    void AddSegment( size_t i, TrackPointArray &points );
+    void AddVertex( size_t b, size_t i, TrackPointArray &points );
+    void DrawBlock( ViewPort &vp, size_t b, int l, size_t n );
+    static void Upload( GLenum target, GLuint &buffer, size_t &capacity, size_t &uploaded,
+                        const void *data, size_t count, size_t elem_size );
+
+    double              m_last_lon;             // unwrapped longitude of the last point
+    size_t              m_points;
+    std::vector<Block>  m_blocks;
+    std::vector<float>  m_vertices;
+    GLuint              m_vbo;
+    size_t              m_vbo_capacity, m_vbo_uploaded;
+    Level               m_levels[TRACK_GL_LOD_LEVELS];
+};
+
+TrackGLGeometry::TrackGLGeometry()
+{
+    m_last_lon = 0.;
+    m_points = 0;
+    m_vbo = 0;
+    m_vbo_capacity = m_vbo_uploaded = 0;
+}
+
+TrackGLGeometry::~TrackGLGeometry()
+{
+    if( m_vbo )
+        s_glDeleteBuffers( 1, &m_vbo );
+    for( int l = 0; l < TRACK_GL_LOD_LEVELS; l++ )
+        if( m_levels[l].ibo )
+            s_glDeleteBuffers( 1, &m_levels[l].ibo );
+}
+
+//  Drop everything from point n on, the box of the new last block is rebuilt
+void TrackGLGeometry::Truncate( size_t n, TrackPointArray &points )
+{
+    const double mult = DEGREE * WGS84_semimajor_axis_meters * mercator_k0;
+
+    size_t slots = SlotCount( n );
+    size_t blocks = BlockCount( n );
+    m_points = n;
+    m_vertices.resize( 2 * slots );
+    m_vbo_uploaded = wxMin( m_vbo_uploaded, slots );
+    m_blocks.resize( blocks );
+
+    for( int l = 1; l < TRACK_GL_LOD_LEVELS; l++ ) {
+        Level &level = m_levels[l];
+        while( level.indices.size() && level.indices.back() >= slots )
+            level.indices.pop_back();
+        level.starts.resize( blocks );
+        level.ibo_uploaded = wxMin( level.ibo_uploaded, level.indices.size() );
+    }
+
+    if( !blocks )
+        return;
+
+    Block &block = m_blocks.back();
+    block.box = LLBBox();
+    for( size_t i = ( blocks - 1 ) * TRACK_GL_CHUNK + 1; i < n; i++ )
+        AddSegment( i, points );
+
+    m_last_lon = block.lon + m_vertices[2 * ( slots - 1 )] / mult;
+}
+
+//  Expand the box of the block holding the segment ending at point i
+void TrackGLGeometry::AddSegment( size_t i, TrackPointArray &points )
+{
+    LLBBox segment;
+    segment.SetFromSegment( points.lat[i - 1], points.lon[i - 1], points.lat[i], points.lon[i] );
+
+    LLBBox &box = m_blocks[( i - 1 ) / TRACK_GL_CHUNK].box;
+    if( box.GetValid() )
+        box.Expand( segment );
+    else
+        box = segment;
+}
+
+//  Point i, relative to the origin of block b, at its slot in that block
+void TrackGLGeometry::AddVertex( size_t b, size_t i, TrackPointArray &points )
+{
+    const double mult = DEGREE * WGS84_semimajor_axis_meters * mercator_k0;
+    const Block &block = m_blocks[b];
+
+    m_vertices.push_back( ( m_last_lon - block.lon ) * mult );
+    m_vertices.push_back( TrackMercatorY( points.lat[i] ) - block.y );
+
+    for( int l = 1; l < TRACK_GL_LOD_LEVELS; l++ ) {
+        Level &level = m_levels[l];
+        if( level.starts.size() < m_blocks.size() )
+            level.starts.push_back( level.indices.size() );
+    }
+}
+
+void TrackGLGeometry::Sync( TrackPointArray &points )
+{
+    size_t n = points.size();
+    size_t valid = wxMin( points.changed_from, m_points );
+    if( valid < m_points )
+        Truncate( valid, points );
+
+    m_vertices.reserve( 2 * SlotCount( n ) );
+    for( size_t i = valid; i < n; i++ ) {
+        //  Keep the longitude continuous with the previous point
+        double lon = points.lon[i];
+        if( i )
+            lon += 360. * floor( ( m_last_lon - lon ) / 360. + .5 );
+        m_last_lon = lon;
+
+        size_t b = i / TRACK_GL_CHUNK;
+        bool boundary = i && ( i % TRACK_GL_CHUNK ) == 0;
+
+        //  The last point of a block is also the first of the next
+        if( boundary ) {
+            AddVertex( b - 1, i, points );
+            for( int l = 1; l < TRACK_GL_LOD_LEVELS; l++ )
+                m_levels[l].indices.push_back( Slot( b - 1, i ) );
+        }
+        if( i == 0 || boundary ) {
+            Block block;
+            block.lon = lon;
+            block.y = TrackMercatorY( points.lat[i] );
+            m_blocks.push_back( block );
+        }
+        AddVertex( b, i, points );
+        if( i )
+            AddSegment( i, points );
+
+        double tolerance = TRACK_GL_LOD_BASE_METERS;
+        for( int l = 1; l < TRACK_GL_LOD_LEVELS; l++, tolerance *= 4 ) {
+            std::vector<GLuint> &indices = m_levels[l].indices;
+            GLuint slot = Slot( b, i );
+            if( i % TRACK_GL_CHUNK ) {
+                float dx = m_vertices[2 * slot] - m_vertices[2 * indices.back()];
+                float dy = m_vertices[2 * slot + 1] - m_vertices[2 * indices.back() + 1];
+                if( dx * dx + dy * dy < tolerance * tolerance )
+                    continue;
+            }
+            indices.push_back( slot );
+        }
+    }
+    m_points = n;
+    points.changed_from = n;
+
+    Upload( GL_ARRAY_BUFFER, m_vbo, m_vbo_capacity, m_vbo_uploaded,
+            m_vertices.data(), VertexCount(), 2 * sizeof( float ) );
+#ifndef ocpnUSE_GLES
+    for( int l = 1; l < TRACK_GL_LOD_LEVELS; l++ ) {
+        Level &level = m_levels[l];
+        Upload( GL_ELEMENT_ARRAY_BUFFER, level.ibo, level.ibo_capacity, level.ibo_uploaded,
+                level.indices.data(), level.indices.size(), sizeof( GLuint ) );
+    }
+#endif
+    s_glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    s_glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+}
+
+//  Send elements [uploaded, count) to the buffer, reallocating with room to grow when full
+void TrackGLGeometry::Upload( GLenum target, GLuint &buffer, size_t &capacity, size_t &uploaded,
+                              const void *data, size_t count, size_t elem_size )
+{
+    if( uploaded == count )
+        return;
+
+    if( !buffer )
+        s_glGenBuffers( 1, &buffer );
+    s_glBindBuffer( target, buffer );
+
+    if( !s_glBufferSubData ) {
+        s_glBufferData( target, count * elem_size, data, GL_DYNAMIC_DRAW );
+        capacity = uploaded = count;
+        return;
+    }
+
+    if( count > capacity ) {
+        capacity = wxMax( 2 * count, 1024 );
+        s_glBufferData( target, capacity * elem_size, NULL, GL_DYNAMIC_DRAW );
+        uploaded = 0;
+    }
+
+    s_glBufferSubData( target, uploaded * elem_size, ( count - uploaded ) * elem_size,
+                       (const char *) data + uploaded * elem_size );
+    uploaded = count;
+}
+
+//  Block b at level l, with the modelview matrix built in double from its origin, as
+//  ViewPort::GetDoublePixFromLL
+void TrackGLGeometry::DrawBlock( ViewPort &vp, size_t b, int l, size_t n )
+{
+    const double mult = DEGREE * WGS84_semimajor_axis_meters * mercator_k0;
+    const Block &block = m_blocks[b];
+
+    double dlon = block.lon - vp.clon;
+    dlon -= 360. * floor( dlon / 360. + .5 );
+    double xoff = dlon * mult;
+    double yoff = block.y - toSMcache_y30( vp.clat );
+
+    double ppm = vp.view_scale_ppm;
+    double c = cos( vp.rotation ), s = sin( vp.rotation );
+    GLfloat m[16] = { (GLfloat)( ppm * c ), (GLfloat)( ppm * s ), 0, 0,
+                      (GLfloat)( ppm * s ), (GLfloat)( -ppm * c ), 0, 0,
+                      0, 0, 1, 0,
+                      (GLfloat)( vp.pix_width / 2. + ppm * ( c * xoff + s * yoff ) ),
+                      (GLfloat)( vp.pix_height / 2. + ppm * ( s * xoff - c * yoff ) ), 0, 1 };
+
+    glPushMatrix();
+    glMultMatrixf( m );
+
+    size_t first = Slot( b, b * TRACK_GL_CHUNK );
+    size_t end = ( b + 1 < m_blocks.size() ) ? first + TRACK_GL_CHUNK + 1 : n;
+    if( l == 0 ) {
+        glDrawArrays( GL_LINE_STRIP, first, end - first );
+    } else {
+        const Level &level = m_levels[l];
+        size_t start = level.starts[b];
+        size_t count = ( b + 1 < m_blocks.size() ) ? level.starts[b + 1] - start : level.indices.size() - start;
+        if( count > 1 )
+            glDrawElements( GL_LINE_STRIP, count, GL_UNSIGNED_INT, (const GLvoid *) ( start * sizeof( GLuint ) ) );
+
+        //  Points after the last one the level kept
+        size_t last = level.indices[start + count - 1];
+        if( last < end - 1 )
+            glDrawArrays( GL_LINE_STRIP, last, end - last );
+    }
+
+    glPopMatrix();
+}
+
+void TrackGLGeometry::Draw( ViewPort &vp, const LLBBox &box )
+{
+    size_t n = VertexCount();
+    if( m_points < 2 )
+        return;
+
+    //  Coarsest level still under a pixel between kept points
+    int l = 0;
+#ifndef ocpnUSE_GLES                            // no GL_UNSIGNED_INT element indices
+    double tolerance = TRACK_GL_LOD_BASE_METERS;
+    for( int k = 1; k < TRACK_GL_LOD_LEVELS; k++, tolerance *= 4 )
+        if( tolerance * vp.view_scale_ppm <= TRACK_GL_LOD_PIXELS )
+            l = k;
+#endif
+
+    glMatrixMode( GL_MODELVIEW );
+
+    s_glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+    glVertexPointer( 2, GL_FLOAT, 0, 0 );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    if( l )
+        s_glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_levels[l].ibo );
+
+    for( size_t b = 0; b < m_blocks.size(); b++ ) {
+        const LLBBox &block_box = m_blocks[b].box;
+        if( block_box.GetValid() && !box.IntersectOut( block_box ) )
+            DrawBlock( vp, b, l, n );
+    }
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    s_glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    s_glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+}
+#endif
+
 //---------------------------------------------------------------------------------
 //    Track Implementation
 //---------------------------------------------------------------------------------
@@ -235,14 +626,40 @@ Track::Track()
 
     m_HyperlinkList = new HyperlinkList;
     m_HighlightedTrackPoint = -1;
+    m_bSelectablePending = false;
+    m_pGLGeometry = NULL;
+    m_pending_count = 0;
 }
 
 Track::~Track( void )
 {
-    for(size_t i = 0; i < TrackPoints.size(); i++)
-        delete TrackPoints[i];
-
     delete m_HyperlinkList;
+#ifdef ocpnUSE_GL
+    delete m_pGLGeometry;
+#endif
+}
+
+//  The points of a track loaded hidden, from the GPX text kept at load
+void Track::ParsePendingPoints()
+{
+    std::string trksegs;
+    trksegs.swap( m_pending_trksegs );
+    m_pending_count = 0;
+
+    GPXLoadTrackSegs( trksegs, TrackPoints );
+    TrackPoints.changed_from = 0;
+    SubTracks.clear();
+}
+
+void Track::SetVisible( bool visible )
+{
+    m_bVisible = visible;
+
+    if( visible && m_bSelectablePending ) {
+        m_bSelectablePending = false;
+        pSelect->DeleteAllSelectableTrackSegments( this );
+        pSelect->AddAllSelectableTrackSegments( this );
+    }
 }
 
 #define TIMER_TRACK1           778
@@ -260,14 +677,15 @@ ActiveTrack::ActiveTrack()
     SetPrecision( g_nTrackPrecision );
 
     m_prev_time = wxInvalidDateTime;
-    m_lastStoredTP = NULL;
+    m_lastStoredTP = -1;
 
     wxDateTime now = wxDateTime::Now();
 //    m_ConfigRouteNum = now.GetTicks();        // a unique number....
     trackPointState = firstPoint;
-    m_lastStoredTP = NULL;
-    m_removeTP = NULL;
-    m_fixedTP = NULL;
+    m_lastStoredTP = -1;
+    m_removeTP = -1;
+    m_prevFixedTP = -1;
+    m_fixedTP = -1;
     m_track_run = 0;
     m_CurrentTrackSeg = 0;
     m_prev_dist = 999.0;
@@ -321,8 +739,8 @@ void ActiveTrack::Stop( bool do_add_point )
             AddPointNow( true );                   // Force add last point
         else{    
             double delta = 0.0;
-            if( m_lastStoredTP )
-                delta = DistGreatCircle( gLat, gLon, m_lastStoredTP->m_lat, m_lastStoredTP->m_lon );
+            if( m_lastStoredTP >= 0 )
+                delta = DistGreatCircle( gLat, gLon, TrackPoints.lat[m_lastStoredTP], TrackPoints.lon[m_lastStoredTP] );
 
             if(  delta > m_minTrackpoint_delta ) 
                 AddPointNow( true );                   // Add last point
@@ -338,19 +756,19 @@ extern TrackList        *pTrackList;
 Track *ActiveTrack::DoExtendDaily()
 {
     Track *pExtendTrack = NULL;
-    TrackPoint *pExtendPoint = NULL;
+    TrackPoint ExtendPoint;
 
-    TrackPoint *pLastPoint = GetPoint( 0 );
+    TrackPoint LastPoint = GetPoint( 0 );
 
     wxTrackListNode *track_node = pTrackList->GetFirst();
     while( track_node ) {
         Track *ptrack = track_node->GetData();
 
-        if( !ptrack->m_bIsInLayer && ptrack->m_GUID != m_GUID ) {
-            TrackPoint *track_node = ptrack->GetLastPoint();
-            if( track_node->GetCreateTime() <= pLastPoint->GetCreateTime() ) {
-                if( !pExtendPoint  || track_node->GetCreateTime() > pExtendPoint->GetCreateTime() ) {
-                    pExtendPoint = track_node;
+        if( !ptrack->m_bIsInLayer && ptrack->m_GUID != m_GUID && ptrack->GetnPoints() ) {
+            TrackPoint track_node = ptrack->GetLastPoint();
+            if( track_node.GetCreateTime() <= LastPoint.GetCreateTime() ) {
+                if( !pExtendTrack  || track_node.GetCreateTime() > ExtendPoint.GetCreateTime() ) {
+                    ExtendPoint = track_node;
                     pExtendTrack = ptrack;
                 }
             }
@@ -358,9 +776,9 @@ Track *ActiveTrack::DoExtendDaily()
         track_node = track_node->GetNext();                         // next track
     }
     if( pExtendTrack
-        && pExtendTrack->GetPoint( 0 )->GetCreateTime().FromTimezone( wxDateTime::GMT0 ).IsSameDate(pLastPoint->GetCreateTime().FromTimezone( wxDateTime::GMT0 ) ) ) {
+        && pExtendTrack->GetPoint( 0 ).GetCreateTime().FromTimezone( wxDateTime::GMT0 ).IsSameDate(LastPoint.GetCreateTime().FromTimezone( wxDateTime::GMT0 ) ) ) {
         int begin = 1;
-        if( pLastPoint->GetCreateTime() == pExtendPoint->GetCreateTime() ) begin = 2;
+        if( LastPoint.GetCreateTime() == ExtendPoint.GetCreateTime() ) begin = 2;
         pSelect->DeleteAllSelectableTrackSegments( pExtendTrack );
         wxString suffix = _T("");
         if( GetName().IsNull() ) {
@@ -388,31 +806,34 @@ void Track::Clone( Track *psourcetrack, int start_nPoint, int end_nPoint, const
     m_TrackStartString = psourcetrack->m_TrackStartString;
     m_TrackEndString = psourcetrack->m_TrackEndString;
 
+    LoadPendingPoints();
     bool b_splitting = GetnPoints() == 0;
 
     int startTrkSegNo;
     if( b_splitting ) {
-        startTrkSegNo = psourcetrack->GetPoint( start_nPoint )->m_GPXTrkSegNo;
+        startTrkSegNo = psourcetrack->GetPoint( start_nPoint ).m_GPXTrkSegNo;
     } else {
-        startTrkSegNo = GetLastPoint()->m_GPXTrkSegNo;
+        startTrkSegNo = GetLastPoint().m_GPXTrkSegNo;
     }
-    int i;
-    for( i = start_nPoint; i <= end_nPoint; i++ ) {
 
-        TrackPoint *psourcepoint = psourcetrack->GetPoint( i );
-        if( psourcepoint ) {
-            TrackPoint *ptargetpoint = new TrackPoint( psourcepoint);
-            
-            AddPoint( ptargetpoint );
-        }
+    end_nPoint = wxMin( end_nPoint, psourcetrack->GetnPoints() - 1 );
+    if( end_nPoint >= start_nPoint )
+        TrackPoints.reserve( TrackPoints.size() + end_nPoint - start_nPoint + 1 );
+
+    for( int i = start_nPoint; i <= end_nPoint; i++ ) {
+        TrackPoint targetpoint = psourcetrack->GetPoint( i );
+        targetpoint.m_GPXTrkSegNo = 1;
+
+        AddPoint( targetpoint );
     }
 }
 
-void ActiveTrack::AdjustCurrentTrackPoint( TrackPoint *prototype )
+void ActiveTrack::AdjustCurrentTrackPoint( const TrackPoint &prototype )
 {
-    if(prototype) {
-        *m_lastStoredTP = *prototype;
-        m_prev_time = prototype->GetCreateTime().FromUTC();
+    if( m_lastStoredTP >= 0 ) {
+        TrackPoints.Set( m_lastStoredTP, prototype );
+        SubTracks.clear();
+        m_prev_time = prototype.GetCreateTime().FromUTC();
     }
 }
 
@@ -421,8 +842,8 @@ void ActiveTrack::OnTimerTrack( wxTimerEvent& event )
     m_TimerTrack.Stop();
     m_track_run++;
 
-    if( m_lastStoredTP )
-        m_prev_dist = DistGreatCircle( gLat, gLon, m_lastStoredTP->m_lat, m_lastStoredTP->m_lon );
+    if( m_lastStoredTP >= 0 )
+        m_prev_dist = DistGreatCircle( gLat, gLon, TrackPoints.lat[m_lastStoredTP], TrackPoints.lon[m_lastStoredTP] );
     else
         m_prev_dist = 999.0;
 
@@ -440,8 +861,11 @@ void ActiveTrack::OnTimerTrack( wxTimerEvent& event )
         if( ( trackPointState == firstPoint ) && !g_bTrackDaily )
         {
             wxDateTime now = wxDateTime::Now();
-            if(TrackPoints.empty())
-                TrackPoints.front()->SetCreateTime(now.ToUTC());
+            if(!TrackPoints.empty()) {
+                TrackPoint first = TrackPoints.Get(0);
+                first.SetCreateTime(now.ToUTC());
+                TrackPoints.Set(0, first);
+            }
         }
 
     m_TimerTrack.Start( 1000, wxTIMER_CONTINUOUS );
@@ -465,8 +889,8 @@ void ActiveTrack::AddPointNow( bool do_add_point )
 
     switch( trackPointState ) {
         case firstPoint: {
-            TrackPoint *pTrackPoint = AddNewPoint( gpsPoint, now.ToUTC() );
-            m_lastStoredTP = pTrackPoint;
+            AddNewPoint( gpsPoint, now.ToUTC() );
+            m_lastStoredTP = TrackPoints.size() - 1;
             trackPointState = secondPoint;
             do_add_point = false;
             break;
@@ -486,22 +910,22 @@ void ActiveTrack::AddPointNow( bool do_add_point )
 
             // Scan points skipped so far and see if anyone has XTE over the threshold.
             for( unsigned int i=0; i<skipPoints.size(); i++ ) {
-                double xte = GetXTE( m_lastStoredTP->m_lat, m_lastStoredTP->m_lon, gLat, gLon, skipPoints[i].lat, skipPoints[i].lon );
+                double xte = GetXTE( TrackPoints.lat[m_lastStoredTP], TrackPoints.lon[m_lastStoredTP], gLat, gLon, skipPoints[i].lat, skipPoints[i].lon );
                 if( xte > xteMax ) {
                     xteMax = xte;
                     xteMaxIndex = i;
                 }
             }
             if( xteMax > m_allowedMaxXTE ) {
-                TrackPoint *pTrackPoint = AddNewPoint( skipPoints[xteMaxIndex], skipTimes[xteMaxIndex] );
-                pSelect->AddSelectableTrackSegment( m_lastStoredTP->m_lat, m_lastStoredTP->m_lon,
-                        pTrackPoint->m_lat, pTrackPoint->m_lon,
-                        m_lastStoredTP, pTrackPoint, this );
+                TrackPoint NewPoint = AddNewPoint( skipPoints[xteMaxIndex], skipTimes[xteMaxIndex] );
+                pSelect->AddSelectableTrackSegment( TrackPoints.lat[m_lastStoredTP], TrackPoints.lon[m_lastStoredTP],
+                        NewPoint.m_lat, NewPoint.m_lon,
+                        m_lastStoredTP, TrackPoints.size() - 1, this );
 
                 m_prevFixedTP = m_fixedTP;
                 m_fixedTP = m_removeTP;
                 m_removeTP = m_lastStoredTP;
-                m_lastStoredTP = pTrackPoint;
+                m_lastStoredTP = TrackPoints.size() - 1;
                 for( unsigned int i=0; i<=xteMaxIndex; i++ ) {
                     skipPoints.pop_front();
                     skipTimes.pop_front();
@@ -510,18 +934,20 @@ void ActiveTrack::AddPointNow( bool do_add_point )
                 // Now back up and see if we just made 3 points in a straight line and the middle one
                 // (the next to last) point can possibly be eliminated. Here we reduce the allowed
                 // XTE as a function of leg length. (Half the XTE for very short legs).
-                if( GetnPoints() > 2 ) {
-                    double dist = DistGreatCircle( m_fixedTP->m_lat, m_fixedTP->m_lon, m_lastStoredTP->m_lat, m_lastStoredTP->m_lon );
+                if( GetnPoints() > 2 && m_fixedTP >= 0 && m_removeTP == GetnPoints() - 2 ) {
+                    double dist = DistGreatCircle( TrackPoints.lat[m_fixedTP], TrackPoints.lon[m_fixedTP],
+                                                   TrackPoints.lat[m_lastStoredTP], TrackPoints.lon[m_lastStoredTP] );
                     double xte = GetXTE( m_fixedTP, m_lastStoredTP, m_removeTP );
                     if( xte < m_allowedMaxXTE / wxMax(1.0, 2.0 - dist*2.0) ) {
-                        TrackPoints.pop_back();
-                        TrackPoints.pop_back();
-                        TrackPoints.push_back( m_lastStoredTP );
-                        pSelect->DeletePointSelectableTrackSegments( m_removeTP );
-                        pSelect->AddSelectableTrackSegment( m_fixedTP->m_lat, m_fixedTP->m_lon,
-                                m_lastStoredTP->m_lat, m_lastStoredTP->m_lon,
+                        //  The removed point is the one just before the last, so
+                        //  the fixed points keep their indices
+                        pSelect->DeletePointSelectableTrackSegments( this, m_removeTP );
+                        TrackPoints.erase( m_removeTP );
+                        SubTracks.clear();
+                        m_lastStoredTP = TrackPoints.size() - 1;
+                        pSelect->AddSelectableTrackSegment( TrackPoints.lat[m_fixedTP], TrackPoints.lon[m_fixedTP],
+                                TrackPoints.lat[m_lastStoredTP], TrackPoints.lon[m_lastStoredTP],
                                 m_fixedTP, m_lastStoredTP, this );
-                        delete m_removeTP;
                         m_removeTP = m_fixedTP;
                         m_fixedTP = m_prevFixedTP;
                     }
@@ -536,10 +962,10 @@ void ActiveTrack::AddPointNow( bool do_add_point )
 
     // Check if this is the last point of the track.
     if( do_add_point ) {
-        TrackPoint *pTrackPoint = AddNewPoint( gpsPoint, now.ToUTC() );
-        pSelect->AddSelectableTrackSegment( m_lastStoredTP->m_lat, m_lastStoredTP->m_lon,
-                pTrackPoint->m_lat, pTrackPoint->m_lon,
-                m_lastStoredTP, pTrackPoint, this );
+        TrackPoint NewPoint = AddNewPoint( gpsPoint, now.ToUTC() );
+        pSelect->AddSelectableTrackSegment( TrackPoints.lat[m_lastStoredTP], TrackPoints.lon[m_lastStoredTP],
+                NewPoint.m_lat, NewPoint.m_lon,
+                m_lastStoredTP, TrackPoints.size() - 1, this );
     }
 
     m_prev_time = now;
@@ -549,7 +975,7 @@ void Track::AddPointToList(ChartCanvas *cc, std::list< std::list<wxPoint> > &poi
 {
     wxPoint r(INVALID_COORD, INVALID_COORD);
     if ( (size_t)n < TrackPoints.size() )
-        cc->GetCanvasPointPix( TrackPoints[n]->m_lat, TrackPoints[n]->m_lon, &r );
+        cc->GetCanvasPointPix( TrackPoints.lat[n], TrackPoints.lon[n], &r );
 
     std::list<wxPoint> &pointlist = pointlists.back();
     if(r.x == INVALID_COORD) {
@@ -616,11 +1042,8 @@ void Track::ClearHighlights()
 
 void Track::Draw( ChartCanvas *cc, ocpnDC& dc, ViewPort &VP, const LLBBox &box )
 {
-    std::list< std::list<wxPoint> > pointlists;
-    GetPointLists(cc, pointlists, VP, box);
-
-    if(!pointlists.size())
-        return;
+    if( !IsVisible() || GetnPoints() == 0 ) return;
+    LoadPendingPoints();
 
     unsigned short int FromSegNo = 1;
 
@@ -657,6 +1080,20 @@ void Track::Draw( ChartCanvas *cc, ocpnDC& dc, ViewPort &VP, const LLBBox &box )
             radius = 0;
     }
 
+#ifdef ocpnUSE_GL
+    if( !dc.GetDC() && !radius && DrawGLGeometry( cc, col, width, box ) ) {
+        if(m_HighlightedTrackPoint >= 0 && m_HighlightedTrackPoint < (int)TrackPoints.size())
+            TrackPoints.Get(m_HighlightedTrackPoint).Draw(cc, dc);
+        return;
+    }
+#endif
+
+    std::list< std::list<wxPoint> > pointlists;
+    GetPointLists(cc, pointlists, VP, box);
+
+    if(!pointlists.size())
+        return;
+
     if( dc.GetDC() || radius ) {
         dc.SetPen( *wxThePenList->FindOrCreatePen( col, width, style ) );
         dc.SetBrush( *wxTheBrushList->FindOrCreateBrush( col, wxBRUSHSTYLE_SOLID ) );
@@ -732,24 +1169,68 @@ void Track::Draw( ChartCanvas *cc, ocpnDC& dc, ViewPort &VP, const LLBBox &box )
     }
 #endif
 
-    if(m_HighlightedTrackPoint >= 0)
-        TrackPoints[m_HighlightedTrackPoint]->Draw(cc, dc);
+    if(m_HighlightedTrackPoint >= 0 && m_HighlightedTrackPoint < (int)TrackPoints.size())
+        TrackPoints.Get(m_HighlightedTrackPoint).Draw(cc, dc);
+}
+
+#ifdef ocpnUSE_GL
+//  Draw from the track's GL buffers, false if this view needs the pointlists path
+bool Track::DrawGLGeometry( ChartCanvas *cc, const wxColour &col, int width, const LLBBox &box )
+{
+    ViewPort &vp = cc->GetVP();
+    if( !g_b_EnableVBO || ( vp.m_projection_type != PROJECTION_MERCATOR &&
+                            vp.m_projection_type != PROJECTION_WEB_MERCATOR ) )
+        return false;
+
+    if( !m_pGLGeometry )
+        m_pGLGeometry = new TrackGLGeometry;
+    m_pGLGeometry->Sync( TrackPoints );
+
+    glColor3ub(col.Red(), col.Green(), col.Blue());
+    glLineWidth( wxMax( g_GLMinSymbolLineWidth, width ) );
+    if( g_GLOptions.m_GLLineSmoothing )
+        glEnable( GL_LINE_SMOOTH );
+    glEnable( GL_BLEND );
+
+    m_pGLGeometry->Draw( vp, box );
+
+    //    Last segment to ownship, dynamically
+    if( IsRunning() ) {
+        wxPoint a, b;
+        cc->GetCanvasPointPix( TrackPoints.lat.back(), TrackPoints.lon.back(), &a );
+        cc->GetCanvasPointPix( gLat, gLon, &b );
+        if( a.x != INVALID_COORD && b.x != INVALID_COORD ) {
+            int points[4] = { a.x, a.y, b.x, b.y };
+            glVertexPointer(2, GL_INT, 0, points);
+            glEnableClientState(GL_VERTEX_ARRAY);
+            glDrawArrays(GL_LINES, 0, 2);
+            glDisableClientState(GL_VERTEX_ARRAY);
+        }
+    }
+
+    glDisable( GL_LINE_SMOOTH );
+    glDisable( GL_BLEND );
+    return true;
 }
+#endif
 
-TrackPoint *Track::GetPoint( int nWhichPoint )
+//  Out of range points come back as a default TrackPoint
+TrackPoint Track::GetPoint( int nWhichPoint )
 {
-    if(nWhichPoint < (int) TrackPoints.size())
-        return TrackPoints[nWhichPoint];
+    LoadPendingPoints();
+    if(nWhichPoint >= 0 && nWhichPoint < (int) TrackPoints.size())
+        return TrackPoints.Get(nWhichPoint);
     else
-        return NULL;
+        return TrackPoint();
 }
 
-TrackPoint *Track::GetLastPoint()
+TrackPoint Track::GetLastPoint()
 {
+    LoadPendingPoints();
     if(TrackPoints.empty())
-        return NULL;
+        return TrackPoint();
 
-    return TrackPoints.back();
+    return TrackPoints.Get(TrackPoints.size() - 1);
 }
 
 static double heading_diff(double x)
@@ -773,8 +1254,8 @@ double Track::ComputeScale(int left, int right)
     // better performance with loss of rendering track accuracy
 
     double max_dist = 0;
-    double lata = TrackPoints[left]->m_lat, lona = TrackPoints[left]->m_lon;
-    double latb = TrackPoints[right]->m_lat, lonb = TrackPoints[right]->m_lon;
+    double lata = TrackPoints.lat[left], lona = TrackPoints.lon[left];
+    double latb = TrackPoints.lat[right], lonb = TrackPoints.lon[right];
 
     double bx = heading_diff(lonb - lona), by = latb - lata;
 
@@ -787,7 +1268,7 @@ double Track::ComputeScale(int left, int right)
 
     if ( lengthSquared == 0.0 ) {
         for(int i = left+1; i < right; i++) {
-            double lat = TrackPoints[i]->m_lat, lon = TrackPoints[i]->m_lon;
+            double lat = TrackPoints.lat[i], lon = TrackPoints.lon[i];
             // v == w case
             double vx = heading_diff(lon - lona);
             double vy = lat - lata;
@@ -799,7 +1280,7 @@ double Track::ComputeScale(int left, int right)
     } else {
         double invLengthSquared = 1/lengthSquared;
         for(int i = left+1; i < right; i++) {
-            double lat = TrackPoints[i]->m_lat, lon = TrackPoints[i]->m_lon;
+            double lat = TrackPoints.lat[i], lon = TrackPoints.lon[i];
 
             double vx = heading_diff(lon - lona);
             double vy = lat - lata;
@@ -829,9 +1310,10 @@ double Track::ComputeScale(int left, int right)
 /* Add a point to a track, should be iterated
    on to build up a track from data.  If a track
    is being slowing enlarged, see AddPointFinalized below */
-void Track::AddPoint( TrackPoint *pNewPoint )
+void Track::AddPoint( const TrackPoint &NewPoint )
 {
-    TrackPoints.push_back( pNewPoint );
+    LoadPendingPoints();
+    TrackPoints.push_back( NewPoint );
     SubTracks.clear(); // invalidate subtracks
 }
 
@@ -872,6 +1354,7 @@ void Track::GetPointLists(ChartCanvas *cc, std::list< std::list<wxPoint> > &poin
 /* ensures the SubTracks are valid for assembly use */
 void Track::Finalize()
 {
+    LoadPendingPoints();
     if(SubTracks.size()) // subtracks already computed
         return;
 
@@ -884,10 +1367,10 @@ void Track::Finalize()
         new_level.resize(n);
         if(level == 0)
             for(int i=0; i<n; i++) {
-                new_level[i].m_box.SetFromSegment(TrackPoints[i]->m_lat,
-                                                  TrackPoints[i]->m_lon,
-                                                  TrackPoints[i+1]->m_lat,
-                                                  TrackPoints[i+1]->m_lon);
+                new_level[i].m_box.SetFromSegment(TrackPoints.lat[i],
+                                                  TrackPoints.lon[i],
+                                                  TrackPoints.lat[i+1],
+                                                  TrackPoints.lon[i+1]);
                 new_level[i].m_scale = 0;
             }
         else {
@@ -949,25 +1432,26 @@ void Track::InsertSubTracks(LLBBox &box, int level, int pos)
    but should not be used for building a large track O(n log(n)) which
    _is_ worse than blowing the subtracks and calling Finalize.
 */
-void Track::AddPointFinalized( TrackPoint *pNewPoint )
+void Track::AddPointFinalized( const TrackPoint &NewPoint )
 {
-    TrackPoints.push_back( pNewPoint );
+    LoadPendingPoints();
+    TrackPoints.push_back( NewPoint );
 
     int pos = TrackPoints.size() - 1;
 
     if(pos > 0) {
         LLBBox box;
-        box.SetFromSegment(TrackPoints[pos-1]->m_lat,
-                           TrackPoints[pos-1]->m_lon,
-                           TrackPoints[pos]->m_lat,
-                           TrackPoints[pos]->m_lon);
+        box.SetFromSegment(TrackPoints.lat[pos-1],
+                           TrackPoints.lon[pos-1],
+                           TrackPoints.lat[pos],
+                           TrackPoints.lon[pos]);
         InsertSubTracks(box, 0, pos-1);
     }
 }
 
-TrackPoint* Track::AddNewPoint( vector2D point, wxDateTime time )
+TrackPoint Track::AddNewPoint( vector2D point, wxDateTime time )
 {
-    TrackPoint *tPoint = new TrackPoint( point.lat, point.lon, time );
+    TrackPoint tPoint( point.lat, point.lon, time );
 
     AddPointFinalized( tPoint );
 
@@ -975,46 +1459,54 @@ TrackPoint* Track::AddNewPoint( vector2D point, wxDateTime time )
     return tPoint;
 }
 
-void Track::DouglasPeuckerReducer( std::vector<TrackPoint*>& list,
-                                   std::vector<bool> & keeplist,
+//  Iterative, so very long tracks cannot exhaust the stack
+void Track::DouglasPeuckerReducer( std::vector<bool> & keeplist,
                                    int from, int to, double delta ) {
-    keeplist[from] = true;
-    keeplist[to] = true;
+    std::vector< std::pair<int, int> > spans;
+    spans.push_back( std::make_pair( from, to ) );
+
+    while( !spans.empty() ) {
+        from = spans.back().first;
+        to = spans.back().second;
+        spans.pop_back();
+
+        keeplist[from] = true;
+        keeplist[to] = true;
 
-    int maxdistIndex = -1;
-    double maxdist = 0;
+        int maxdistIndex = -1;
+        double maxdist = 0;
 
-    for( int i=from+1; i<to; i++ ) {
+        for( int i=from+1; i<to; i++ ) {
 
-        double dist = 1852.0 * GetXTE( list[from], list[to], list[i] );
+            double dist = 1852.0 * GetXTE( from, to, i );
 
-        if( dist > maxdist ) {
-            maxdist = dist;
-            maxdistIndex = i;
+            if( dist > maxdist ) {
+                maxdist = dist;
+                maxdistIndex = i;
+            }
         }
-    }
 
-    if( maxdist > delta ) {
-        DouglasPeuckerReducer( list, keeplist, from, maxdistIndex, delta );
-        DouglasPeuckerReducer( list, keeplist, maxdistIndex, to, delta );
+        if( maxdist > delta ) {
+            spans.push_back( std::make_pair( from, maxdistIndex ) );
+            spans.push_back( std::make_pair( maxdistIndex, to ) );
+        }
     }
 }
 
 double Track::Length()
 {
-    TrackPoint *l = NULL;
+    LoadPendingPoints();
     double total = 0.0;
-    for(size_t i = 0; i < TrackPoints.size(); i++) {
-        TrackPoint *t = TrackPoints[i];
-        if(l) {
-            const double offsetLat = 1e-6;
-            const double deltaLat = l->m_lat - t->m_lat;
-            if ( fabs( deltaLat ) > offsetLat )
-                total += DistGreatCircle( l->m_lat, l->m_lon, t->m_lat, t->m_lon );
-            else
-                total += DistGreatCircle( l->m_lat + copysign( offsetLat, deltaLat ), l->m_lon, t->m_lat, t->m_lon );
-        }
-        l = t;
+    for(size_t i = 1; i < TrackPoints.size(); i++) {
+        double llat = TrackPoints.lat[i-1], llon = TrackPoints.lon[i-1];
+        double tlat = TrackPoints.lat[i], tlon = TrackPoints.lon[i];
+
+        const double offsetLat = 1e-6;
+        const double deltaLat = llat - tlat;
+        if ( fabs( deltaLat ) > offsetLat )
+            total += DistGreatCircle( llat, llon, tlat, tlon );
+        else
+            total += DistGreatCircle( llat + copysign( offsetLat, deltaLat ), llon, tlat, tlon );
     }
 
     return total;
@@ -1022,33 +1514,33 @@ double Track::Length()
 
 int Track::Simplify( double maxDelta )
 {
+    LoadPendingPoints();
     int reduction = 0;
 
-    std::vector<TrackPoint*> pointlist;
-    std::vector<bool> keeplist;
-
-    ::wxBeginBusyCursor();
+    if( TrackPoints.size() < 3 )
+        return 0;
 
-    for(size_t i = 0; i < TrackPoints.size(); i++) {
-        TrackPoint *trackpoint = TrackPoints[i];
+    std::vector<bool> keeplist( TrackPoints.size(), false );
 
-        pointlist.push_back(trackpoint);
-        keeplist.push_back(false);
-    }
+    ::wxBeginBusyCursor();
 
-    DouglasPeuckerReducer( pointlist, keeplist, 0, pointlist.size()-1, maxDelta );
+    DouglasPeuckerReducer( keeplist, 0, TrackPoints.size()-1, maxDelta );
 
     pSelect->DeleteAllSelectableTrackSegments( this );
-    TrackPoints.clear();
 
-    for( size_t i=0; i<pointlist.size(); i++ ) {
-        if( keeplist[i] )
-            TrackPoints.push_back( pointlist[i] );
-        else {
-            delete pointlist[i];
+    //  Compact the kept points in place
+    size_t n = 0;
+    for( size_t i=0; i<keeplist.size(); i++ ) {
+        if( keeplist[i] ) {
+            if( n != i )
+                TrackPoints.Set( n, TrackPoints.Get( i ) );
+            n++;
+        } else
             reduction++;
-        }
     }
+    while( TrackPoints.size() > n )
+        TrackPoints.pop_back();
+    SubTracks.clear();
 
     pSelect->AddAllSelectableTrackSegments( this );
 
@@ -1059,13 +1551,13 @@ int Track::Simplify( double maxDelta )
 
 Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
 {
+    LoadPendingPoints();
 
     Route *route = new Route();
 
-    TrackPoint *pWP_src = TrackPoints.front();
     size_t prpnodeX;
     RoutePoint *pWP_dst, *pWP_prev;
-    TrackPoint *prp_OK = NULL;  // last routepoint known not to exceed xte limit, if not yet added
+    int prp_OK = -1;  // index of the last routepoint known not to exceed xte limit, if not yet added
 
     wxString icon = _T("xmblue");
     if( g_TrackDeltaDistance >= 0.1 ) icon = _T("diamond");
@@ -1082,7 +1574,7 @@ Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
 
 // add first point
 
-    pWP_dst = new RoutePoint( pWP_src->m_lat, pWP_src->m_lon, icon, _T ( "" ), wxEmptyString );
+    pWP_dst = new RoutePoint( TrackPoints.lat[0], TrackPoints.lon[0], icon, _T ( "" ), wxEmptyString );
     route->AddPoint( pWP_dst );
 
     pWP_dst->m_bShowName = false;
@@ -1092,7 +1584,6 @@ Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
 // add intermediate points as needed
 
     for(size_t i = 1; i < TrackPoints.size();) {
-        TrackPoint *prp = TrackPoints[i];
         prpnodeX = i;
         pWP_dst->m_lat = pWP_prev->m_lat;
         pWP_dst->m_lon = pWP_prev->m_lon;
@@ -1102,10 +1593,10 @@ Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
         delta_hdg = 0.0;
         back_ic = next_ic;
 
-        DistanceBearingMercator( prp->m_lat, prp->m_lon, pWP_prev->m_lat, pWP_prev->m_lon, &delta_hdg,
+        DistanceBearingMercator( TrackPoints.lat[i], TrackPoints.lon[i], pWP_prev->m_lat, pWP_prev->m_lon, &delta_hdg,
                 &delta_dist );
 
-        if( ( delta_dist > ( leg_speed * 6.0 ) ) && !prp_OK ) {
+        if( ( delta_dist > ( leg_speed * 6.0 ) ) && prp_OK < 0 ) {
             int delta_inserts = floor( delta_dist / ( leg_speed * 4.0 ) );
             delta_dist = delta_dist / ( delta_inserts + 1 );
             double tlat = 0.0;
@@ -1128,21 +1619,20 @@ Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
             next_ic = 0;
             delta_dist = 0.0;
             back_ic = next_ic;
-            prp_OK = prp;
+            prp_OK = i;
             isProminent = true;
         } else {
             isProminent = false;
             if( delta_dist >= ( leg_speed * 4.0 ) ) isProminent = true;
-            if( !prp_OK ) prp_OK = prp;
+            if( prp_OK < 0 ) prp_OK = i;
         }
         while( prpnodeX < TrackPoints.size() ) {
 
-            TrackPoint *prpX = TrackPoints[prpnodeX];
 //            TrackPoint src(pWP_prev->m_lat, pWP_prev->m_lon);
-            xte = GetXTE( pWP_src, prpX, prp );
+            xte = GetXTE( 0, prpnodeX, i );
             if( isProminent || ( xte > g_TrackDeltaDistance ) ) {
 
-                pWP_dst = new RoutePoint( prp_OK->m_lat, prp_OK->m_lon, icon, _T ( "" ),
+                pWP_dst = new RoutePoint( TrackPoints.lat[prp_OK], TrackPoints.lon[prp_OK], icon, _T ( "" ),
                         wxEmptyString );
 
                 route->AddPoint( pWP_dst );
@@ -1156,7 +1646,7 @@ Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
                 pWP_prev = pWP_dst;
                 next_ic = 0;
                 prpnodeX = TrackPoints.size();
-                prp_OK = NULL;
+                prp_OK = -1;
             }
 
             if( prpnodeX != TrackPoints.size()) prpnodeX--;
@@ -1165,14 +1655,14 @@ Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
             }
         }
 
-        if( prp_OK ) {
-            prp_OK = prp;
+        if( prp_OK >= 0 ) {
+            prp_OK = i;
         }
 
-        DistanceBearingMercator( prp->m_lat, prp->m_lon, pWP_prev->m_lat, pWP_prev->m_lon, NULL,
+        DistanceBearingMercator( TrackPoints.lat[i], TrackPoints.lon[i], pWP_prev->m_lat, pWP_prev->m_lon, NULL,
                 &delta_dist );
 
-        if( !( ( delta_dist > ( g_TrackDeltaDistance ) ) && !prp_OK ) ) {
+        if( !( ( delta_dist > ( g_TrackDeltaDistance ) ) && prp_OK < 0 ) ) {
             i++;
             next_ic++;
         }
@@ -1181,8 +1671,8 @@ Route *Track::RouteFromTrack( wxGenericProgressDialog *pprog )
 
 // add last point, if needed
     if( delta_dist >= g_TrackDeltaDistance ) {
-        pWP_dst = new RoutePoint( TrackPoints.back()->m_lat,
-                                  TrackPoints.back()->m_lon,
+        pWP_dst = new RoutePoint( TrackPoints.lat.back(),
+                                  TrackPoints.lon.back(),
                                   icon, _T ( "" ), wxEmptyString );
         route->AddPoint( pWP_dst );
 
@@ -1240,11 +1730,11 @@ double Track::GetXTE( double fm1Lat, double fm1Lon, double fm2Lat, double fm2Lon
     return _distance(p, projection);
 }
 
-double Track::GetXTE( TrackPoint *fm1, TrackPoint *fm2, TrackPoint *to )
+double Track::GetXTE( int fm1, int fm2, int to )
 {
-    if( !fm1 || !fm2 || !to ) return 0.0;
+    if( fm1 < 0 || fm2 < 0 || to < 0 ) return 0.0;
     if( fm1 == to ) return 0.0;
     if( fm2 == to ) return 0.0;
-    return GetXTE( fm1->m_lat, fm1->m_lon, fm2->m_lat, fm2->m_lon, to->m_lat, to->m_lon );
-;
+    return GetXTE( TrackPoints.lat[fm1], TrackPoints.lon[fm1], TrackPoints.lat[fm2], TrackPoints.lon[fm2],
+                   TrackPoints.lat[to], TrackPoints.lon[to] );
 }
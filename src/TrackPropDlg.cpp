@@ -892,11 +892,7 @@ void TrackPropDlg::InitializeList()
     m_lcPoints->m_pTrack = m_pTrack;
 
     if(m_pTrack->GetnPoints()){
-        TrackPoint *prp = m_pTrack->GetPoint(0);
-        if(prp)
-            m_lcPoints->m_LMT_Offset = long(( prp->m_lon ) * 3600. / 15. );  // estimated
-        else
-            m_lcPoints->m_LMT_Offset = 0;
+        m_lcPoints->m_LMT_Offset = long(( m_pTrack->GetPointLon(0) ) * 3600. / 15. );  // estimated
     }
 
     if( m_lcPoints->IsVirtual() )
@@ -979,17 +975,17 @@ bool TrackPropDlg::UpdateProperties()
     m_sdbBtmBtnsSizerExtend->Enable( false );
 
     // Calculate AVG speed if we are showing a track and total time
-    TrackPoint *last_point = m_pTrack->GetLastPoint();
-    TrackPoint *first_point = m_pTrack->GetPoint( 0 );
+    TrackPoint last_point = m_pTrack->GetLastPoint();
+    TrackPoint first_point = m_pTrack->GetPoint( 0 );
     double trackLength = m_pTrack->Length( );
     double total_seconds = 0.;
 
     wxString speed( _T("--") );
 
-    if(last_point && first_point){
-        if( last_point->GetCreateTime().IsValid() && first_point->GetCreateTime().IsValid() ) {
+    if(m_pTrack->GetnPoints()){
+        if( last_point.GetCreateTime().IsValid() && first_point.GetCreateTime().IsValid() ) {
             total_seconds =
-                    last_point->GetCreateTime().Subtract( first_point->GetCreateTime() ).GetSeconds().ToDouble();
+                    last_point.GetCreateTime().Subtract( first_point.GetCreateTime() ).GetSeconds().ToDouble();
             if( total_seconds != 0. ) {
                 m_avgspeed = trackLength / total_seconds * 3600;
             } else {
@@ -1082,13 +1078,13 @@ bool TrackPropDlg::UpdateProperties()
 bool TrackPropDlg::IsThisTrackExtendable()
 {
     m_pExtendTrack = NULL;
-    m_pExtendPoint = NULL;
+    m_ExtendPoint = TrackPoint();
     if( m_pTrack == g_pActiveTrack || m_pTrack->m_bIsInLayer ) {
         return false;
     }
 
-    TrackPoint *pLastPoint = m_pTrack->GetPoint( 0 );
-    if( !pLastPoint->GetCreateTime().IsValid() ) {
+    TrackPoint LastPoint = m_pTrack->GetPoint( 0 );
+    if( !LastPoint.GetCreateTime().IsValid() ) {
         return false;
     }
     
@@ -1096,12 +1092,12 @@ bool TrackPropDlg::IsThisTrackExtendable()
     while( track_node ) {
         Track *ptrack = track_node->GetData();
         if( ptrack->IsVisible() && ( ptrack->m_GUID != m_pTrack->m_GUID ) ) {
-            TrackPoint *track_node = ptrack->GetLastPoint();
-            if( track_node ){
-                if( track_node->GetCreateTime().IsValid() ) {
-                    if( track_node->GetCreateTime() <= pLastPoint->GetCreateTime() ) {
-                        if( !m_pExtendPoint || track_node->GetCreateTime() > m_pExtendPoint->GetCreateTime() ) {
-                            m_pExtendPoint = track_node;
+            if( ptrack->GetnPoints() ){
+                TrackPoint track_node = ptrack->GetLastPoint();
+                if( track_node.GetCreateTime().IsValid() ) {
+                    if( track_node.GetCreateTime() <= LastPoint.GetCreateTime() ) {
+                        if( !m_pExtendTrack || track_node.GetCreateTime() > m_ExtendPoint.GetCreateTime() ) {
+                            m_ExtendPoint = track_node;
                             m_pExtendTrack = ptrack;
                         }
                     }
@@ -1119,11 +1115,11 @@ bool TrackPropDlg::IsThisTrackExtendable()
 
 void TrackPropDlg::OnExtendBtnClick( wxCommandEvent& event )
 {
-    TrackPoint *pFirstPoint = m_pTrack->GetPoint( 0 );
+    TrackPoint FirstPoint = m_pTrack->GetPoint( 0 );
 
     if( IsThisTrackExtendable() ) {
         int begin = 0;
-        if( pFirstPoint->GetCreateTime() == m_pExtendPoint->GetCreateTime() ) {
+        if( FirstPoint.GetCreateTime() == m_ExtendPoint.GetCreateTime() ) {
             begin = 1;
         }
         pSelect->DeleteAllSelectableTrackSegments( m_pExtendTrack );
@@ -1188,7 +1184,7 @@ void TrackPropDlg::OnTrackPropCopyTxtClick( wxCommandEvent& event )
             << _("Destination") << tab << m_pTrack->m_TrackEndString << eol
             << _("Total distance") << tab << m_tTotDistance->GetValue() << eol
             << _("Speed") << tab << m_tAvgSpeed->GetValue() << eol
-            << _("Departure Time") + _T(" ") + _("(m/d/y h:m)") << tab << m_pTrack->GetPoint(1)->GetCreateTime().Format() << eol
+            << _("Departure Time") + _T(" ") + _("(m/d/y h:m)") << tab << m_pTrack->GetPoint(1).GetCreateTime().Format() << eol
             << _("Time enroute") << tab << m_tTimeEnroute->GetValue() << eol << eol;
 
     int noCols;
@@ -1256,15 +1252,15 @@ void TrackPropDlg::OnTrackPropListClick( wxListEvent& event )
     m_pTrack->m_HighlightedTrackPoint = -1;
 
     if( itemno >= 0 ) {
-        TrackPoint *prp = m_pTrack->GetPoint(itemno);
-        if( prp ) {
+        if( itemno < m_pTrack->GetnPoints() ) {
+            TrackPoint prp = m_pTrack->GetPoint(itemno);
             m_pTrack->m_HighlightedTrackPoint = itemno; // highlight the trackpoint
 
             if( !( m_pTrack->m_bIsInLayer ) && !( m_pTrack == g_pActiveTrack ) ) {
                 m_nSelected = selected_no + 1;
                 m_sdbBtmBtnsSizerSplit->Enable( true );
             }
-            gFrame->JumpToPosition( gFrame->GetPrimaryCanvas(), prp->m_lat, prp->m_lon, gFrame->GetPrimaryCanvas()->GetVPScale() );
+            gFrame->JumpToPosition( gFrame->GetPrimaryCanvas(), prp.m_lat, prp.m_lon, gFrame->GetPrimaryCanvas()->GetVPScale() );
 #ifdef __WXMSW__            
             if(m_lcPoints)
                 m_lcPoints->SetFocus();
@@ -1651,11 +1647,8 @@ wxString OCPNTrackListCtrl::OnGetItemText( long item, long column ) const
     if(item < 0 || item >= m_pTrack->GetnPoints())
         return wxEmptyString;
     
-    TrackPoint              *this_point = m_pTrack->GetPoint(item);
-    TrackPoint              *prev_point = item > 0 ? m_pTrack->GetPoint(item-1) : NULL;
-
-    if( ! this_point )
-        return wxEmptyString;
+    TrackPoint              this_point = m_pTrack->GetPoint(item);
+    TrackPoint              prev_point = m_pTrack->GetPoint(item-1);
 
     double                  gt_brg, gt_leg_dist;
     double slat, slon;
@@ -1666,8 +1659,8 @@ wxString OCPNTrackListCtrl::OnGetItemText( long item, long column ) const
     }
     else
     {
-        slat = prev_point->m_lat;
-        slon = prev_point->m_lon;
+        slat = prev_point.m_lat;
+        slon = prev_point.m_lon;
     }
 
     switch( column )
@@ -1680,27 +1673,27 @@ wxString OCPNTrackListCtrl::OnGetItemText( long item, long column ) const
             break;
 
         case 1:
-            DistanceBearingMercator( this_point->m_lat, this_point->m_lon, slat, slon, &gt_brg, &gt_leg_dist );
+            DistanceBearingMercator( this_point.m_lat, this_point.m_lon, slat, slon, &gt_brg, &gt_leg_dist );
 
             ret.Printf( _T("%6.2f ") + getUsrDistanceUnit(), toUsrDistance( gt_leg_dist ) );
             break;
 
         case 2:
-            DistanceBearingMercator( this_point->m_lat, this_point->m_lon, slat, slon, &gt_brg, &gt_leg_dist );
+            DistanceBearingMercator( this_point.m_lat, this_point.m_lon, slat, slon, &gt_brg, &gt_leg_dist );
             ret.Printf( _T("%03.0f \u00B0T"), gt_brg );
             break;
 
         case 3:
-            ret = toSDMM( 1, this_point->m_lat, 1 );
+            ret = toSDMM( 1, this_point.m_lat, 1 );
             break;
 
         case 4:
-            ret = toSDMM( 2, this_point->m_lon, 1 );
+            ret = toSDMM( 2, this_point.m_lon, 1 );
             break;
 
         case 5:
             {
-                wxDateTime timestamp = this_point->GetCreateTime();
+                wxDateTime timestamp = this_point.GetCreateTime();
                 if( timestamp.IsValid() )
                     ret = timestamp2s( timestamp, m_tz_selection, m_LMT_Offset, TIMESTAMP_FORMAT );
                 else
@@ -1709,13 +1702,13 @@ wxString OCPNTrackListCtrl::OnGetItemText( long item, long column ) const
             break;
 
         case 6:
-            if( ( item > 0 ) && this_point->GetCreateTime().IsValid()
-                    && prev_point->GetCreateTime().IsValid() )
+            if( ( item > 0 ) && this_point.GetCreateTime().IsValid()
+                    && prev_point.GetCreateTime().IsValid() )
             {
-                DistanceBearingMercator( this_point->m_lat, this_point->m_lon, slat, slon, &gt_brg, &gt_leg_dist );
+                DistanceBearingMercator( this_point.m_lat, this_point.m_lon, slat, slon, &gt_brg, &gt_leg_dist );
                 double speed = 0.;
                 double seconds =
-                        this_point->GetCreateTime().Subtract( prev_point->GetCreateTime() ).GetSeconds().ToDouble();
+                        this_point.GetCreateTime().Subtract( prev_point.GetCreateTime() ).GetSeconds().ToDouble();
 
                 if( seconds > 0. )
                     speed = gt_leg_dist / seconds * 3600;
@@ -1834,6 +1834,9 @@ void AISDraw( ocpnDC& dc, ViewPort& vp, ChartCanvas *cp )
 
     //    Draw all targets in three pass loop, sorted on SOG, GPSGate & DSC on top
     //    This way, fast targets are not obscured by slow/stationary targets
+    //    Target names are queued, and drawn together on top of all targets
+    dc.BeginTextBatch();
+
     for( it = ( *current_targets ).begin(); it != ( *current_targets ).end(); ++it ) {
         AIS_Target_Data *td = it->second;
         if( ( td->SOG < g_ShowMoored_Kts )
@@ -1858,6 +1861,8 @@ void AISDraw( ocpnDC& dc, ViewPort& vp, ChartCanvas *cp )
         AIS_Target_Data *td = it->second;
         if( ( td->Class == AIS_GPSG_BUDDY ) || ( td->Class == AIS_DSC ) ) AISDrawTarget( td, dc, vp, cp );
     }
+
+    dc.EndTextBatch();
 }
 
 bool AnyAISTargetsOnscreen( ChartCanvas *cc, ViewPort &vp )
@@ -138,6 +138,10 @@
 #include "cm93.h"
 #include "s52plib.h"
 #include "s57chart.h"
+#include "RenderBench.h"
+#include "TessBench.h"
+#include "RegionBench.h"
+#include "ChartPreloader.h"
 #include "mygdal/cpl_csv.h"
 #include "s52utils.h"
 #endif
@@ -191,6 +195,11 @@ bool                      g_bUpgradeInProcess;
 bool                      g_bPauseTest;
 int                       g_unit_test_1;
 int                       g_unit_test_2;
+wxString                  g_render_bench_script;
+int                       g_region_bench_views;
+wxString                  g_cm93_bench_dir;
+wxString                  g_tess_bench_dir;
+int                       g_bench_exit_code;
 bool                      g_start_fullscreen;
 bool                      g_rebuild_gl_cache;
 bool                      g_parse_all_enc;
@@ -993,6 +1002,10 @@ void MyApp::OnInitCmdLine( wxCmdLineParser& parser )
     parser.AddOption( _T("unit_test_1"), wxEmptyString, _("Display a slideshow of <num> charts and then exit. Zero or negative <num> specifies no limit."), wxCMD_LINE_VAL_NUMBER );
 
     parser.AddSwitch( _T("unit_test_2") );
+    parser.AddOption( _T("render_bench"), wxEmptyString, _T("Run the S-57 render benchmark script <file>, report the timings and exit."), wxCMD_LINE_VAL_STRING );
+    parser.AddOption( _T("region_bench"), wxEmptyString, _T("Run the chart region clipping benchmark over <num> views, report the timings and exit."), wxCMD_LINE_VAL_NUMBER );
+    parser.AddOption( _T("cm93_bench"), wxEmptyString, _T("Run the cm93 cell decode benchmark over the cells in <dir>, report the timings and exit."), wxCMD_LINE_VAL_STRING );
+    parser.AddOption( _T("tess_bench"), wxEmptyString, _T("Run the GLU / libtess2 area tesselation benchmark over the ENC cells in <dir>, report the timings and exit."), wxCMD_LINE_VAL_STRING );
 }
 
 bool MyApp::OnCmdLineParsed( wxCmdLineParser& parser )
@@ -1005,6 +1018,11 @@ bool MyApp::OnCmdLineParsed( wxCmdLineParser& parser )
     g_bdisable_opengl = parser.Found( _T("no_opengl") );
     g_rebuild_gl_cache = parser.Found( _T("rebuild_gl_raster_cache") );
     g_parse_all_enc = parser.Found( _T("parse_all_enc") );
+    parser.Found( _T("render_bench"), &g_render_bench_script );
+    parser.Found( _T("cm93_bench"), &g_cm93_bench_dir );
+    parser.Found( _T("tess_bench"), &g_tess_bench_dir );
+    if( parser.Found( _T("region_bench"), &number ) )
+        g_region_bench_views = wxMax( static_cast<int>( number ), 1 );
     if( parser.Found( _T("unit_test_1"), &number ) )
     {
         g_unit_test_1 = static_cast<int>( number );
@@ -1559,6 +1577,13 @@ bool MyApp::OnInit()
 {
     if( !wxApp::OnInit() ) return false;
 
+#ifdef USE_S57
+    //  The cm93 decode benchmark needs no window, it is run from OnRun()
+    //  before any exists
+    if( !g_cm93_bench_dir.IsEmpty() )
+        return true;
+#endif
+
     GpxDocument::SeedRandom();
 
     last_own_ship_sog_cog_calc_ts = wxInvalidDateTime;
@@ -2402,8 +2427,26 @@ extern ocpnGLOptions g_GLOptions;
     return TRUE;
 }
 
+//  The benchmarks report failure through the exit code
+int MyApp::OnRun()
+{
+#ifdef USE_S57
+    if( !g_cm93_bench_dir.IsEmpty() )
+        return CM93DecodeBench( g_cm93_bench_dir ) ? 0 : 1;
+#endif
+
+    int rc = wxApp::OnRun();
+    return g_bench_exit_code ? g_bench_exit_code : rc;
+}
+
 int MyApp::OnExit()
 {
+#ifdef USE_S57
+    //  Nothing was set up for the cm93 decode benchmark
+    if( !g_cm93_bench_dir.IsEmpty() )
+        return TRUE;
+#endif
+
     wxLogMessage( _T("opencpn::MyApp starting exit.") );
 
     //  Send current nav status data to log file   // pjotrc 2010.02.09
@@ -2561,6 +2604,7 @@ EVT_TIMER(FRAME_TC_TIMER, MyFrame::OnFrameTCTimer)
 EVT_TIMER(FRAME_COG_TIMER, MyFrame::OnFrameCOGTimer)
 EVT_TIMER(MEMORY_FOOTPRINT_TIMER, MyFrame::OnMemFootTimer)
 EVT_MAXIMIZE(MyFrame::OnMaximize)
+EVT_IDLE(MyFrame::OnIdle)
 EVT_COMMAND(wxID_ANY, wxEVT_COMMAND_TOOL_RCLICKED, MyFrame::RequestNewToolbarArgEvent)
 EVT_ERASE_BACKGROUND(MyFrame::OnEraseBackground)
 EVT_TIMER(RESIZE_TIMER, MyFrame::OnResizeTimer)
@@ -2677,6 +2721,11 @@ MyFrame::MyFrame( wxFrame *frame, const wxString& title, const wxPoint& pos, con
 
     //  And from the thread SENC creator
     Connect( wxEVT_OCPN_BUILDSENCTHREAD, (wxObjectEventFunction) (wxEventFunction) &MyFrame::OnSENCEvtThread );
+
+#ifdef USE_S57
+    //  And from the background cm93 cell loader
+    Connect( wxEVT_OCPN_CM93CELLLOADED, (wxObjectEventFunction) (wxEventFunction) &MyFrame::OnCM93CellLoaded );
+#endif
     //        Establish the system icons for the frame.
 
 #ifdef __WXMSW__
@@ -2709,11 +2758,13 @@ MyFrame::MyFrame( wxFrame *frame, const wxString& title, const wxPoint& pos, con
     m_resizeTimer.SetOwner(this, RESIZE_TIMER);
     m_recaptureTimer.SetOwner(this, RECAPTURE_TIMER);
 
+    m_pChartPreloader = new ChartPreloader;
 }
 
 MyFrame::~MyFrame()
 {
     FrameTimer1.Stop();
+    delete m_pChartPreloader;
     delete ChartData;
     //delete pCurrentStack;
 
@@ -2849,6 +2900,14 @@ ColorScheme MyFrame::GetColorScheme()
     return global_color_scheme;
 }
 
+#ifdef USE_S57
+void MyFrame::OnCM93CellLoaded( wxCommandEvent& event )
+{
+    //  More cm93 cells are decoded, so let the canvases pick them up
+    ReloadAllVP();
+}
+#endif
+
 void MyFrame::ReloadAllVP()
 {
     for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
@@ -4795,6 +4854,15 @@ void MyFrame::InvalidateAllGL()
 #endif
 }
 
+void MyFrame::InvalidateAllQuilts()
+{
+    for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
+        ChartCanvas *cc = g_canvasArray.Item(i);
+        if(cc)
+            cc->InvalidateQuilt();
+    }
+}
+
 void MyFrame::RefreshAllCanvas( bool bErase)
 {
     // For each canvas
@@ -5020,9 +5088,9 @@ void MyFrame::TrackOn( void )
     wxString name = g_pActiveTrack->GetName();
     if(name.IsEmpty())
     {
-        TrackPoint *tp = g_pActiveTrack->GetPoint( 0 );
-        if( tp->GetCreateTime().IsValid() )
-            name = tp->GetCreateTime().FormatISODate() + _T(" ") + tp->GetCreateTime().FormatISOTime();
+        TrackPoint tp = g_pActiveTrack->GetPoint( 0 );
+        if( tp.GetCreateTime().IsValid() )
+            name = tp.GetCreateTime().FormatISODate() + _T(" ") + tp.GetCreateTime().FormatISOTime();
         else
             name = _("(Unnamed Track)");
     }
@@ -5135,9 +5203,9 @@ void MyFrame::TrackDailyRestart( void )
     //  Set the restarted track's current state such that the current track point's attributes match the
     //  attributes of the last point of the track that was just stopped at midnight.
 
-    if( pPreviousTrack ) {
-        TrackPoint *pMidnightPoint = pPreviousTrack->GetLastPoint();
-        g_pActiveTrack->AdjustCurrentTrackPoint(pMidnightPoint);
+    if( pPreviousTrack && pPreviousTrack->GetnPoints() ) {
+        TrackPoint MidnightPoint = pPreviousTrack->GetLastPoint();
+        g_pActiveTrack->AdjustCurrentTrackPoint(MidnightPoint);
     }
 
     if( pRouteManagerDialog && pRouteManagerDialog->IsShown() ) {
@@ -6429,6 +6497,9 @@ bool MyFrame::UpdateChartDatabaseInplace( ArrayOfCDI &DirArray, bool b_force, bo
     bool b_run = FrameTimer1.IsRunning();
     FrameTimer1.Stop();                  // stop other asynchronous activity
 
+    if( m_pChartPreloader )
+        m_pChartPreloader->Invalidate();
+
     // ..For each canvas...
     for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
         ChartCanvas *cc = g_canvasArray.Item(i);
@@ -6992,10 +7063,53 @@ void MyFrame::CheckToolbarPosition()
 #endif
 }
 
+//  Work that must stay off the paint path runs once the event queue is empty
+void MyFrame::OnIdle( wxIdleEvent& event )
+{
+    if( m_pChartPreloader )
+        m_pChartPreloader->Idle();
+
+    event.Skip();
+}
+
 void MyFrame::OnFrameTimer1( wxTimerEvent& event )
 {
     CheckToolbarPosition();
 
+#ifdef USE_S57
+    //  Once startup is complete, so the frame can close normally afterwards
+    if( !g_render_bench_script.IsEmpty() && g_bDeferredInitDone ) {
+        FrameTimer1.Stop();
+        LoadS57();
+        RenderBench bench;
+        if( !bench.Run( g_render_bench_script, GetPrimaryCanvas() ) )
+            g_bench_exit_code = 1;
+        g_render_bench_script.Clear();
+        Close();
+        return;
+    }
+
+    if( !g_tess_bench_dir.IsEmpty() && g_bDeferredInitDone ) {
+        FrameTimer1.Stop();
+        TessBench bench;
+        if( !bench.Run( g_tess_bench_dir ) )
+            g_bench_exit_code = 1;
+        g_tess_bench_dir.Clear();
+        Close();
+        return;
+    }
+#endif
+
+    if( g_region_bench_views && g_bDeferredInitDone ) {
+        FrameTimer1.Stop();
+        RegionBench bench;
+        if( !bench.Run( g_region_bench_views ) )
+            g_bench_exit_code = 1;
+        g_region_bench_views = 0;
+        Close();
+        return;
+    }
+
     if( ! g_bPauseTest && (g_unit_test_1 || g_unit_test_2) ) {
 //            if((0 == ut_index) && GetQuiltMode())
 //                  ToggleQuiltMode();
@@ -7413,6 +7527,14 @@ void MyFrame::OnFrameTimer1( wxTimerEvent& event )
     if( g_pAISTargetList && ( 0 == ( g_tick % ( 5 ) ) ) )
         g_pAISTargetList->UpdateAISTargetList();
 
+    //  Fold the navobj journal into navobj.xml now and then, in the background
+    if( pConfig && ( 0 == ( g_tick % ( 10 ) ) ) )
+        pConfig->CheckNavObjJournal();
+
+    //  Plan the chart cache warming along the track ahead, the charts open on idle
+    if( m_pChartPreloader )
+        m_pChartPreloader->Tick();
+
     //  Pick up any change Toolbar status displays
     UpdateGPSCompassStatusBoxes();
     UpdateAISTool();
@@ -8292,9 +8414,9 @@ void MyFrame::OnEvtPlugInMessage( OCPN_MsgEvent & event )
                 name = (*it)->GetName();
                 if(name.IsEmpty())
                 {
-                    TrackPoint *rp = (*it)->GetPoint( 0 );
-                    if( rp && rp->GetCreateTime().IsValid() )
-                        name = rp->GetCreateTime().FormatISODate() + _T(" ") + rp->GetCreateTime().FormatISOTime();
+                    TrackPoint rp = (*it)->GetPoint( 0 );
+                    if( rp.GetCreateTime().IsValid() )
+                        name = rp.GetCreateTime().FormatISODate() + _T(" ") + rp.GetCreateTime().FormatISOTime();
                     else
                         name = _("(Unnamed Track)");
                 }
@@ -8305,9 +8427,8 @@ void MyFrame::OnEvtPlugInMessage( OCPN_MsgEvent & event )
                 v[_T("TotalNodes")] = (*it)->GetnPoints();
                 for(int j = 0; j< (*it)->GetnPoints(); j++)
                 {
-                    TrackPoint *tp = (*it)->GetPoint(j);
-                    v[_T("lat")] = tp->m_lat;
-                    v[_T("lon")] = tp->m_lon;
+                    v[_T("lat")] = (*it)->GetPointLat(j);
+                    v[_T("lon")] = (*it)->GetPointLon(j);
                     v[_T("NodeNr")] = i;
                     i++;
                     wxString msg_id( _T("OCPN_TRACKPOINTS_COORDS") );
@@ -8420,10 +8541,10 @@ void MyFrame::OnEvtPlugInMessage( OCPN_MsgEvent & event )
                     wxString name = (*it)->GetName();
                     if(name.IsEmpty())
                     {
-                        TrackPoint *tp = (*it)->GetPoint( 0 );
-                        if( tp && tp->GetCreateTime().IsValid() )
-                            name = tp->GetCreateTime().FormatISODate() + _T(" ")
-                                + tp->GetCreateTime().FormatISOTime();
+                        TrackPoint tp = (*it)->GetPoint( 0 );
+                        if( tp.GetCreateTime().IsValid() )
+                            name = tp.GetCreateTime().FormatISODate() + _T(" ")
+                                + tp.GetCreateTime().FormatISOTime();
                         else
                             name = _("(Unnamed Track)");
                     }
@@ -52,6 +52,7 @@
 #include <wx/progdlg.h>
 
 #include "chcanv.h"
+#include "Quilt.h"
 
 #ifdef USE_S57
 #include "s57chart.h"
@@ -68,6 +69,21 @@ extern int          g_memCacheLimit;
 extern bool         g_bopengl;
 extern s52plib      *ps52plib;
 extern ChartDB      *ChartData;
+extern double       gLat, gLon;
+extern bool         bGPSValid;
+
+WX_DEFINE_ARRAY_PTR(ChartCanvas*, arrayofCanvasPtr);
+extern arrayofCanvasPtr g_canvasArray;
+
+//    Eviction scoring floors, so new and tiny entries still compare sensibly
+#define CACHE_MIN_OPEN_MS       10.
+#define CACHE_MIN_CHART_KB      64
+
+//    Chart memory footprint estimates
+#define CACHE_VECTOR_EXPANSION  4.
+#define CACHE_MAX_CHART_KB      (256 * 1024)
+#define CACHE_CM93_CHART_KB     (64 * 1024)
+#define CACHE_RASTER_CHART_KB   (4 * 1024)
 
 bool G_FloatPtInPolygon(MyFlPoint *rgpts, int wnumpts, float x, float y) ;
 bool GetMemoryStatus(int *mem_total, int *mem_used);
@@ -231,6 +247,10 @@ ChartDB::ChartDB()
       m_b_busy = false;
       m_ticks = 0;
 
+      m_cache_stats.hits = m_cache_stats.misses = m_cache_stats.evictions = 0;
+      m_cache_stats.mem_kb = 0;
+      m_cache_stats.open_ms = 0.;
+
       //    Report cache policy
       if(g_memCacheLimit)
       {
@@ -285,11 +305,28 @@ void ChartDB::DeleteCacheEntry(CacheEntry *pce, bool bDelTexture, const wxString
          g_glTextureManager->PurgeChartTextures(ch, bDelTexture);
 #endif
 
+     m_cache_stats.mem_kb -= pce->mem_kb;
+
      pChartCache->Remove(pce);
      delete ch;
      delete pce;
 }
 
+//    Evict a chart to make room, updating mem_used.
+//    The allocator may keep freed pages, so the application memory measured
+//    afterwards can stay high.  Count the chart's own accounted size as freed,
+//    otherwise one new chart could flush the whole cache.
+void ChartDB::EvictCacheEntry(CacheEntry *pce, bool bDelTexture, const wxString &msg, int &mem_used)
+{
+     int freed = pce->mem_kb;
+     DeleteCacheEntry(pce, bDelTexture, msg);
+     m_cache_stats.evictions++;
+
+     int mem_now;
+     GetMemoryStatus(0, &mem_now);
+     mem_used = wxMin(mem_now, mem_used - freed);
+}
+
 void ChartDB::DeleteCacheEntry(int i, bool bDelTexture, const wxString &msg)
 {
      CacheEntry *pce = (CacheEntry *)(pChartCache->Item(i));
@@ -303,7 +340,9 @@ void ChartDB::PurgeCache()
       wxLogMessage(_T("Chart cache purge"));
 
       if( wxMUTEX_NO_ERROR == m_cache_mutex.Lock() ){
+        ChartCacheStats stats = m_cache_stats;
         unsigned int nCache = pChartCache->GetCount();
+
         for(unsigned int i=0 ; i<nCache ; i++)
         {
                DeleteCacheEntry(0, true);
@@ -311,6 +350,8 @@ void ChartDB::PurgeCache()
         pChartCache->Clear();
         
         m_cache_mutex.Unlock();
+
+        LogCacheStats(stats, nCache);
       }
 }
 
@@ -383,18 +424,16 @@ void ChartDB::PurgeCacheUnusedCharts( double factor)
                         break;
                     }
                     
-                    CacheEntry *pce = FindOldestDeleteCandidate( false );
+                    CacheEntry *pce = FindDeleteCandidate( false );
                     if(pce){
                         // don't purge background spooler
-                        DeleteCacheEntry(pce, false /*true*/, msg);
+                        EvictCacheEntry(pce, false /*true*/, msg, mem_used);
                         //printf("DCE, new count is:  %d\n", pChartCache->GetCount()); 
                     }
                     else {
                         break;
                     }
                     
-                    GetMemoryStatus(0, &mem_used);
-                    
                     nl--;
                 }
         }
@@ -420,10 +459,11 @@ void ChartDB::PurgeCacheUnusedCharts( double factor)
                         break;
                     }
                     
-                    CacheEntry *pce = FindOldestDeleteCandidate( false );
+                    CacheEntry *pce = FindDeleteCandidate( false );
                     if(pce){
                         // don't purge background spooler
                         DeleteCacheEntry(pce, false /*true*/, msg);
+                        m_cache_stats.evictions++;
                     }
                     else {
                         break;
@@ -1124,7 +1164,79 @@ ChartBase *ChartDB::OpenChartFromDBAndLock(wxString chart_path, ChartInitFlag in
     return OpenChartFromDBAndLock(dbii, init_flag);
 }
 
-CacheEntry *ChartDB::FindOldestDeleteCandidate( bool blog)
+//    How much evicting this chart is worth, higher first.
+//    Charts that have not been asked for in a while, are big, reopen quickly,
+//    and lie far from every canvas view and from own-ship score highest, so
+//    the charts around the view survive panning back and forth over a chart
+//    boundary.
+double ChartDB::EvictionScore( CacheEntry *pce, const std::vector<LLBBox> &views )
+{
+    double age = m_ticks - pce->RecentTime;
+    double size = wxMax(pce->mem_kb, CACHE_MIN_CHART_KB);
+    double cost = pce->open_ms + CACHE_MIN_OPEN_MS;
+
+    //  Distance to the nearest view, in view heights
+    double distance = 0.;
+    Extent ext;
+    if( views.size() && ((ChartBase *)pce->pChart)->GetChartExtent(&ext) ) {
+        distance = 1e6;
+        for( size_t i = 0; i < views.size(); i++ ) {
+            const LLBBox &v = views[i];
+            double height = wxMax(v.GetMaxLat() - v.GetMinLat(), 1e-6);
+            double dlat = wxMax(0., wxMax(v.GetMinLat() - ext.NLAT, ext.SLAT - v.GetMaxLat()));
+            double dlon = wxMax(0., wxMax(v.GetMinLon() - ext.ELON, ext.WLON - v.GetMaxLon()));
+            distance = wxMin(distance, sqrt(dlat * dlat + dlon * dlon) / height);
+        }
+    }
+
+    return (1. + age) * (1. + distance) * size / cost;
+}
+
+//    Is this chart drawn on any canvas right now, as part of its quilt or
+//    as its single chart?
+bool ChartDB::IsCacheEntryShown( CacheEntry *pce )
+{
+    for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
+        ChartCanvas *cc = g_canvasArray.Item(i);
+        if(!cc)
+            continue;
+        if(cc->GetQuiltMode()){
+            if(cc->m_pQuilt && cc->m_pQuilt->IsChartInQuilt(pce->FullPath))
+                return true;
+        }
+        else if(cc->m_singleChart == pce->pChart)
+            return true;
+    }
+    return false;
+}
+
+//    Estimated memory a chart holds once open, in kB.
+//    Vector cells grow several times over their source file once their
+//    objects are built.  The file size says nothing about what the others
+//    hold: raster charts keep little more than the line index and a screen
+//    sized pixel cache, their tiles being accounted by the texture cache,
+//    and cm93 and MBTiles load their data on demand.
+int ChartDB::EstimateChartFootprintKB( const wxString &path, ChartTypeEnum type, ChartFamilyEnum family )
+{
+    if(type == CHART_TYPE_CM93COMP)
+        return CACHE_CM93_CHART_KB;
+    if(type == CHART_TYPE_MBTILES)
+        return CACHE_MIN_CHART_KB;
+    if(family == CHART_FAMILY_RASTER)
+        return CACHE_RASTER_CHART_KB;
+
+    wxULongLong size = wxFileName::GetSize(path);
+    if(size == wxInvalidSize)
+        return CACHE_MIN_CHART_KB;
+
+    double kb = size.ToDouble() / 1024.;
+    if(family == CHART_FAMILY_VECTOR)
+        kb *= CACHE_VECTOR_EXPANSION;
+
+    return wxMax(CACHE_MIN_CHART_KB, (int)wxMin(kb, (double)CACHE_MAX_CHART_KB));
+}
+
+CacheEntry *ChartDB::FindDeleteCandidate( bool blog)
 {
     CacheEntry *pret = 0;
     
@@ -1133,27 +1245,52 @@ CacheEntry *ChartDB::FindOldestDeleteCandidate( bool blog)
         if(nCache > 1)
         {
             if(blog)
-                wxLogMessage(_T("Searching chart cache for oldest entry"));
-            int LRUTime = m_ticks;
-            int iOldest = 0;
+                wxLogMessage(_T("Searching chart cache for the best eviction candidate"));
+
+            //  The canvas views, and own-ship in a box the size of the first one
+            std::vector<LLBBox> views;
+            for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
+                ChartCanvas *cc = g_canvasArray.Item(i);
+                if(cc && cc->GetVP().IsValid())
+                    views.push_back(cc->GetVP().GetBBox());
+            }
+            if(bGPSValid && views.size()){
+                double dlat = (views[0].GetMaxLat() - views[0].GetMinLat()) / 2;
+                double dlon = (views[0].GetMaxLon() - views[0].GetMinLon()) / 2;
+                LLBBox ship;
+                ship.Set(gLat - dlat, gLon - dlon, gLat + dlat, gLon + dlon);
+                views.push_back(ship);
+            }
+
+            //  Charts on screen go only when nothing else can
+            double best = -1., best_shown = -1.;
+            int iBest = -1, iBestShown = -1;
             for(unsigned int i=0 ; i<nCache ; i++)
             {
                 CacheEntry *pce = (CacheEntry *)(pChartCache->Item(i));
-                if(pce->RecentTime < LRUTime && !pce->n_lock){
-                    LRUTime = pce->RecentTime;
-                    iOldest = i;
+                if(pce->n_lock)
+                    continue;
+
+                double score = EvictionScore(pce, views);
+                if(IsCacheEntryShown(pce)){
+                    if(score > best_shown){
+                        best_shown = score;
+                        iBestShown = i;
+                    }
+                }
+                else if(score > best){
+                    best = score;
+                    iBest = i;
                 }
             }
-            int dt = m_ticks - LRUTime;
+            if(iBest < 0)
+                iBest = iBestShown;
 
-            CacheEntry *pce = (CacheEntry *)(pChartCache->Item(iOldest));
-            ChartBase *pDeleteCandidate =  (ChartBase *)(pce->pChart);
-                
-            if( (!pce->n_lock) ){
+            if( iBest >= 0 ){
+                pret = (CacheEntry *)(pChartCache->Item(iBest));
                 if(blog)
-                    wxLogMessage(_T("Oldest unlocked cache index is %d, delta t is %d"), iOldest, dt);
-                
-                pret = pce;
+                    wxLogMessage(_T("Eviction candidate cache index is %d, delta t is %d, open %.0f ms, %d kB"),
+                                 iBest, m_ticks - pret->RecentTime, pret->open_ms, pret->mem_kb);
             }
             else
                 wxLogMessage(_T("All chart in cache locked, size: %d"), nCache);
@@ -1164,6 +1301,24 @@ CacheEntry *ChartDB::FindOldestDeleteCandidate( bool blog)
     return pret;
 }
 
+ChartCacheStats ChartDB::GetCacheStats()
+{
+    wxMutexLocker lock(m_cache_mutex);
+    return m_cache_stats;
+}
+
+//    Log a copy of the counters, taken with the cache mutex held
+void ChartDB::LogCacheStats( const ChartCacheStats &stats, int nCharts )
+{
+    long requests = stats.hits + stats.misses;
+    wxString msg;
+    msg.Printf(_T("Chart cache: %d charts, %ld kB accounted, hits %ld (%.1f%%), misses %ld, evictions %ld, %.0f ms opening"),
+               nCharts, stats.mem_kb, stats.hits,
+               requests ? 100. * stats.hits / requests : 0., stats.misses,
+               stats.evictions, stats.open_ms);
+    wxLogMessage(msg);
+}
+
 
 
 ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
@@ -1190,6 +1345,9 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
       int old_lock = 0;
 
       bool bInCache = false;
+      bool bEvicted = false;
+      ChartCacheStats evict_stats;
+      int evict_count = 0;
 
 //    Search the cache
       {
@@ -1221,6 +1379,7 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
                         pce->RecentTime = m_ticks;           // chart is OK
                         pce->b_in_use = true;
                     }
+                    m_cache_stats.hits++;
                     return Ch;
               }
               else
@@ -1229,6 +1388,7 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
                        pthumbwin->pThumbChart = NULL;
                     delete Ch;                                  // chart is not useable
                     old_lock = pce->n_lock;
+                    m_cache_stats.mem_kb -= pce->mem_kb;
                     pChartCache->Remove(pce);                   // so remove it
                     delete pce;
                         
@@ -1241,12 +1401,14 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
                    pce->RecentTime = m_ticks;
                    pce->b_in_use = true;
                }
+               m_cache_stats.hits++;
                return Ch;
           }
         }
 
         if(!bInCache)                    // not in cache
         {
+            m_cache_stats.misses++;
             m_b_busy = true;
             if( !m_b_locked ) {
                 //    Use memory limited cache policy, if defined....
@@ -1268,18 +1430,20 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
                         wxString msg(_T("Removing oldest chart from cache: "));
                         while (1)
                         {
-                          CacheEntry *pce = FindOldestDeleteCandidate(true);
+                          CacheEntry *pce = FindDeleteCandidate(true);
                           if (pce == 0)
                               break;                      // no possible delete candidate
                           
                           // purge texture cache, really need memory here
-                          DeleteCacheEntry(pce, true, msg);
+                          EvictCacheEntry(pce, true, msg, mem_used);
 
-                          GetMemoryStatus(0, &mem_used);
                           if((mem_used < g_memCacheLimit * 8 / 10) || (pChartCache->GetCount() <= 2)) 
                               break;
                                 
                         }  // while
+                        bEvicted = true;
+                        evict_stats = m_cache_stats;
+                        evict_count = pChartCache->GetCount();
                     }
                 }
 
@@ -1292,13 +1456,17 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
                         wxString msg(_T("Removing oldest chart from cache: "));
                         while (nCache > (unsigned int)g_nCacheLimit)
                         {
-                            CacheEntry *pce = FindOldestDeleteCandidate( true );
+                            CacheEntry *pce = FindDeleteCandidate( true );
                             if (pce == 0)
                                 break;
                             
                             DeleteCacheEntry(pce, true, msg);
+                            m_cache_stats.evictions++;
                             nCache--;
                         }
+                        bEvicted = true;
+                        evict_stats = m_cache_stats;
+                        evict_count = pChartCache->GetCount();
                     }
                     
                 }
@@ -1306,6 +1474,9 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
         }
       } // unlock
 
+      if(bEvicted)
+          LogCacheStats(evict_stats, evict_count);
+
       if(!bInCache)                    // not in cache
       {
             wxLogMessage(_T("Creating new chart"));
@@ -1432,6 +1603,7 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
             if(Ch)
             {
                   InitReturn ir;
+                  wxStopWatch sw;
                   
 #ifdef USE_S57
                   s52plib *plib = ps52plib;
@@ -1458,6 +1630,8 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
 
                   }
 
+                  double open_ms = sw.Time();
+
                   if(INIT_OK == ir)
                   {
 
@@ -1472,9 +1646,13 @@ ChartBase *ChartDB::OpenChartUsingCache(int dbindex, ChartInitFlag init_flag)
 //                              printf("    Adding chart %d\n", dbindex);
                               pce->RecentTime = m_ticks;
                               pce->n_lock = old_lock;
+                              pce->open_ms = open_ms;
+                              pce->mem_kb = EstimateChartFootprintKB(ChartFullPath, chart_type, chart_family);
 
                               if( wxMUTEX_NO_ERROR == m_cache_mutex.Lock() ){
                                 pChartCache->Add((void *)pce);
+                                m_cache_stats.mem_kb += pce->mem_kb;
+                                m_cache_stats.open_ms += open_ms;
                                 m_cache_mutex.Unlock();
                               }
                               else {
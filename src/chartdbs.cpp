@@ -1064,6 +1064,8 @@ WX_DEFINE_OBJARRAY(ArrayOfChartClassDescriptor);
 ChartDatabase::ChartDatabase()
 {
       bValid = false;
+      m_b_updating = false;
+      m_table_generation = 0;
       m_ChartTableEntryDummy.Clear();
 
       UpdateChartClassDescriptorArray();
@@ -1506,6 +1508,9 @@ wxString ChartDatabase::GetFullChartInfo(ChartBase *pc, int dbIndex, int *char_w
 // ----------------------------------------------------------------------------
 bool ChartDatabase::Create(ArrayOfCDI &dir_array, wxGenericProgressDialog *pprog)
 {
+      std::lock_guard<std::mutex> table_lock( m_table_mutex );
+      m_b_updating = true;
+
       m_dir_array = dir_array;
 
       bValid = false;
@@ -1514,13 +1519,15 @@ bool ChartDatabase::Create(ArrayOfCDI &dir_array, wxGenericProgressDialog *pprog
       active_chartTable.Clear();
       active_chartTable_pathindex.clear();
 
-      Update(dir_array, true, pprog);                   // force the update the reload everything
+      UpdateTable(dir_array, true, pprog);              // force the update the reload everything
 
       bValid = true;
 
       //      Explicitly set the version
       m_dbversion = DB_VERSION_CURRENT;
 
+      m_table_generation++;
+      m_b_updating = false;
       return true;
 }
 
@@ -1533,6 +1540,18 @@ bool ChartDatabase::Create(ArrayOfCDI &dir_array, wxGenericProgressDialog *pprog
 //    resulting in valid pChartTable in (this)
 // ----------------------------------------------------------------------------
 bool ChartDatabase::Update(ArrayOfCDI& dir_array, bool bForce, wxGenericProgressDialog *pprog)
+{
+      std::lock_guard<std::mutex> table_lock( m_table_mutex );
+      m_b_updating = true;
+
+      bool ret = UpdateTable(dir_array, bForce, pprog);
+
+      m_table_generation++;
+      m_b_updating = false;
+      return ret;
+}
+
+bool ChartDatabase::UpdateTable(ArrayOfCDI& dir_array, bool bForce, wxGenericProgressDialog *pprog)
 {
       m_dir_array = dir_array;
 
@@ -2362,6 +2381,9 @@ bool ChartDatabase::AddChart( wxString &chartfilename, ChartClassDescriptor &cha
 
 bool ChartDatabase::AddSingleChart( wxString &ChartFullPath, bool b_force_full_search )
 {
+    std::lock_guard<std::mutex> table_lock( m_table_mutex );
+    m_b_updating = true;
+
     //  Find a relevant chart class descriptor
     wxFileName fn(ChartFullPath);
     wxString ext = fn.GetExt();
@@ -2461,6 +2483,8 @@ bool ChartDatabase::AddSingleChart( wxString &ChartFullPath, bool b_force_full_s
 
     m_nentries = active_chartTable.GetCount();
 
+    m_table_generation++;
+    m_b_updating = false;
     return rv;
 
 }
@@ -2468,6 +2492,9 @@ bool ChartDatabase::AddSingleChart( wxString &ChartFullPath, bool b_force_full_s
 
 bool ChartDatabase::RemoveSingleChart( wxString &ChartFullPath )
 {
+    std::lock_guard<std::mutex> table_lock( m_table_mutex );
+    m_b_updating = true;
+
     bool rv = false;
 
     //  Walk the chart table, looking for the target
@@ -2518,6 +2545,8 @@ bool ChartDatabase::RemoveSingleChart( wxString &ChartFullPath )
 
     m_nentries = active_chartTable.GetCount();
 
+    m_table_generation++;
+    m_b_updating = false;
     return rv;
 }
 
@@ -645,6 +645,7 @@ void ChartSymbols::BuildLookup( Lookup &lookup )
     memcpy( LUP->OBCL, lookup.name.mb_str(), 7 );
 
     LUP->ATTArray = lookup.attributeCodeArray;
+    s52plib::CompileLUPAttributes( LUP );
 
     LUP->INST = new wxString( lookup.instruction );
     LUP->LUCM = lookup.comment;
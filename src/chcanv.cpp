@@ -436,6 +436,7 @@ ChartCanvas::ChartCanvas ( wxFrame *frame, int canvasIndex ) :
     pss_overlay_bmp = NULL;
     pss_overlay_mask = NULL;
     m_bChartDragging = false;
+    m_last_input_time = 0;
     m_bMeasure_Active = false;
     m_bMeasure_DistCircle = false;
     m_pMeasureRoute = NULL;
@@ -2627,6 +2628,7 @@ void ChartCanvas::OnKeyDown( wxKeyEvent &event )
 
     bool b_handled = false;
 
+    m_last_input_time = wxGetLocalTimeMillis();
     m_modkeys = event.GetModifiers();
 
     int panspeed = m_modkeys == wxMOD_ALT ? 2 : 100;
@@ -3389,6 +3391,20 @@ bool ChartCanvas::StartTimedMovement( bool stoptimer )
     return true;
 }
 
+//  True while the canvas is being panned, zoomed or rotated, or within quiet_ms
+//  of the last mouse button, wheel or key event
+bool ChartCanvas::IsUserInteracting( long quiet_ms )
+{
+    if( m_bChartDragging || m_MouseDragging || m_bzooming )
+        return true;
+    if( m_pan_drag != wxPoint( 0, 0 ) || m_panx || m_pany || m_zoom_factor != 1 || m_rotation_speed )
+        return true;
+    if( pPanTimer && pPanTimer->IsRunning() )
+        return true;
+
+    return wxGetLocalTimeMillis() - m_last_input_time < quiet_ms;
+}
+
 void ChartCanvas::DoTimedMovement()
 {
     if( m_pan_drag == wxPoint(0, 0) && !m_panx && !m_pany && m_zoom_factor==1 && !m_rotation_speed)
@@ -3890,12 +3906,12 @@ void ChartCanvas::OnRolloverPopupTimerEvent( wxTimerEvent& event )
 
                 if( !m_pTrackRolloverWin->IsActive() ) {
                     wxString s;
-                    TrackPoint *segShow_point_a = (TrackPoint *) m_pRolloverTrackSeg->m_pData1;
-                    TrackPoint *segShow_point_b = (TrackPoint *) m_pRolloverTrackSeg->m_pData2;
+                    TrackPoint segShow_point_a = pt->GetPoint( m_pRolloverTrackSeg->m_Data4 );
+                    TrackPoint segShow_point_b = pt->GetPoint( m_pRolloverTrackSeg->m_Data5 );
 
                     double brg, dist;
-                    DistanceBearingMercator( segShow_point_b->m_lat, segShow_point_b->m_lon,
-                                             segShow_point_a->m_lat, segShow_point_a->m_lon, &brg, &dist );
+                    DistanceBearingMercator( segShow_point_b.m_lat, segShow_point_b.m_lon,
+                                             segShow_point_a.m_lat, segShow_point_a.m_lon, &brg, &dist );
 
                     if( !pt->m_bIsInLayer )
                         s.Append( _("Track") + _T(": ") );
@@ -3913,8 +3929,8 @@ void ChartCanvas::OnRolloverPopupTimerEvent( wxTimerEvent& event )
                     if( g_bShowTrue )
                         s << wxString::Format( wxString("%03d°  ", wxConvUTF8 ), (int)brg );
                     if( g_bShowMag ){
-                        double latAverage = (segShow_point_b->m_lat + segShow_point_a->m_lat)/2;
-                        double lonAverage = (segShow_point_b->m_lon + segShow_point_a->m_lon)/2;
+                        double latAverage = (segShow_point_b.m_lat + segShow_point_a.m_lat)/2;
+                        double lonAverage = (segShow_point_b.m_lon + segShow_point_a.m_lon)/2;
                         double varBrg = gFrame->GetMag( brg, latAverage, lonAverage);
 
                         s << wxString::Format( wxString("%03d°(M)  ", wxConvUTF8 ), (int)varBrg );
@@ -3922,8 +3938,8 @@ void ChartCanvas::OnRolloverPopupTimerEvent( wxTimerEvent& event )
 
                     s << FormatDistanceAdaptive( dist );
 
-                    if(segShow_point_a->GetTimeString() && segShow_point_b->GetTimeString()){
-                        double segmentSpeed = toUsrSpeed( dist / ( (segShow_point_b->GetCreateTime() - segShow_point_a->GetCreateTime()).GetSeconds().ToDouble() / 3600.) );
+                    if(segShow_point_a.HasCreateTime() && segShow_point_b.HasCreateTime()){
+                        double segmentSpeed = toUsrSpeed( dist / ( (segShow_point_b.GetCreateTime() - segShow_point_a.GetCreateTime()).GetSeconds().ToDouble() / 3600.) );
                         s << wxString::Format( _T("  %.1f "), (float)segmentSpeed ) << getUsrSpeedUnit();
                     }
 
@@ -5171,6 +5187,16 @@ bool ChartCanvas::SetViewPoint( double lat, double lon, double scale_ppm, double
                 m_pQuilt->Compose( VPoint );
 //                printf("comp time %ld\n", sw.Time());
 
+                //  Get the regions ready for where the view is heading, assuming it keeps moving
+                if( last_vp.IsValid() && last_vp.view_scale_ppm > 0 ) {
+                    ViewPort vp_next = VPoint;
+                    vp_next.clat = wxMax( -85., wxMin( 85., 2 * VPoint.clat - last_vp.clat ) );
+                    vp_next.clon = 2 * VPoint.clon - last_vp.clon;
+                    vp_next.view_scale_ppm = VPoint.view_scale_ppm * VPoint.view_scale_ppm / last_vp.view_scale_ppm;
+                    vp_next.SetBoxes();
+                    m_pQuilt->ComposeAhead( vp_next );
+                }
+
                 //      If the extended chart stack has changed, invalidate any cached render bitmap
 //                if(m_pQuilt->GetXStackHash() != hash1) {
 //                    m_bm_cache_vp.Invalidate();
@@ -6268,10 +6294,10 @@ void ChartCanvas::UpdateShips()
     ShipDraw( ocpndc );
 
     if( g_pActiveTrack && g_pActiveTrack->IsRunning() ) {
-        TrackPoint* p = g_pActiveTrack->GetLastPoint();
-        if( p ) {
+        if( g_pActiveTrack->GetnPoints() ) {
+            TrackPoint p = g_pActiveTrack->GetLastPoint();
             wxPoint px;
-            GetCanvasPointPix( p->m_lat, p->m_lon, &px );
+            GetCanvasPointPix( p.m_lat, p.m_lon, &px );
             ocpndc.CalcBoundingBox( px.x, px.y );
         }
     }
@@ -6816,6 +6842,8 @@ bool ChartCanvas::MouseEventSetup( wxMouseEvent& event,  bool b_handle_dclick )
     event.GetPosition( &x, &y );
 
     m_MouseDragging = event.Dragging();
+    if( !event.Moving() )
+        m_last_input_time = wxGetLocalTimeMillis();
 
     //  Some systems produce null drag events, where the pointer position has not changed from the previous value.
     //  Detect this case, and abort further processing (FS#1748)
@@ -9100,31 +9128,22 @@ void pupHandler_PasteTrack() {
     Track* pasted = kml.GetParsedTrack();
     if( ! pasted ) return;
 
-    TrackPoint* curPoint;
-
     Track* newTrack = new Track();
-    TrackPoint* newPoint;
-    TrackPoint* prevPoint = NULL;
 
     newTrack->SetName(pasted->GetName());
+    newTrack->Reserve( pasted->GetnPoints() );
 
     for( int i = 0; i < pasted->GetnPoints(); i++ ) {
-        curPoint = pasted->GetPoint( i );
-
-        newPoint = new TrackPoint( curPoint );
-
-        wxDateTime now = wxDateTime::Now();
-        newPoint->SetCreateTime(curPoint->GetCreateTime());
+        TrackPoint newPoint = pasted->GetPoint( i );
+        newPoint.m_GPXTrkSegNo = 1;
 
         newTrack->AddPoint( newPoint );
 
-        if( prevPoint )
+        if( i )
             pSelect->AddSelectableTrackSegment(
-                prevPoint->m_lat, prevPoint->m_lon,
-                newPoint->m_lat, newPoint->m_lon,
-                prevPoint, newPoint, newTrack );
-
-        prevPoint = newPoint;
+                pasted->GetPointLat( i - 1 ), pasted->GetPointLon( i - 1 ),
+                newPoint.m_lat, newPoint.m_lon,
+                i - 1, i, newTrack );
     }
 
     pTrackList->Append( newTrack );
@@ -12952,6 +12971,10 @@ bool ChartCanvas::UpdateS52State()
         // TODO ps52plib->m_bShowAtons = m_encShowBuoys;
         ps52plib->SetAnchorOn( m_encShowAnchor );
         ps52plib->SetQualityOfData( m_encShowDataQual );
+
+        //  Only the render filters differ between canvases, so the charts
+        //  shared with another canvas keep their prepared rules
+        ps52plib->UpdateStateHash();
     }
 
     return retval;
@@ -37,8 +37,20 @@
 #include <wx/spinctrl.h>
 #include <wx/listctrl.h>
 #include <wx/regex.h>
+#include <wx/stopwatch.h>
+#include <wx/dir.h>
+#include <wx/file.h>
+#include <wx/timer.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include "mygdal/ogr_api.h"
 #include "s57chart.h"
@@ -59,6 +71,15 @@
 
 #include <stdio.h>
 
+//    Vector cell decoding, see decode_cm93_block
+#if defined ( __aarch64__ ) && defined ( __ARM_NEON )
+#define CM93_DECODE_NEON
+#include <arm_neon.h>
+#elif ( defined ( __GNUC__ ) || defined ( __clang__ ) ) && ( defined ( __x86_64__ ) || defined ( __i386__ ) ) && !defined ( __MINGW32__ )
+#define CM93_DECODE_AVX512VBMI
+#include <immintrin.h>
+#endif
+
 #ifdef ocpnUSE_GL
 #include "glChartCanvas.h"
 extern ocpnGLOptions g_GLOptions;
@@ -79,6 +100,7 @@ extern wxString         g_SENCPrefix;
 extern s52plib          *ps52plib;
 extern MyConfig         *pConfig;
 extern bool             g_bDebugCM93;
+extern int              g_nCPUCount;
 extern int              g_cm93_zoom_factor;
 extern PopUpDSlide       *pPopupDetailSlider;
 extern int              g_detailslider_dialog_x, g_detailslider_dialog_y;
@@ -282,7 +304,12 @@ OCPNRegion M_COVR_Desc::GetRegion ( const ViewPort &vp, wxPoint *pwp )
 
 WX_DECLARE_HASH_MAP ( int, int, wxIntegerHash, wxIntegerEqual, cm93cell_hash );
 
-char sig_version[] = "COVR1002";
+//    Cache file layout:
+//    signature, count of scanned cells, scanned cell indices, then the M_COVR outlines in WKB form.
+//    Scanned cells with no M_COVR are recorded too, so no cell is ever reopened just to find it empty.
+char sig_version[] = "COVR1003";
+
+static int get_dval ( int native_scale );
 
 class covr_set
 {
@@ -291,11 +318,14 @@ class covr_set
             ~covr_set();
 
             bool Init ( wxChar scale_char, wxString &prefix );
+            void Save ( void );
             unsigned int GetCoverCount() { return m_covr_array_outlines.GetCount(); }
             M_COVR_Desc *GetCover ( unsigned int im ) { return &m_covr_array_outlines[im]; }
+            void GetCoversInBox ( const LLBBox &box, std::vector<M_COVR_Desc *> &covers );
             void Add_MCD ( M_COVR_Desc *pmcd );
             bool Add_Update_MCD ( M_COVR_Desc *pmcd );
             bool IsCovrLoaded ( int cell_index );
+            void SetCovrLoaded ( int cell_index );
             int Find_MCD ( M_COVR_Desc *pmcd );
             M_COVR_Desc *Find_MCD ( int cell_index, int object_id, int sbcell );
 
@@ -309,27 +339,57 @@ class covr_set
 
             cm93cell_hash     m_cell_hash;                        // This is a hash, indexed by cell index, elements contain the number of M_COVRs
             // found on this particular cell
+
+      private:
+            void IndexCover ( unsigned int im );
+            void GetGridRange ( double lat_min, double lon_min, double lat_max, double lon_max,
+                                int *ilat0, int *ilat1, int *ilon0, int *ilon1 );
+
+            //    Spatial index: outline array indices by cell, and by a lat/lon grid of cell sized buckets
+            std::map<int, std::vector<unsigned int> >   m_cell_index_map;
+            std::map<int, std::vector<unsigned int> >   m_grid_index_map;
+            int               m_grid_nlat;
+            int               m_grid_nlon;
+            double            m_grid_step;                      // degrees per bucket
 };
 
 covr_set::covr_set ( cm93chart *parent )
 {
       m_pParent = parent;
+
+      m_scale = 20000000;
+      m_grid_step = 40.;
+      m_grid_nlat = 5;
+      m_grid_nlon = 9;
 }
 
 covr_set::~covr_set()
 {
-      //    Create/Update the cache
+      Save();
+}
+
+//    Create/Update the cache
+void covr_set::Save ( void )
+{
       if(m_cachefile.IsEmpty())
             return;                             // presumably for Z scale charts
                                                 // for which we create no cache
 
-      if ( m_covr_array_outlines.GetCount() )
+      if ( m_cell_hash.size() )
       {
             wxFFileOutputStream ofs ( m_cachefile );
             if ( ofs.IsOk() )
             {
                   ofs.Write ( sig_version, 8 );             // write signature
 
+                  int ncells = m_cell_hash.size();
+                  ofs.Write ( &ncells, sizeof ( int ) );
+                  for ( cm93cell_hash::iterator it = m_cell_hash.begin() ; it != m_cell_hash.end() ; ++it )
+                  {
+                        int cell_index = it->first;
+                        ofs.Write ( &cell_index, sizeof ( int ) );
+                  }
+
                   for ( unsigned int i=0 ; i < m_covr_array_outlines.GetCount() ; i++ )
                   {
                         int wkbsize = m_covr_array_outlines[i].GetWKBSize();
@@ -363,6 +423,11 @@ bool covr_set::Init ( wxChar scale_char, wxString &prefix )
             default:  m_scale = 20000000;  break;
       }
 
+      //    Size the spatial index buckets to the cells of this scale
+      m_grid_step = get_dval ( m_scale ) / 3.;
+      m_grid_nlat = ( int ) ceil ( 180. / m_grid_step );
+      m_grid_nlon = ( int ) ceil ( 360. / m_grid_step );
+
       //    Create the cache file name
       wxString prefix_string = prefix;
       wxString sep ( wxFileName::GetPathSeparator() );
@@ -422,6 +487,18 @@ bool covr_set::Init ( wxChar scale_char, wxString &prefix )
             else
                   return false;                                    // short file
 
+            //    The list of cells already scanned
+            int ncells = 0;
+            if ( ifs.Read ( &ncells, sizeof ( int ) ).LastRead() != sizeof ( int ) )
+                  return false;
+
+            for ( int i=0 ; i < ncells ; i++ )
+            {
+                  int cell_index;
+                  if ( ifs.Read ( &cell_index, sizeof ( int ) ).LastRead() != sizeof ( int ) )
+                        return false;
+                  m_cell_hash[cell_index] = 0;
+            }
 
             bool b_cont = true;
             while ( b_cont )
@@ -430,15 +507,7 @@ bool covr_set::Init ( wxChar scale_char, wxString &prefix )
                   int length = pmcd->ReadWKB ( ifs );
 
                   if ( length )
-                  {
-                        m_covr_array_outlines.Add ( pmcd );
-
-                        if ( m_cell_hash.find ( pmcd->m_cell_index ) == m_cell_hash.end() )
-                              m_cell_hash[pmcd->m_cell_index] = 0;      // initialize the element
-
-                        m_cell_hash[pmcd->m_cell_index]++;        // add this M_COVR to the hash map
-
-                  }
+                        Add_MCD ( pmcd );
                   else
                   {
                         delete pmcd;
@@ -450,9 +519,75 @@ bool covr_set::Init ( wxChar scale_char, wxString &prefix )
       return true;
 }
 
+void covr_set::GetGridRange ( double lat_min, double lon_min, double lat_max, double lon_max,
+                              int *ilat0, int *ilat1, int *ilon0, int *ilon1 )
+{
+      *ilat0 = wxMax ( 0, ( int ) floor ( ( lat_min + 90. ) / m_grid_step ) );
+      *ilat1 = wxMin ( m_grid_nlat - 1, ( int ) floor ( ( lat_max + 90. ) / m_grid_step ) );
+
+      //    Longitude buckets are not normalized here, callers wrap them into [0, m_grid_nlon)
+      *ilon0 = ( int ) floor ( ( lon_min + 180. ) / m_grid_step );
+      *ilon1 = ( int ) floor ( ( lon_max + 180. ) / m_grid_step );
+      if ( *ilon1 - *ilon0 >= m_grid_nlon )
+            *ilon1 = *ilon0 + m_grid_nlon - 1;
+}
+
+void covr_set::IndexCover ( unsigned int im )
+{
+      M_COVR_Desc *pmcd = &m_covr_array_outlines[im];
+
+      m_cell_index_map[pmcd->m_cell_index].push_back ( im );
+
+      int ilat0, ilat1, ilon0, ilon1;
+      GetGridRange ( pmcd->m_covr_lat_min, pmcd->m_covr_lon_min, pmcd->m_covr_lat_max, pmcd->m_covr_lon_max,
+                     &ilat0, &ilat1, &ilon0, &ilon1 );
+
+      for ( int ilat = ilat0 ; ilat <= ilat1 ; ilat++ )
+      {
+            for ( int ilon = ilon0 ; ilon <= ilon1 ; ilon++ )
+            {
+                  int jlon = ( ( ilon % m_grid_nlon ) + m_grid_nlon ) % m_grid_nlon;
+                  m_grid_index_map[( ilat * m_grid_nlon ) + jlon].push_back ( im );
+            }
+      }
+}
+
+//    Collect the M_COVRs whose bounding boxes may intersect the given box
+void covr_set::GetCoversInBox ( const LLBBox &box, std::vector<M_COVR_Desc *> &covers )
+{
+      covers.clear();
+
+      int ilat0, ilat1, ilon0, ilon1;
+      GetGridRange ( box.GetMinLat(), box.GetMinLon(), box.GetMaxLat(), box.GetMaxLon(),
+                     &ilat0, &ilat1, &ilon0, &ilon1 );
+
+      std::vector<unsigned int> hits;
+      for ( int ilat = ilat0 ; ilat <= ilat1 ; ilat++ )
+      {
+            for ( int ilon = ilon0 ; ilon <= ilon1 ; ilon++ )
+            {
+                  int jlon = ( ( ilon % m_grid_nlon ) + m_grid_nlon ) % m_grid_nlon;
+                  std::map<int, std::vector<unsigned int> >::iterator it = m_grid_index_map.find ( ( ilat * m_grid_nlon ) + jlon );
+                  if ( it != m_grid_index_map.end() )
+                        hits.insert ( hits.end(), it->second.begin(), it->second.end() );
+            }
+      }
+
+      std::sort ( hits.begin(), hits.end() );
+      hits.erase ( std::unique ( hits.begin(), hits.end() ), hits.end() );
+
+      for ( unsigned int i=0 ; i < hits.size() ; i++ )
+      {
+            M_COVR_Desc *pmcd = &m_covr_array_outlines[hits[i]];
+            if ( !box.IntersectOut ( pmcd->m_covr_bbox ) )
+                  covers.push_back ( pmcd );
+      }
+}
+
 void covr_set::Add_MCD ( M_COVR_Desc *pmcd )
 {
       m_covr_array_outlines.Add ( pmcd );
+      IndexCover ( m_covr_array_outlines.GetCount() - 1 );
 
       if ( m_cell_hash.find ( pmcd->m_cell_index ) == m_cell_hash.end() )     // not present yet?
             m_cell_hash[pmcd->m_cell_index] = 0;  // initialize
@@ -465,80 +600,53 @@ bool covr_set::IsCovrLoaded ( int cell_index )
       return ( m_cell_hash.find ( cell_index ) != m_cell_hash.end() );
 }
 
+//    Record a cell as scanned, whether or not it has any M_COVR
+void covr_set::SetCovrLoaded ( int cell_index )
+{
+      if ( m_cell_hash.find ( cell_index ) == m_cell_hash.end() )
+            m_cell_hash[cell_index] = 0;
+}
+
 bool covr_set::Add_Update_MCD ( M_COVR_Desc *pmcd )
 {
-      if ( m_cell_hash.find ( pmcd->m_cell_index ) == m_cell_hash.end() )     // not present yet?
+      if ( NULL == Find_MCD ( pmcd->m_cell_index, pmcd->m_object_id, pmcd->m_subcell ) )
       {
-            m_covr_array_outlines.Add ( pmcd );
-            m_cell_hash[pmcd->m_cell_index] = 1;  // initialize
+            Add_MCD ( pmcd );
             return true;
       }
-      //    There is at least one MCD already in place for this cell index
-      //    We need to search the entire table to see if any of those MCD's
-      //    correspond to this MCD's object identifier and subcell, as well as cell index
       else
-      {
-            bool b_found = false;
-            for ( unsigned int i=0 ; i < m_covr_array_outlines.GetCount() ; i++ )
-            {
-                  M_COVR_Desc *pmcd_candidate = &m_covr_array_outlines[i];
-                  if ( ( pmcd_candidate->m_cell_index == pmcd->m_cell_index ) &&
-                          ( pmcd_candidate->m_object_id == pmcd->m_object_id ) &&
-                          ( pmcd_candidate->m_subcell == pmcd->m_subcell ) )
-
-                  {
-                        b_found = true;
-                        break;
-                  }
-            }
-
-            if ( !b_found )
-            {
-                  m_covr_array_outlines.Add ( pmcd );
-                  m_cell_hash[pmcd->m_cell_index]++;        // add this M_COVR to the hash map
-                  return true;
-            }
-            else
-                  return false;
-      }
+            return false;
 }
 
 int covr_set::Find_MCD ( M_COVR_Desc *pmcd )
 {
-      if ( m_cell_hash.find ( pmcd->m_cell_index ) == m_cell_hash.end() )     // not present?
+      std::map<int, std::vector<unsigned int> >::iterator it = m_cell_index_map.find ( pmcd->m_cell_index );
+      if ( it == m_cell_index_map.end() )     // not present?
             return -1;
-      else
-      {
-            //    There is at least one MCD already in place for this cell index
-            //    We need to search the entire table to see if any of those MCD's
-            //    correspond to this MCD's object identifier as well as cell index
 
-            for ( unsigned int i=0 ; i < m_covr_array_outlines.GetCount() ; i++ )
-            {
-                  M_COVR_Desc *pmcd_candidate = &m_covr_array_outlines[i];
-                  if ( ( pmcd_candidate->m_cell_index == pmcd->m_cell_index ) &&
-                          ( pmcd_candidate->m_object_id == pmcd->m_object_id ) &&
-                          ( pmcd_candidate->m_subcell == pmcd->m_subcell ) )
-                  {
-                        return ( int ) i;
-                  }
-            }
+      //    Search the MCD's already in place for this cell index for a matching
+      //    object identifier and subcell
+      for ( unsigned int i=0 ; i < it->second.size() ; i++ )
+      {
+            M_COVR_Desc *pmcd_candidate = &m_covr_array_outlines[it->second[i]];
+            if ( ( pmcd_candidate->m_object_id == pmcd->m_object_id ) &&
+                    ( pmcd_candidate->m_subcell == pmcd->m_subcell ) )
+                  return ( int ) it->second[i];
       }
       return -1;
 }
 
 M_COVR_Desc *covr_set::Find_MCD ( int cell_index, int object_id, int subcell )
 {
-      if ( m_cell_hash.find ( cell_index ) == m_cell_hash.end() )     // not present?
+      std::map<int, std::vector<unsigned int> >::iterator it = m_cell_index_map.find ( cell_index );
+      if ( it == m_cell_index_map.end() )     // not present?
             return NULL;
 
-      for ( unsigned int i=0 ; i < m_covr_array_outlines.GetCount() ; i++ )
+      for ( unsigned int i=0 ; i < it->second.size() ; i++ )
       {
-            M_COVR_Desc *pmcd_candidate = &m_covr_array_outlines[i];
-            if ( ( pmcd_candidate->m_cell_index == cell_index ) &&
-                    ( pmcd_candidate->m_object_id == object_id ) &&
+            M_COVR_Desc *pmcd_candidate = &m_covr_array_outlines[it->second[i]];
+            if ( ( pmcd_candidate->m_object_id == object_id ) &&
                     ( pmcd_candidate->m_subcell == subcell ) )
-
                   return pmcd_candidate;
       }
 
@@ -1059,6 +1167,8 @@ cm93_dictionary::~cm93_dictionary()
 
 //    CM93 Decode support routines
 
+static void SelectDecodeKernel ( void );
+
 void CreateDecodeTable ( void )
 {
       int i;
@@ -1072,110 +1182,143 @@ void CreateDecodeTable ( void )
             unsigned char a = Encode_table[i];
             Decode_table[ ( int ) a] = ( unsigned char ) i;
       }
-}
-
 
-static int   read_and_decode_bytes ( FILE *stream, void *p, int nbytes )
-{
-      if ( 0 == nbytes )                  // declare victory if no bytes requested
-            return 1;
+      SelectDecodeKernel();
+}
 
-      //    read into callers buffer
-      if ( fread ( p, nbytes, 1, stream ) != 1)
-            return 0;
 
-      //    decode inplace
-      unsigned char *q = ( unsigned char * ) p;
+//    A cm93 cell file, read in one block and decoded in place
+typedef struct{
+      unsigned char     *data;
+      size_t            length;
+      size_t            pos;
+}cm93_cell_stream;
 
-      for ( int i=0 ; i < nbytes ; i++ )
+//    Decode a block in place.
+//    The loop is unrolled so that several independent table lookups are in flight at once.
+static void decode_cm93_block_scalar ( unsigned char *p, size_t n )
+{
+      size_t i = 0;
+      for ( ; i + 8 <= n ; i += 8 )
       {
-            unsigned char a = *q;
-            int b = a;
-            unsigned char c = Decode_table[b];
-            *q = c;
-
-            q++;
+            unsigned char c0 = Decode_table[p[i]];
+            unsigned char c1 = Decode_table[p[i + 1]];
+            unsigned char c2 = Decode_table[p[i + 2]];
+            unsigned char c3 = Decode_table[p[i + 3]];
+            unsigned char c4 = Decode_table[p[i + 4]];
+            unsigned char c5 = Decode_table[p[i + 5]];
+            unsigned char c6 = Decode_table[p[i + 6]];
+            unsigned char c7 = Decode_table[p[i + 7]];
+            p[i]     = c0; p[i + 1] = c1; p[i + 2] = c2; p[i + 3] = c3;
+            p[i + 4] = c4; p[i + 5] = c5; p[i + 6] = c6; p[i + 7] = c7;
+      }
+      for ( ; i < n ; i++ )
+            p[i] = Decode_table[p[i]];
+}
+
+//    Vector versions, for instruction sets that can look up a whole 256 entry table
+//    in a few instructions.  AVX-512 VBMI looks up 128 entries per vpermi2b, NEON
+//    64 entries per tbl/tbx.  The 16 entry SSSE3/AVX2 pshufb needs 16 lookups per
+//    vector and is no faster than the scalar loop.
+
+#ifdef CM93_DECODE_AVX512VBMI
+__attribute__ ( ( target ( "avx512f,avx512bw,avx512vbmi" ) ) )
+static void decode_cm93_block_avx512vbmi ( unsigned char *p, size_t n )
+{
+      const __m512i t0 = _mm512_loadu_si512 ( Decode_table );
+      const __m512i t1 = _mm512_loadu_si512 ( Decode_table + 64 );
+      const __m512i t2 = _mm512_loadu_si512 ( Decode_table + 128 );
+      const __m512i t3 = _mm512_loadu_si512 ( Decode_table + 192 );
+
+      size_t i = 0;
+      for ( ; i + 64 <= n ; i += 64 )
+      {
+            __m512i v = _mm512_loadu_si512 ( p + i );
+            __m512i lo = _mm512_permutex2var_epi8 ( t0, v, t1 );        // entries 0-127, on bits 0-6
+            __m512i hi = _mm512_permutex2var_epi8 ( t2, v, t3 );        // entries 128-255
+            _mm512_storeu_si512 ( p + i, _mm512_mask_blend_epi8 ( _mm512_movepi8_mask ( v ), lo, hi ) );
       }
-      return 1;
+      decode_cm93_block_scalar ( p + i, n - i );
 }
+#endif
 
-
-static int read_and_decode_double ( FILE *stream, double *p )
+#ifdef CM93_DECODE_NEON
+static void decode_cm93_block_neon ( unsigned char *p, size_t n )
 {
-      double t;
-      //    read into temp buffer
-      if ( fread ( &t, sizeof ( double ), 1, stream ) != 1)
-            return 0;
+      uint8x16x4_t t[4];
+      for ( int k = 0 ; k < 4 ; k++ )
+            for ( int j = 0 ; j < 4 ; j++ )
+                  t[k].val[j] = vld1q_u8 ( Decode_table + 64 * k + 16 * j );
 
-      //    decode inplace
-      unsigned char *q = ( unsigned char * ) &t;
-
-      for ( unsigned int i=0 ; i < sizeof ( double ) ; i++ )
+      const uint8x16_t step = vdupq_n_u8 ( 64 );
+      size_t i = 0;
+      for ( ; i + 16 <= n ; i += 16 )
       {
-            unsigned char a = *q;
-            int b = a;
-            unsigned char c = Decode_table[b];
-            *q = c;
-
-            q++;
-      }
-
-      //    copy to target
-      *p = t;
-
-      return 1;
+            //    Indices past the 64 entry table leave the lane as it is
+            uint8x16_t v = vld1q_u8 ( p + i );
+            uint8x16_t r = vqtbl4q_u8 ( t[0], v );
+            v = vsubq_u8 ( v, step );
+            r = vqtbx4q_u8 ( r, t[1], v );
+            v = vsubq_u8 ( v, step );
+            r = vqtbx4q_u8 ( r, t[2], v );
+            v = vsubq_u8 ( v, step );
+            r = vqtbx4q_u8 ( r, t[3], v );
+            vst1q_u8 ( p + i, r );
+      }
+      decode_cm93_block_scalar ( p + i, n - i );
 }
+#endif
 
-static int read_and_decode_int ( FILE *stream, int *p )
-{
-      int t;
-      //    read into temp buffer
-      if ( fread ( &t, sizeof ( int ), 1, stream ) != 1)
-            return 0;
+typedef void ( *cm93_decode_kernel ) ( unsigned char *p, size_t n );
 
-      //    decode inplace
-      unsigned char *q = ( unsigned char * ) &t;
+static cm93_decode_kernel decode_cm93_block = decode_cm93_block_scalar;
+static const char *decode_cm93_block_name = "scalar";
 
-      for ( unsigned int i=0 ; i < sizeof ( int ) ; i++ )
+//    Pick the fastest kernel this CPU runs, once the decode table is built
+static void SelectDecodeKernel ( void )
+{
+#ifdef CM93_DECODE_AVX512VBMI
+      if ( __builtin_cpu_supports ( "avx512vbmi" ) && __builtin_cpu_supports ( "avx512bw" ) )
       {
-            unsigned char a = *q;
-            int b = a;
-            unsigned char c = Decode_table[b];
-            *q = c;
-
-            q++;
+            decode_cm93_block = decode_cm93_block_avx512vbmi;
+            decode_cm93_block_name = "AVX-512 VBMI";
       }
-
-      //    copy to target
-      *p = t;
-
-      return 1;
+#endif
+#ifdef CM93_DECODE_NEON
+      decode_cm93_block = decode_cm93_block_neon;
+      decode_cm93_block_name = "NEON";
+#endif
 }
 
-static int read_and_decode_ushort ( FILE *stream, unsigned short *p )
+static int   read_and_decode_bytes ( cm93_cell_stream *stream, void *p, int nbytes )
 {
-      unsigned short t;
-      //    read into temp buffer
-      if ( fread ( &t, sizeof ( unsigned short ), 1, stream ) != 1)
+      if ( 0 == nbytes )                  // declare victory if no bytes requested
+            return 1;
+
+      if ( ( nbytes < 0 ) || ( stream->pos + nbytes > stream->length ) )
             return 0;
 
-      //    decode inplace
-      unsigned char *q = ( unsigned char * ) &t;
+      //    copy already decoded bytes into callers buffer
+      memcpy ( p, stream->data + stream->pos, nbytes );
+      stream->pos += nbytes;
 
-      for ( unsigned int i=0 ; i < sizeof ( unsigned short ) ; i++ )
-      {
-            unsigned char a = *q;
-            int b = a;
-            unsigned char c = Decode_table[b];
-            *q = c;
+      return 1;
+}
 
-            q++;
-      }
 
-      //    copy to target
-      *p = t;
+static int read_and_decode_double ( cm93_cell_stream *stream, double *p )
+{
+      return read_and_decode_bytes ( stream, p, sizeof ( double ) );
+}
 
-      return 1;
+static int read_and_decode_int ( cm93_cell_stream *stream, int *p )
+{
+      return read_and_decode_bytes ( stream, p, sizeof ( int ) );
+}
+
+static int read_and_decode_ushort ( cm93_cell_stream *stream, unsigned short *p )
+{
+      return read_and_decode_bytes ( stream, p, sizeof ( unsigned short ) );
 }
 
 
@@ -1350,7 +1493,7 @@ static int get_dval ( int native_scale )
 }
 
 
-static bool read_header_and_populate_cib ( FILE *stream, Cell_Info_Block *pCIB )
+static bool read_header_and_populate_cib ( cm93_cell_stream *stream, Cell_Info_Block *pCIB )
 {
       //    Read header, populate Cell_Info_Block
 
@@ -1444,7 +1587,7 @@ static bool read_header_and_populate_cib ( FILE *stream, Cell_Info_Block *pCIB )
       return true;
 }
 
-static bool read_vector_record_table ( FILE *stream, int count, Cell_Info_Block *pCIB )
+static bool read_vector_record_table ( cm93_cell_stream *stream, int count, Cell_Info_Block *pCIB )
 {
       bool brv;
 
@@ -1520,7 +1663,7 @@ static bool read_vector_record_table ( FILE *stream, int count, Cell_Info_Block
 }
 
 
-static bool read_3dpoint_table ( FILE *stream, int count, Cell_Info_Block *pCIB )
+static bool read_3dpoint_table ( cm93_cell_stream *stream, int count, Cell_Info_Block *pCIB )
 {
       geometry_descriptor *p = pCIB->point3d_descriptor_block;
       cm93_point_3d *q = pCIB->p3dpoint_array;
@@ -1563,7 +1706,7 @@ static bool read_3dpoint_table ( FILE *stream, int count, Cell_Info_Block *pCIB
 }
 
 
-static bool read_2dpoint_table ( FILE *stream, int count, Cell_Info_Block *pCIB )
+static bool read_2dpoint_table ( cm93_cell_stream *stream, int count, Cell_Info_Block *pCIB )
 {
 
 //      int rv = read_and_decode_bytes(stream, pCIB->p2dpoint_array, count * 4);
@@ -1585,7 +1728,7 @@ static bool read_2dpoint_table ( FILE *stream, int count, Cell_Info_Block *pCIB
 }
 
 
-static bool read_feature_record_table ( FILE *stream, int n_features, Cell_Info_Block *pCIB )
+static bool read_feature_record_table ( cm93_cell_stream *stream, int n_features, Cell_Info_Block *pCIB )
 {
       try
       {
@@ -1818,24 +1961,46 @@ static bool read_feature_record_table ( FILE *stream, int n_features, Cell_Info_
 bool Ingest_CM93_Cell ( const char * cell_file_name, Cell_Info_Block *pCIB )
 {
 
+      unsigned char *buffer = NULL;
+
       try
       {
 
-            int file_length;
+            wxStopWatch sw;
 
-            //    Get the file length
+            //    Read the whole file in one block
             FILE *flstream = fopen ( cell_file_name, "rb" );
             if ( !flstream )
                   return false;
 
             fseek ( flstream, 0, SEEK_END );
-            file_length = ftell ( flstream );
-            fclose ( flstream );
+            long file_length = ftell ( flstream );
+            fseek ( flstream, 0, SEEK_SET );
 
-            //    Open the file
-            FILE *stream = fopen ( cell_file_name, "rb" );
-            if ( !stream )
+            if ( file_length <= 0 )
+            {
+                  fclose ( flstream );
                   return false;
+            }
+
+            buffer = ( unsigned char * ) malloc ( file_length );
+            bool bread = buffer && ( fread ( buffer, file_length, 1, flstream ) == 1 );
+            fclose ( flstream );
+            if ( !bread )
+            {
+                  free ( buffer );
+                  return false;
+            }
+
+            //    and decode it in place
+            decode_cm93_block ( buffer, file_length );
+            long t_decode = sw.Time();
+
+            cm93_cell_stream cs;
+            cm93_cell_stream *stream = &cs;
+            cs.data = buffer;
+            cs.length = file_length;
+            cs.pos = 0;
 
             //    Validate the integrity of the cell file
 
@@ -1848,66 +2013,442 @@ bool Ingest_CM93_Cell ( const char * cell_file_name, Cell_Info_Block *pCIB )
             read_and_decode_int ( stream, &int1 );         // length of table 2
 
             int test = word0 + int0 + int1;
-            if ( test != file_length )
-            {
-                  fclose ( stream );
-                  return false;                           // file is corrupt
-            }
+            bool bok = ( test == file_length );               // else file is corrupt
 
             //    Cell is OK, proceed to ingest
 
+            if ( bok )
+                  bok = read_header_and_populate_cib ( stream, pCIB );
+
+            if ( bok )
+                  bok = read_vector_record_table ( stream, pCIB->m_nvector_records, pCIB );
+
+            if ( bok )
+                  bok = read_3dpoint_table ( stream, pCIB->m_n_point3d_records, pCIB );
+
+            if ( bok )
+                  bok = read_2dpoint_table ( stream, pCIB->m_n_point2d_records, pCIB );
+
+            if ( bok )
+                  bok = read_feature_record_table ( stream, pCIB->m_nfeature_records, pCIB );
+
+//      wxASSERT(cs.pos == file_length);
+
+            free ( buffer );
+
+            if ( g_bDebugCM93 )
+                  printf ( "   Ingest_CM93_Cell %s: %ld bytes, read+decode %ld ms, total %ld ms\n",
+                           cell_file_name, file_length, t_decode, sw.Time() );
+
+            return bok;
+      }
+
+      catch ( ... )
+      {
+            free ( buffer );
+            return false;
+      }
+
 
-            if ( !read_header_and_populate_cib ( stream, pCIB ) )
+}
+
+
+
+
+//----------------------------------------------------------------------------------
+//      cm93 background cell loader
+//
+//      cm93 cell files are read, decompressed and decoded into Cell_Info_Blocks on
+//      a worker thread.  Decoded cells are kept in a small LRU cache, so that the
+//      M_COVR scan and the full object chain build of the same cell share one read.
+//      The cache and the pending set are only touched from the GUI thread.
+//----------------------------------------------------------------------------------
+
+const wxEventType wxEVT_OCPN_CM93CELLLOADED = wxNewEventType();
+
+#define CM93_CELL_CACHE_SIZE    32
+
+//    Cells the coverage survey keeps queued for decoding at any one time
+#define CM93_SURVEY_CELLS_IN_FLIGHT     4
+
+static void Free_CM93_CIB ( Cell_Info_Block *pCIB )
+{
+      free ( pCIB->pobject_block );
+      free ( pCIB->p2dpoint_array );
+      free ( pCIB->pprelated_object_block );
+      free ( pCIB->object_vector_record_descriptor_block );
+      free ( pCIB->attribute_block_top );
+      free ( pCIB->edge_vector_descriptor_block );
+      free ( pCIB->pvector_record_block_top );
+      free ( pCIB->point3d_descriptor_block );
+      free ( pCIB->p3dpoint_array );
+}
+
+//    Cell decode benchmark, run by the --cm93_bench command line option.
+//    Every uncompressed cell file under dir is read into memory, then decoded
+//    repeatedly with the scalar kernel and with the kernel this CPU selects, and
+//    the results compared.  Then the cells are ingested with each kernel.
+bool CM93DecodeBench ( const wxString &dir )
+{
+      if ( !cm93_decode_table_created )
+      {
+            CreateDecodeTable();
+            cm93_decode_table_created = true;
+      }
+
+      wxArrayString files;
+      if ( !wxDir::Exists ( dir ) || !wxDir::GetAllFiles ( dir, &files ) )
+      {
+            printf ( "CM93DecodeBench: no files in %s\n", ( const char * ) dir.mb_str() );
+            return false;
+      }
+
+      //    Keep the files that decode to a consistent cell prolog
+      std::vector<std::vector<unsigned char> > cells;
+      wxArrayString cell_files;
+      size_t total = 0;
+      for ( unsigned int i = 0 ; i < files.GetCount() ; i++ )
+      {
+            wxFile f ( files[i] );
+            wxFileOffset length = f.IsOpened() ? f.Length() : 0;
+            if ( length < 10 )
+                  continue;
+
+            std::vector<unsigned char> data ( length );
+            if ( f.Read ( &data[0], length ) != length )
+                  continue;
+
+            unsigned char prolog[10];
+            memcpy ( prolog, &data[0], 10 );
+            decode_cm93_block_scalar ( prolog, 10 );
+            unsigned short word0;
+            int int0, int1;
+            memcpy ( &word0, prolog, 2 );
+            memcpy ( &int0, prolog + 2, 4 );
+            memcpy ( &int1, prolog + 6, 4 );
+            if ( word0 + int0 + int1 != length )
+                  continue;
+
+            total += length;
+            cells.push_back ( data );
+            cell_files.Add ( files[i] );
+      }
+
+      if ( cells.empty() )
+      {
+            printf ( "CM93DecodeBench: no cm93 cells in %s\n", ( const char * ) dir.mb_str() );
+            return false;
+      }
+
+      printf ( "CM93DecodeBench: %d cells, %.1f MB, kernel %s\n", ( int ) cells.size(), total / 1e6, decode_cm93_block_name );
+
+      cm93_decode_kernel kernels[2] = { decode_cm93_block_scalar, decode_cm93_block };
+      const char *names[2] = { "scalar", decode_cm93_block_name };
+      std::vector<unsigned char> reference;
+      bool bok = true;
+
+      for ( int k = 0 ; k < 2 ; k++ )
+      {
+            //    Best of several passes, the copies are not timed
+            double best_ms = 0.;
+            std::vector<unsigned char> work;
+            for ( int pass = 0 ; pass < 20 ; pass++ )
             {
-                  fclose ( stream );
-                  return false;
+                  double ms = 0.;
+                  work.clear();
+                  for ( size_t c = 0 ; c < cells.size() ; c++ )
+                  {
+                        std::vector<unsigned char> buf = cells[c];
+                        wxStopWatch sw;
+                        kernels[k] ( &buf[0], buf.size() );
+                        ms += sw.TimeInMicro().ToDouble() / 1000.;
+                        if ( pass == 0 )
+                              work.insert ( work.end(), buf.begin(), buf.end() );
+                  }
+                  if ( pass == 0 || ms < best_ms )
+                        best_ms = ms;
+                  if ( pass == 0 )
+                  {
+                        if ( k == 0 )
+                              reference = work;
+                        else if ( work != reference )
+                        {
+                              printf ( "CM93DecodeBench: %s decode differs from scalar\n", names[k] );
+                              bok = false;
+                        }
+                  }
             }
+            printf ( "  decode %-14s %8.3f ms  %8.1f MB/s\n", names[k], best_ms, best_ms > 0. ? total / 1e3 / best_ms : 0. );
+      }
 
-
-            if ( !read_vector_record_table ( stream, pCIB->m_nvector_records, pCIB ) )
+      //    Whole cell ingestion, the files are in the OS cache by now
+      for ( int k = 0 ; k < 2 ; k++ )
+      {
+            decode_cm93_block = kernels[k];
+            wxStopWatch sw;
+            for ( unsigned int c = 0 ; c < cell_files.GetCount() ; c++ )
             {
-                  fclose ( stream );
-                  return false;
+                  Cell_Info_Block cib = Cell_Info_Block();
+                  if ( !Ingest_CM93_Cell ( ( const char * ) cell_files[c].mb_str(), &cib ) )
+                        bok = false;
+                  Free_CM93_CIB ( &cib );
             }
+            printf ( "  ingest %-14s %8ld ms\n", names[k], sw.Time() );
+      }
+      decode_cm93_block = kernels[1];
 
-            if ( !read_3dpoint_table ( stream, pCIB->m_n_point3d_records, pCIB ) )
+      fflush ( stdout );
+      return bok;
+}
+
+class cm93_subcell_data
+{
+public:
+      char              m_subcell;
+      wxString          m_file;
+      wxString          m_compfile;             // set if m_file is to be decompressed from here
+      Cell_Info_Block   *m_pCIB;
+};
+
+class cm93_cell_data
+{
+public:
+      cm93_cell_data(){ m_cell_index = 0; m_bfetched = false; m_bsurvey = false; }
+      ~cm93_cell_data()
+      {
+            for ( unsigned int i=0 ; i < m_subcells.size() ; i++ )
             {
-                  fclose ( stream );
-                  return false;
+                  if ( m_subcells[i].m_pCIB )
+                  {
+                        Free_CM93_CIB ( m_subcells[i].m_pCIB );
+                        delete m_subcells[i].m_pCIB;
+                  }
             }
+      }
+
+      wxString                            m_key;
+      int                                 m_cell_index;
+      bool                                m_bfetched;             // handed to a chart at least once
+      bool                                m_bsurvey;              // wanted by the coverage survey only
+      std::vector<cm93_subcell_data>      m_subcells;
+};
+
+class cm93_cell_loader
+{
+public:
+      cm93_cell_loader();
+      ~cm93_cell_loader();
+
+      cm93_cell_data *GetCell ( const wxString &key );
+      bool IsPending ( const wxString &key ){ return m_pending.count ( key ) != 0; }
+      void RequestCell ( cm93_cell_data *pcell );
+      void WantNotify ( const wxString &key );
+      void Discard ( cm93_cell_data *pcell );
+      void Collect ( void );
+
+private:
+      void Worker ( void );
+      static bool IngestSubcell ( cm93_subcell_data &sub );
+
+      std::thread                   m_thread;
+      std::mutex                    m_mutex;
+      std::condition_variable       m_cv;
+      std::deque<cm93_cell_data *>  m_queue;
+      std::vector<cm93_cell_data *> m_done;
+      cm93_cell_data                *m_pcurrent;      // being ingested by the worker
+      bool                          m_bstop;
+      bool                          m_bnotify_pending;
+
+      std::set<wxString>            m_pending;
+      std::list<cm93_cell_data *>   m_cache;          // most recently used first
+};
+
+cm93_cell_loader::cm93_cell_loader()
+{
+      m_bstop = false;
+      m_bnotify_pending = false;
+      m_pcurrent = NULL;
+      m_thread = std::thread ( [this]() { Worker(); } );
+}
+
+cm93_cell_loader::~cm93_cell_loader()
+{
+      {
+            std::lock_guard<std::mutex> lock ( m_mutex );
+            m_bstop = true;
+      }
+      m_cv.notify_all();
+      m_thread.join();
 
-            if ( !read_2dpoint_table ( stream, pCIB->m_n_point2d_records, pCIB ) )
+      for ( unsigned int i=0 ; i < m_queue.size() ; i++ )
+            delete m_queue[i];
+      for ( unsigned int i=0 ; i < m_done.size() ; i++ )
+            delete m_done[i];
+      for ( std::list<cm93_cell_data *>::iterator it = m_cache.begin() ; it != m_cache.end() ; ++it )
+            delete *it;
+}
+
+cm93_cell_data *cm93_cell_loader::GetCell ( const wxString &key )
+{
+      for ( std::list<cm93_cell_data *>::iterator it = m_cache.begin() ; it != m_cache.end() ; ++it )
+      {
+            if ( ( *it )->m_key == key )
             {
-                  fclose ( stream );
-                  return false;
+                  cm93_cell_data *pcell = *it;
+                  m_cache.erase ( it );
+                  m_cache.push_front ( pcell );
+                  pcell->m_bfetched = true;
+                  return pcell;
             }
+      }
+      return NULL;
+}
+
+void cm93_cell_loader::RequestCell ( cm93_cell_data *pcell )
+{
+      m_pending.insert ( pcell->m_key );
+      {
+            std::lock_guard<std::mutex> lock ( m_mutex );
+            m_queue.push_back ( pcell );
+      }
+      m_cv.notify_one();
+}
 
-            if ( !read_feature_record_table ( stream, pCIB->m_nfeature_records, pCIB ) )
+//    A chart now waits for a cell the coverage survey asked for, so have its arrival
+//    refresh the canvases after all
+void cm93_cell_loader::WantNotify ( const wxString &key )
+{
+      bool bnotify = false;
+      {
+            std::lock_guard<std::mutex> lock ( m_mutex );
+            for ( unsigned int i=0 ; i < m_queue.size() ; i++ )
+                  if ( m_queue[i]->m_key == key )
+                        m_queue[i]->m_bsurvey = false;
+            if ( m_pcurrent && m_pcurrent->m_key == key )
+                  m_pcurrent->m_bsurvey = false;
+            for ( unsigned int i=0 ; i < m_done.size() ; i++ )
             {
-                  fclose ( stream );
-                  return false;
+                  if ( m_done[i]->m_key == key && m_done[i]->m_bsurvey )
+                  {
+                        m_done[i]->m_bsurvey = false;
+                        bnotify = !m_bnotify_pending;
+                        m_bnotify_pending = true;
+                  }
             }
+      }
 
-//      int file_end = ftell(stream);
+      if ( bnotify && gFrame )
+      {
+            wxCommandEvent evt ( wxEVT_OCPN_CM93CELLLOADED );
+            gFrame->GetEventHandler()->QueueEvent ( evt.Clone() );
+      }
+}
 
-//      wxASSERT(file_end == file_length);
+//    Drop a cached cell that no chart needs
+void cm93_cell_loader::Discard ( cm93_cell_data *pcell )
+{
+      m_cache.remove ( pcell );
+      delete pcell;
+}
 
-            fclose ( stream );
+//    Move the cells decoded since the last call into the cache, trimming it to size
+void cm93_cell_loader::Collect ( void )
+{
+      std::vector<cm93_cell_data *> done;
+      {
+            std::lock_guard<std::mutex> lock ( m_mutex );
+            done.swap ( m_done );
+            m_bnotify_pending = false;
+      }
 
+      for ( unsigned int i=0 ; i < done.size() ; i++ )
+      {
+            m_pending.erase ( done[i]->m_key );
+            m_cache.push_front ( done[i] );
+      }
 
-            return true;
+      //    Cells not yet fetched by the chart that asked for them are spared,
+      //    unless a large backlog (e.g. a cell outline scan) has piled up.
+      std::list<cm93_cell_data *>::iterator it = m_cache.end();
+      while ( m_cache.size() > CM93_CELL_CACHE_SIZE && it != m_cache.begin() )
+      {
+            --it;
+            if ( ( *it )->m_bfetched || m_cache.size() > 4 * CM93_CELL_CACHE_SIZE )
+            {
+                  delete *it;
+                  it = m_cache.erase ( it );
+            }
       }
+}
 
-      catch ( ... )
+bool cm93_cell_loader::IngestSubcell ( cm93_subcell_data &sub )
+{
+      wxString file = sub.m_file;
+
+      if ( sub.m_compfile.Length() )
       {
-            return false;
+            file = wxFileName::CreateTempFileName ( wxFileName ( sub.m_compfile ).GetFullName() );
+            if ( !DecompressXZFile ( sub.m_compfile, file ) )
+            {
+                  wxRemoveFile ( file );
+                  return false;
+            }
       }
 
+      sub.m_pCIB = new Cell_Info_Block();             // value-initialized, so all block pointers are NULL
+      bool bret = Ingest_CM93_Cell ( ( const char * ) file.mb_str(), sub.m_pCIB );
+      if ( !bret )
+      {
+            Free_CM93_CIB ( sub.m_pCIB );
+            delete sub.m_pCIB;
+            sub.m_pCIB = NULL;
+      }
 
+      if ( sub.m_compfile.Length() )
+            wxRemoveFile ( file );
+
+      return bret;
 }
 
+void cm93_cell_loader::Worker ( void )
+{
+      while ( true )
+      {
+            cm93_cell_data *pcell;
+            {
+                  std::unique_lock<std::mutex> lock ( m_mutex );
+                  m_cv.wait ( lock, [this]() { return m_bstop || !m_queue.empty(); } );
+                  if ( m_bstop )
+                        return;
+                  pcell = m_queue.front();
+                  m_queue.pop_front();
+                  m_pcurrent = pcell;
+            }
+
+            for ( unsigned int i=0 ; i < pcell->m_subcells.size() ; i++ )
+                  IngestSubcell ( pcell->m_subcells[i] );
 
+            //    Cells decoded for the coverage survey alone do not need a refresh
+            bool bnotify = false;
+            {
+                  std::lock_guard<std::mutex> lock ( m_mutex );
+                  m_pcurrent = NULL;
+                  m_done.push_back ( pcell );
+                  if ( !pcell->m_bsurvey )
+                  {
+                        bnotify = !m_bnotify_pending;
+                        m_bnotify_pending = true;
+                  }
+            }
 
+            //    One refresh request is enough for any number of cells finished before the next Collect()
+            if ( bnotify && gFrame )
+            {
+                  wxCommandEvent evt ( wxEVT_OCPN_CM93CELLLOADED );
+                  gFrame->GetEventHandler()->QueueEvent ( evt.Clone() );
+            }
+      }
+}
 
 //----------------------------------------------------------------------------------
 //      cm93chart Implementation
@@ -1941,6 +2482,10 @@ cm93chart::cm93chart()
       //  Need a covr_set
       m_pcovr_set = new covr_set ( this );
 
+      m_bsurvey_listed = false;
+      m_bsurvey_cancel = false;
+      m_bsurvey_done = false;
+
 
       //    Make initial allocation of shared outline drawing buffer
       m_pDrawBuffer = ( wxPoint * ) malloc ( 4 * sizeof ( wxPoint ) );
@@ -1955,6 +2500,10 @@ cm93chart::cm93chart()
 
 cm93chart::~cm93chart()
 {
+      m_bsurvey_cancel = true;
+      if ( m_survey_thread.joinable() )
+            m_survey_thread.join();
+
       free ( m_pcontour_array );
 
       delete m_pcovr_set;
@@ -1963,18 +2512,31 @@ cm93chart::~cm93chart()
 
 }
 
-void  cm93chart::Unload_CM93_Cell ( void )
+//    Point the working CIB at a decoded (sub)cell held by the cell loader cache.
+//    The blocks remain owned by the cache; m_cell_mcovr_list and the offset flags are per chart.
+void cm93chart::Attach_CM93_Cell ( const Cell_Info_Block *pCIB )
 {
-      free ( m_CIB.pobject_block );
-//      free(m_CIB.m_2a);
-      free ( m_CIB.p2dpoint_array );
-      free ( m_CIB.pprelated_object_block );
-      free ( m_CIB.object_vector_record_descriptor_block );
-      free ( m_CIB.attribute_block_top );
-      free ( m_CIB.edge_vector_descriptor_block );
-      free ( m_CIB.pvector_record_block_top );
-      free ( m_CIB.point3d_descriptor_block );
-      free ( m_CIB.p3dpoint_array );
+      m_CIB.transform_x_rate = pCIB->transform_x_rate;
+      m_CIB.transform_y_rate = pCIB->transform_y_rate;
+      m_CIB.transform_x_origin = pCIB->transform_x_origin;
+      m_CIB.transform_y_origin = pCIB->transform_y_origin;
+      m_CIB.min_lat = pCIB->min_lat;
+      m_CIB.min_lon = pCIB->min_lon;
+
+      m_CIB.p2dpoint_array = pCIB->p2dpoint_array;
+      m_CIB.pprelated_object_block = pCIB->pprelated_object_block;
+      m_CIB.attribute_block_top = pCIB->attribute_block_top;
+      m_CIB.edge_vector_descriptor_block = pCIB->edge_vector_descriptor_block;
+      m_CIB.point3d_descriptor_block = pCIB->point3d_descriptor_block;
+      m_CIB.pvector_record_block_top = pCIB->pvector_record_block_top;
+      m_CIB.p3dpoint_array = pCIB->p3dpoint_array;
+      m_CIB.object_vector_record_descriptor_block = pCIB->object_vector_record_descriptor_block;
+      m_CIB.pobject_block = pCIB->pobject_block;
+
+      m_CIB.m_nvector_records = pCIB->m_nvector_records;
+      m_CIB.m_nfeature_records = pCIB->m_nfeature_records;
+      m_CIB.m_n_point3d_records = pCIB->m_n_point3d_records;
+      m_CIB.m_n_point2d_records = pCIB->m_n_point2d_records;
 }
 
 
@@ -2190,6 +2752,9 @@ void cm93chart::SetVPParms ( const ViewPort &vpt )
       //    Create an array of CellIndexes covering the current viewport
       std::vector<int> vpcells = GetVPCellArray ( vpt );
 
+      //    Pick up any cells the background loader has finished since last time
+      m_pManager->m_pcell_loader->Collect();
+
       //    Check the member array to see if all these viewport cells have been loaded
       bool bcell_is_in;
       bool recalc_depth = false;
@@ -2206,42 +2771,36 @@ void cm93chart::SetVPParms ( const ViewPort &vpt )
                   }
             }
 
-            //    The cell is not in place, so go load it
+            //    The cell is not in place, so build it from the decoded cell, if available.
+            //    Otherwise it has been queued for loading, and we will be called again when it arrives.
             if ( !bcell_is_in )
             {
-                OCPNPlatform::ShowBusySpinner();
                   int cell_index = vpcells[i];
+                  bool b_nofiles;
+                  cm93_cell_data *pcell = GetDecodedCell ( cell_index, &b_nofiles );
+                  if ( !pcell )
+                        continue;
 
-                  if ( loadcell_in_sequence ( cell_index, '0' ) ) // Base cell
-                  {
-                        ProcessVectorEdges();
-                        CreateObjChain ( cell_index, ( int ) '0', vpt.view_scale_ppm );
+                  OCPNPlatform::ShowBusySpinner();
 
-                        ForceEdgePriorityEvaluate();              // need to re-evaluate priorities
-                        recalc_depth = true;
-
-                        m_cells_loaded_array.push_back ( cell_index );
-
-                        Unload_CM93_Cell();
-                  }
+                  //    Process the base cell and subcells in sequence
+                  for ( unsigned int is=0 ; is < pcell->m_subcells.size() ; is++ )
+                  {
+                        cm93_subcell_data &sub = pcell->m_subcells[is];
+                        if ( !sub.m_pCIB )
+                              continue;
 
-                  char loadcell_key = 'A';               // starting
+                        m_LastFileName = sub.m_file;
 
-                  //    Load any subcells in sequence
-                  //    On successful load, add it to the member list and process the cell
-                  while ( loadcell_in_sequence ( cell_index, loadcell_key ) )
-                  {
+                        Attach_CM93_Cell ( sub.m_pCIB );
                         ProcessVectorEdges();
-                        CreateObjChain ( cell_index, ( int ) loadcell_key, vpt.view_scale_ppm );
+                        CreateObjChain ( cell_index, ( int ) sub.m_subcell, vpt.view_scale_ppm );
 
                         ForceEdgePriorityEvaluate();              // need to re-evaluate priorities
+                        recalc_depth = true;
 
                         if (std::find(m_cells_loaded_array.begin(), m_cells_loaded_array.end(), cell_index) == m_cells_loaded_array.end())
                               m_cells_loaded_array.push_back ( cell_index );
-
-                        Unload_CM93_Cell();
-
-                        loadcell_key++;
                   }
 
                   AssembleLineGeometry();
@@ -2435,6 +2994,7 @@ int cm93chart::CreateObjChain ( int cell_index, int subcell, double view_scale_p
 
       int iObj = 0;
       S57Obj *obj;
+      std::vector<PolyTessGeo *> tess_list;
 
       double scale = gFrame->GetBestVPScale(this);
       int nativescale = GetNativeScale();
@@ -2581,6 +3141,9 @@ int cm93chart::CreateObjChain ( int cell_index, int subcell, double view_scale_p
 //              Add linked object/LUP to the working set
                               _insertRules ( obj,LUP, this );
 
+                              if( obj->pPolyTessGeo && !obj->pPolyTessGeo->IsOk() )
+                                  tess_list.push_back( obj->pPolyTessGeo );
+
 //              Establish Object's Display Category
                               obj->m_DisplayCat = LUP->DISC;
 
@@ -2604,6 +3167,21 @@ int cm93chart::CreateObjChain ( int cell_index, int subcell, double view_scale_p
             iObj++;
       }
 
+      //    Tesselate the area features of this cell now, across all cores,
+      //    rather than one by one on first render
+      if( tess_list.size() ){
+          int nCPU = wxMax(1, wxThread::GetCPUCount());
+          if(g_nCPUCount > 0)
+              nCPU = g_nCPUCount;
+
+          wxStopWatch sw;
+          PolyTessGeo::BuildDeferredTessBatch( tess_list, nCPU );
+
+          if ( g_bDebugCM93 )
+              wxLogMessage( _T( "   CM93 cell %d%c: %d area features tesselated in %ld ms" ),
+                            cell_index, (char)subcell, (int)tess_list.size(), sw.Time() );
+      }
+
 
 
 //     CALLGRIND_STOP_INSTRUMENTATION
@@ -4410,43 +4988,159 @@ bool cm93chart::UpdateCovrSet ( ViewPort *vpt )
       //    Create an array of CellIndexes covering the current viewport
       std::vector<int> vpcells = GetVPCellArray ( *vpt );
 
+      m_pManager->m_pcell_loader->Collect();
+
       //    Check the member covr_set to see if all these viewport cells have had their m_covr loaded
 
       for ( unsigned int i=0 ; i < vpcells.size() ; i++ )
       {
-            //    If the cell is not already in the master coverset, go load enough of it to get the offsets and outlines.....
-            if ( !m_pcovr_set->IsCovrLoaded ( vpcells[i] ) )
+            //    If the cell is not already in the master coverset, extract the offsets and outlines
+            //    from the decoded cell, or queue it for loading.
+            UpdateCellCovr ( vpcells[i], false );
+      }                 // for cellindex array
+
+      return true;
+}
+
+
+
+//    Take the M_COVR of one cell into the covr_set from its decoded cell, queueing the cell
+//    for decoding if needed.  Returns false while the cell is still being decoded.
+bool cm93chart::UpdateCellCovr ( int cell_index, bool b_survey )
+{
+      if ( m_pcovr_set->IsCovrLoaded ( cell_index ) )
+            return true;
+
+      bool b_nofiles;
+      cm93_cell_data *pcell = GetDecodedCell ( cell_index, &b_nofiles, b_survey );
+      if ( !pcell && !b_nofiles )
+            return false;
+
+      int n_attached = 0;
+      if ( pcell )
+      {
+            for ( unsigned int is=0 ; is < pcell->m_subcells.size() ; is++ )
+            {
+                  cm93_subcell_data &sub = pcell->m_subcells[is];
+                  if ( !sub.m_pCIB )
+                        continue;
+
+                  //Extract the m_covr structures inline
+                  Attach_CM93_Cell ( sub.m_pCIB );
+                  ProcessMCOVRObjects ( cell_index, sub.m_subcell );
+                  n_attached++;
+            }
+      }
+
+      //    A cell whose files all failed to ingest is not loaded, so it is not
+      //    recorded (or persisted) as having no coverage
+      if ( n_attached || b_nofiles )
+            m_pcovr_set->SetCovrLoaded ( cell_index );
+
+      //    Cells decoded for the survey alone are not kept in the cache
+      if ( pcell && pcell->m_bsurvey )
+            m_pManager->m_pcell_loader->Discard ( pcell );
+
+      return true;
+}
+
+//    List the cells of one scale in a cm93 dataset, from the file names alone.
+//    Cell files are named <subcell><lat:3><lon:4>.<scale>, under <root:8>/<scale>/.
+static void ListCM93Cells ( wxString prefix, wxChar scale_char, std::deque<int> *pcells,
+                            const std::atomic<bool> *pcancel )
+{
+      std::set<int> cells;
+      wxString scales[2] = { wxString ( scale_char ), wxString ( scale_char ).Lower() };
+
+      wxDir root ( prefix );
+      if ( !root.IsOpened() )
+            return;
+
+      wxString root_name;
+      bool b_cont = root.GetFirst ( &root_name, wxEmptyString, wxDIR_DIRS );
+      while ( b_cont && !*pcancel )
+      {
+            if ( root_name.Len() == 8 && root_name.IsNumber() )
             {
-                  if ( loadcell_in_sequence ( vpcells[i], '0' ) )
+                  for ( int ic = 0 ; ic < 2 ; ic++ )
                   {
-                        ProcessMCOVRObjects ( vpcells[i], '0' );
-                        Unload_CM93_Cell();           // all done with this (sub)cell
+                        wxString path = prefix + root_name;
+                        appendOSDirSep ( &path );
+                        path += scales[ic];
+                        if ( !wxDir::Exists ( path ) )
+                              continue;
+
+                        wxDir dir ( path );
+                        wxString name;
+                        bool b_file = dir.GetFirst ( &name, wxEmptyString, wxDIR_FILES );
+                        while ( b_file )
+                        {
+                              long lat, lon;
+                              if ( name.Len() >= 10 && name[8] == '.' &&
+                                   name.Mid ( 1, 3 ).ToLong ( &lat ) && name.Mid ( 4, 4 ).ToLong ( &lon ) )
+                                    cells.insert ( ( lat * 10000 ) + lon );
+                              b_file = dir.GetNext ( &name );
+                        }
+
+                        if ( ic == 0 && scales[1] == scales[0] )
+                              break;
                   }
-                  m_pcovr_set->m_cell_hash[vpcells[i]] = 1;
+            }
+            b_cont = root.GetNext ( &root_name );
+      }
 
-                  char loadcell_key = 'A';               // starting subcells
+      pcells->assign ( cells.begin(), cells.end() );
+}
 
-                  //    Load the subcells in sequence
-                  //    On successful load, add it to the covr set and process the cell
-                  while ( loadcell_in_sequence ( vpcells[i], loadcell_key ) )
-                  {
-                        //Extract the m_covr structures inline
+//    One step of the coverage survey of the whole dataset at this scale, see
+//    cm93compchart::SurveyCoverage().  The cell files are listed on a worker thread,
+//    then a few cells at a time are decoded by the cell loader and their M_COVR taken
+//    into the covr_set, which is saved when done.  Returns true once every cell is in.
+bool cm93chart::SurveyCovrStep ( void )
+{
+      if ( m_bsurvey_done )
+            return true;
 
-                        ProcessMCOVRObjects ( vpcells[i], loadcell_key );
+      if ( !m_bsurvey_listed )
+      {
+            if ( !m_survey_thread.joinable() )
+            {
+                  wxString prefix = m_prefix;
+                  wxChar scale_char = m_scalechar[0];
+                  m_survey_thread = std::thread ( [this, prefix, scale_char]() {
+                        ListCM93Cells ( prefix, scale_char, &m_survey_cells, &m_bsurvey_cancel );
+                        m_bsurvey_listed = true;
+                  } );
+            }
+            return false;
+      }
 
-                        Unload_CM93_Cell();           // all done with this (sub)cell
+      if ( m_survey_thread.joinable() )
+            m_survey_thread.join();
 
-                        loadcell_key++;
+      m_pManager->m_pcell_loader->Collect();
 
-                  }     // while
-            }           // cell is not in
-      }                 // for cellindex array
+      unsigned int n_waiting = 0;
+      std::deque<int>::iterator it = m_survey_cells.begin();
+      while ( it != m_survey_cells.end() && n_waiting < CM93_SURVEY_CELLS_IN_FLIGHT )
+      {
+            if ( UpdateCellCovr ( *it, true ) )
+                  it = m_survey_cells.erase ( it );
+            else
+            {
+                  ++it;
+                  n_waiting++;
+            }
+      }
 
+      if ( !m_survey_cells.empty() )
+            return false;
+
+      m_pcovr_set->Save();
+      m_bsurvey_done = true;
       return true;
 }
 
-
-
 bool cm93chart::IsPointInLoadedM_COVR ( double xc, double yc )
 {
     //  Provisionally revert to older method pending investigation.
@@ -4469,16 +5163,9 @@ LLRegion cm93chart::GetValidRegion()
 
 
 
-int cm93chart::loadcell_in_sequence ( int cellindex, char subcell )
-{
-      int rv = loadsubcell ( cellindex, subcell );
-
-      return rv;
-}
-
-
-
-int cm93chart::loadsubcell ( int cellindex, wxChar sub_char )
+//    Find the file holding a cm93 (sub)cell, using the NoFind array to skip known missing files.
+//    On return, compfile is set if only the .xz compressed version exists.
+bool cm93chart::locatesubcell ( int cellindex, wxChar sub_char, wxString &file, wxString &compfile )
 {
 
       //    Create the file name
@@ -4502,7 +5189,6 @@ int cm93chart::loadsubcell ( int cellindex, wxChar sub_char )
       int ilatroot = ( ( ( ilat - 30 ) / 60 ) * 60 ) + 30;
       int ilonroot = ( ilon / 60 ) * 60;
 
-      wxString file;
       file.Printf ( _T ( "%04d%04d." ), jlat, jlon );
       file += m_scalechar;
       file[0] = sub_char;
@@ -4538,7 +5224,7 @@ int cm93chart::loadsubcell ( int cellindex, wxChar sub_char )
       }
 
       bool bfound = false;
-      wxString compfile;
+      compfile.Clear();
       if(b_useNoFind){
         if(m_noFindArray.Index(key) == wxNOT_FOUND){
             if ( ::wxFileExists ( file ) )
@@ -4631,52 +5317,75 @@ int cm93chart::loadsubcell ( int cellindex, wxChar sub_char )
       }
 
       if(!bfound && !compfile.Length())
-          return 0;
-
-      //    File is known to exist
+          return false;
 
       wxString msg ( _T ( "Loading CM93 cell " ) );
       msg += file;
       wxLogMessage ( msg );
 
-      //    Set the member variable to be the actual file name for use in single chart mode info display
-      m_LastFileName = file;
+      return true;
+}
 
-      // Decompress if needed
-      if(compfile.Length()) {
-          file = wxFileName::CreateTempFileName(wxFileName(compfile).GetFullName());
-          if(!DecompressXZFile(compfile, file)) {
-              wxRemoveFile(file);
-              return 0;
-          }
+//    Fetch a decoded cell from the cell loader cache.
+//    If it is not there, locate the base cell and its subcells and queue them for background loading.
+//    Returns NULL while the cell is pending, with *pb_nofiles set if no files exist for the cell at all.
+//    b_survey marks a request from the coverage survey, whose cells need no canvas refresh.
+cm93_cell_data *cm93chart::GetDecodedCell ( int cell_index, bool *pb_nofiles, bool b_survey )
+{
+      *pb_nofiles = false;
+
+      cm93_cell_loader *ploader = m_pManager->m_pcell_loader;
+
+      wxString key = m_scalechar;
+      key << cell_index;
+
+      cm93_cell_data *pcell = ploader->GetCell ( key );
+      if ( pcell )
+      {
+            if ( !b_survey )
+                  pcell->m_bsurvey = false;               // a chart uses it, keep it cached
+            return pcell;
       }
 
-      if ( g_bDebugCM93 )
+      if ( ploader->IsPending ( key ) )
       {
-            char str[256];
-            strncpy ( str, msg.mb_str(), 255 );
-            str[255] = 0;
-            printf ( "   %s\n", str );
+            if ( !b_survey )
+                  ploader->WantNotify ( key );
+            return NULL;
       }
 
-      //    Ingest it
-      if ( !Ingest_CM93_Cell ( ( const char * ) file.mb_str(), &m_CIB ) )
+      pcell = new cm93_cell_data;
+      pcell->m_key = key;
+      pcell->m_cell_index = cell_index;
+      pcell->m_bsurvey = b_survey;
+
+      cm93_subcell_data sub;
+      sub.m_pCIB = NULL;
+
+      sub.m_subcell = '0';                                // Base cell
+      if ( locatesubcell ( cell_index, sub.m_subcell, sub.m_file, sub.m_compfile ) )
+            pcell->m_subcells.push_back ( sub );
+
+      sub.m_subcell = 'A';                                // then any subcells, in sequence
+      while ( locatesubcell ( cell_index, sub.m_subcell, sub.m_file, sub.m_compfile ) )
       {
-            wxString msg ( _T ( "   cm93chart  Error ingesting " ) );
-            msg.Append ( file );
-            wxLogMessage ( msg );
+            pcell->m_subcells.push_back ( sub );
+            sub.m_subcell++;
+      }
 
-            if(compfile.Length())
-                wxRemoveFile(file);
-            return 0;
+      if ( pcell->m_subcells.empty() )
+      {
+            delete pcell;
+            *pb_nofiles = true;
+            return NULL;
       }
 
-      if(compfile.Length())
-          wxRemoveFile(file);
+      ploader->RequestCell ( pcell );
 
-      return 1;
+      return NULL;
 }
 
+
 void cm93chart::SetUserOffsets ( int cell_index, int object_id, int subcell, int xoff, int yoff )
 {
       M_COVR_Desc *pmcd = GetCoverSet()->Find_MCD ( cell_index, object_id, subcell );
@@ -4726,10 +5435,12 @@ cm93manager::cm93manager ( void )
       m_bfoundG = false;
       m_bfoundZ = false;
 
+      m_pcell_loader = new cm93_cell_loader;
 }
 
 cm93manager::~cm93manager ( void )
 {
+      delete m_pcell_loader;
       delete m_pcm93Dict;
 }
 
@@ -4811,6 +5522,19 @@ cm93_dictionary *cm93manager::FindAndLoadDict ( const wxString &file )
 //----------------------------------------------------------------------------
 // cm93 Composite Chart object class Implementation
 //----------------------------------------------------------------------------
+//    Drives cm93compchart::SurveyCoverage() from the GUI thread
+class cm93_survey_timer : public wxTimer
+{
+public:
+      cm93_survey_timer ( cm93compchart *parent ) { m_parent = parent; }
+      void Notify() { m_parent->SurveyCoverage(); }
+
+private:
+      cm93compchart     *m_parent;
+};
+
+#define CM93_SURVEY_TICK_MSEC   250
+
 cm93compchart::cm93compchart()
 {
       m_ChartType = CHART_TYPE_CM93COMP;
@@ -4841,6 +5565,9 @@ cm93compchart::cm93compchart()
       m_last_cell_adjustvp = NULL;
 
       m_pcm93mgr = new cm93manager();
+
+      m_psurvey_timer = NULL;
+      m_survey_scale = 1;
 }
 
 cm93compchart::~cm93compchart()
@@ -4849,6 +5576,8 @@ cm93compchart::~cm93compchart()
         g_pCM93OffsetDialog->Hide();
     }
 
+      delete m_psurvey_timer;
+
       for ( int i = 0 ; i < 8 ; i++ )
             delete m_pcm93chart_array[i];
 
@@ -4938,11 +5667,53 @@ InitReturn cm93compchart::Init ( const wxString& name, ChartInitFlag flags )
 
       bReadyToRender = true;
 
+      //    Complete the coverage of the whole dataset in the background
+      if ( !m_psurvey_timer )
+      {
+            m_psurvey_timer = new cm93_survey_timer ( this );
+            m_psurvey_timer->Start ( CM93_SURVEY_TICK_MSEC, wxTIMER_CONTINUOUS );
+      }
+
       return INIT_OK;
 
 
 }
 
+//    Precompute the M_COVR coverage of every cell in the dataset, scale by scale (the Z
+//    scale keeps no coverage cache), a few cells per tick.  The coverage sets are saved as
+//    each scale completes, so later sessions find every cell's coverage in the cache and
+//    open no cell file just to learn what covers the viewport.
+void cm93compchart::SurveyCoverage ( void )
+{
+      while ( m_survey_scale < 8 )
+      {
+            cm93chart *psc = m_pcm93chart_array[m_survey_scale];
+            if ( !psc )
+            {
+                  psc = new cm93chart();
+                  m_pcm93chart_array[m_survey_scale] = psc;
+
+                  wxString file_dummy = _T ( "CM93." );
+                  file_dummy << ( wxChar ) ( 'A' + m_survey_scale - 1 );
+
+                  psc->SetCM93Dict ( m_pDictComposite );
+                  psc->SetCM93Prefix ( m_prefixComposite );
+                  psc->SetCM93Manager ( m_pcm93mgr );
+
+                  psc->SetColorScheme ( m_global_color_scheme );
+                  psc->Init ( file_dummy, FULL_INIT );
+            }
+
+            if ( !psc->SurveyCovrStep() )
+                  return;
+
+            m_survey_scale++;
+      }
+
+      wxLogMessage ( _T ( "CM93 coverage survey complete" ) );
+      m_psurvey_timer->Stop();
+}
+
 void cm93compchart::Activate ( void )
 {
 //       if ( g_bShowCM93DetailSlider )
@@ -5175,18 +5946,9 @@ int cm93compchart::PrepareChartScale ( const ViewPort &vpt, int cmscale, bool bO
                         covr_set *pcover = m_pcm93chart_current->GetCoverSet();
                         if ( pcover )
                         {
-                              bool boverlap = false;
-                              for ( unsigned int im=0 ; im < pcover->GetCoverCount() ; im++ )
-                              {
-                                    M_COVR_Desc *mcd = pcover->GetCover ( im );
-
-                                    if ( ! ( vp.GetBBox().IntersectOut ( mcd->m_covr_bbox ) ) )
-                                    {
-                                          boverlap = true;
-                                          break;
-                                    }
-                              }
-                              if ( boverlap )
+                              std::vector<M_COVR_Desc *> covers;
+                              pcover->GetCoversInBox ( vp.GetBBox(), covers );
+                              if ( covers.size() )
                                     cellscale_is_useable = true;
                         }
                   }
@@ -6153,11 +6915,11 @@ bool cm93compchart::RenderNextSmallerCellOutlines ( ocpnDC &dc, ViewPort& vp, Ch
               //    Render the chart outlines
               covr_set *pcover = psc->GetCoverSet();
 
-              for ( unsigned int im=0 ; im < pcover->GetCoverCount() ; im++ ){
-                  M_COVR_Desc *mcd = pcover->GetCover ( im );
+              std::vector<M_COVR_Desc *> covers;
+              pcover->GetCoversInBox ( vp.GetBBox(), covers );
 
-                  if(vp.GetBBox().IntersectOut ( mcd->m_covr_bbox ))
-                      continue;
+              for ( unsigned int im=0 ; im < covers.size() ; im++ ){
+                  M_COVR_Desc *mcd = covers[im];
 #ifdef ocpnUSE_GL
                   if (g_bopengl) {
                       RenderCellOutlinesOnGL(nvp, mcd);
@@ -75,6 +75,7 @@ private:
 #include "navutil.h"
 #include "TexFont.h"
 #include "glTexCache.h"
+#include "glChartTileCache.h"
 #include "gshhs.h"
 #include "ais.h"
 #include "OCPNPlatform.h"
@@ -207,6 +208,7 @@ PFNGLGETCOMPRESSEDTEXIMAGEPROC s_glGetCompressedTexImage;
 PFNGLGENBUFFERSPROC                 s_glGenBuffers;
 PFNGLBINDBUFFERPROC                 s_glBindBuffer;
 PFNGLBUFFERDATAPROC                 s_glBufferData;
+PFNGLBUFFERSUBDATAPROC              s_glBufferSubData;
 PFNGLDELETEBUFFERSPROC              s_glDeleteBuffers;
 
 
@@ -461,6 +463,8 @@ static void GetglEntryPoints( void )
             ocpnGetProcAddress( "glBindBuffer", extensions[i]);
         s_glBufferData = (PFNGLBUFFERDATAPROC)
             ocpnGetProcAddress( "glBufferData", extensions[i]);
+        s_glBufferSubData = (PFNGLBUFFERSUBDATAPROC)
+            ocpnGetProcAddress( "glBufferSubData", extensions[i]);
         s_glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)
             ocpnGetProcAddress( "glDeleteBuffers", extensions[i]);
 
@@ -477,6 +481,7 @@ static void GetglEntryPoints( void )
         if( i < n_ext ){
             s_glBindBuffer = (PFNGLBINDBUFFERPROC) ocpnGetProcAddress( "glBindBuffer", extensions[i]);
             s_glBufferData = (PFNGLBUFFERDATAPROC) ocpnGetProcAddress( "glBufferData", extensions[i]);
+            s_glBufferSubData = (PFNGLBUFFERSUBDATAPROC) ocpnGetProcAddress( "glBufferSubData", extensions[i]);
             s_glDeleteBuffers = (PFNGLDELETEBUFFERSPROC) ocpnGetProcAddress( "glDeleteBuffers", extensions[i]);
         }
     }
@@ -541,6 +546,9 @@ glChartCanvas::glChartCanvas( wxWindow *parent ) :
     m_b_BuiltFBO = false;
     m_b_DisableFBO = false;
 
+    m_pTileCache = new glChartTileCache( this );
+    m_btiles_composed = false;
+
     ownship_tex = 0;
     ownship_color = -1;
 
@@ -580,6 +588,7 @@ glChartCanvas::glChartCanvas( wxWindow *parent ) :
 
 glChartCanvas::~glChartCanvas()
 {
+    delete m_pTileCache;
 }
 
 void glChartCanvas::FlushFBO( void ) 
@@ -1342,6 +1351,9 @@ void glChartCanvas::DrawStaticRoutesTracksAndWaypoints( ViewPort &vp )
         return;
     ocpnDC dc(*this);
 
+    //  Mark names are queued, and drawn together on top of the routes
+    dc.BeginTextBatch();
+
     for(wxTrackListNode *node = pTrackList->GetFirst();
         node; node = node->GetNext() ) {
         Track *pTrackDraw = node->GetData();
@@ -1380,12 +1392,17 @@ void glChartCanvas::DrawStaticRoutesTracksAndWaypoints( ViewPort &vp )
                     pWP->DrawGL( vp, m_pParentCanvas );
         }
     }
+
+    dc.EndTextBatch();
 }
 
 void glChartCanvas::DrawDynamicRoutesTracksAndWaypoints( ViewPort &vp )
 {
     ocpnDC dc(*this);
 
+    //  Mark names are queued, and drawn together on top of the routes
+    dc.BeginTextBatch();
+
     for(wxTrackListNode *node = pTrackList->GetFirst();
         node; node = node->GetNext() ) {
         Track *pTrackDraw = node->GetData();
@@ -1430,7 +1447,8 @@ void glChartCanvas::DrawDynamicRoutesTracksAndWaypoints( ViewPort &vp )
                 pWP->DrawGL( vp, m_pParentCanvas );
         }
     }
-    
+
+    dc.EndTextBatch();
 }
 
 static void GetLatLonCurveDist(const ViewPort &vp, float &lat_dist, float &lon_dist)
@@ -2609,6 +2627,7 @@ void glChartCanvas::Invalidate()
     /* should probably use a different flag for this */
 
     m_pParentCanvas->m_glcc->m_cache_vp.Invalidate();
+    m_pTileCache->Invalidate();
 
 }
 
@@ -3053,7 +3072,11 @@ void glChartCanvas::RenderQuiltViewGLText( ViewPort &vp, const OCPNRegion &rect_
 
 void glChartCanvas::RenderCharts(ocpnDC &dc, const OCPNRegion &rect_region)
 {
-    ViewPort &vp = m_pParentCanvas->VPoint;
+    RenderCharts(dc, rect_region, m_pParentCanvas->VPoint);
+}
+
+void glChartCanvas::RenderCharts(ocpnDC &dc, const OCPNRegion &rect_region, ViewPort &vp)
+{
 
 #ifdef USE_S57
     
@@ -3539,9 +3562,47 @@ void glChartCanvas::Render()
     int sx = gl_width;
     int sy = gl_height;
 
+    // Compose the frame from cached chart tiles, rendering only those out of date.
+    // The result goes to the framebuffer object, where the gesture handlers expect the last frame.
+    bool useTiles = false;
+    if(m_b_BuiltFBO && !m_bfogit && !scale_it && !bpost_hilite
+       && !g_GLOptions.m_bUseCanvasPanning && sx == m_cache_tex_x && sy == m_cache_tex_y
+       && m_pTileCache->CanCache( VPoint ) ) {
+        useTiles = m_pTileCache->Update( gldc, VPoint );
+        if( useTiles ) {
+            ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, m_fb0 );
+            ( s_glFramebufferTexture2D )( GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
+                                          g_texture_rectangle_format,
+                                          m_cache_tex[m_cache_page], 0 );
+
+            //  The page still holds the last frame, which neither the stretched
+            //  fallback nor the tiles may cover after a zoom out or a cut short update
+            wxColour color = GetGlobalColor( _T ( "NODTA" ) );
+            if( color.IsOk() )
+                glClearColor( color.Red() / 256., color.Green()/256., color.Blue()/256., 1.0 );
+            else
+                glClearColor(0, 0., 0, 1.0);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            m_pTileCache->Compose( VPoint );
+            ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, 0 );
+
+            m_fbo_offsetx = 0;
+            m_fbo_offsety = 0;
+            m_fbo_swidth = sx;
+            m_fbo_sheight = sy;
+            useFBO = true;
+        }
+
+        //  Come back for the tiles left out of this frame's budget
+        if( !m_pTileCache->IsComplete() )
+            Refresh( false );
+    }
+    m_btiles_composed = useTiles;
+
     // Try to use the framebuffer object's cache of the last frame
     // to accelerate drawing this frame (if overlapping)
-    if(m_b_BuiltFBO && !m_bfogit && !scale_it && !bpost_hilite
+    if(!useTiles && m_b_BuiltFBO && !m_bfogit && !scale_it && !bpost_hilite
        //&& VPoint.tilt == 0 // disabling fbo in tilt mode gives better quality but slower
         ) {
         //  Is this viewpoint the same as the previously painted one?
@@ -4161,6 +4222,24 @@ void glChartCanvas::FastPan(int dx, int dy)
         glDisable( GL_STENCIL_TEST );
     }
     
+    //  The tiles the last frame was composed from also cover what the pan uncovers
+    if( m_btiles_composed && m_pTileCache->HasTiles() ) {
+        m_fbo_offsety += dy;
+        m_fbo_offsetx += dx;
+
+        wxColour color = GetGlobalColor( _T ( "NODTA" ) );
+        if( color.IsOk() )
+            glClearColor( color.Red() / 256., color.Green()/256., color.Blue()/256., 1.0 );
+        else
+            glClearColor(0, 0., 0, 1.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        m_pTileCache->Compose( m_cache_vp, m_fbo_offsetx, -m_fbo_offsety );
+
+        SwapBuffers();
+        return;
+    }
+
     float vx0 = 0;
     float vy0 = 0;
     float vy = sy;
@@ -0,0 +1,590 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Tiled framebuffer cache of rendered chart layers
+ *
+ ***************************************************************************
+ *   Copyright (C) 2026 by the NavalCPN developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************
+ */
+
+#include <wx/wxprec.h>
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include <string.h>
+
+#include "dychart.h"
+
+#include "glChartTileCache.h"
+#include "glChartCanvas.h"
+#include "chcanv.h"
+#include "Quilt.h"
+#include "chartbase.h"
+#include "georef.h"
+#include "OCPNRegion.h"
+
+#define TILE_TEX_SIZE           512         // tile texture size, including the gutter
+#define TILE_GUTTER             32          // rendered past each edge, for symbols straddling two tiles
+#define TILE_SIZE               ( TILE_TEX_SIZE - 2 * TILE_GUTTER )
+#define TILE_TEX_BYTES          ( TILE_TEX_SIZE * TILE_TEX_SIZE * 4 )
+#define TILE_MEM_SHARE          4           // tiles may use up to 1/4 of the texture memory setting
+#define TILE_RENDER_BUDGET      12          // ms of tile rendering per frame, when something else can be shown
+
+extern ocpnGLOptions g_GLOptions;
+extern long g_tex_mem_used;
+
+extern PFNGLGENFRAMEBUFFERSEXTPROC         s_glGenFramebuffers;
+extern PFNGLGENRENDERBUFFERSEXTPROC        s_glGenRenderbuffers;
+extern PFNGLFRAMEBUFFERTEXTURE2DEXTPROC    s_glFramebufferTexture2D;
+extern PFNGLBINDFRAMEBUFFEREXTPROC         s_glBindFramebuffer;
+extern PFNGLFRAMEBUFFERRENDERBUFFEREXTPROC s_glFramebufferRenderbuffer;
+extern PFNGLRENDERBUFFERSTORAGEEXTPROC     s_glRenderbufferStorage;
+extern PFNGLBINDRENDERBUFFEREXTPROC        s_glBindRenderbuffer;
+extern PFNGLDELETEFRAMEBUFFERSEXTPROC      s_glDeleteFramebuffers;
+extern PFNGLDELETERENDERBUFFERSEXTPROC     s_glDeleteRenderbuffers;
+
+//  Clip the convex quad q to the world pixel square of tile (ix, iy)
+//  Returns the number of vertices left in out, which must hold 8 points
+static int ClipQuadToTile( const double *q, int ix, int iy, double *out )
+{
+    double edge[4] = { (double)ix * TILE_SIZE, (double)( ix + 1 ) * TILE_SIZE,
+                       (double)iy * TILE_SIZE, (double)( iy + 1 ) * TILE_SIZE };
+    double in[16];
+    memcpy( in, q, 8 * sizeof( double ) );
+    int n = 4;
+
+    for( int e = 0; e < 4 && n; e++ ) {
+        int c = e < 2 ? 0 : 1;                  // x or y
+        double sign = ( e % 2 ) ? -1. : 1.;     // keep the side above the minimum, or below the maximum
+        int m = 0;
+        for( int i = 0; i < n; i++ ) {
+            double *p = in + 2 * i, *r = in + 2 * ( ( i + 1 ) % n );
+            double dp = sign * ( p[c] - edge[e] ), dr = sign * ( r[c] - edge[e] );
+            if( dp >= 0 ) {
+                out[2 * m] = p[0], out[2 * m + 1] = p[1];
+                m++;
+            }
+            if( ( dp >= 0 ) != ( dr >= 0 ) ) {
+                double t = dp / ( dp - dr );
+                out[2 * m] = p[0] + t * ( r[0] - p[0] );
+                out[2 * m + 1] = p[1] + t * ( r[1] - p[1] );
+                m++;
+            }
+        }
+        n = m;
+        memcpy( in, out, 2 * n * sizeof( double ) );
+    }
+    return n;
+}
+
+//  Is every vertex of the polygon inside the convex quad q, to within a pixel?
+static bool PolygonInQuad( const double *poly, int n, const double *q )
+{
+    double area = 0;
+    for( int i = 0; i < 4; i++ ) {
+        const double *a = q + 2 * i, *b = q + 2 * ( ( i + 1 ) % 4 );
+        area += a[0] * b[1] - b[0] * a[1];
+    }
+    double sign = area < 0 ? -1. : 1.;
+
+    for( int i = 0; i < 4; i++ ) {
+        const double *a = q + 2 * i, *b = q + 2 * ( ( i + 1 ) % 4 );
+        double ex = b[0] - a[0], ey = b[1] - a[1];
+        double len = sqrt( ex * ex + ey * ey );
+        for( int j = 0; j < n; j++ ) {
+            double cross = ex * ( poly[2 * j + 1] - a[1] ) - ey * ( poly[2 * j] - a[0] );
+            if( sign * cross < -len )
+                return false;
+        }
+    }
+    return true;
+}
+
+glChartTileCache::glChartTileCache( glChartCanvas *glcc )
+{
+    m_glcc = glcc;
+    m_fbo = 0;
+    m_renderbuffer = 0;
+    m_bfbo_failed = false;
+    m_bkey = false;
+    m_bfallback = false;
+    m_generation = 0;
+    m_frame = 0;
+    m_bcomplete = true;
+    m_bdirect = false;
+}
+
+glChartTileCache::~glChartTileCache()
+{
+    Clear();
+}
+
+void glChartTileCache::Clear()
+{
+    for( size_t i = 0; i < m_tiles.size(); i++ ) {
+        glDeleteTextures( 1, &m_tiles[i]->tex );
+        delete m_tiles[i];
+    }
+    g_tex_mem_used -= m_tiles.size() * TILE_TEX_BYTES;
+    m_tiles.clear();
+
+    if( m_fbo ) {
+        ( s_glDeleteFramebuffers )( 1, &m_fbo );
+        ( s_glDeleteRenderbuffers )( 1, &m_renderbuffer );
+        m_fbo = 0;
+    }
+
+    m_bkey = false;
+    m_bfallback = false;
+    m_bcomplete = true;
+    m_bdirect = false;
+}
+
+bool glChartTileCache::BuildFBO()
+{
+    if( !s_glGenFramebuffers || m_bfbo_failed )
+        return false;
+
+    glGetError();       // clear any earlier error
+
+    ( s_glGenFramebuffers )( 1, &m_fbo );
+    ( s_glGenRenderbuffers )( 1, &m_renderbuffer );
+
+    ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, m_fbo );
+    ( s_glBindRenderbuffer )( GL_RENDERBUFFER_EXT, m_renderbuffer );
+
+    //  Same attachments as the canvas framebuffer, for chart clipping, at tile size
+    if( m_glcc->m_b_useFBOStencil ) {
+        ( s_glRenderbufferStorage )( GL_RENDERBUFFER_EXT, GL_DEPTH24_STENCIL8_EXT,
+                                     TILE_TEX_SIZE, TILE_TEX_SIZE );
+        ( s_glFramebufferRenderbuffer )( GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT,
+                                         GL_RENDERBUFFER_EXT, m_renderbuffer );
+        ( s_glFramebufferRenderbuffer )( GL_FRAMEBUFFER_EXT, GL_STENCIL_ATTACHMENT_EXT,
+                                         GL_RENDERBUFFER_EXT, m_renderbuffer );
+    } else {
+        GLenum depth_format = GL_DEPTH_COMPONENT24;
+#ifdef ocpnUSE_GLES
+        if( !QueryExtension("GL_OES_depth24") )
+            depth_format = GL_DEPTH_COMPONENT16;
+#endif
+        ( s_glRenderbufferStorage )( GL_RENDERBUFFER_EXT, depth_format,
+                                     TILE_TEX_SIZE, TILE_TEX_SIZE );
+        ( s_glFramebufferRenderbuffer )( GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT,
+                                         GL_RENDERBUFFER_EXT, m_renderbuffer );
+    }
+
+    ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, 0 );
+
+    int err = glGetError();
+    if( err ) {
+        wxString msg;
+        msg.Printf( _T("    OpenGL-> Chart tile framebuffer error:  %08X"), err );
+        wxLogMessage( msg );
+
+        ( s_glDeleteFramebuffers )( 1, &m_fbo );
+        ( s_glDeleteRenderbuffers )( 1, &m_renderbuffer );
+        m_fbo = 0;
+        m_bfbo_failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool glChartTileCache::CanCache( ViewPort &vp )
+{
+    if( !g_GLOptions.m_bUseChartTileCache )
+        return false;
+
+    if( vp.m_projection_type != PROJECTION_MERCATOR &&
+        vp.m_projection_type != PROJECTION_WEB_MERCATOR )
+        return false;
+
+    if( vp.tilt != 0. || fabs( vp.skew ) > .0001 )
+        return false;
+
+    //  The tile grid does not wrap at the antimeridian
+    LLBBox &box = vp.GetBBox();
+    if( box.GetMinLon() < -180. || box.GetMaxLon() > 180. )
+        return false;
+
+    ChartCanvas *cc = m_glcc->m_pParentCanvas;
+    bool b_rotated = fabs( vp.rotation ) > .0001;
+
+    if( vp.b_quilt ) {
+        if( cc->m_pQuilt->IsBusy() )
+            return false;
+
+        //  cm93 sets its own viewport parameters while rendering, and draws its own text
+        ChartBase *ref = cc->m_pQuilt->GetRefChart();
+        if( ref && ref->GetChartType() == CHART_TYPE_CM93COMP )
+            return false;
+
+        //  Vector symbols are drawn upright on the screen, so may not be rotated with the tiles
+        if( b_rotated && cc->m_pQuilt->IsQuiltVector() )
+            return false;
+    } else {
+        //  A single vector chart renders its own text, decluttered per render
+        if( !cc->m_singleChart || cc->m_singleChart->GetChartFamily() != CHART_FAMILY_RASTER )
+            return false;
+    }
+
+    return true;
+}
+
+glChartTileKey glChartTileCache::MakeKey( ViewPort &vp )
+{
+    ChartCanvas *cc = m_glcc->m_pParentCanvas;
+
+    glChartTileKey key;
+    key.view_scale_ppm = vp.view_scale_ppm;
+    key.projection = vp.m_projection_type;
+    key.color_scheme = cc->GetColorScheme();
+    if( vp.b_quilt ) {
+        key.ref_index = cc->m_pQuilt->GetRefChartdbIndex();
+        key.chart = NULL;
+    } else {
+        key.ref_index = -1;
+        key.chart = cc->m_singleChart;
+    }
+    return key;
+}
+
+//  The screen corners in world pixels, y down, and the world pixel at the screen center
+//  sdx, sdy offset the view center, in screen pixels
+void glChartTileCache::GetScreenQuad( ViewPort &vp, double sdx, double sdy, double *q,
+                                      double &cx, double &cy )
+{
+    double easting, northing;
+    toSM( vp.clat, vp.clon, 0., 0., &easting, &northing );
+
+    double c = cos( vp.rotation ), s = sin( vp.rotation );
+    cx = easting * vp.view_scale_ppm + sdx * c + sdy * s;
+    cy = -northing * vp.view_scale_ppm - sdx * s + sdy * c;
+
+    double hw = vp.pix_width / 2., hh = vp.pix_height / 2.;
+    double corners[8] = { -hw, -hh, hw, -hh, hw, hh, -hw, hh };
+    for( int i = 0; i < 4; i++ ) {
+        double dx = corners[2 * i], dy = corners[2 * i + 1];
+        q[2 * i]     = cx + dx * c + dy * s;
+        q[2 * i + 1] = cy - dx * s + dy * c;
+    }
+}
+
+void glChartTileCache::GetTileRange( const double *q, int &ix0, int &iy0, int &ix1, int &iy1 )
+{
+    double minx = q[0], maxx = q[0], miny = q[1], maxy = q[1];
+    for( int i = 1; i < 4; i++ ) {
+        minx = wxMin( minx, q[2 * i] ), maxx = wxMax( maxx, q[2 * i] );
+        miny = wxMin( miny, q[2 * i + 1] ), maxy = wxMax( maxy, q[2 * i + 1] );
+    }
+    ix0 = (int) floor( minx / TILE_SIZE ), ix1 = (int) floor( maxx / TILE_SIZE );
+    iy0 = (int) floor( miny / TILE_SIZE ), iy1 = (int) floor( maxy / TILE_SIZE );
+}
+
+//  A north up viewport covering the tile texture, gutter included
+ViewPort glChartTileCache::TileViewPort( ViewPort &vp, int ix, int iy )
+{
+    ViewPort tvp = vp;
+
+    double x = ( ix + 0.5 ) * TILE_SIZE, y = ( iy + 0.5 ) * TILE_SIZE;
+    fromSM( x / vp.view_scale_ppm, -y / vp.view_scale_ppm, 0., 0., &tvp.clat, &tvp.clon );
+
+    tvp.rotation = 0.;
+    tvp.pix_width = TILE_TEX_SIZE;
+    tvp.pix_height = TILE_TEX_SIZE;
+    tvp.InvalidateTransformCache();
+    tvp.SetBoxes();
+    tvp.Validate();
+
+    return tvp;
+}
+
+glChartTile *glChartTileCache::FindTile( const glChartTileKey &key, int ix, int iy )
+{
+    for( size_t i = 0; i < m_tiles.size(); i++ ) {
+        glChartTile *tile = m_tiles[i];
+        if( tile->ix == ix && tile->iy == iy && tile->key == key )
+            return tile;
+    }
+    return NULL;
+}
+
+glChartTile *glChartTileCache::NewTile( int ix, int iy, int nvisible )
+{
+    glChartTile *tile = NULL;
+
+    //  Reuse the least recently drawn tile once the cache holds its share of the
+    //  texture memory, and at least a couple of screens
+    size_t max_tiles = (size_t) g_GLOptions.m_iTextureMemorySize * 1024 * 1024 / TILE_MEM_SHARE / TILE_TEX_BYTES;
+    if( m_tiles.size() >= wxMax( max_tiles, (size_t) 2 * nvisible ) ) {
+        for( size_t i = 0; i < m_tiles.size(); i++ ) {
+            glChartTile *t = m_tiles[i];
+            if( t->last_used != m_frame && ( !tile || t->last_used < tile->last_used ) )
+                tile = t;
+        }
+    }
+
+    if( !tile ) {
+        tile = new glChartTile;
+        glGenTextures( 1, &tile->tex );
+        glBindTexture( GL_TEXTURE_2D, tile->tex );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, TILE_TEX_SIZE, TILE_TEX_SIZE, 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, NULL );
+        glBindTexture( GL_TEXTURE_2D, 0 );
+        m_tiles.push_back( tile );
+        g_tex_mem_used += TILE_TEX_BYTES;
+    }
+
+    tile->key = m_key;
+    tile->ix = ix;
+    tile->iy = iy;
+    tile->generation = m_generation - 1;
+    tile->last_used = m_frame;
+    memset( tile->valid, 0, sizeof tile->valid );
+
+    return tile;
+}
+
+void glChartTileCache::RenderTile( ocpnDC &dc, ViewPort &vp, glChartTile *tile )
+{
+    ( s_glFramebufferTexture2D )( GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
+                                  GL_TEXTURE_2D, tile->tex, 0 );
+
+    GLbitfield mask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+    if( glChartCanvas::s_b_useStencil ) {
+        glStencilMask( 0xff );
+        mask |= GL_STENCIL_BUFFER_BIT;
+    }
+    glClear( mask );
+
+    ViewPort tvp = TileViewPort( vp, tile->ix, tile->iy );
+    m_glcc->RenderCharts( dc, OCPNRegion( 0, 0, TILE_TEX_SIZE, TILE_TEX_SIZE ), tvp );
+
+    //  Quilt patches are clipped to the view they were composed for,
+    //  single charts render the whole tile
+    if( vp.b_quilt ) {
+        double cx, cy;
+        GetScreenQuad( vp, 0., 0., tile->valid, cx, cy );
+    } else {
+        double x0 = (double) tile->ix * TILE_SIZE, x1 = x0 + TILE_SIZE;
+        double y0 = (double) tile->iy * TILE_SIZE, y1 = y0 + TILE_SIZE;
+        double valid[8] = { x0, y0, x1, y0, x1, y1, x0, y1 };
+        memcpy( tile->valid, valid, sizeof valid );
+    }
+
+    tile->generation = m_generation;
+    tile->last_used = m_frame;
+}
+
+bool glChartTileCache::Update( ocpnDC &dc, ViewPort &vp )
+{
+    if( !m_fbo && !BuildFBO() )
+        return false;
+
+    //  On a scale or quilt reference chart change, the tiles of the last complete
+    //  frame stand in for missing ones
+    glChartTileKey key = MakeKey( vp );
+    if( !m_bkey || !( key == m_key ) ) {
+        if( m_bkey && key.SameLayers( m_key ) ) {
+            if( m_bcomplete || !m_bfallback ) {
+                m_fallback_key = m_key;
+                m_bfallback = true;
+            }
+        } else
+            m_bfallback = false;
+
+        m_key = key;
+        m_bkey = true;
+    }
+
+    m_frame++;
+
+    double q[8], cx, cy;
+    GetScreenQuad( vp, 0., 0., q, cx, cy );
+
+    int ix0, iy0, ix1, iy1;
+    GetTileRange( q, ix0, iy0, ix1, iy1 );
+    int nvisible = ( ix1 - ix0 + 1 ) * ( iy1 - iy0 + 1 );
+
+    //  With nothing to stand in for them, rendering more missing tiles than a screen
+    //  full of pixels costs more than rendering the screen.  The canvas renders directly
+    //  then, and the tiles are filled within the budget once the view holds still.
+    bool b_direct = false;
+    if( !m_bfallback ) {
+        int nmissing = 0;
+        for( int iy = iy0; iy <= iy1; iy++ ) {
+            for( int ix = ix0; ix <= ix1; ix++ ) {
+                double poly[16];
+                if( ClipQuadToTile( q, ix, iy, poly ) >= 3 && !FindTile( m_key, ix, iy ) )
+                    nmissing++;
+            }
+        }
+        b_direct = (double) nmissing * TILE_TEX_SIZE * TILE_TEX_SIZE > (double) vp.pix_width * vp.pix_height;
+    }
+
+    bool b_still = m_bdirect && !memcmp( q, m_direct_q, sizeof m_direct_q );
+    m_bdirect = b_direct;
+    memcpy( m_direct_q, q, sizeof m_direct_q );
+    if( b_direct && !b_still ) {
+        m_bcomplete = false;
+        return false;
+    }
+
+    GLint viewport_save[4];
+    bool b_bound = false;
+
+    wxStopWatch sw;
+    m_bcomplete = true;
+
+    for( int iy = iy0; iy <= iy1; iy++ ) {
+        for( int ix = ix0; ix <= ix1; ix++ ) {
+            double poly[16];
+            int n = ClipQuadToTile( q, ix, iy, poly );
+            if( n < 3 )
+                continue;
+
+            glChartTile *tile = FindTile( m_key, ix, iy );
+            if( tile ) {
+                tile->last_used = m_frame;
+                if( tile->generation == m_generation && PolygonInQuad( poly, n, tile->valid ) )
+                    continue;
+            }
+
+            //  Stale or stretched content can be shown meanwhile
+            if( ( tile || m_bfallback || b_direct ) && sw.Time() > TILE_RENDER_BUDGET ) {
+                m_bcomplete = false;
+                continue;
+            }
+
+            if( !tile )
+                tile = NewTile( ix, iy, nvisible );
+
+            if( !b_bound ) {
+                glGetIntegerv( GL_VIEWPORT, viewport_save );
+                ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, m_fbo );
+
+                glViewport( 0, 0, TILE_TEX_SIZE, TILE_TEX_SIZE );
+                glMatrixMode( GL_PROJECTION );
+                glPushMatrix();
+                glLoadIdentity();
+                glOrtho( 0, TILE_TEX_SIZE, TILE_TEX_SIZE, 0, -1, 1 );
+                glMatrixMode( GL_MODELVIEW );
+                glPushMatrix();
+                glLoadIdentity();
+                b_bound = true;
+            }
+
+            RenderTile( dc, vp, tile );
+        }
+    }
+
+    if( b_bound ) {
+        ( s_glBindFramebuffer )( GL_FRAMEBUFFER_EXT, 0 );
+
+        glMatrixMode( GL_PROJECTION );
+        glPopMatrix();
+        glMatrixMode( GL_MODELVIEW );
+        glPopMatrix();
+        glViewport( viewport_save[0], viewport_save[1], viewport_save[2], viewport_save[3] );
+    }
+
+    return !b_direct;
+}
+
+void glChartTileCache::DrawTile( glChartTile *tile, double scale, double cx, double cy,
+                                 const ViewPort &vp, bool blinear )
+{
+    double x0 = (double) tile->ix * TILE_SIZE * scale - cx + vp.pix_width / 2.;
+    double y0 = (double) tile->iy * TILE_SIZE * scale - cy + vp.pix_height / 2.;
+    double x1 = x0 + TILE_SIZE * scale;
+    double y1 = y0 + TILE_SIZE * scale;
+
+    //  Texture rows run bottom up
+    float t0 = (float) TILE_GUTTER / TILE_TEX_SIZE;
+    float t1 = (float) ( TILE_GUTTER + TILE_SIZE ) / TILE_TEX_SIZE;
+
+    glBindTexture( GL_TEXTURE_2D, tile->tex );
+    GLint filter = blinear ? GL_LINEAR : GL_NEAREST;
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter );
+
+    glBegin( GL_QUADS );
+    glTexCoord2f( t0, t1 );  glVertex2f( x0, y0 );
+    glTexCoord2f( t1, t1 );  glVertex2f( x1, y0 );
+    glTexCoord2f( t1, t0 );  glVertex2f( x1, y1 );
+    glTexCoord2f( t0, t0 );  glVertex2f( x0, y1 );
+    glEnd();
+}
+
+void glChartTileCache::Compose( ViewPort &vp, double sdx, double sdy )
+{
+    if( !m_bkey || vp.view_scale_ppm != m_key.view_scale_ppm )
+        return;
+
+    double q[8], cx, cy;
+    GetScreenQuad( vp, sdx, sdy, q, cx, cy );
+
+    int ix0, iy0, ix1, iy1;
+    GetTileRange( q, ix0, iy0, ix1, iy1 );
+
+    bool b_rotated = fabs( vp.rotation ) > .0001;
+
+    glPushMatrix();
+    glChartCanvas::RotateToViewPort( vp );
+
+    glEnable( GL_TEXTURE_2D );
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+
+    if( !m_bcomplete && m_bfallback ) {
+        double scale = vp.view_scale_ppm / m_fallback_key.view_scale_ppm;
+        for( size_t i = 0; i < m_tiles.size(); i++ ) {
+            glChartTile *tile = m_tiles[i];
+            if( !( tile->key == m_fallback_key ) )
+                continue;
+
+            double x0 = (double) tile->ix * TILE_SIZE * scale, x1 = x0 + TILE_SIZE * scale;
+            double y0 = (double) tile->iy * TILE_SIZE * scale, y1 = y0 + TILE_SIZE * scale;
+            if( x1 < (double) ix0 * TILE_SIZE || x0 > (double) ( ix1 + 1 ) * TILE_SIZE ||
+                y1 < (double) iy0 * TILE_SIZE || y0 > (double) ( iy1 + 1 ) * TILE_SIZE )
+                continue;
+
+            DrawTile( tile, scale, cx, cy, vp, true );
+        }
+    }
+
+    for( int iy = iy0; iy <= iy1; iy++ ) {
+        for( int ix = ix0; ix <= ix1; ix++ ) {
+            glChartTile *tile = FindTile( m_key, ix, iy );
+            if( tile )
+                DrawTile( tile, 1., cx, cy, vp, b_rotated );
+        }
+    }
+
+    glDisable( GL_TEXTURE_2D );
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    glPopMatrix();
+}
@@ -1250,6 +1250,28 @@ bool glTextureManager::PurgeChartTextures( ChartBase *pc, bool b_purge_factory )
         return false;
 }
 
+//  Is the chart shown by any of the chart canvases, quilted or not?
+static bool IsChartInAnyCanvas( const wxString &chart_full_path )
+{
+    for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
+        ChartCanvas *cc = g_canvasArray.Item(i);
+        if(!cc)
+            continue;
+
+        if( cc->GetVP().b_quilt ) {         // quilted
+            if( !cc->m_pQuilt || !cc->m_pQuilt->IsComposed() ||
+                cc->m_pQuilt->IsChartInQuilt( chart_full_path ) )
+                return true;
+        }
+        else {                              // not quilted
+            if( cc->m_singleChart && cc->m_singleChart->GetFullPath().IsSameAs(chart_full_path) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
 bool glTextureManager::TextureCrunch(double factor)
 {
 
@@ -1271,27 +1293,9 @@ bool glTextureManager::TextureCrunch(double factor)
         if(!bGLMemCrunch)
             break;
 
-               // For each canvas
-        for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
-            ChartCanvas *cc = g_canvasArray.Item(i);
-            if(cc){
-
-                if( cc->GetVP().b_quilt )          // quilted
-                {
-                        if( cc->m_pQuilt && cc->m_pQuilt->IsComposed() &&
-                            !cc->m_pQuilt->IsChartInQuilt( chart_full_path ) ) {
-                            ptf->DeleteSomeTextures( g_GLOptions.m_iTextureMemorySize * 1024 * 1024 * factor *hysteresis);
-                            }
-                }
-                else      // not quilted
-                {
-                    if( !cc->m_singleChart->GetFullPath().IsSameAs(chart_full_path))
-                    {
-                        ptf->DeleteSomeTextures( g_GLOptions.m_iTextureMemorySize * 1024 * 1024 * factor  *hysteresis);
-                    }
-                }
-            }
-        }
+        //  Textures are shared by all canvases, only those no canvas shows may go
+        if( !IsChartInAnyCanvas( chart_full_path ) )
+            ptf->DeleteSomeTextures( g_GLOptions.m_iTextureMemorySize * 1024 * 1024 * factor *hysteresis);
     }
 
     return true;
@@ -1332,31 +1336,11 @@ bool glTextureManager::FactoryCrunch(double factor)
         // we better have to find one because glTexFactory keep cache texture open
         // and ocpn will eventually run out of file descriptors
 
-        // For each canvas
-        for(unsigned int i=0 ; i < g_canvasArray.GetCount() ; i++){
-            ChartCanvas *cc = g_canvasArray.Item(i);
-            if(cc){
-
-                if( cc->GetVP().b_quilt )          // quilted
-                {
-                    if( cc->m_pQuilt && cc->m_pQuilt->IsComposed() &&
-                        !cc->m_pQuilt->IsChartInQuilt( chart_full_path ) ) {
-
-                        int lru = ptf->GetLRUTime();
-                        if(lru < lru_oldest && !ptf->BackgroundCompressionAsJob()){
-                            lru_oldest = lru;
-                            ptf_oldest = ptf;
-                        }
-                    }
-                } else {
-                    if( !cc->m_singleChart->GetFullPath().IsSameAs(chart_full_path)) {
-                        int lru = ptf->GetLRUTime();
-                        if(lru < lru_oldest && !ptf->BackgroundCompressionAsJob()){
-                            lru_oldest = lru;
-                            ptf_oldest = ptf;
-                        }
-                    }
-                }
+        if( !IsChartInAnyCanvas( chart_full_path ) ) {
+            int lru = ptf->GetLRUTime();
+            if(lru < lru_oldest && !ptf->BackgroundCompressionAsJob()){
+                lru_oldest = lru;
+                ptf_oldest = ptf;
             }
         }
     }
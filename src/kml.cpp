@@ -91,21 +91,16 @@ KmlPastebufferType Kml::ParseTrack( TiXmlNode* node, wxString& name ) {
     if( 0 == strncmp( node->ToElement()->Value(), "LineString", 10 ) ) {
         dPointList coordinates;
         if( ParseCoordinates( node, coordinates ) > 2 ) {
-            TrackPoint* trackpoint = NULL;
-            TrackPoint* prevPoint = NULL;
-
-            for( unsigned int i=0; i<coordinates.size(); i++ ) {
-                trackpoint = new TrackPoint(coordinates[i].y, coordinates[i].x);
-                parsedTrack->AddPoint( trackpoint );
-            }
+            parsedTrack->Reserve( coordinates.size() );
+            for( unsigned int i=0; i<coordinates.size(); i++ )
+                parsedTrack->AddPoint( TrackPoint(coordinates[i].y, coordinates[i].x) );
         }
         return KML_PASTE_TRACK;
     }
 
     if( 0 == strncmp( node->ToElement()->Value(), "gx:Track", 8 ) ) {
-        TrackPoint* trackpoint = NULL;
+        std::vector<TrackPoint> trackpoints;
         TiXmlElement* point = node->FirstChildElement( "gx:coord" );
-        int pointCounter = 0;
 
         for( ; point; point=point->NextSiblingElement( "gx:coord" ) ) {
             double lat, lon;
@@ -116,23 +111,24 @@ KmlPastebufferType Kml::ParseTrack( TiXmlNode* node, wxString& name ) {
             std::getline( ss, txtCoord, ' ' );
             lat = atof( txtCoord.c_str() );
 
-            parsedTrack->AddPoint( new TrackPoint(lat, lon) );
-            pointCounter++;
+            trackpoints.push_back( TrackPoint(lat, lon) );
         }
 
         TiXmlElement* when = node->FirstChildElement( "when" );
 
         wxDateTime whenTime;
 
-        int i = 0;
-        for( ; when; when=when->NextSiblingElement( "when" ) ) {
-            trackpoint = parsedTrack->GetPoint(i);
-            if( ! trackpoint ) continue;
+        size_t i = 0;
+        for( ; when && i < trackpoints.size(); when=when->NextSiblingElement( "when" ) ) {
             whenTime.ParseFormat( wxString( when->GetText(), wxConvUTF8 ), _T("%Y-%m-%dT%H:%M:%SZ") );
-            trackpoint->SetCreateTime(whenTime);
+            trackpoints[i].SetCreateTime(whenTime);
             i++;
         }
 
+        parsedTrack->Reserve( trackpoints.size() );
+        for( i = 0; i < trackpoints.size(); i++ )
+            parsedTrack->AddPoint( trackpoints[i] );
+
         return KML_PASTE_TRACK;
     }
     return KML_PASTE_INVALID;
@@ -504,22 +500,20 @@ wxString Kml::MakeKmlFromTrack( Track* track ) {
     std::stringstream lineStringCoords;
 
     for(int i=0; i<track->GetnPoints(); i++) {
-        TrackPoint *trackpoint = track->GetPoint(i);
+        TrackPoint trackpoint = track->GetPoint(i);
 
         TiXmlElement* when = new TiXmlElement( "when" );
         gxTrack->LinkEndChild( when );
 
-        wxDateTime whenTime( trackpoint->GetCreateTime() );
+        wxDateTime whenTime( trackpoint.GetCreateTime() );
         TiXmlText* whenVal = new TiXmlText( whenTime.Format( _T("%Y-%m-%dT%H:%M:%SZ") ).mb_str( wxConvUTF8 ) );
         when->LinkEndChild( whenVal );
     }
 
     for(int i=0; i<track->GetnPoints(); i++) {
-        TrackPoint *trackpoint = track->GetPoint(i);
-
         TiXmlElement* coord = new TiXmlElement( "gx:coord" );
         gxTrack->LinkEndChild( coord );
-        wxString coordStr = wxString::Format( _T("%f %f 0.0"), trackpoint->m_lon, trackpoint->m_lat );
+        wxString coordStr = wxString::Format( _T("%f %f 0.0"), track->GetPointLon(i), track->GetPointLat(i) );
         TiXmlText* coordVal = new TiXmlText( coordStr.mb_str( wxConvUTF8 ) );
         coord->LinkEndChild( coordVal );
     }
@@ -55,6 +55,10 @@
 #include <string.h>
 #include <math.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "tesselator.h"
 #include "Striper.h"
 
@@ -64,6 +68,8 @@
 
 static const double   CM93_semimajor_axis_meters = 6378388.0;            // CM93 semimajor axis
 
+extern int            g_nTessBackend;
+
 
 
 //      Module Internal Prototypes
@@ -292,7 +298,7 @@ PolyTessGeo::PolyTessGeo(OGRPolygon *poly, bool bSENC_SM, double ref_lat, double
 
     m_bcm93 = false;
     
-    BuildTessGLU();
+    Tesselate();
     
     // Free the working memory
     for(int i = 0; i < m_ncnt ; i++)
@@ -369,8 +375,9 @@ int PolyTessGeo::BuildDeferredTess(void)
       
       m_bcm93 = true;
 
-      // For cm93, we prefer TessGLU, since it produces more TriangleStrips, so renders faster with less storage.
-      int rv = BuildTessGLU();
+      // For cm93, TessGLU produces more TriangleStrips, so renders faster with less storage.
+      // libtess2 is faster to build, and may be selected by g_nTessBackend.
+      int rv = Tesselate();
       
       // All done with this geometry
       delete m_pxgeom;
@@ -815,607 +822,417 @@ int PolyTessGeo::BuildTessGLU()
 
 
 
-int PolyTessGeo::BuildTess(void)
+//      Transcribe one contour into a float x,y array, dropping coincident points
+//      and forcing the requested winding direction.
+//      Returns the number of points kept.
+static int TranscribeContour( wxPoint2DDouble *pp, int npt, bool b_want_cw, float *out )
 {
-    //  Setup the tesselator
-    
-    TESSalloc ma;
-    TESStesselator* tess = 0;
-    const int nvp = 3;
-//    unsigned char* vflags = 0;
-#ifdef USE_POOL
-    struct MemPool pool;
-    unsigned char mem[4024*1024];
-//    int nvflags = 0;
-#else
-    int allocated = 0;
-    double t0 = 0, t1 = 0;
-#endif
+    if( npt < 1 )
+        return 0;
 
-#ifdef USE_POOL
+    bool b_reverse = ( isRingClockwise(pp, npt) != b_want_cw );
 
-    pool.size = 0;
-    pool.cap = sizeof(mem);
-    pool.buf = mem;
-    memset(&ma, 0, sizeof(ma));
-    ma.memalloc = poolAlloc;
-    ma.memfree = poolFree;
-    ma.userData = (void*)&pool;
-    ma.extraVertices = 256; // realloc not provided, allow 256 extra vertices.
+    //  Start from the last point in traversal order, so that a closing point
+    //  which duplicates the first is dropped.
+    double x0, y0;
+    if(b_reverse){
+        x0 = pp[0].m_x;
+        y0 = pp[0].m_y;
+    }
+    else{
+        x0 = pp[npt-1].m_x;
+        y0 = pp[npt-1].m_y;
+    }
 
-#else
- 
-    memset(&ma, 0, sizeof(ma));
-    ma.memalloc = stdAlloc;
-    ma.memfree = stdFree;
-    ma.userData = (void*)&allocated;
-    ma.extraVertices = 256; // realloc not provided, allow 256 extra vertices.
-#endif
+    int nkept = 0;
+    for(int ip = 0 ; ip < npt ; ip++){
+        int pidx = b_reverse ? npt - ip - 1 : ip;
+        double x = pp[pidx].m_x;
+        double y = pp[pidx].m_y;
 
-    tess = tessNewTess(&ma);
-    if (!tess)
-        return -1;
+        if((fabs(x-x0) > EQUAL_EPS) || (fabs(y-y0) > EQUAL_EPS)){
+            *out++ = x;
+            *out++ = y;
+            nkept++;
+        }
 
-    //tessSetOption(tess, TESS_CONSTRAINED_DELAUNAY_TRIANGULATION, 1);
+        x0 = x;
+        y0 = y;
+    }
 
-    
-    //  Create the contour vertex arrays
-    
-      int iir, ip;
+    return nkept;
+}
 
-//      Get max number number of points(vertices) in any contour
-      int npta  = m_cntr[0];
-      npta += 2;                            // fluff
+//      Returns true if the ring is strictly convex and winds exactly once,
+//      so that a single triangle fan covers it.
+static bool IsRingConvex( const float *ring, int npt )
+{
+    if( npt < 3 )
+        return false;
+
+    int sign = 0;
+    int xflips = 0, yflips = 0;
+    double last_dx = 0, last_dy = 0;
+
+    for(int i = 0 ; i < npt ; i++){
+        const float *a = &ring[i * 2];
+        const float *b = &ring[((i + 1) % npt) * 2];
+        const float *c = &ring[((i + 2) % npt) * 2];
+
+        double dx = b[0] - a[0];
+        double dy = b[1] - a[1];
+        double cross = dx * (c[1] - b[1]) - dy * (c[0] - b[0]);
+
+        if( cross > 0 ){
+            if( sign < 0 )
+                return false;
+            sign = 1;
+        }
+        else if( cross < 0 ){
+            if( sign > 0 )
+                return false;
+            sign = -1;
+        }
 
-      for( iir=0 ; iir < m_ncnt-1 ; iir++){
-            int nptr = m_cntr[iir+1];
-            npta = wxMax(npta, nptr); 
-      }
+        //  A star-shaped ring turns consistently but winds more than once;
+        //  catch it by counting the direction reversals along each axis.
+        if( dx != 0 ){
+            if( last_dx != 0 && (dx > 0) != (last_dx > 0) )
+                xflips++;
+            last_dx = dx;
+        }
+        if( dy != 0 ){
+            if( last_dy != 0 && (dy > 0) != (last_dy > 0) )
+                yflips++;
+            last_dy = dy;
+        }
+    }
 
+    return (sign != 0) && (xflips <= 2) && (yflips <= 2);
+}
 
-      TESSreal *geoPt = (TESSreal *)malloc((npta) * 2 * sizeof(TESSreal));     // tess input vertex array
-      TESSreal *ppt = geoPt;
 
+//      Select and run the tesselator for the current contour set
+int PolyTessGeo::Tesselate( void )
+{
+    //  Simple convex rings need no tesselator at all.
+    //  LOD reduction applies only to larger rings, so leave those to the tesselators.
+    if( (m_ncnt == 1) && ((m_cntr[0] <= 20) || (m_LOD_meters <= .01)) ){
+        float *ring = (float *)malloc((m_cntr[0] + 1) * 2 * sizeof(float));
+        int npt = TranscribeContour( (wxPoint2DDouble *)m_vertexPtrArray[0], m_cntr[0], false, ring );
 
-//      Create input structures
+        bool b_convex = IsRingConvex( ring, npt );
+        if( b_convex )
+            BuildTessFan( ring, npt );
 
-//    Exterior Ring
-      int npte = m_cntr[0];
-      unsigned int ptValid = npte;
+        free( ring );
 
-//  Check and account for winding direction of ring
+        if( b_convex )
+            return 0;
+    }
 
+    if( TESS_BACKEND_LIBTESS2 == g_nTessBackend ){
+        if( 0 == BuildTess() )
+            return 0;
+    }
 
-      double x0, y0, x, y;
-      OGRPoint p;
+    return BuildTessGLU();
+}
 
-      wxPoint2DDouble *pp = (wxPoint2DDouble *)m_vertexPtrArray[0];
-      bool cw = isRingClockwise(pp, m_cntr[0]);
-      
-      //pp++;       // skip 0?
 
-      if(cw)
-      {
-            x0 = pp->m_x;
-            y0 = pp->m_y;
-      }
-      else
-      {
-            x0 = pp[npte-1].m_x;
-            y0 = pp[npte-1].m_y;
-      }
+//      Compute the lat/lon bounding box of a TriPrim from its (float) vertex list
+void PolyTessGeo::SetTriPrimBox( TriPrim *pTPG )
+{
+    double sxmax = -1e8;
+    double sxmin =  1e8;
+    double symax = -1e8;
+    double symin =  1e8;
+
+    float *pv = (float *)pTPG->p_vertex;
+    for(int iv=0 ; iv < pTPG->nVert ; iv++){
+        double xd = *pv++;
+        double yd = *pv++;
+
+        if(m_bcm93){
+            double valx = ( xd * mx_rate ) + mx_offset;
+            double valy = ( yd * my_rate ) + my_offset;
+
+            //    Convert to lat/lon
+            double lat = ( 2.0 * atan ( exp ( valy/CM93_semimajor_axis_meters ) ) - PI/2. ) / DEGREE;
+            double lon = ( valx / ( DEGREE * CM93_semimajor_axis_meters ) );
+
+            sxmax = wxMax(lon, sxmax);
+            sxmin = wxMin(lon, sxmin);
+            symax = wxMax(lat, symax);
+            symin = wxMin(lat, symin);
+        }
+        else{
+            sxmax = wxMax(xd, sxmax);
+            sxmin = wxMin(xd, sxmin);
+            symax = wxMax(yd, symax);
+            symin = wxMin(yd, symin);
+        }
+    }
 
+    if(m_bcm93)
+        pTPG->tri_box.Set(symin, sxmin, symax, sxmax);
+    else{
+        double minlat, minlon, maxlat, maxlon;
+        fromSM(sxmin, symin, m_ref_lat, m_ref_lon, &minlat, &minlon);
+        fromSM(sxmax, symax, m_ref_lat, m_ref_lon, &maxlat, &maxlon);
+        pTPG->tri_box.Set(minlat, minlon, maxlat, maxlon);
+    }
+}
 
 
-//  Transcribe points to vertex array, in proper order with no duplicates
-//   also, accounting for tess_orient
-      for(ip = 0 ; ip < npte ; ip++)
-      {
-            int pidx;
-            if(cw)
-                  pidx = npte - ip - 1;
+//      Build the PolyTriGroup from a TriPrim chain whose vertices live in a single float buffer
+void PolyTessGeo::FinishTriGroup( TriPrim *pTPG_Head, float *vbuf, int vbuf_size )
+{
+    m_ppg_head = new PolyTriGroup;
+    m_ppg_head->m_bSMSENC = m_b_senc_sm;
 
-            else
-                  pidx = ip;
+    m_ppg_head->nContours = m_ncnt;
+    m_ppg_head->pn_vertex = m_cntr;             // pointer to array of poly vertex counts
+    m_ppg_head->tri_prim_head = pTPG_Head;      // head of linked list of TriPrims
 
-            x = pp[pidx].m_x;
-            y = pp[pidx].m_y;
+    //  No longer need the full geometry in the SENC,
+    m_nwkb = 2 * 2 * sizeof(float);
+    m_ppg_head->pgroup_geom = (float *)calloc(sizeof(float), 2 * 2);
 
-            if((fabs(x-x0) > EQUAL_EPS) || (fabs(y-y0) > EQUAL_EPS))
-            {
-                  if(m_tess_orient == TESS_VERT)
-                  {
-                        *ppt++ = x;
-                        *ppt++ = y;
-                  }
-                  else
-                  {
-                        *ppt++ = y;
-                        *ppt++ = x;
-                  }
-            }
-            else
-                  ptValid--;
+    m_ppg_head->bsingle_alloc = true;
+    m_ppg_head->single_buffer = (unsigned char *)vbuf;
+    m_ppg_head->single_buffer_size = vbuf_size;
+    m_ppg_head->data_type = DATA_TYPE_FLOAT;
 
-            x0 = x;
-            y0 = y;
-      }
+    m_bOK = true;
+}
 
-      
-      //  Apply LOD reduction
-    int beforeLOD = ptValid;
-    int afterLOD = beforeLOD;
-   
-    std::vector<bool> bool_keep;
-    if(ptValid > 5 && (m_LOD_meters > .01)){
-        
-        for(unsigned int i = 0 ; i < ptValid ; i++)
-            bool_keep.push_back(false);
 
-        // Keep a few key points
-        bool_keep[0] = true;
-        bool_keep[1] = true;
-        bool_keep[ptValid-1] = true;
-        bool_keep[ptValid-2] = true;
-        
-        DouglasPeuckerFI(geoPt, 1, ptValid-2, m_LOD_meters, bool_keep);
-            
-        // Create a new buffer
-        float *LOD_result = (float *)malloc((npte) * 2 * sizeof(float));     
-        float *plod = LOD_result;
-        int kept_LOD =0;
-        
-        for(unsigned int i=0 ; i < ptValid ; i++){
-            if(bool_keep[i]){
-                float x = geoPt[i*2];
-                float y = geoPt[(i*2) + 1];
-                *plod++ = x;
-                *plod++ = y;
-                kept_LOD++;
-            }
-        }
+//      Convex ring with no holes, emitted as a single triangle fan
+int PolyTessGeo::BuildTessFan( float *ring, int npt )
+{
+    int vbuf_size = npt * 2 * sizeof(float);
+    float *vbuf = (float *)malloc(vbuf_size);
 
-        beforeLOD = ptValid;
-        afterLOD = kept_LOD;
-    
-        tessAddContour(tess, 2, LOD_result, sizeof(float)*2, kept_LOD);
-        
-        free(LOD_result);
+    float *pv = vbuf;
+    for(int i=0 ; i < npt ; i++){
+        *pv++ = ring[i*2]     + m_feature_easting;     // adjust to chart ref coordinates
+        *pv++ = ring[i*2 + 1] + m_feature_northing;
     }
-    else {
-        tessAddContour(tess, 2, geoPt, sizeof(float)*2, ptValid);
-    }
-    
-    
 
-#if 1
-//  Now the interior contours
-      for(iir=0; iir < m_ncnt-1; iir++)
-      {
-            ppt = geoPt;
-            wxPoint2DDouble *pp = (wxPoint2DDouble *)m_vertexPtrArray[iir + 1];
+    TriPrim *pTPG = new TriPrim;
+    pTPG->p_next = NULL;
+    pTPG->type = PTG_TRIANGLE_FAN;
+    pTPG->nVert = npt;
+    pTPG->p_vertex = (double *)vbuf;
+    SetTriPrimBox( pTPG );
 
-            int npti  = m_cntr[iir+1];
-            ptValid = npti;
-            
-      //  Check and account for winding direction of ring
-            bool cw = isRingClockwise(pp, m_cntr[iir+1]);
+    m_nvertex_max = npt;
 
-            if(!cw)
-            {
-                  x0 = pp[0].m_x;
-                  y0 = pp[0].m_y;
-            }
-            else
-            {
-                  x0 = pp[npti-1].m_x;
-                  y0 = pp[npti-1].m_y;
-            }
+    FinishTriGroup( pTPG, vbuf, vbuf_size );
 
-//  Transcribe points to vertex array, in proper order with no duplicates
-//   also, accounting for tess_orient
-            for(int ip = 0 ; ip < npti ; ip++)
-            {
-                  OGRPoint p;
-                  int pidx;
-                  if(!cw)                               // interior contours must be cw
-                        pidx = npti - ip - 1;
-                  else
-                        pidx = ip;
+    return 0;
+}
 
 
-                  x = pp[pidx].m_x;
-                  y = pp[pidx].m_y;
+//      Build PolyTessGeo Object using the libtess2 tesselator
+//      Output matches BuildTessGLU(): a TriPrim chain in a single float buffer,
+//      in chart reference coordinates
+int PolyTessGeo::BuildTess(void)
+{
+    //  Setup the tesselator
+    TESSalloc ma;
+    int allocated = 0;
+    memset(&ma, 0, sizeof(ma));
+    ma.memalloc = stdAlloc;
+    ma.memfree = stdFree;
+    ma.userData = (void*)&allocated;
+    ma.extraVertices = 256; // realloc not provided, allow 256 extra vertices.
 
-                  if((fabs(x-x0) > EQUAL_EPS) || (fabs(y-y0) > EQUAL_EPS))
-                  {
-                        if(m_tess_orient == TESS_VERT)
-                        {
-                              *ppt++ = x;
-                              *ppt++ = y;
-                        }
-                        else
-                        {
-                              *ppt++ = y;
-                              *ppt++ = x;
-                        }
-                  }
-                  else
-                        ptValid--;
+    TESStesselator* tess = tessNewTess(&ma);
+    if (!tess)
+        return -1;
 
-                  x0 = x;
-                  y0 = y;
+    //  Get max number of points(vertices) in any contour
+    int npta = 0;
+    for(int i=0 ; i < m_ncnt ; i++)
+        npta = wxMax(npta, m_cntr[i]);
 
-            }
-            
-            tessAddContour(tess, 2, geoPt, sizeof(float)*2, ptValid);
+    float *geoPt = (float *)malloc((npta + 2) * 2 * sizeof(float));     // tess input vertex array
 
-      }
-#endif
+    //  Exterior ring, counter-clockwise
+    int ptValid = TranscribeContour( (wxPoint2DDouble *)m_vertexPtrArray[0], m_cntr[0], false, geoPt );
 
+    //  Apply LOD reduction
+    if(ptValid > 20 && (m_LOD_meters > .01)){
+        std::vector<bool> bool_keep(ptValid, false);
 
-      //      Ready to kick off the tesselator
+        // Keep a few key points
+        bool_keep[0] = true;
+        bool_keep[1] = true;
+        bool_keep[ptValid-1] = true;
+        bool_keep[ptValid-2] = true;
 
-      TriPrim *pTPG_Last = NULL;
-      TriPrim *pTPG_Head = NULL;
+        DouglasPeuckerFI(geoPt, 1, ptValid-2, m_LOD_meters, bool_keep);
 
-      //s_nvmax = 0;
+        //  Compact the kept points in place
+        int kept_LOD = 0;
+        for(int i=0 ; i < ptValid ; i++){
+            if(bool_keep[i]){
+                geoPt[kept_LOD * 2]     = geoPt[i * 2];
+                geoPt[kept_LOD * 2 + 1] = geoPt[i * 2 + 1];
+                kept_LOD++;
+            }
+        }
+        ptValid = kept_LOD;
+    }
 
-      //OCPNStopWatchTess tt0;
-      
-      if (!tessTesselate(tess, TESS_WINDING_POSITIVE, TESS_POLYGONS, nvp, 2, 0))
-        return -1;
-      double tessTime = 0; //tt0.GetTime();
+    tessAddContour(tess, 2, geoPt, sizeof(float)*2, ptValid);
+
+    //  Now the interior contours, clockwise
+    for(int iir=0; iir < m_ncnt-1; iir++){
+        int npti = TranscribeContour( (wxPoint2DDouble *)m_vertexPtrArray[iir + 1], m_cntr[iir+1], true, geoPt );
+        tessAddContour(tess, 2, geoPt, sizeof(float)*2, npti);
+    }
 
+    free( geoPt );
 
-    //  Tesselation all done, so...
-    //  Create the data structures
-    
-    //  Make a linked list of TriPrims from tess output arrays
+    //      Ready to kick off the tesselator
+    const int nvp = 3;
+    if (!tessTesselate(tess, TESS_WINDING_POSITIVE, TESS_POLYGONS, nvp, 2, 0)){
+        tessDeleteTess(tess);
+        return -1;
+    }
 
     const TESSreal* verts = tessGetVertices(tess);
-    const int* vinds = tessGetVertexIndices(tess);
     const int* elems = tessGetElements(tess);
-    const int nverts = tessGetVertexCount(tess);
     int nelems = tessGetElementCount(tess);
 
-      
-    bool skip = false;
-    //skip = true;
-    
-    double stripTime = 0;
-    //tt0.Reset();
-
+    TriPrim *pTPG_Head = NULL;
+    TriPrim *pTPG_Last = NULL;
+    float *vbo = NULL;
     int bytes_needed_vbo = 0;
-    float *vbo = 0;
-    
-    if(m_bstripify && nelems && !skip){
-        
-         
+    m_nvertex_max = 0;
+
+    if(m_bstripify && nelems){
         STRIPERCREATE sc;
-        sc.DFaces                       = (udword *)elems;
-        sc.NbFaces                      = nelems;
+        sc.DFaces               = (udword *)elems;
+        sc.NbFaces              = nelems;
         sc.AskForWords          = false;
         sc.ConnectAllStrips     = false;
         sc.OneSided             = false;
         sc.SGIAlgorithm         = false;
 
-       
         Striper Strip;
         Strip.Init(sc);
-        
+
         STRIPERRESULT sr;
         Strip.Compute(sr);
 
-        stripTime = 0; //tt0.GetTime();
-
-/*        
-        fprintf(stdout, "Number of strips: %d\n", sr.NbStrips);
-        fprintf(stdout, "Number of points: %d\n", nelems);
-        uword* Refs = (uword*)sr.StripRuns;
-        for(udword i=0;i<sr.NbStrips;i++)
-        {
-                fprintf(stdout, "Strip %d:   ", i);
-                udword NbRefs = sr.StripLengths[i];
-                for(udword j=0;j<NbRefs;j++)
-                {
-                        fprintf(stdout, "%d ", *Refs++);
-                }
-                fprintf(stdout, "\n");
+        //  Calculate and allocate the final (float) VBO-like buffer for this entire feature
+        for(unsigned int i=0 ; i < sr.NbStrips ; i++){
+            if(sr.StripLengths[i] >= 3)
+                bytes_needed_vbo += sr.StripLengths[i] * 2 * sizeof(float);
         }
-*/
-        // calculate and allocate the final (float) VBO-like buffer for this entire feature
-        
-        int *Refs = (int *)sr.StripRuns;
-        for(unsigned int i=0;i<sr.NbStrips;i++){
-            unsigned int NbRefs = sr.StripLengths[i];         //  vertices per strip
-            bytes_needed_vbo += NbRefs * 2 * sizeof(float);
-        }
-        
+
         vbo = (float *)malloc(bytes_needed_vbo);
         float *vbo_run = vbo;
-        
-        for(unsigned int i=0;i<sr.NbStrips;i++){
-            unsigned int NbRefs = sr.StripLengths[i];         //  vertices per strip
- 
-            if(NbRefs >= 3){                              // this is a valid primitive
-
-                TriPrim *pTPG = new TriPrim;
-                if(NULL == pTPG_Last){
-                    pTPG_Head = pTPG;
-                    pTPG_Last = pTPG;
-                }
-                else{
-                    pTPG_Last->p_next = pTPG;
-                    pTPG_Last = pTPG;
-                }
-
-                pTPG->p_next = NULL;
-                pTPG->nVert = NbRefs;
-            
-//                pTPG->p_vertex = (double *)malloc(NbRefs * 2 * sizeof(double));
-//                GLdouble *pdd = (GLdouble*)pTPG->p_vertex;
-
-                pTPG->p_vertex = (double *)vbo_run;
-
-            //  Preset LLBox bounding box limits
-                double sxmax = -1e8;
-                double sxmin = 1e8;
-                double symax = -1e8;
-                double symin = 1e8;
 
-                if(NbRefs >3)
-                    pTPG->type = GL_TRIANGLE_STRIP;
-                else
-                    pTPG->type = GL_TRIANGLES;
-
-                // Add the first two points
-                int vindex[3];
-                vindex[0] = *Refs++;
-                vindex[1] = *Refs++;
-                unsigned int np = 2;         // for the first triangle
-                    
-                for(unsigned int i = 2; i < NbRefs ; i++){    
-                    vindex[np] = *Refs++;
-                    np++;
-                    
-                    for (unsigned int j = 0; j < np; ++j){
-                        double yd = verts[vindex[j]*2];
-                        double xd = verts[vindex[j]*2+1];
-                    
-                    // Calculate LLBox bounding box for each Tri-prim
-                        if(m_bmerc_transform){
-                            double valx = ( xd * mx_rate ) + mx_offset;
-                            double valy = ( yd * my_rate ) + my_offset;
-            
-                                //    quickly convert to lat/lon
-                            double lat = ( 2.0 * atan ( exp ( valy/CM93_semimajor_axis_meters ) ) - PI/2. ) / DEGREE;
-                            double lon= ( valx / ( DEGREE * CM93_semimajor_axis_meters ) );
-
-
-                            sxmax = wxMax(lon, sxmax);
-                            sxmin = wxMin(lon, sxmin);
-                            symax = wxMax(lat, symax);
-                            symin = wxMin(lat, symin);
-                        }
-                        else{
-                            sxmax = wxMax(xd, sxmax);
-                            sxmin = wxMin(xd, sxmin);
-                            symax = wxMax(yd, symax);
-                            symin = wxMin(yd, symin);
-                        }
-                        
-                    //  Append this point to TriPrim vbo
-
-                        *vbo_run++ = (xd) + m_feature_easting;    // adjust to chart ref coordinates
-                        *vbo_run++ = (yd) + m_feature_northing;
-                    }               // For
-
-                    // Compute the final LLbbox for this TriPrim chain
-                    double minlat, minlon, maxlat, maxlon;
-                    fromSM(sxmin, symin, m_feature_ref_lat, m_feature_ref_lon, &minlat, &minlon);
-                    fromSM(sxmax, symax, m_feature_ref_lat, m_feature_ref_lon, &maxlat, &maxlon);
-
-                    pTPG->tri_box.Set(minlat, minlon, maxlat, maxlon);
-
-                    // set for next single point
-                    np = 0;
+        int *Refs = (int *)sr.StripRuns;
+        for(unsigned int i=0 ; i < sr.NbStrips ; i++){
+            int NbRefs = sr.StripLengths[i];         //  vertices per strip
 
-                }
+            if(NbRefs < 3){
+                Refs += NbRefs;
+                continue;
             }
-            else
-                Refs += sr.StripLengths[i];
-           
-        }                       // for strips
-    }
-    else{       // not stripified
-        
-        m_nvertex_max = nverts;               // record largest vertex count
-        
-        bytes_needed_vbo = nelems * nvp * 2 * sizeof(float);
-        vbo = (float *)malloc(bytes_needed_vbo);
-        float *vbo_run = vbo;
-
-        for (int i = 0; i < nelems; ++i){
-            const int* p = &elems[i*nvp];
 
             TriPrim *pTPG = new TriPrim;
-            if(NULL == pTPG_Last){
-                    pTPG_Head = pTPG;
-                    pTPG_Last = pTPG;
-            }
-            else{
-                    pTPG_Last->p_next = pTPG;
-                    pTPG_Last = pTPG;
-            }
+            if(NULL == pTPG_Last)
+                pTPG_Head = pTPG;
+            else
+                pTPG_Last->p_next = pTPG;
+            pTPG_Last = pTPG;
 
             pTPG->p_next = NULL;
-            pTPG->type = GL_TRIANGLES;
-            pTPG->nVert = nvp;
-            
-//            pTPG->p_vertex = (double *)malloc(nvp * 2 * sizeof(double));
-//            GLdouble *pdd = (GLdouble*)pTPG->p_vertex;
-
+            pTPG->type = (NbRefs > 3) ? PTG_TRIANGLE_STRIP : PTG_TRIANGLES;
+            pTPG->nVert = NbRefs;
             pTPG->p_vertex = (double *)vbo_run;
 
-            //  Preset LLBox bounding box limits
-            double sxmax = -1e8;
-            double sxmin = 1e8;
-            double symax = -1e8;
-            double symin = 1e8;
-
-            for (size_t j = 0; j < nvp && p[j] != TESS_UNDEF; ++j){
-                double yd = verts[p[j]*2];
-                double xd = verts[p[j]*2+1];
-                
-                // Calculate LLBox bounding box for each Tri-prim
-                if(m_bmerc_transform){
-                    double valx = ( xd * mx_rate ) + mx_offset;
-                    double valy = ( yd * my_rate ) + my_offset;
-    
-                        //    quickly convert to lat/lon
-                    double lat = ( 2.0 * atan ( exp ( valy/CM93_semimajor_axis_meters ) ) - PI/2. ) / DEGREE;
-                    double lon= ( valx / ( DEGREE * CM93_semimajor_axis_meters ) );
-
-
-                    sxmax = wxMax(lon, sxmax);
-                    sxmin = wxMin(lon, sxmin);
-                    symax = wxMax(lat, symax);
-                    symin = wxMin(lat, symin);
-                }
-                else{
-                    sxmax = wxMax(xd, sxmax);
-                    sxmin = wxMin(xd, sxmin);
-                    symax = wxMax(yd, symax);
-                    symin = wxMin(yd, symin);
-                }
-                
-                //  Append this point to TriPrim, converting to SM if called for
-
-                if(m_b_senc_sm){
-                    double easting, northing;
-                    toSM(yd, xd, m_ref_lat, m_ref_lon, &easting, &northing);
-                    *vbo_run++ = easting;
-                    *vbo_run++ = northing;
-                }
-                else{
-                    *vbo_run++ = xd;
-                    *vbo_run++ = yd;
-                }
+            for(int j=0 ; j < NbRefs ; j++){
+                int iv = *Refs++;
+                *vbo_run++ = verts[iv*2]     + m_feature_easting;    // adjust to chart ref coordinates
+                *vbo_run++ = verts[iv*2 + 1] + m_feature_northing;
             }
-        
-        pTPG->tri_box.Set(symin, sxmin, symax, sxmax);
-        }
-    }           // stripify
-
-    if(m_printStats){
-        int nTri = 0;
-        int nStrip = 0;
-        
-        TriPrim *p_tp = pTPG_Head;
-        while( p_tp ) {
-            if(p_tp->type == GL_TRIANGLES)
-                nTri++;
-            if(p_tp->type == GL_TRIANGLE_STRIP)
-                nStrip++;
-            
-          p_tp = p_tp->p_next; // pick up the next in chain
-        }
-        
-        if((nTri + nStrip) > 10000){
-            printf("LOD:  %d/%d\n", afterLOD, beforeLOD);
-
-            printf("Tess time(ms): %f\n", tessTime);
-            printf("Strip time(ms): %f\n", stripTime);
 
-            printf("Primitives:   Tri: %5d  Strip: %5d  Total: %5d\n", nTri, nStrip, nTri + nStrip);
-            printf("\n");
+            SetTriPrimBox( pTPG );
+            m_nvertex_max = wxMax(m_nvertex_max, NbRefs);
         }
     }
- 
-   
-    
-      m_ppg_head = new PolyTriGroup;
-      m_ppg_head->m_bSMSENC = m_b_senc_sm;
+    else if(nelems){
+        //  One triangle list for the whole feature
+        bytes_needed_vbo = nelems * nvp * 2 * sizeof(float);
+        vbo = (float *)malloc(bytes_needed_vbo);
+        float *vbo_run = vbo;
 
-      m_ppg_head->nContours = m_ncnt;
-      m_ppg_head->pn_vertex = m_cntr;             // pointer to array of poly vertex counts
-      m_ppg_head->tri_prim_head = pTPG_Head;         // head of linked list of TriPrims
-      //m_ppg_head->data_type = DATA_TYPE_DOUBLE;
-      
+        for (int i = 0; i < nelems * nvp; ++i){
+            int iv = elems[i];
+            *vbo_run++ = verts[iv*2]     + m_feature_easting;
+            *vbo_run++ = verts[iv*2 + 1] + m_feature_northing;
+        }
 
-//  Transcribe the raw geometry buffer
-//  Converting to float as we go, and
-//  allowing for tess_orient
-//  Also, convert to SM if requested
+        pTPG_Head = new TriPrim;
+        pTPG_Head->p_next = NULL;
+        pTPG_Head->type = PTG_TRIANGLES;
+        pTPG_Head->nVert = nelems * nvp;
+        pTPG_Head->p_vertex = (double *)vbo;
+        SetTriPrimBox( pTPG_Head );
 
-      int nptfinal = npta;
-      
-      //  No longer need the full geometry in the SENC,
-      nptfinal = 1;
-      
-      m_nwkb = (nptfinal +1) * 2 * sizeof(float);
-      m_ppg_head->pgroup_geom = (float *)malloc(m_nwkb);
-      float *vro = m_ppg_head->pgroup_geom;
-      ppt = geoPt;
-      float tx,ty;
+        m_nvertex_max = pTPG_Head->nVert;
+    }
 
-      for(ip = 0 ; ip < nptfinal ; ip++)
-      {
-            if(TESS_HORZ == m_tess_orient)
-            {
-                  ty = *ppt++;
-                  tx = *ppt++;
-            }
-            else
-            {
-                  tx = *ppt++;
-                  ty = *ppt++;
-            }
+    tessDeleteTess(tess);
 
-            if(m_b_senc_sm)
-            {
-            //  Calculate SM from chart common reference point
-                  double easting, northing;
-                  toSM(ty, tx, 0/*ref_lat*/, 0/*ref_lon*/, &easting, &northing);
-                  *vro++ = easting;              // x
-                  *vro++ = northing;             // y
-            }
-            else
-            {
-                  *vro++ = tx;                  // lon
-                  *vro++ = ty;                  // lat
-            }
+    //    All allocated buffers are owned now by the m_ppg_head
+    //    And will be freed on dtor of this object
+    FinishTriGroup( pTPG_Head, vbo, bytes_needed_vbo );
 
-            ppt++;                      // skip z
-      }
+    return 0;
+}
 
 
-      m_ppg_head->bsingle_alloc = true;
-      m_ppg_head->single_buffer = (unsigned char *)vbo;
-      m_ppg_head->single_buffer_size = bytes_needed_vbo;
-      m_ppg_head->data_type = DATA_TYPE_FLOAT;
-      
+//      Run the deferred tesselation of a set of PolyTessGeo objects on a pool of threads.
+//      Each object owns its own tesselator and buffers, so no locking is needed.
+void PolyTessGeo::BuildDeferredTessBatch( std::vector<PolyTessGeo *> &list, int nThreads )
+{
+    nThreads = wxMin(nThreads, (int)list.size());
 
-      free (geoPt);
+    if( nThreads < 2 ){
+        for(size_t i=0 ; i < list.size() ; i++)
+            list[i]->BuildDeferredTess();
+        return;
+    }
 
-      //    All allocated buffers are owned now by the m_ppg_head
-      //    And will be freed on dtor of this object
- 
-      if (tess) tessDeleteTess(tess);
+    std::atomic<size_t> next(0);
+    auto worker = [&list, &next]() {
+        size_t i;
+        while( (i = next++) < list.size() )
+            list[i]->BuildDeferredTess();
+    };
 
-      m_bOK = true;
-      
+    std::vector<std::thread> pool;
+    for(int i=0 ; i < nThreads - 1 ; i++)
+        pool.push_back( std::thread( worker ) );
 
-      return 0;
-      
+    worker();
 
+    for(size_t i=0 ; i < pool.size() ; i++)
+        pool[i].join();
 }
 
 
 
 
-
 // GLU tesselation support functions
 void  beginCallback(GLenum which, void *polyData)
 {
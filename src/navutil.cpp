@@ -99,6 +99,7 @@ extern int              g_restore_stackindex;
 extern int              g_restore_dbindex;
 extern RouteList        *pRouteList;
 extern TrackList        *pTrackList;
+extern ActiveTrack      *g_pActiveTrack;
 extern LayerList        *pLayerList;
 extern int              g_LayerIdx;
 extern Select           *pSelect;
@@ -440,6 +441,8 @@ extern wxString         g_uiStyle;
 extern bool             g_useMUI;
 
 int                     g_nCPUCount;
+int                     g_nTessBackend;
+int                     g_nChartPreloadMinutes = 20;
 
 extern bool             g_bDarkDecorations;
 extern unsigned int     g_canvasConfig;
@@ -487,6 +490,9 @@ void appendOSDirSlash(wxString* pString);
 //          MyConfig Implementation
 //-----------------------------------------------------------------------------
 
+#define NAVOBJ_JOURNAL_COMPACT_SIZE     ( 4 * 1024 * 1024 )     // bytes
+#define NAVOBJ_JOURNAL_COMPACT_SECONDS  ( 30 * 60 )
+
 MyConfig::MyConfig( const wxString &LocalFileName ) :
     wxFileConfig( _T (""), _T (""), LocalFileName, _T (""),  wxCONFIG_USE_LOCAL_FILE )
 {
@@ -495,11 +501,17 @@ MyConfig::MyConfig( const wxString &LocalFileName ) :
     m_sNavObjSetFile = config_file.GetPath( wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR );
     m_sNavObjSetFile += _T ( "navobj.xml" );
     m_sNavObjSetChangesFile = m_sNavObjSetFile + _T ( ".changes" );
+    m_sNavObjSetJournalFile = m_sNavObjSetFile + _T ( ".journal" );
 
     m_pNavObjectInputSet = NULL;
     m_pNavObjectChangesSet = NULL;
 
     m_bSkipChangeSetUpdate = false;
+
+    m_NavObjSeq = 0;
+    m_NavObjCompactTime = wxGetLocalTime();
+    m_bNavObjThreadBusy = false;
+    m_bNavObjSaveOK = true;
 }
 
 void MyConfig::CreateRotatingNavObjBackup()
@@ -571,6 +583,7 @@ int MyConfig::LoadMyConfig()
 
     #ifdef ocpnUSE_GL
     g_GLOptions.m_bUseAcceleratedPanning = true;
+    g_GLOptions.m_bUseChartTileCache = true;
     g_GLOptions.m_GLPolygonSmoothing = true;
     g_GLOptions.m_GLLineSmoothing = true;
     g_GLOptions.m_iTextureDimension = 512;
@@ -785,6 +798,8 @@ int MyConfig::LoadMyConfigRaw( bool bAsTemplate )
     Read( _T ( "UseModernUI5" ), &g_useMUI );
 
     Read( _T( "NCPUCount" ), &g_nCPUCount);
+    Read( _T( "TessellationBackend" ), &g_nTessBackend );     // 0 = GLU, 1 = libtess2
+    Read( _T( "ChartPreloadMinutes" ), &g_nChartPreloadMinutes );     // 0 disables
 
     Read( _T ( "DebugGDAL" ), &g_bGDAL_Debug );
     Read( _T ( "DebugNMEA" ), &g_nNMEADebug );
@@ -875,6 +890,7 @@ int MyConfig::LoadMyConfigRaw( bool bAsTemplate )
     if(!bAsTemplate ){
         Read( _T ( "OpenGLExpert" ), &g_bGLexpert, false );
         Read( _T ( "UseAcceleratedPanning" ), &g_GLOptions.m_bUseAcceleratedPanning, true );
+        Read( _T ( "UseChartTileCache" ), &g_GLOptions.m_bUseChartTileCache, true );
         Read( _T ( "GPUTextureCompression" ), &g_GLOptions.m_bTextureCompression);
         Read( _T ( "GPUTextureCompressionCaching" ), &g_GLOptions.m_bTextureCompressionCaching);
         Read( _T ( "PolygonSmoothing" ), &g_GLOptions.m_GLPolygonSmoothing);
@@ -1597,13 +1613,26 @@ void MyConfig::LoadNavObjects()
         m_pNavObjectInputSet = new NavObjectCollection1();
 
     int wpt_dups = 0;
+    long parse_ms = 0, objects_ms = 0;
+    wxStopWatch sw;
+    m_NavObjSeq = 0;
     if( ::wxFileExists( m_sNavObjSetFile ) &&
-        m_pNavObjectInputSet->load_file( m_sNavObjSetFile.fn_str() ) )
+        m_pNavObjectInputSet->load_file( m_sNavObjSetFile.fn_str() ) ) {
+        parse_ms = sw.Time();
         m_pNavObjectInputSet->LoadAllGPXObjects(false, wpt_dups);
+        m_NavObjSeq = m_pNavObjectInputSet->GetJournalSeq();
+        objects_ms = sw.Time() - parse_ms;
+    }
 
     wxLogMessage( _T("Done loading navobjects, %d duplicate waypoints ignored"), wpt_dups );
+    sw.Start();
     delete m_pNavObjectInputSet;
+    m_pNavObjectInputSet = NULL;
+    long free_ms = sw.Time();
+
+    bool bUnsaved = false;
 
+    //  Changes left over by a version that logged them as XML
     if( ::wxFileExists( m_sNavObjSetChangesFile ) ) {
 
         wxULongLong size = wxFileName::GetSize(m_sNavObjSetChangesFile);
@@ -1623,14 +1652,43 @@ void MyConfig::LoadNavObjects()
         if(size != 0){
             wxLogMessage( _T("Applying NavObjChanges") );
             pNavObjectChangesSet->ApplyChanges();
-            UpdateNavObj();
+            bUnsaved = true;
         }
 
         delete pNavObjectChangesSet;
 
     }
 
-    m_pNavObjectChangesSet = new NavObjectChanges(m_sNavObjSetChangesFile);
+    //  Replay the journal records newer than navobj.xml, the older generation first.
+    //  Journal files exist here only if the last session did not end with a full save.
+    wxString retired = m_sNavObjSetJournalFile + _T(".1");
+    wxUint64 last_seq = m_NavObjSeq;
+    m_bSkipChangeSetUpdate = true;
+    if( ::wxFileExists( retired ) && NavObjectChanges::ReplayJournal( retired, m_NavObjSeq, last_seq ) )
+        bUnsaved = true;
+    if( ::wxFileExists( m_sNavObjSetJournalFile ) &&
+        NavObjectChanges::ReplayJournal( m_sNavObjSetJournalFile, m_NavObjSeq, last_seq ) )
+        bUnsaved = true;
+    m_bSkipChangeSetUpdate = false;
+    m_NavObjSeq = last_seq;
+
+    long journal_ms = sw.Time() - free_ms;
+
+    wxLogMessage( wxString::Format( _T("navobj.xml load times: parse %ld ms, objects %ld ms, free %ld ms, changes %ld ms"),
+                                    parse_ms, objects_ms, free_ms, journal_ms ) );
+
+    if( bUnsaved )
+        UpdateNavObj();
+    else {
+        //  Nothing newer than the snapshot, the journal files are redundant
+        wxLogNull logNo;
+        if( ::wxFileExists( retired ) )
+            ::wxRemoveFile( retired );
+        if( ::wxFileExists( m_sNavObjSetJournalFile ) )
+            ::wxRemoveFile( m_sNavObjSetJournalFile );
+    }
+
+    m_pNavObjectChangesSet = new NavObjectChanges( m_sNavObjSetJournalFile, m_NavObjSeq + 1 );
 }
 
 bool MyConfig::LoadLayers(wxString &path)
@@ -1835,10 +1893,10 @@ void MyConfig::DeleteWayPoint( RoutePoint *pWP )
         m_pNavObjectChangesSet->AddWP( pWP, "delete" );
 }
 
-void MyConfig::AddNewTrackPoint( TrackPoint *pWP, const wxString& parent_GUID )
+void MyConfig::AddNewTrackPoint( const TrackPoint &WP, const wxString& parent_GUID )
 {
     if( !m_bSkipChangeSetUpdate )
-        m_pNavObjectChangesSet->AddTrackPoint( pWP, "add", parent_GUID );
+        m_pNavObjectChangesSet->AddTrackPoint( WP, "add", parent_GUID );
 }
 
 bool MyConfig::UpdateChartDirs( ArrayOfCDI& dir_array )
@@ -2316,6 +2374,7 @@ void MyConfig::UpdateSettings()
 #ifdef ocpnUSE_GL
     /* opengl options */
     Write( _T ( "UseAcceleratedPanning" ), g_GLOptions.m_bUseAcceleratedPanning );
+    Write( _T ( "UseChartTileCache" ), g_GLOptions.m_bUseChartTileCache );
 
     Write( _T ( "GPUTextureCompression" ), g_GLOptions.m_bTextureCompression);
     Write( _T ( "GPUTextureCompressionCaching" ), g_GLOptions.m_bTextureCompressionCaching);
@@ -2718,25 +2777,100 @@ void MyConfig::UpdateSettings()
     Flush();
 }
 
-void MyConfig::UpdateNavObj( void )
+//  Write navobj.xml from the objects in memory and retire the journal records it now contains.
+//  Walking the objects must happen here, on the GUI thread; with bBackground only a snapshot
+//  is taken here, and the track points are formatted and the document written to disk by a
+//  worker thread while changes go to a fresh journal.
+void MyConfig::UpdateNavObj( bool bBackground )
 {
+    WaitNavObjCompaction();
 
 //   Create the NavObjectCollection, and save to specified file
     NavObjectCollection1 *pNavObjectSet = new NavObjectCollection1();
 
-    pNavObjectSet->CreateAllGPXObjects();
-    pNavObjectSet->SaveFile( m_sNavObjSetFile );
+    if( bBackground )
+        pNavObjectSet->SnapshotAllGPXObjects();
+    else
+        pNavObjectSet->CreateAllGPXObjects();
+
+    if( m_pNavObjectChangesSet )
+        m_NavObjSeq = m_pNavObjectChangesSet->GetLastSeq();
+    pNavObjectSet->SetJournalSeq( m_NavObjSeq );
+
+    wxString retired = m_sNavObjSetJournalFile + _T(".1");
+    if( m_pNavObjectChangesSet ) {
+        m_pNavObjectChangesSet->Rotate( retired );
+
+        //  A track with less than two points is left out of navobj.xml, so carry it
+        //  into the new journal ahead of the points still to come
+        if( g_pActiveTrack && g_pActiveTrack->GetnPoints() < 2 )
+            m_pNavObjectChangesSet->AddTrack( g_pActiveTrack, "add" );
+    }
+    else if( ::wxFileExists( m_sNavObjSetJournalFile ) ) {
+        if( ::wxFileExists( retired ) ) {
+            wxLogNull logNo;
+            ::wxRemoveFile( m_sNavObjSetJournalFile );          // both already applied
+        } else
+            ::wxRenameFile( m_sNavObjSetJournalFile, retired, true );
+    }
+
+    m_NavObjCompactTime = wxGetLocalTime();
+
+    wxString file = m_sNavObjSetFile;
+    auto save = [this, pNavObjectSet, file, retired]() {
+        pNavObjectSet->CompleteGPXSnapshot();
+
+        wxString tmp = file + _T(".tmp");
+        bool bok = pNavObjectSet->save_file( tmp.fn_str(), "  " );
+        delete pNavObjectSet;
+
+        if( bok )
+            bok = ::wxRenameFile( tmp, file, true );
+        if( bok && ::wxFileExists( retired ) )
+            ::wxRemoveFile( retired );
 
-    delete pNavObjectSet;
+        m_bNavObjSaveOK = bok;
+        m_bNavObjThreadBusy = false;
+    };
+
+    m_bNavObjThreadBusy = true;
+    if( bBackground )
+        m_NavObjThread = std::thread( save );
+    else {
+        save();
+        if( !m_bNavObjSaveOK )
+            wxLogMessage( _T("Failed to save ") + m_sNavObjSetFile );
+    }
 
     if( ::wxFileExists( m_sNavObjSetChangesFile ) ){
         wxLogNull logNo;                // avoid silly log error message.
         wxRemoveFile( m_sNavObjSetChangesFile );
     }
+}
 
-    //delete m_pNavObjectChangesSet;
-    //m_pNavObjectChangesSet = new NavObjectChanges(m_sNavObjSetChangesFile);
+void MyConfig::WaitNavObjCompaction()
+{
+    if( !m_NavObjThread.joinable() )
+        return;
+
+    m_NavObjThread.join();
+    if( !m_bNavObjSaveOK )
+        wxLogMessage( _T("Failed to save ") + m_sNavObjSetFile + _T(", journal kept") );
+}
+
+//  Called periodically.  Compacts the journal into navobj.xml once it grows large or old.
+void MyConfig::CheckNavObjJournal()
+{
+    if( m_bNavObjThreadBusy )
+        return;
+    WaitNavObjCompaction();
+
+    if( !m_pNavObjectChangesSet || !m_pNavObjectChangesSet->GetRecordCount() )
+        return;
 
+    if( ( m_pNavObjectChangesSet->GetSize() > NAVOBJ_JOURNAL_COMPACT_SIZE ) ||
+        ( wxGetLocalTime() - m_NavObjCompactTime > NAVOBJ_JOURNAL_COMPACT_SECONDS ) )
+        UpdateNavObj( true );
 }
 
 static wxFileName exportFileName(wxWindow* parent, const wxString suggestedName )
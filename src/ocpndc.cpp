@@ -1032,31 +1032,7 @@ void ocpnDC::DrawText( const wxString &text, wxCoord x, wxCoord y )
         wxCoord h = 0;
 
         if(m_buseTex){
-        
-            m_texfont.Build( m_font );      // make sure the font is ready
-            m_texfont.GetTextExtent(text, &w, &h);
-            
-            if( w && h ) {
-                
-                glEnable( GL_BLEND );
-                glEnable( GL_TEXTURE_2D );
-                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
-                glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
-
-                glPushMatrix();
-                glTranslatef(x, y, 0);
-                
-                glColor3ub( m_textforegroundcolour.Red(), m_textforegroundcolour.Green(),
-                            m_textforegroundcolour.Blue() );
-                
-
-                m_texfont.RenderString(text);
-                glPopMatrix();
-
-                glDisable( GL_TEXTURE_2D );
-                glDisable( GL_BLEND );
-
-            }
+            TexFontAtlas::Get().AddString( m_font, text, x, y, m_textforegroundcolour );
         }
         else{           
             wxScreenDC sdc;
@@ -1159,6 +1135,22 @@ void ocpnDC::DrawText( const wxString &text, wxCoord x, wxCoord y )
 #endif    
 }
 
+void ocpnDC::BeginTextBatch()
+{
+#ifdef ocpnUSE_GL
+    if( !dc )
+        TexFontAtlas::Get().BeginBatch();
+#endif
+}
+
+void ocpnDC::EndTextBatch()
+{
+#ifdef ocpnUSE_GL
+    if( !dc )
+        TexFontAtlas::Get().EndBatch();
+#endif
+}
+
 void ocpnDC::GetTextExtent( const wxString &string, wxCoord *w, wxCoord *h, wxCoord *descent,
         wxCoord *externalLeading, wxFont *font )
 {
@@ -1173,8 +1165,7 @@ void ocpnDC::GetTextExtent( const wxString &string, wxCoord *w, wxCoord *h, wxCo
 
         if(m_buseTex){
   #ifdef ocpnUSE_GL       
-        m_texfont.Build( f );      // make sure the font is ready
-        m_texfont.GetTextExtent(string, w, h);
+        TexFontAtlas::Get().GetTextExtent( f, string, w, h );
   #else        
         wxMemoryDC temp_dc;
         temp_dc.GetTextExtent( string, w, h, descent, externalLeading, &f );
@@ -7256,7 +7256,7 @@ void options::OnApplyClick(wxCommandEvent& event) {
 
     // Take a snapshot of the S52 config right now,
     // for later comparison
-    ps52plib->GenerateStateHash();
+    ps52plib->UpdateStateHash();
     long stateHash = ps52plib->GetStateHash();
 
 
@@ -7330,7 +7330,7 @@ void options::OnApplyClick(wxCommandEvent& event) {
     ps52plib->UpdateMarinerParams();
     ps52plib->m_nDepthUnitDisplay = depthUnit;
 
-    ps52plib->GenerateStateHash();
+    ps52plib->UpdateStateHash();
 
     // Detect a change to S52 library config
     if( (stateHash != ps52plib->GetStateHash()) || bUserStdChange )
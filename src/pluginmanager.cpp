@@ -2920,6 +2920,7 @@ int AddChartToDBInPlace( wxString &full_path, bool b_RefreshCanvas )
             //  Completely reload the chart database, for a fresh start
             ArrayOfCDI XnewChartDirArray;
             pConfig->LoadChartDirArray( XnewChartDirArray );
+            gFrame->InvalidateAllQuilts();
             delete ChartData;
             ChartData = new ChartDB();
             ChartData->LoadBinary(ChartListFileName, XnewChartDirArray);
@@ -2957,6 +2958,7 @@ int RemoveChartFromDBInPlace( wxString &full_path )
     //  Completely reload the chart database, for a fresh start
         ArrayOfCDI XnewChartDirArray;
         pConfig->LoadChartDirArray( XnewChartDirArray );
+        gFrame->InvalidateAllQuilts();
         delete ChartData;
         ChartData = new ChartDB();
         ChartData->LoadBinary(ChartListFileName, XnewChartDirArray);
@@ -3604,23 +3606,23 @@ bool AddPlugInTrack( PlugIn_Track *ptrack, bool b_permanent )
     Track *track = new Track();
 
     PlugIn_Waypoint *pwp;
-    TrackPoint *pWP_src;
+    TrackPoint WP_src;
     int ip = 0;
 
     wxPlugin_WaypointListNode *pwpnode = ptrack->pWaypointList->GetFirst();
     while( pwpnode ) {
         pwp = pwpnode->GetData();
 
-        TrackPoint *pWP = new TrackPoint( pwp->m_lat, pwp->m_lon );
-        pWP->SetCreateTime( pwp->m_CreateTime );
+        TrackPoint WP( pwp->m_lat, pwp->m_lon );
+        WP.SetCreateTime( pwp->m_CreateTime );
 
-        track->AddPoint( pWP );
+        track->AddPoint( WP );
 
         if(ip > 0)
-            pSelect->AddSelectableTrackSegment( pWP_src->m_lat, pWP_src->m_lon, pWP->m_lat,
-                                                pWP->m_lon, pWP_src, pWP, track );
+            pSelect->AddSelectableTrackSegment( WP_src.m_lat, WP_src.m_lon, WP.m_lat,
+                                                WP.m_lon, ip - 1, ip, track );
         ip++;
-        pWP_src = pWP;
+        WP_src = WP;
 
         pwpnode = pwpnode->GetNext(); //PlugInWaypoint
     }
@@ -5544,6 +5546,8 @@ void CreateCompatibleS57Object( PI_S57Obj *pObj, S57Obj *cobj, chart_context *pc
             cobj->m_chart_context->vertex_buffer = ppctx->vertex_buffer;
         }
         cobj->m_chart_context->chart = 0;           // note bene, this is always NULL for a PlugIn chart
+        for( int i = 0; i < LINE_LOD_LEVELS; i++ )
+            cobj->m_chart_context->line_lod_tolerance[i] = 0;   // no precomputed line levels of detail
     }
 }
 
@@ -6937,3 +6941,17 @@ int GetLatLonFormat()
 {
     return g_iSDMMFormat;
 }
+
+bool GetChartCacheStats( long *hits, long *misses, long *evictions, long *mem_kb, double *open_ms )
+{
+    if( !ChartData )
+        return false;
+
+    ChartCacheStats stats = ChartData->GetCacheStats();
+    if( hits ) *hits = stats.hits;
+    if( misses ) *misses = stats.misses;
+    if( evictions ) *evictions = stats.evictions;
+    if( mem_kb ) *mem_kb = stats.mem_kb;
+    if( open_ms ) *open_ms = stats.open_ms;
+    return true;
+}
@@ -1419,9 +1419,7 @@ void RouteManagerDialog::OnTrkRightClick( wxListEvent &event )
 
 static bool CompareTracks( Track* track1, Track* track2 )
 {
-    TrackPoint* start1 = track1->GetPoint(0);
-    TrackPoint* start2 = track2->GetPoint(0);
-    return start1->GetCreateTime() < start2->GetCreateTime();
+    return track1->GetPoint(0).GetCreateTime() < track2->GetPoint(0).GetCreateTime();
 }
 
 void RouteManagerDialog::OnTrkMenuSelected( wxCommandEvent &event )
@@ -1504,9 +1502,6 @@ void RouteManagerDialog::OnTrkMenuSelected( wxCommandEvent &event )
         case TRACK_MERGE: {
             Track* targetTrack = NULL;
             Track* mergeTrack = NULL;
-            TrackPoint* tPoint;
-            TrackPoint* newPoint;
-            TrackPoint* lastPoint;
             std::vector<Track*> mergeList;
             std::vector<Track*> deleteList;
             bool runningSkipped = false;
@@ -1523,7 +1518,6 @@ void RouteManagerDialog::OnTrkMenuSelected( wxCommandEvent &event )
             std::sort(mergeList.begin(), mergeList.end(), CompareTracks );
 
             targetTrack = mergeList[ 0 ];
-            lastPoint = targetTrack->GetLastPoint();
 
             for(auto const& mergeTrack: mergeList) {
                 if(mergeTrack == *mergeList.begin())
@@ -1534,16 +1528,18 @@ void RouteManagerDialog::OnTrkMenuSelected( wxCommandEvent &event )
                     continue;
                 }
 
+                targetTrack->Reserve( targetTrack->GetnPoints() + mergeTrack->GetnPoints() );
+
                 for(int i=0; i<mergeTrack->GetnPoints(); i++) {
-                    tPoint = mergeTrack->GetPoint(i);
-                    newPoint = new TrackPoint( tPoint->m_lat, tPoint->m_lon, tPoint->GetCreateTime() );
+                    TrackPoint tPoint = mergeTrack->GetPoint(i);
+                    TrackPoint newPoint( tPoint.m_lat, tPoint.m_lon, tPoint.GetCreateTime() );
 
+                    int n = targetTrack->GetnPoints();
                     targetTrack->AddPoint( newPoint );
 
-                    pSelect->AddSelectableTrackSegment( lastPoint->m_lat, lastPoint->m_lon, newPoint->m_lat,
-                            newPoint->m_lon, lastPoint, newPoint, targetTrack );
-
-                    lastPoint = newPoint;
+                    if( n )
+                        pSelect->AddSelectableTrackSegment( targetTrack->GetPointLat( n - 1 ), targetTrack->GetPointLon( n - 1 ),
+                                newPoint.m_lat, newPoint.m_lon, n - 1, n, targetTrack );
                 }
                 deleteList.push_back( mergeTrack );
             }
@@ -34,6 +34,11 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "georef.h"
 #include "viewport.h"
 
@@ -75,16 +80,6 @@ void PLIBDrawGLThickLine( float x1, float y1, float x2, float y2, wxPen pen, boo
 
 void LoadS57Config();
 
-#ifdef ocpnUSE_GL
-typedef struct {
-    TexFont cache;
-    wxFont  *key;
-} TexFontCache;
-
-#define TXF_CACHE 8
-static TexFontCache s_txf[TXF_CACHE];
-#endif
-
 
 //    Implement all lists
 #include <wx/listimpl.cpp>
@@ -337,6 +332,51 @@ LUPHashIndex *LUPArrayContainer::GetArrayIndexHelper( const char *objectName )
 }
 
 
+//-----------------------------------------------------------------------------
+//      Render stage timing
+//-----------------------------------------------------------------------------
+void S52RenderStats::Clear( void )
+{
+    for( int i = 0; i < S52_STAGE_NUM; i++ ) {
+        usec[i] = 0.;
+        calls[i] = 0;
+    }
+    depth = 0;
+}
+
+class S52StageTimer {
+public:
+    S52StageTimer( S52RenderStats *stats, int stage )
+    {
+        m_stats = stats;
+        m_stage = stage;
+        m_bOuter = false;
+        if( m_stats && !m_stats->depth++ ) {
+            m_bOuter = true;
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~S52StageTimer()
+    {
+        if( !m_stats )
+            return;
+
+        m_stats->depth--;
+        if( m_bOuter ) {
+            std::chrono::duration<double, std::micro> t = std::chrono::steady_clock::now() - m_start;
+            m_stats->usec[m_stage] += t.count();
+            m_stats->calls[m_stage]++;
+        }
+    }
+
+private:
+    S52RenderStats *m_stats;
+    int m_stage;
+    bool m_bOuter;
+    std::chrono::steady_clock::time_point m_start;
+};
+
 //-----------------------------------------------------------------------------
 //      s52plib implementation
 //-----------------------------------------------------------------------------
@@ -372,9 +412,6 @@ s52plib::s52plib( const wxString& PLib, bool b_forceLegacy )
     
     UpdateMarinerParams();
 
-    ledge = new int[2000];
-    redge = new int[2000];
-
     //    Defaults
     m_VersionMajor = 3;
     m_VersionMinor = 2;
@@ -397,6 +434,7 @@ s52plib::s52plib( const wxString& PLib, bool b_forceLegacy )
     m_anchorOn = true;
     m_qualityOfDataOn = false;
 
+    m_state_epoch = 0;
     GenerateStateHash();
 
     HPGL = new RenderFromHPGL( this );
@@ -417,7 +455,10 @@ s52plib::s52plib( const wxString& PLib, bool b_forceLegacy )
     m_TextureFormat = -1;
     SetGLPolygonSmoothing( true );
     SetGLLineSmoothing( true );
-    
+
+    m_bGLBatch = false;
+    m_pRenderStats = NULL;
+    m_CSLUP_generation = 0;
 }
 
 s52plib::~s52plib()
@@ -437,9 +478,6 @@ s52plib::~s52plib()
 
     delete pOBJLArray;
 
-    delete[] ledge;
-    delete[] redge;
-
     ChartSymbols::DeleteGlobals();
 
     delete HPGL;
@@ -495,6 +533,10 @@ void s52plib::DestroyLUP( LUPrec *pLUP )
     
     for(unsigned int i = 0 ; i < pLUP->ATTArray.size() ; i++)
         free (pLUP->ATTArray[i]);
+
+    free( pLUP->ATTCond );
+    pLUP->ATTCond = NULL;
+    pLUP->nATTCond = 0;
     
     delete pLUP->INST;
 }
@@ -631,14 +673,21 @@ void s52plib::UpdateMarinerParams( void )
 }
 
 void s52plib::GenerateStateHash()
+{
+    //  A new epoch changes both hashes, even with no setting changed,
+    //  forcing all canvases to re-configure and all charts to re-prepare
+    m_state_epoch++;
+    UpdateStateHash();
+}
+
+void s52plib::UpdateStateHash()
 {
     unsigned char state_buffer[512];  // Needs to be at least this big...
     memset(state_buffer, 0, sizeof(state_buffer));
     
-    int time = ::wxGetUTCTime();
-    memcpy(state_buffer, &time, sizeof(int));
+    memcpy(state_buffer, &m_state_epoch, sizeof(int));
     
-    size_t offset = sizeof(int);           // skipping the time int, first element
+    size_t offset = sizeof(int);           // skipping the epoch int, first element
     
     for(int i=0 ; i < S52_MAR_NUM ; i++){
         if( (offset + sizeof(double)) < sizeof(state_buffer)){
@@ -648,6 +697,27 @@ void s52plib::GenerateStateHash()
         }
     }
     
+    if(offset + 3 * sizeof(int) < sizeof(state_buffer)){
+        int styles[3] = { m_nSymbolStyle, m_nBoundaryStyle, m_nDepthUnitDisplay };
+        memcpy(&state_buffer[offset], styles, sizeof(styles));  offset += sizeof(styles);
+    }
+    
+    if(offset + sizeof(bool) < sizeof(state_buffer))
+        { memcpy(&state_buffer[offset], &m_bShowS57ImportantTextOnly, sizeof(bool));  offset += sizeof(bool); }
+    
+    if(offset + sizeof(bool) < sizeof(state_buffer))
+        { memcpy(&state_buffer[offset], &m_bDeClutterText, sizeof(bool)); offset += sizeof(bool); }
+    
+    if(offset + sizeof(bool) < sizeof(state_buffer))
+        { memcpy(&state_buffer[offset], &m_bShowNationalTexts, sizeof(bool));  offset += sizeof(bool); }
+    
+    if(offset + sizeof(bool) < sizeof(state_buffer))
+        { memcpy(&state_buffer[offset], &m_bExtendLightSectors, sizeof(bool));  offset += sizeof(bool); }
+
+    //  Everything so far is what charts prepare for, and is common to all canvases
+    m_prepare_hash = crc32buf(state_buffer, offset );
+    
+    //  The rest only filters the render, and may differ between canvases
     for(unsigned int i=0 ; i < m_noshow_array.GetCount() ; i++){
         if( (offset + 6) < sizeof(state_buffer)){
             memcpy(&state_buffer[offset], m_noshow_array[i].obj, 6) ;
@@ -655,34 +725,59 @@ void s52plib::GenerateStateHash()
         }
     }
     
+    if(offset + sizeof(int) < sizeof(state_buffer)){
+        int cat = m_nDisplayCategory;
+        memcpy(&state_buffer[offset], &cat, sizeof(int));  offset += sizeof(int);
+    }
+    
     if(offset + sizeof(bool) < sizeof(state_buffer))
         { memcpy(&state_buffer[offset], &m_bShowSoundg, sizeof(bool));  offset += sizeof(bool); }
     
     if(offset + sizeof(bool) < sizeof(state_buffer))
         { memcpy(&state_buffer[offset], &m_bShowS57Text, sizeof(bool));  offset += sizeof(bool); }
     
-    if(offset + sizeof(bool) < sizeof(state_buffer))
-        { memcpy(&state_buffer[offset], &m_bShowS57ImportantTextOnly, sizeof(bool));  offset += sizeof(bool); }
-    
-    if(offset + sizeof(bool) < sizeof(state_buffer))
-        { memcpy(&state_buffer[offset], &m_bDeClutterText, sizeof(bool)); offset += sizeof(bool); }
-    
-    if(offset + sizeof(bool) < sizeof(state_buffer))
-        { memcpy(&state_buffer[offset], &m_bShowNationalTexts, sizeof(bool));  offset += sizeof(bool); }
-    
     if(offset + sizeof(bool) < sizeof(state_buffer))
         { memcpy(&state_buffer[offset], &m_bShowAtonText, sizeof(bool));  offset += sizeof(bool); }
 
     if(offset + sizeof(bool) < sizeof(state_buffer))
         { memcpy(&state_buffer[offset], &m_bShowLdisText, sizeof(bool));  offset += sizeof(bool); }
-    
+
     if(offset + sizeof(bool) < sizeof(state_buffer))
-        { memcpy(&state_buffer[offset], &m_bExtendLightSectors, sizeof(bool));  offset += sizeof(bool); }
+        { memcpy(&state_buffer[offset], &m_bShowMeta, sizeof(bool));  offset += sizeof(bool); }
 
+    //  The Mariner's Standard object classes, as one checksum
+    if(pOBJLArray && (offset + sizeof(unsigned int) < sizeof(state_buffer))){
+        std::vector<unsigned char> viz( pOBJLArray->GetCount() + 1, 0 );
+        for(unsigned int i=0 ; i < pOBJLArray->GetCount() ; i++)
+            viz[i] = ((OBJLElement *)(pOBJLArray->Item(i)))->nViz;
+        unsigned int viz_crc = crc32buf(&viz[0], viz.size());
+        memcpy(&state_buffer[offset], &viz_crc, sizeof(viz_crc));  offset += sizeof(viz_crc);
+    }
+    
     m_state_hash = crc32buf(state_buffer, offset );
     
 }
 
+long s52plib::GetCSParamKey( void )
+{
+    //  Everything the CS procedures read, other than the object itself
+    static const S52_MAR_param_t cs_params[] = { S52_MAR_SHOW_TEXT, S52_MAR_TWO_SHADES,
+        S52_MAR_SAFETY_CONTOUR, S52_MAR_SAFETY_DEPTH, S52_MAR_SHALLOW_CONTOUR,
+        S52_MAR_DEEP_CONTOUR, S52_MAR_SHALLOW_PATTERN, S52_MAR_SYMBOLIZED_BND };
+    const int n_params = sizeof(cs_params) / sizeof(cs_params[0]);
+
+    double key_buffer[n_params + 4];
+    for( int i = 0; i < n_params; i++ )
+        key_buffer[i] = S52_getMarinerParam( cs_params[i] );
+
+    key_buffer[n_params] = m_nSymbolStyle;
+    key_buffer[n_params + 1] = m_nBoundaryStyle;
+    key_buffer[n_params + 2] = m_nDepthUnitDisplay;
+    key_buffer[n_params + 3] = m_CSLUP_generation;      // results point into the CS LUPs
+
+    return crc32buf( (unsigned char *) key_buffer, sizeof(key_buffer) );
+}
+
 wxArrayOfLUPrec* s52plib::SelectLUPARRAY( LUPname TNAM  )
 {
     switch( TNAM ){
@@ -722,6 +817,77 @@ LUPArrayContainer *s52plib::SelectLUPArrayContainer( LUPname TNAM )
 
 extern Cond condTable[];
 
+//      Pack a 6 character S57 attribute acronym into an integer key
+static inline unsigned long long S52_AttrKey( const char *acronym )
+{
+    unsigned long long key = 0;
+    for( int i = 0; i < 6; i++ )
+        key = ( key << 8 ) | (unsigned char) acronym[i];
+    return key;
+}
+
+//      Compile the attribute conditions of a LUP, so that FindBestLUP() compares
+//      integer keys and pre-parsed values instead of strings
+void s52plib::CompileLUPAttributes( LUPrec *LUP )
+{
+    free( LUP->ATTCond );
+    LUP->ATTCond = NULL;
+    LUP->nATTCond = LUP->ATTArray.size();
+    if( !LUP->nATTCond )
+        return;
+
+    LUP->ATTCond = (LUPAttCond *) calloc( LUP->nATTCond, sizeof(LUPAttCond) );
+
+    for( int i = 0; i < LUP->nATTCond; i++ ) {
+        LUPAttCond *pc = &LUP->ATTCond[i];
+        char *slatc = LUP->ATTArray[i];
+
+        // LUP attribute value not UTF8 convertible (never seen in PLIB 3.x)
+        if( !slatc || ( strlen( slatc ) < 6 ) ) {
+            pc->kind = LUP_ATT_IGNORE;
+            continue;
+        }
+
+        char *slatv = slatc + 6;
+        pc->key = S52_AttrKey( slatc );
+        pc->sval = slatv;
+
+        if( *slatv == ' ' )                 // any object value will match wild card (S52 para 8.3.3.4)
+            pc->kind = LUP_ATT_ANY;
+        else if( *slatv == '?' )            // LUP attribute value is "undefined"
+            pc->kind = LUP_ATT_UNDEF;
+        else {
+            pc->kind = LUP_ATT_VALUE;
+            pc->ival = atoi( slatv );
+            pc->fval = atof( slatv );
+        }
+    }
+}
+
+//      S57 attribute type 'L' list: comma separated integer
+static bool MatchLUPIntList( const char *slatv, int *b )
+{
+    bool attValMatch = false;
+    int a;
+    char ss[41];
+    strncpy( ss, slatv, 39 );
+    ss[40] = '\0';
+    char *s = &ss[0];
+
+    sscanf( s, "%d", &a );
+
+    while( *s != '\0' ) {
+        if( a == *b ) {
+            sscanf( ++s, "%d", &a );
+            b++;
+            attValMatch = true;
+
+        } else
+            attValMatch = false;
+    }
+    return attValMatch;
+}
+
 LUPrec *s52plib::FindBestLUP( wxArrayOfLUPrec *LUPArray, unsigned int startIndex, unsigned int count, S57Obj *pObj, bool bStrict )
 {
     //  Check the parameters
@@ -734,153 +900,102 @@ LUPrec *s52plib::FindBestLUP( wxArrayOfLUPrec *LUPArray, unsigned int startIndex
     LUPrec *LUP = LUPArray->Item( startIndex );
 
     int nATTMatch = 0;
-    int countATT = 0;
     bool bmatch_found = false;
 
     if( pObj->att_array == NULL )
         goto check_LUP;       // object has no attributes to compare, so return "best" LUP
-        
+
+    {
+    //  Encode the object attribute acronyms the same way as the LUP conditions
+    unsigned long long obj_keys_local[64];
+    std::vector<unsigned long long> obj_keys_heap;
+    unsigned long long *obj_keys = obj_keys_local;
+    if( pObj->n_attr > 64 ) {
+        obj_keys_heap.resize( pObj->n_attr );
+        obj_keys = &obj_keys_heap[0];
+    }
+    for( int i = 0; i < pObj->n_attr; i++ )
+        obj_keys[i] = S52_AttrKey( pObj->att_array + 6 * i );
+
     for( unsigned int i = 0; i < count; ++i ) {
         LUPrec *LUPCandidate = LUPArray->Item( startIndex + i );
         
         if( !LUPCandidate->ATTArray.size() )
             continue;        // this LUP has no attributes coded
 
-        countATT = 0;
-        char *currATT = pObj->att_array;
-        int attIdx = 0;
+        if( !LUPCandidate->ATTCond )
+            CompileLUPAttributes( LUPCandidate );
 
-        for( unsigned int iLUPAtt = 0; iLUPAtt < LUPCandidate->ATTArray.size(); iLUPAtt++ ) {
+        int countATT = 0;
 
-            // Get the LUP attribute name
-            char *slatc = LUPCandidate->ATTArray[iLUPAtt];
+        for( int iLUPAtt = 0; iLUPAtt < LUPCandidate->nATTCond; iLUPAtt++ ) {
+            const LUPAttCond &cond = LUPCandidate->ATTCond[iLUPAtt];
+            if( cond.kind == LUP_ATT_IGNORE )
+                continue;
 
-            if( slatc && (strlen(slatc) < 6) )
-                goto next_LUP_Attr;         // LUP attribute value not UTF8 convertible (never seen in PLIB 3.x)
+            //  Find the first object attribute with this name
+            int attIdx = 0;
+            while( ( attIdx < pObj->n_attr ) && ( obj_keys[attIdx] != cond.key ) )
+                ++attIdx;
+            if( attIdx == pObj->n_attr )
+                continue;
 
-            if( slatc ){
-                char *slatv = slatc + 6;
-                while( attIdx < pObj->n_attr ) {
-                    if( 0 == strncmp( slatc, currATT, 6 ) ) {
-                        //OK we have an attribute name match
-                        
-                        
-                        bool attValMatch = false;
-                        
-                        // special case (i)
-                        if( !strncmp( slatv, " ", 1 ) ) {        // any object value will match wild card (S52 para 8.3.3.4)
-                            ++countATT;
-                            goto next_LUP_Attr;
-                        }
-                        
-                        // special case (ii)
-                        //TODO  Find an ENC with "UNKNOWN" DRVAL1 or DRVAL2 and debug this code
-                        if( !strncmp( slatv, "?", 1) ){          // if LUP attribute value is "undefined"
+            if( cond.kind == LUP_ATT_ANY ) {
+                ++countATT;
+                continue;
+            }
 
-                        //  Match if the object does NOT contain this attribute
-                            goto next_LUP_Attr;
-                        }
-                        
-                        
-                        //checking against object attribute value
-                        S57attVal *v = ( pObj->attVal->Item( attIdx ) );
-                        
-                        switch( v->valType ){
-                            case OGR_INT: // S57 attribute type 'E' enumerated, 'I' integer
-                            {
-                                int LUP_att_val = atoi( slatv );
-                                if( LUP_att_val == *(int*) ( v->value ) )
-                                    attValMatch = true;
-                                break;
-                            }
-                            
-                            case OGR_INT_LST: // S57 attribute type 'L' list: comma separated integer
-                            {
-                                int a;
-                                char ss[41];
-                                strncpy( ss, slatv, 39 );
-                                ss[40] = '\0';
-                                char *s = &ss[0];
-                                
-                                int *b = (int*) v->value;
-                                sscanf( s, "%d", &a );
-                                
-                                while( *s != '\0' ) {
-                                    if( a == *b ) {
-                                        sscanf( ++s, "%d", &a );
-                                        b++;
-                                        attValMatch = true;
-                                        
-                                    } else
-                                        attValMatch = false;
-                                }
-                                break;
-                            }
-                            case OGR_REAL: // S57 attribute type'F' float
-                            {
-                                double obj_val = *(double*) ( v->value );
-                                float att_val = atof( slatv );
-                                if( fabs( obj_val - att_val ) < 1e-6 )
-                                    if( obj_val == att_val  )
-                                        attValMatch = true;
-                                break;
-                            }
-                            
-                            case OGR_STR: // S57 attribute type'A' code string, 'S' free text
-                            {
-                                //    Strings must be exact match
-                                //    n.b. OGR_STR is used for S-57 attribute type 'L', comma-separated list
-                                
-                                //wxString cs( (char *) v->value, wxConvUTF8 ); // Attribute from object
-                                //if( LATTC.Mid( 6 ) == cs )
-                                if( !strcmp((char *) v->value, slatv))
-                                    attValMatch = true;
-                                break;
-                            }
-                            
-                            default:
-                                break;
-                        } //switch
-                        
-                        // value match
-                        if( attValMatch )
-                            ++countATT;
-                                                
-                        goto next_LUP_Attr;
-                    } // if attribute name match
-                    
-                    //  Advance to the next S57obj attribute
-                    currATT += 6;
-                    ++attIdx;
-                    
-                } //while
-            } //if
-            
-next_LUP_Attr:
-         
-            currATT = pObj->att_array; // restart the object attribute list
-            attIdx = 0;
+            //TODO  Find an ENC with "UNKNOWN" DRVAL1 or DRVAL2 and debug this code
+            if( cond.kind == LUP_ATT_UNDEF )
+                continue;
+
+            //checking against object attribute value
+            S57attVal *v = ( pObj->attVal->Item( attIdx ) );
+            bool attValMatch = false;
+
+            switch( v->valType ){
+                case OGR_INT: // S57 attribute type 'E' enumerated, 'I' integer
+                    attValMatch = ( cond.ival == *(int*) ( v->value ) );
+                    break;
+
+                case OGR_INT_LST: // S57 attribute type 'L' list: comma separated integer
+                    attValMatch = MatchLUPIntList( cond.sval, (int*) v->value );
+                    break;
+
+                case OGR_REAL: // S57 attribute type'F' float
+                {
+                    double obj_val = *(double*) ( v->value );
+                    if( fabs( obj_val - cond.fval ) < 1e-6 )
+                        if( obj_val == cond.fval )
+                            attValMatch = true;
+                    break;
+                }
+
+                case OGR_STR: // S57 attribute type'A' code string, 'S' free text
+                    //    Strings must be exact match
+                    //    n.b. OGR_STR is used for S-57 attribute type 'L', comma-separated list
+                    attValMatch = !strcmp( (char *) v->value, cond.sval );
+                    break;
+
+                default:
+                    break;
+            } //switch
+
+            // value match
+            if( attValMatch )
+                ++countATT;
         } // for iLUPAtt
         
-        //      Create a "match score", defined as fraction of candidate LUP attributes
-        //      actually matched by feature.
-        //      Used later for resolving "ties"
-        
-        int nattr_matching_on_candidate = countATT;
-        int nattrs_on_candidate = LUPCandidate->ATTArray.size();
-        double candidate_score = ( 1. * nattr_matching_on_candidate )
-        / ( 1. * nattrs_on_candidate );
-        
         //       According to S52 specs, match must be perfect,
         //         and the first 100% match is selected
-        if( candidate_score == 1.0 ) {
+        if( countATT == LUPCandidate->nATTCond ) {
             LUP = LUPCandidate;
             bmatch_found = true;
             break; // selects the first 100% match
         }
         
     } //for loop
-    
+    }
 
 check_LUP:
 //  In strict mode, we require at least one attribute to match exactly
@@ -1296,17 +1411,8 @@ void s52plib::FlushSymbolCaches( void )
     }
     m_CARC_DL_hashmap.clear();
     
-    // Flush all texFonts
-    TexFont *f_cache = 0;
-    unsigned int i;
-    for (i = 0; i < TXF_CACHE; i++)
-    {
-        if (s_txf[i].key != 0) {
-            f_cache = &s_txf[i].cache;
-            f_cache->Delete();
-            s_txf[i].key = 0;
-        }
-    }
+    // Flush the text glyphs
+    TexFontAtlas::Get().Clear();
     
 #endif
 }
@@ -1337,6 +1443,8 @@ void s52plib::ClearCNSYLUPArray( void )
 
         condSymbolLUPArray->Clear();
     }
+    m_CSLUP_hash.clear();
+    m_CSLUP_generation++;
 }
 
 bool s52plib::S52_flush_Plib()
@@ -1363,6 +1471,8 @@ bool s52plib::S52_flush_Plib()
 #endif
     
     DestroyLUPArray( condSymbolLUPArray );
+    m_CSLUP_hash.clear();
+    m_CSLUP_generation++;
 
 //      Destroy Rules
     DestroyRules( _line_sym );
@@ -1453,6 +1563,17 @@ S52color* s52plib::getColor( const char *colorName )
     return c;
 }
 
+//      Colour of a rule, resolved once per colour table rather than looked up
+//      by name on every render
+S52color* s52plib::getRuleColor( Rules *rules, const char *colorName )
+{
+    if( !rules->color || ( rules->color_table != m_colortable_index ) ) {
+        rules->color = getColor( colorName );
+        rules->color_table = m_colortable_index;
+    }
+    return rules->color;
+}
+
 wxColour s52plib::getwxColour( const wxString &colorName )
 {
     wxColor c;
@@ -1841,10 +1962,9 @@ bool s52plib::RenderText( wxDC *pdc, S52_TextC *ptext, int x, int y, wxRect *pRe
             ptext->rendered_char_height = (h_scaled - descent) * 8 / 10;
             
         }
-        // We render string with "special" characters the old, hard way, since we don't necessarily have the glyphs in our font, 
-        // or if we do we would need a hashmap to cache and extract them
-        // And we also do this if the text is to be scaled up artificially.
-        if( (ptext->bspecial_char) || b_force_no_texture) {       
+        // We render text to be scaled up artificially the old, hard way, as a texture per string.
+        // Everything else, "special" characters included, comes from the shared glyph atlas
+        if( b_force_no_texture ) {
             if( !ptext->texobj ) // is texture ready?
             {
                 wxScreenDC sdc;
@@ -2064,30 +2184,10 @@ bool s52plib::RenderText( wxDC *pdc, S52_TextC *ptext, int x, int y, wxRect *pRe
         }
         
         else {                                          // render using cached texture glyphs
-            // rebuild font if needed
-            TexFont *f_cache = 0;
-            unsigned int i;
-            for (i = 0; i < TXF_CACHE; i++)
-            {
-                if (s_txf[i].key == ptext->pFont) {
-                    f_cache = &s_txf[i].cache;
-                    break;
-                }
-                if (s_txf[i].key == 0) {
-                    break;
-                }
-            }
-            if (i == TXF_CACHE) {
-                i = rand() & (TXF_CACHE -1);
-            }
-            if (f_cache == 0) {
-                s_txf[i].key = ptext->pFont;
-                f_cache = &s_txf[i].cache;
-                f_cache->Build(*ptext->pFont);
-            }
-            
+            TexFontAtlas &atlas = TexFontAtlas::Get();
+
             int w, h;
-            f_cache->GetTextExtent(ptext->frmtd, &w, &h);
+            atlas.GetTextExtent( *ptext->pFont, ptext->frmtd, &w, &h );
             
             // We don't store descent/ascent info for font texture cache
             // So we have to estimate based on conventional Arial metrics
@@ -2166,25 +2266,10 @@ bool s52plib::RenderText( wxDC *pdc, S52_TextC *ptext, int x, int y, wxRect *pRe
                 
                 // If the user has not changed the color from BLACK, then use the color specified in the S52 LUP
                 if( wcolor == *wxBLACK )
-                    glColor3ub( ptext->pcol->R, ptext->pcol->G, ptext->pcol->B );
-                else
-                    glColor3ub( wcolor.Red(), wcolor.Green(), wcolor.Blue() );
-                
-                glEnable( GL_BLEND );
-                glEnable( GL_TEXTURE_2D );
-                glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
-                
-                glPushMatrix();
-                glTranslatef(xp, yp, 0);
-                
+                    wcolor = wxColour( ptext->pcol->R, ptext->pcol->G, ptext->pcol->B );
+
                 /* undo previous rotation to make text level */
-                glRotatef(vp->rotation*180/PI, 0, 0, -1);
-                
-                f_cache->RenderString(ptext->frmtd);
-                glPopMatrix();
-                
-                glDisable( GL_TEXTURE_2D );
-                glDisable( GL_BLEND );
+                atlas.AddString( *ptext->pFont, ptext->frmtd, xp, yp, wcolor, vp->rotation );
             }
         }
         
@@ -2307,23 +2392,91 @@ bool s52plib::RenderText( wxDC *pdc, S52_TextC *ptext, int x, int y, wxRect *pRe
 
 
 
-//    Return true if test_rect overlaps any rect in the current text rectangle list, except itself
-bool s52plib::CheckTextRectList( const wxRect &test_rect, S52_TextC *ptext )
+//----------------------------------------------------------------------------------
+//      S52TextRectGrid Implementation
+//----------------------------------------------------------------------------------
+
+#define TEXT_GRID_CELL_SHIFT    6               // 64 pixel cells
+
+static inline long long TextGridKey( int cx, int cy )
+{
+    return ( (long long) cx << 32 ) ^ (unsigned int) cy;
+}
+
+void S52TextRectGrid::Clear( void )
+{
+    m_entries.clear();
+    m_cells.clear();
+    m_owner_entry.clear();
+}
+
+void S52TextRectGrid::CellRange( const wxRect &rect, int &cx0, int &cy0, int &cx1, int &cy1 ) const
+{
+    cx0 = rect.x >> TEXT_GRID_CELL_SHIFT;
+    cy0 = rect.y >> TEXT_GRID_CELL_SHIFT;
+    cx1 = ( rect.x + wxMax( rect.width, 1 ) - 1 ) >> TEXT_GRID_CELL_SHIFT;
+    cy1 = ( rect.y + wxMax( rect.height, 1 ) - 1 ) >> TEXT_GRID_CELL_SHIFT;
+}
+
+//      Enter the current rectangle of a placed text.  A text placed again
+//      replaces its earlier rectangle.
+void S52TextRectGrid::Insert( S52_TextC *owner, const wxRect &rect )
 {
-    //    Iterate over the current object list, looking at rText
 
-    for( TextObjList::Node *node = m_textObjList.GetFirst(); node; node = node->GetNext() ) {
-        wxRect *pcurrent_rect = &( node->GetData()->rText );
+    std::unordered_map<S52_TextC *, int>::iterator it = m_owner_entry.find( owner );
+    if( it != m_owner_entry.end() ) {
+        Entry &old = m_entries[it->second];
+        if( old.rect == rect )
+            return;
+        old.owner = NULL;
+        old.rect = wxRect();
+    }
+
+    int index = m_entries.size();
+    Entry e;
+    e.rect = rect;
+    e.owner = owner;
+    m_entries.push_back( e );
+    m_owner_entry[owner] = index;
+
+    int cx0, cy0, cx1, cy1;
+    CellRange( rect, cx0, cy0, cx1, cy1 );
+    for( int cy = cy0; cy <= cy1; cy++ )
+        for( int cx = cx0; cx <= cx1; cx++ )
+            m_cells[TextGridKey( cx, cy )].push_back( index );
+}
 
-        if( pcurrent_rect->Intersects( test_rect ) ) {
-            if( node->GetData() != ptext )
-                return true;
+bool S52TextRectGrid::Intersects( const wxRect &rect, S52_TextC *except ) const
+{
+    if( m_entries.empty() )
+        return false;
 
+    int cx0, cy0, cx1, cy1;
+    CellRange( rect, cx0, cy0, cx1, cy1 );
+    for( int cy = cy0; cy <= cy1; cy++ ) {
+        for( int cx = cx0; cx <= cx1; cx++ ) {
+            std::unordered_map<long long, std::vector<int> >::const_iterator it =
+                m_cells.find( TextGridKey( cx, cy ) );
+            if( it == m_cells.end() )
+                continue;
+
+            const std::vector<int> &cell = it->second;
+            for( size_t i = 0; i < cell.size(); i++ ) {
+                const Entry &e = m_entries[cell[i]];
+                if( e.owner && ( e.owner != except ) && e.rect.Intersects( rect ) )
+                    return true;
+            }
         }
     }
     return false;
 }
 
+//    Return true if test_rect overlaps any rect in the current text rectangle list, except itself
+bool s52plib::CheckTextRectList( const wxRect &test_rect, S52_TextC *ptext )
+{
+    return m_textGrid.Intersects( test_rect, ptext );
+}
+
 bool s52plib::TextRenderCheck( ObjRazRules *rzRules )
 {
     if( !m_bShowS57Text ) return false;
@@ -2493,7 +2646,6 @@ int s52plib::RenderT_All( ObjRazRules *rzRules, Rules *rules, ViewPort *vp, bool
         //  text renders in its rule set.  RDOCAL is one example.  There are others
         //  We need to cache only the first text structure, but should update the render rectangle
         //  to reflect all texts rendered for this object,  in order to process the declutter logic.
-        bool b_dupok = false;
         if( b_free_text ) {
             delete text;
         
@@ -2506,30 +2658,16 @@ int s52plib::RenderT_All( ObjRazRules *rzRules, Rules *rules, ViewPort *vp, bool
                 wxRect r0 = text->rText;
                 r0 = r0.Union(rect);
                 text->rText = r0;
-            
-                b_dupok = true;                 // OK to add a duplicate text structure to the declutter list, just for this case.
             }
         }
         else
             text->rText = rect;
         
         
-        //      If this text was actually drawn, add a pointer to its rect to the de-clutter list if it doesn't already exist
+        //      If this text was actually drawn, enter its rect into the de-clutter grid
         if( m_bDeClutterText ) {
-            if( bwas_drawn ) {
-                bool b_found = false;
-                for( TextObjList::Node *node = m_textObjList.GetFirst(); node; node =  node->GetNext() ) {
-                    S52_TextC *oc = node->GetData();
-
-                    if( oc == text ) {
-                        if(!b_dupok)
-                            b_found = true;
-                        break;
-                    }
-                }
-                if( !b_found )
-                    m_textObjList.Append( text );
-            }
+            if( bwas_drawn )
+                m_textGrid.Insert( text, text->rText );
         }
 
         //  Update the object Bounding box
@@ -2555,12 +2693,16 @@ int s52plib::RenderT_All( ObjRazRules *rzRules, Rules *rules, ViewPort *vp, bool
 // Text
 int s52plib::RenderTX( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_TEXT );
+
     return RenderT_All( rzRules, rules, vp, true );
 }
 
 // Text formatted
 int s52plib::RenderTE( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_TEXT );
+
     return RenderT_All( rzRules, rules, vp, false );
 }
 
@@ -3039,9 +3181,20 @@ bool s52plib::RenderRasterSymbol( ObjRazRules *rzRules, Rule *prule, wxPoint &r,
 
     //      Now render the symbol
 
+#ifdef ocpnUSE_GL
+    //  Symbols from the texture atlas are deferred into the open batch
+    if( !m_pdc && texture && m_bGLBatch ) {
+        AddGLSymbolBatch( texture, texrect, r, pivot_x, pivot_y, scale_factor, vp );
+    }
+    else
+#endif
     if( !m_pdc )          // opengl
     {
 #ifdef ocpnUSE_GL
+        //  Keep the S52 draw order, anything batched before this symbol goes first
+        if( m_bGLBatch )
+            FlushGLBatch( vp );
+
         glEnable( GL_BLEND );
         
         if(texture) {
@@ -3230,6 +3383,8 @@ bool s52plib::RenderRasterSymbol( ObjRazRules *rzRules, Rule *prule, wxPoint &r,
 // SYmbol
 int s52plib::RenderSY( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_SYMBOLS );
+
     float angle = 0;
     double orient;
 
@@ -3274,9 +3429,41 @@ int s52plib::RenderSY( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 
 }
 
+//  Coarsest precomputed line level of detail (see s57chart::BuildLineLOD())
+//  that stays within LINE_LOD_PIXELS at this scale, -1 for full resolution
+static int GetLineLODLevel( S57Obj *obj, ViewPort *vp )
+{
+    chart_context *ctx = obj->m_chart_context;
+    if( !ctx || !ctx->chart )
+        return -1;
+
+    double pix_per_unit = fabs( obj->x_rate ) * vp->view_scale_ppm;
+    for( int l = LINE_LOD_LEVELS - 1; l >= 0; l-- ) {
+        if( ( ctx->line_lod_tolerance[l] > 0 ) && ( ctx->line_lod_tolerance[l] * pix_per_unit <= LINE_LOD_PIXELS ) )
+            return l;
+    }
+    return -1;
+}
+
+//  Vertex indices of an edge at level lod, or the next finer level it has.
+//  NULL means all nCount points of the edge.
+static const unsigned int *GetEdgeLOD( VE_Element *pedge, int lod, unsigned int *count )
+{
+    for( int l = lod; l >= 0; l-- ) {
+        if( pedge->lod_index[l] ) {
+            *count = pedge->lod_count[l];
+            return pedge->lod_index[l];
+        }
+    }
+    *count = pedge->nCount;
+    return NULL;
+}
+
 // Line Simple Style, OpenGL
 int s52plib::RenderGLLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_LINES );
+
     // for now don't use vbo model in non-mercator
     if(vp->m_projection_type != PROJECTION_MERCATOR)
         return RenderLS(rzRules, rules, vp);
@@ -3341,7 +3528,7 @@ int s52plib::RenderGLLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
     
     line_segment_element *ls_list = rzRules->obj->m_ls_list;
     
-    S52color *c = getColor( str + 7 ); // Colour
+    S52color *c = getRuleColor( rules, str + 7 ); // Colour
     int w = atoi( str + 5 ); // Width
     
     glColor3ub( c->R, c->G, c->B );
@@ -3385,29 +3572,118 @@ int s52plib::RenderGLLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 #endif
     
 #ifndef ocpnUSE_GLES // linestipple is emulated poorly
-    if( !strncmp( str, "DASH", 4 ) ) {
-        glLineStipple( 1, 0x3F3F );
-        glEnable( GL_LINE_STIPPLE );
-    }
-    else if( !strncmp( str, "DOTT", 4 ) ) {
-        glLineStipple( 1, 0x3333 );
-        glEnable( GL_LINE_STIPPLE );
-    }
-    else
-        glDisable( GL_LINE_STIPPLE );
-#endif    
-        
-    glPushMatrix();
-    
-    // Set up the OpenGL transform matrix for this object
-    //  Transform from Simple Mercator (relative to chart reference point) to screen coordinates.
-    
-    //  First, the VP transform
-    glTranslatef( vp->pix_width / 2, vp->pix_height/2, 0 );
-    glScalef( vp->view_scale_ppm, -vp->view_scale_ppm, 0 );
-    glTranslatef( -rzRules->sm_transform_parms->easting_vp_center, -rzRules->sm_transform_parms->northing_vp_center, 0 );
-    
-    //  Next, the per-object transform
+    unsigned short stipple = 0;
+    if( !strncmp( str, "DASH", 4 ) )
+        stipple = 0x3F3F;
+    else if( !strncmp( str, "DOTT", 4 ) )
+        stipple = 0x3333;
+
+    //  While batching, lines are gathered as indices into the chart line vertex
+    //  buffer.  Solid lines go in as GL_LINES pairs.  Stippled lines are kept as
+    //  strips, since splitting a strip into pairs would restart the pattern at
+    //  every vertex.
+    if( m_bGLBatch ) {
+        unsigned int vbo = b_useVBO ? rzRules->obj->auxParm2 : 0;
+        bool b_smooth = lineWidth > 4.0 && m_GLLineSmoothing;
+        S57Obj *obj = rzRules->obj;
+        sm_parms *sm = rzRules->sm_transform_parms;
+
+        S52GLLineBatch *batch = NULL;
+        for( size_t i = 0; i < m_line_batches.size(); i++ ) {
+            S52GLLineBatch &b = m_line_batches[i];
+            if( b.vbo == vbo && b.vertex_buffer == vertex_buffer
+                && b.R == c->R && b.G == c->G && b.B == c->B
+                && b.line_width == lineWidth && b.b_smooth == b_smooth && b.stipple == stipple
+                && b.x_origin == obj->x_origin && b.y_origin == obj->y_origin
+                && b.x_rate == obj->x_rate && b.y_rate == obj->y_rate
+                && b.easting_vp_center == sm->easting_vp_center
+                && b.northing_vp_center == sm->northing_vp_center ) {
+                batch = &b;
+                break;
+            }
+        }
+        if( !batch ) {
+            m_line_batches.push_back( S52GLLineBatch() );
+            batch = &m_line_batches.back();
+            batch->vbo = vbo;
+            batch->vertex_buffer = vertex_buffer;
+            batch->R = c->R; batch->G = c->G; batch->B = c->B;
+            batch->line_width = lineWidth;
+            batch->b_smooth = b_smooth;
+            batch->stipple = stipple;
+            batch->x_origin = obj->x_origin; batch->y_origin = obj->y_origin;
+            batch->x_rate = obj->x_rate; batch->y_rate = obj->y_rate;
+            batch->easting_vp_center = sm->easting_vp_center;
+            batch->northing_vp_center = sm->northing_vp_center;
+        }
+
+        int lod = GetLineLODLevel( obj, vp );
+
+        for( ; ls_list; ls_list = ls_list->next ) {
+            if( ls_list->priority != priority_current )
+                continue;
+
+            size_t seg_vbo_offset;
+            unsigned int point_count;
+            const unsigned int *lod_index = NULL;
+            if( (ls_list->ls_type == TYPE_EE) || (ls_list->ls_type == TYPE_EE_REV) ){
+                seg_vbo_offset = ls_list->pedge->vbo_offset;
+                lod_index = GetEdgeLOD( ls_list->pedge, lod, &point_count );
+            }
+            else{
+                seg_vbo_offset = ls_list->pcs->vbo_offset;
+                point_count = 2;
+            }
+
+            unsigned int first = seg_vbo_offset / (2 * sizeof(float));
+            if( stipple ) {
+                if( point_count < 2 )
+                    continue;
+                batch->strips.push_back( batch->indices.size() );
+                for( unsigned int i = 0; i < point_count; i++ )
+                    batch->indices.push_back( first + ( lod_index ? lod_index[i] : i ) );
+            }
+            else if( lod_index ) {
+                for( unsigned int i = 1; i < point_count; i++ ) {
+                    batch->indices.push_back( first + lod_index[i - 1] );
+                    batch->indices.push_back( first + lod_index[i] );
+                }
+            }
+            else {
+                for( unsigned int i = 1; i < point_count; i++ ) {
+                    batch->indices.push_back( first + i - 1 );
+                    batch->indices.push_back( first + i );
+                }
+            }
+        }
+
+        glDisable( GL_LINE_SMOOTH );
+        glDisable( GL_BLEND );
+        return 1;
+    }
+
+    if( stipple ) {
+        glLineStipple( 1, stipple );
+        glEnable( GL_LINE_STIPPLE );
+    }
+    else
+        glDisable( GL_LINE_STIPPLE );
+#else
+    if( m_bGLBatch )
+        FlushGLBatch( vp );
+#endif    
+        
+    glPushMatrix();
+    
+    // Set up the OpenGL transform matrix for this object
+    //  Transform from Simple Mercator (relative to chart reference point) to screen coordinates.
+    
+    //  First, the VP transform
+    glTranslatef( vp->pix_width / 2, vp->pix_height/2, 0 );
+    glScalef( vp->view_scale_ppm, -vp->view_scale_ppm, 0 );
+    glTranslatef( -rzRules->sm_transform_parms->easting_vp_center, -rzRules->sm_transform_parms->northing_vp_center, 0 );
+    
+    //  Next, the per-object transform
     if( rzRules->obj->m_chart_context->chart ){
         glTranslatef( rzRules->obj->x_origin, rzRules->obj->y_origin, 0);
         glScalef( rzRules->obj->x_rate, rzRules->obj->y_rate, 0 );
@@ -3423,13 +3699,20 @@ int s52plib::RenderGLLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
     
 
   
+#ifdef ocpnUSE_GLES
+    int lod = -1;                       // no GL_UNSIGNED_INT element indices
+#else
+    int lod = GetLineLODLevel( rzRules->obj, vp );
+#endif
+
     // from above ls_list is the first drawable segment
     while( ls_list){
         
         if( ls_list->priority == priority_current  )   
         {
             size_t seg_vbo_offset = 0;
-            size_t point_count = 0;
+            unsigned int point_count = 0;
+            const unsigned int *lod_index = NULL;
             
             //  Check visibility of the segment
             bool b_drawit = false;
@@ -3442,7 +3725,7 @@ int s52plib::RenderGLLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
                     // render the segment
                         b_drawit = true;
                         seg_vbo_offset = ls_list->pedge->vbo_offset;
-                        point_count = ls_list->pedge->nCount;
+                        lod_index = GetEdgeLOD( ls_list->pedge, lod, &point_count );
                  }
                     
             }
@@ -3466,14 +3749,15 @@ int s52plib::RenderGLLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
             if( b_drawit) {
                 // render the segment
                 
-                if(b_useVBO){
+                if(b_useVBO)
                     glVertexPointer(2, GL_FLOAT, 2 * sizeof(float), (GLvoid *)(seg_vbo_offset));
-                    glDrawArrays(GL_LINE_STRIP, 0, point_count);
-                }
-                else{
+                else
                     glVertexPointer(2, GL_FLOAT, 2 * sizeof(float), (unsigned char *)vertex_buffer + seg_vbo_offset);
+
+                if(lod_index)
+                    glDrawElements(GL_LINE_STRIP, point_count, GL_UNSIGNED_INT, lod_index);
+                else
                     glDrawArrays(GL_LINE_STRIP, 0, point_count);
-                }
             }
         }
         ls_list = ls_list->next;
@@ -3499,6 +3783,11 @@ int s52plib::RenderGLLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 // Line Simple Style
 int s52plib::RenderLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_LINES );
+
+    if( m_bGLBatch )                // drawn at once, after anything batched so far
+        FlushGLBatch( vp );
+
     // catch legacy PlugIns (e.g.s63_pi)
     if( rzRules->obj->m_n_lsindex  && !rzRules->obj->m_ls_list) 
         return RenderLSLegacy(rzRules, rules, vp);
@@ -3511,7 +3800,7 @@ int s52plib::RenderLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
     int w;
 
     char *str = (char*) rules->INSTstr;
-    c = getColor( str + 7 ); // Colour
+    c = getRuleColor( rules, str + 7 ); // Colour
     wxColour color( c->R, c->G, c->B );
     w = atoi( str + 5 ); // Width
 
@@ -3625,6 +3914,7 @@ int s52plib::RenderLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 
         unsigned char *vbo_point = (unsigned char *)rzRules->obj->m_chart_context->vertex_buffer;
         line_segment_element *ls = rzRules->obj->m_ls_list;
+        int lod = GetLineLODLevel( rzRules->obj, vp );
 
 #ifdef ocpnUSE_GL
         if( !m_pdc && !b_wide_line)
@@ -3634,11 +3924,12 @@ int s52plib::RenderLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
         while(ls){
             if( ls->priority == priority_current  ) {  
 
-                int nPoints;
+                unsigned int nPoints;
+                const unsigned int *lod_index = NULL;
             // fetch the first point
                 if( (ls->ls_type == TYPE_EE) || (ls->ls_type == TYPE_EE_REV) ){
                     ppt = (float *)(vbo_point + ls->pedge->vbo_offset);
-                    nPoints = ls->pedge->nCount;
+                    lod_index = GetEdgeLOD( ls->pedge, lod, &nPoints );
                 }
                 else{
                     ppt = (float *)(vbo_point + ls->pcs->vbo_offset);
@@ -3647,11 +3938,11 @@ int s52plib::RenderLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 
                 wxPoint l;
                 GetPointPixSingle( rzRules, ppt[1], ppt[0], &l, vp );
-                ppt += 2;
             
-                for(int ip=0 ; ip < nPoints - 1 ; ip++){
+                for(unsigned int ip=1 ; ip < nPoints ; ip++){
+                    float *pr = ppt + 2 * ( lod_index ? lod_index[ip] : ip );
                     wxPoint r;
-                    GetPointPixSingle( rzRules, ppt[1], ppt[0], &r, vp );
+                    GetPointPixSingle( rzRules, pr[1], pr[0], &r, vp );
                             //        Draw the edge as point-to-point
                     x0 = l.x, y0 = l.y;
                     x1 = r.x, y1 = r.y;
@@ -3682,7 +3973,6 @@ int s52plib::RenderLS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
                     }
                         
                     l = r;
-                    ppt += 2;
                 }            
             }
             
@@ -3715,7 +4005,7 @@ int s52plib::RenderLSLegacy( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
     int w;
 
     char *str = (char*) rules->INSTstr;
-    c = getColor( str + 7 ); // Colour
+    c = getRuleColor( rules, str + 7 ); // Colour
     wxColour color( c->R, c->G, c->B );
     w = atoi( str + 5 ); // Width
 
@@ -3963,7 +4253,7 @@ int s52plib::RenderLSPlugIn( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
     int w;
     
     char *str = (char*) rules->INSTstr;
-    c = getColor( str + 7 ); // Colour
+    c = getRuleColor( rules, str + 7 ); // Colour
     wxColour color( c->R, c->G, c->B );
     w = atoi( str + 5 ); // Width
     
@@ -4161,6 +4451,11 @@ int s52plib::RenderLSPlugIn( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 // Line Complex
 int s52plib::RenderLC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_LINES );
+
+    if( m_bGLBatch )                // drawn at once, after anything batched so far
+        FlushGLBatch( vp );
+
     //     if(rzRules->obj->Index != 7574)
     //         return 0;
     
@@ -4909,6 +5204,11 @@ next_seg:
 // Multipoint Sounding
 int s52plib::RenderMPS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_SYMBOLS );
+
+    if( m_bGLBatch )                // drawn at once, after anything batched so far
+        FlushGLBatch( vp );
+
     if( !m_bShowSoundg )
         return 0;
 
@@ -5032,6 +5332,11 @@ int s52plib::RenderMPS( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 
 int s52plib::RenderCARC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_SYMBOLS );
+
+    if( m_bGLBatch )                // drawn at once, after anything batched so far
+        FlushGLBatch( vp );
+
     return RenderCARC_VBO(rzRules, rules, vp);
 }
     
@@ -5764,6 +6069,161 @@ int s52plib::DoRenderObjectTextOnly( wxDC *pdcin, ObjRazRules *rzRules, ViewPort
     return 1;
 }
 
+//  The render command of an object for the current plib state: its rules with the
+//  conditional symbology expanded, once the display category and noshow filters let it show.
+//  The CS is evaluated first, since it may move the object to another display category.
+//  Soundings rebuild their CS rules on each render, so are left to DoRenderObject().
+int s52plib::ResolveRenderCommand( ObjRazRules *rzRules, std::vector<Rules *> &rules_out )
+{
+    if( !rzRules->obj || !rzRules->LUP )
+        return S52_CMD_HIDDEN;
+
+    if( !strncmp( rzRules->obj->FeatureName, "SOUNDG", 6 ) )
+        return S52_CMD_DYNAMIC;
+
+    if( IsObjNoshow( rzRules->LUP->OBCL ) )
+        return S52_CMD_HIDDEN;
+
+    Rules *rules = rzRules->LUP->ruleList;
+    while( rules != NULL ) {
+        if( RUL_CND_SY == rules->ruleType ) {
+            if( !rzRules->obj->bCS_Added ) {
+                rzRules->obj->CSrules = NULL;
+                GetAndAddCSRules( rzRules, rules );
+                rzRules->obj->bCS_Added = 1; // mark the object
+            }
+            break;
+        }
+        rules = rules->next;
+    }
+
+    int filter = ObjectCategoryFilter( rzRules );
+    if( filter == S52_CMD_HIDDEN )
+        return filter;
+
+    //  As DoRenderObject() walks them: the rules of a non-empty CS replace the
+    //  CS rule, and end the list
+    rules = rzRules->LUP->ruleList;
+    while( rules != NULL ) {
+        if( RUL_CND_SY == rules->ruleType ) {
+            if( rzRules->obj->CSrules ) {
+                for( Rules *cs = rzRules->obj->CSrules; cs; cs = cs->next )
+                    if( cs->ruleType != RUL_NONE )
+                        rules_out.push_back( cs );
+                break;
+            }
+        }
+        else if( rules->ruleType != RUL_NONE )
+            rules_out.push_back( rules );
+
+        rules = rules->next;
+    }
+
+    return filter;
+}
+
+int s52plib::RenderCommandToDC( wxDC *pdcin, const S52RenderCommand &cmd, ViewPort *vp, int pass )
+{
+    if( cmd.filter == S52_CMD_DYNAMIC ) {
+        if( pass == S52_PASS_TEXT )
+            return DoRenderObjectTextOnly( pdcin, cmd.rzRules, vp );
+        return DoRenderObject( pdcin, cmd.rzRules, vp );
+    }
+
+    return DoRenderCommand( pdcin, cmd, vp, pass );
+}
+
+#ifdef ocpnUSE_GL
+int s52plib::RenderCommandToGL( const wxGLContext &glcc, const S52RenderCommand &cmd, ViewPort *vp, int pass )
+{
+    m_glcc = (wxGLContext *) &glcc;
+
+    if( cmd.filter == S52_CMD_DYNAMIC ) {
+        if( pass == S52_PASS_AREA )
+            return RenderAreaToGL( glcc, cmd.rzRules, vp );
+        if( pass == S52_PASS_TEXT )
+            return DoRenderObjectTextOnly( NULL, cmd.rzRules, vp );
+        return DoRenderObject( NULL, cmd.rzRules, vp );
+    }
+
+    return DoRenderCommand( NULL, cmd, vp, pass );
+}
+#endif
+
+//  Draw a resolved render command.  Only the checks that depend on the view are left.
+int s52plib::DoRenderCommand( wxDC *pdcin, const S52RenderCommand &cmd, ViewPort *vp, int pass )
+{
+    ObjRazRules *rzRules = cmd.rzRules;
+
+    if( !ObjectRenderCheckPos( rzRules, vp ) )
+        return 0;
+
+    g_scaminScale = 1.0;
+    if( ( cmd.filter == S52_CMD_SCAMIN ) && !ObjectRenderCheckScamin( rzRules, vp ) )
+        return 0;
+
+    m_pdc = pdcin; // use this DC
+
+    for( int i = 0; i < cmd.nrules; i++ ) {
+        Rules *rules = cmd.rules[i];
+
+        if( pass == S52_PASS_AREA ) {
+#ifdef ocpnUSE_GL
+            switch( rules->ruleType ){
+                case RUL_ARE_CO:
+                    RenderToGLAC( rzRules, rules, vp );
+                    break; // AC
+                case RUL_ARE_PA:
+                    RenderToGLAP( rzRules, rules, vp );
+                    break; // AP
+                default:
+                    break;
+            }
+#endif
+            continue;
+        }
+
+        switch( rules->ruleType ){
+            case RUL_TXT_TX:
+                RenderTX( rzRules, rules, vp );
+                break; // TX
+            case RUL_TXT_TE:
+                RenderTE( rzRules, rules, vp );
+                break; // TE
+            default:
+                break;
+        }
+
+        if( pass == S52_PASS_TEXT )
+            continue;
+
+        switch( rules->ruleType ){
+            case RUL_SYM_PT:
+                RenderSY( rzRules, rules, vp );
+                break; // SY
+            case RUL_SIM_LN:
+                if(m_pdc)
+                    RenderLS( rzRules, rules, vp );
+                else
+                    RenderGLLS( rzRules, rules, vp );
+                break; // LS
+            case RUL_COM_LN:
+                RenderLC( rzRules, rules, vp );
+                break; // LC
+            case RUL_MUL_SG:
+                RenderMPS( rzRules, rules, vp );
+                break; // MultiPoint Sounding
+            case RUL_ARC_2C:
+                RenderCARC( rzRules, rules, vp );
+                break; // Circular Arc, 2 colors
+            default:
+                break;
+        }
+    }
+
+    return 1;
+}
+
 bool s52plib::PreloadOBJLFromCSV(const wxString &csv_file)
 {
     wxTextFile file( csv_file );
@@ -6178,6 +6638,8 @@ bool s52plib::inter_tri_rect( wxPoint *ptp, render_canvas_parms *pb_spec )
 //              Render triangle
 //
 //----------------------------------------------------------------------------------
+#define DDA_MAX_ROW     1500            // scan converters ignore rows below this
+#define DDA_EDGE_ROWS   2000
 int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
         render_canvas_parms *pPatt_spec )
 {
@@ -6187,6 +6649,13 @@ int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
 
     if( !inter_tri_rect( ptp, pb_spec ) ) return 0;
 
+    //      The edge arrays are local, so that the bands of one buffer may be
+    //      scan converted concurrently.  Only the rows of pb_spec are needed.
+    int ledge[DDA_EDGE_ROWS];
+    int redge[DDA_EDGE_ROWS];
+    int yrow0 = wxMax( 0, pb_spec->y );
+    int yrow1 = wxMin( DDA_MAX_ROW, pb_spec->y + pb_spec->height + 1 );
+
     if( NULL != c ) {
         if(pb_spec->b_revrgb) {
             r = c->R;
@@ -6256,7 +6725,7 @@ int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
             x = xmin << 8;
 
             for( count = ymin; count <= ymax; count++ ) {
-                if( ( count >= 0 ) && ( count < 1500 ) ) ledge[count] = x >> 8;
+                if( ( count >= yrow0 ) && ( count < yrow1 ) ) ledge[count] = x >> 8;
                 x += m;
             }
         }
@@ -6269,7 +6738,7 @@ int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
             x = xmin << 8;
 
             for( count = ymin; count <= ymid; count++ ) {
-                if( ( count >= 0 ) && ( count < 1500 ) ) redge[count] = x >> 8;
+                if( ( count >= yrow0 ) && ( count < yrow1 ) ) redge[count] = x >> 8;
                 x += m;
             }
         }
@@ -6282,7 +6751,7 @@ int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
             x = xmid << 8;
 
             for( count = ymid; count <= ymax; count++ ) {
-                if( ( count >= 0 ) && ( count < 1500 ) ) redge[count] = x >> 8;
+                if( ( count >= yrow0 ) && ( count < yrow1 ) ) redge[count] = x >> 8;
                 x += m;
             }
         }
@@ -6304,7 +6773,7 @@ int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
             x = xmin << 16;
 
             for( count = ymin; count <= ymax; count++ ) {
-                if( ( count >= 0 ) && ( count < 1500 ) ) ledge[count] = x >> 16;
+                if( ( count >= yrow0 ) && ( count < yrow1 ) ) ledge[count] = x >> 16;
                 x += m;
             }
         }
@@ -6317,7 +6786,7 @@ int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
             x = xmin << 16;
 
             for( count = ymin; count <= ymid; count++ ) {
-                if( ( count >= 0 ) && ( count < 1500 ) ) redge[count] = x >> 16;
+                if( ( count >= yrow0 ) && ( count < yrow1 ) ) redge[count] = x >> 16;
                 x += m;
             }
         }
@@ -6330,7 +6799,7 @@ int s52plib::dda_tri( wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
             x = xmid << 16;
 
             for( count = ymid; count <= ymax; count++ ) {
-                if( ( count >= 0 ) && ( count < 1500 ) ) redge[count] = x >> 16;
+                if( ( count >= yrow0 ) && ( count < yrow1 ) ) redge[count] = x >> 16;
                 x += m;
             }
         }
@@ -6598,13 +7067,7 @@ __asm__ __volatile__ ( \
                     }
 
                     else // No Pattern
-                    {
-                        int *pxi = (int *) px;
-                        while( ix <= ixm ) {
-                            *pxi++ = color_int;
-                            ix++;
-                        }
-                    }
+                        std::fill_n( (int *) px, ixm - ix + 1, color_int );
                 }
             }
         }
@@ -6622,6 +7085,8 @@ inline int s52plib::dda_trap( wxPoint *segs, int lseg, int rseg, int ytop, int y
         render_canvas_parms *pb_spec, render_canvas_parms *pPatt_spec )
 {
     unsigned char r = 0, g = 0, b = 0;
+    int ledge[DDA_EDGE_ROWS];
+    int redge[DDA_EDGE_ROWS];
 
     if( NULL != c ) {
         if(pb_spec->b_revrgb) {
@@ -6673,7 +7138,7 @@ inline int s52plib::dda_trap( wxPoint *segs, int lseg, int rseg, int ytop, int y
     }
 
     int y_dda_limit = wxMin ( ybot, ymax );
-    y_dda_limit = wxMin ( y_dda_limit, 1499 ); // don't overrun edge array
+    y_dda_limit = wxMin ( y_dda_limit, DDA_MAX_ROW - 1 ); // don't overrun edge array
 
     //    Some peephole optimization:
     //    if xmax and xmin are both < 0, arrange to simply fill the ledge array with 0
@@ -6752,7 +7217,7 @@ inline int s52plib::dda_trap( wxPoint *segs, int lseg, int rseg, int ytop, int y
         }
 
     y_dda_limit = wxMin ( ybot, ymax );
-    y_dda_limit = wxMin ( y_dda_limit, 1499 ); // don't overrun edge array
+    y_dda_limit = wxMin ( y_dda_limit, DDA_MAX_ROW - 1 ); // don't overrun edge array
 
     dy = ( ymax - ymin );
     if( dy ) {
@@ -7011,13 +7476,7 @@ inline int s52plib::dda_trap( wxPoint *segs, int lseg, int rseg, int ytop, int y
                     }
 
                     else // No Pattern
-                    {
-                        int *pxi = (int *) px;
-                        while( ix <= ixm ) {
-                            *pxi++ = color_int;
-                            ix++;
-                        }
-                    }
+                        std::fill_n( (int *) px, ixm - ix + 1, color_int );
 
                 }
             }
@@ -7027,32 +7486,19 @@ inline int s52plib::dda_trap( wxPoint *segs, int lseg, int rseg, int ytop, int y
     return ret_val;
 }
 
-void s52plib::RenderToBufferFilledPolygon( ObjRazRules *rzRules, S57Obj *obj, S52color *c,
-                                           render_canvas_parms *pb_spec, render_canvas_parms *pPatt_spec, ViewPort *vp )
+//      Scan convert one area fill into pb_spec.
+//      Tesselation must already be complete; this runs on the band threads.
+void s52plib::RenderToBufferFilledPolygon( const S52BufferFill &fill, const LLBBox &BBView,
+                                           render_canvas_parms *pb_spec, ViewPort *vp )
 {
-//    LLBBox BBView = vp->GetBBox();
-        LLBBox BBView = vp->GetBBox();
-    // please untangle this logic with the logic below
-    if(BBView.GetMaxLon()+180 < vp->clon)
-        BBView.Set(BBView.GetMinLat(), BBView.GetMinLon() + 360,
-                   BBView.GetMaxLat(), BBView.GetMaxLon() + 360);
-    else if(BBView.GetMinLon()-180 > vp->clon)
-        BBView.Set(BBView.GetMinLat(), BBView.GetMinLon() - 360,
-                   BBView.GetMaxLat(), BBView.GetMaxLon() - 360);
+    ObjRazRules *rzRules = fill.rzRules;
+    S57Obj *obj = rzRules->obj;
 
+    S52color cp = fill.color;
+    render_canvas_parms patt = fill.patt;
+    render_canvas_parms *pPatt_spec = fill.b_pattern ? &patt : NULL;
 
-    S52color cp;
-    if( NULL != c ) {
-        cp.R = c->R;
-        cp.G = c->G;
-        cp.B = c->B;
-    }
-
-    if( obj->pPolyTessGeo ) {
-        if( !rzRules->obj->pPolyTessGeo->IsOk() ){ // perform deferred tesselation
-            rzRules->obj->pPolyTessGeo->BuildDeferredTess();
-        }
-
+    if( obj->pPolyTessGeo && obj->pPolyTessGeo->IsOk() ) {
         wxPoint *pp3 = (wxPoint *) malloc( 3 * sizeof(wxPoint) );
         wxPoint *ptp = (wxPoint *) malloc(
                 ( obj->pPolyTessGeo->GetnVertexMax() + 1 ) * sizeof(wxPoint) );
@@ -7083,7 +7529,7 @@ void s52plib::RenderToBufferFilledPolygon( ObjRazRules *rzRules, S57Obj *obj, S5
                     for( int iv = 0; iv < p_tp->nVert; iv++ ) {
                         double lon = *pvert_list++;
                         double lat = *pvert_list++;
-                        GetPointPixSingle( rzRules, lat, lon, pr, vp );
+                        GetPointPixSingle( rzRules, lat, lon, pr, vp, fill.x_origin_shift );
 
                         pr++;
                     }
@@ -7094,7 +7540,7 @@ void s52plib::RenderToBufferFilledPolygon( ObjRazRules *rzRules, S57Obj *obj, S5
                     for( int iv = 0; iv < p_tp->nVert; iv++ ) {
                         double lon = *pvert_list++;
                         double lat = *pvert_list++;
-                        GetPointPixSingle( rzRules, lat, lon, pr, vp );
+                        GetPointPixSingle( rzRules, lat, lon, pr, vp, fill.x_origin_shift );
                         
                         pr++;
                     }
@@ -7166,13 +7612,40 @@ void s52plib::RenderToBufferFilledPolygon( ObjRazRules *rzRules, S57Obj *obj, S5
     } // if pPolyTessGeo
 }
 
+//      cm93 objects may need their coordinates translated by 360 degrees to
+//      conform to the viewport
+static float GetGLAreaXOrigin( ObjRazRules *rzRules, const LLBBox &BBView )
+{
+    float x_origin = rzRules->obj->x_origin;
+
+    if(rzRules->obj->m_chart_context->chart) {          // not a PlugIn Chart
+        if( ( (int)rzRules->obj->auxParm3 == (int)PI_CHART_TYPE_CM93 )
+            || ( (int)rzRules->obj->auxParm3 == (int)PI_CHART_TYPE_CM93COMP ) )
+        {
+            if( BBView.GetMaxLon() >= 180. ) {
+                if(rzRules->obj->BBObj.GetMinLon() < BBView.GetMaxLon() - 360.)
+                    x_origin += (float)(mercator_k0 * WGS84_semimajor_axis_meters * 2.0 * PI);
+            }
+            else
+            if( (BBView.GetMinLon() <= -180. && rzRules->obj->BBObj.GetMaxLon() > BBView.GetMinLon() + 360.)
+            || (rzRules->obj->BBObj.GetMaxLon() > 180 && BBView.GetMinLon() + 360 < rzRules->obj->BBObj.GetMaxLon() )
+            )
+            x_origin -= (float)(mercator_k0 * WGS84_semimajor_axis_meters * 2.0 * PI);
+        }
+    }
+
+    return x_origin;
+}
+
 int s52plib::RenderToGLAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_AREAS );
+
 #ifdef ocpnUSE_GL    
     S52color *c;
     char *str = (char*) rules->INSTstr;
 
-    c = getColor( str );
+    c = getRuleColor( rules, str );
 
     glColor3ub( c->R, c->G, c->B );
 
@@ -7191,6 +7664,18 @@ int s52plib::RenderToGLAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
     BBView.EnLarge( margin );
 
     bool b_useVBO = m_useVBO && !rzRules->obj->auxParm1 && vp->m_projection_type == PROJECTION_MERCATOR;
+
+    //  While batching, areas are gathered by colour.  Objects with their own VBO
+    //  keep their vertices there, and add only the indices of the visible triangles.
+    if( m_bGLBatch && rzRules->obj->pPolyTessGeo
+        && vp->m_projection_type == PROJECTION_MERCATOR
+        && rzRules->obj->m_chart_context->chart ) {
+        if( b_useVBO ? AddGLAreaVBOBatch( rzRules, c, BBView ) : AddGLAreaBatch( rzRules, c, BBView ) )
+            return 1;
+    }
+
+    if( m_bGLBatch )
+        FlushGLBatch( vp );
     
     if( rzRules->obj->pPolyTessGeo ) {
         
@@ -7209,25 +7694,7 @@ int s52plib::RenderToGLAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
             glScalef( vp->view_scale_ppm, -vp->view_scale_ppm, 0 );
             glTranslatef( -rzRules->sm_transform_parms->easting_vp_center, -rzRules->sm_transform_parms->northing_vp_center, 0 );
             //  Next, the per-object transform
-
-            float x_origin = rzRules->obj->x_origin;
-            
-            if(rzRules->obj->m_chart_context->chart) {          // not a PlugIn Chart
-                if( ( (int)rzRules->obj->auxParm3 == (int)PI_CHART_TYPE_CM93 )
-                    || ( (int)rzRules->obj->auxParm3 == (int)PI_CHART_TYPE_CM93COMP ) )
-                {
-                    //      We may need to translate object coordinates by 360 degrees to conform.
-                    if( BBView.GetMaxLon() >= 180. ) {
-                        if(rzRules->obj->BBObj.GetMinLon() < BBView.GetMaxLon() - 360.)
-                            x_origin += (float)(mercator_k0 * WGS84_semimajor_axis_meters * 2.0 * PI);
-                    }
-                    else
-                    if( (BBView.GetMinLon() <= -180. && rzRules->obj->BBObj.GetMaxLon() > BBView.GetMinLon() + 360.)
-                    || (rzRules->obj->BBObj.GetMaxLon() > 180 && BBView.GetMinLon() + 360 < rzRules->obj->BBObj.GetMaxLon() )
-                    )
-                    x_origin -= (float)(mercator_k0 * WGS84_semimajor_axis_meters * 2.0 * PI);
-                }
-            }
+            float x_origin = GetGLAreaXOrigin( rzRules, BBView );
             
             glTranslatef( x_origin, rzRules->obj->y_origin, 0);
             glScalef( rzRules->obj->x_rate, rzRules->obj->y_rate, 0 );
@@ -7443,6 +7910,361 @@ int s52plib::RenderToGLAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
     return 1;
 }
 
+static inline void GetTriPrimVertex( TriPrim *p_tp, bool b_double, int k, double &x, double &y )
+{
+    if( b_double ) {
+        x = p_tp->p_vertex[2 * k];
+        y = p_tp->p_vertex[2 * k + 1];
+    } else {
+        float *pf = (float *)p_tp->p_vertex;
+        x = pf[2 * k];
+        y = pf[2 * k + 1];
+    }
+}
+
+S52GLAreaBatch *s52plib::GetGLAreaBatch( S52color *c, sm_parms *sm )
+{
+    for( size_t i = 0; i < m_area_batches.size(); i++ ) {
+        S52GLAreaBatch &b = m_area_batches[i];
+        if( b.R == c->R && b.G == c->G && b.B == c->B
+            && b.easting_vp_center == sm->easting_vp_center
+            && b.northing_vp_center == sm->northing_vp_center )
+            return &b;
+    }
+
+    m_area_batches.push_back( S52GLAreaBatch() );
+    S52GLAreaBatch *batch = &m_area_batches.back();
+    batch->R = c->R; batch->G = c->G; batch->B = c->B;
+    batch->easting_vp_center = sm->easting_vp_center;
+    batch->northing_vp_center = sm->northing_vp_center;
+    return batch;
+}
+
+//      Append the visible triangles of an area object to the batch for its colour,
+//      transformed to SM meters relative to the viewport center.
+//      Returns false if the object must be drawn directly.
+bool s52plib::AddGLAreaBatch( ObjRazRules *rzRules, S52color *c, const LLBBox &BBView )
+{
+#ifdef ocpnUSE_GL
+    S57Obj *obj = rzRules->obj;
+
+    if( !obj->pPolyTessGeo->IsOk() )
+        obj->pPolyTessGeo->BuildDeferredTess();
+
+    PolyTriGroup *ppg = obj->pPolyTessGeo->Get_PolyTriGroup_head();
+    if( !ppg )
+        return false;
+
+    for( TriPrim *p_tp = ppg->tri_prim_head; p_tp; p_tp = p_tp->p_next ) {
+        if( p_tp->type != GL_TRIANGLES && p_tp->type != GL_TRIANGLE_STRIP
+            && p_tp->type != GL_TRIANGLE_FAN )
+            return false;
+    }
+
+    sm_parms *sm = rzRules->sm_transform_parms;
+    S52GLAreaBatch *batch = GetGLAreaBatch( c, sm );
+
+    bool b_double = ( ppg->data_type == DATA_TYPE_DOUBLE );
+    double x_origin = GetGLAreaXOrigin( rzRules, BBView ) - sm->easting_vp_center;
+    double y_origin = obj->y_origin - sm->northing_vp_center;
+    std::vector<float> &v = batch->vertices;
+
+    for( TriPrim *p_tp = ppg->tri_prim_head; p_tp; p_tp = p_tp->p_next ) {
+        if( BBView.IntersectOut( p_tp->tri_box ) )
+            continue;
+
+        //  Fans and strips are unrolled into a plain triangle list
+        int n = p_tp->nVert;
+        int ntri = ( p_tp->type == GL_TRIANGLES ) ? n / 3 : wxMax( 0, n - 2 );
+        for( int t = 0; t < ntri; t++ ) {
+            int k[3];
+            if( p_tp->type == GL_TRIANGLES ) {
+                k[0] = 3 * t; k[1] = 3 * t + 1; k[2] = 3 * t + 2;
+            } else if( p_tp->type == GL_TRIANGLE_STRIP ) {
+                k[0] = t; k[1] = t + 1; k[2] = t + 2;
+            } else {
+                k[0] = 0; k[1] = t + 1; k[2] = t + 2;
+            }
+            for( int j = 0; j < 3; j++ ) {
+                double x, y;
+                GetTriPrimVertex( p_tp, b_double, k[j], x, y );
+                v.push_back( x_origin + obj->x_rate * x );
+                v.push_back( y_origin + obj->y_rate * y );
+            }
+        }
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+//      Append the visible triangles of an area object with a resident VBO to the
+//      batch for its colour, as indices into that VBO.
+//      Returns false if the object must be drawn directly, as when its VBO is
+//      not built yet, which RenderToGLAC() does on the first draw.
+bool s52plib::AddGLAreaVBOBatch( ObjRazRules *rzRules, S52color *c, const LLBBox &BBView )
+{
+#if defined(ocpnUSE_GL) && !defined(ocpnUSE_GLES)     // GLES has no GL_UNSIGNED_INT indices
+    S57Obj *obj = rzRules->obj;
+    if( obj->auxParm0 <= 0 )
+        return false;
+
+    PolyTriGroup *ppg = obj->pPolyTessGeo->Get_PolyTriGroup_head();
+    if( !ppg || !ppg->bsingle_alloc || ppg->data_type != DATA_TYPE_FLOAT )
+        return false;
+
+    for( TriPrim *p_tp = ppg->tri_prim_head; p_tp; p_tp = p_tp->p_next ) {
+        if( p_tp->type != GL_TRIANGLES && p_tp->type != GL_TRIANGLE_STRIP
+            && p_tp->type != GL_TRIANGLE_FAN )
+            return false;
+    }
+
+    S52GLAreaBatch *batch = GetGLAreaBatch( c, rzRules->sm_transform_parms );
+    std::vector<unsigned int> &v = batch->vbo_indices;
+    size_t first = v.size();
+
+    //  The primitives follow each other in the VBO
+    unsigned int base = 0;
+    for( TriPrim *p_tp = ppg->tri_prim_head; p_tp; p_tp = p_tp->p_next ) {
+        int n = p_tp->nVert;
+        if( !BBView.IntersectOut( p_tp->tri_box ) ) {
+            int ntri = ( p_tp->type == GL_TRIANGLES ) ? n / 3 : wxMax( 0, n - 2 );
+            for( int t = 0; t < ntri; t++ ) {
+                if( p_tp->type == GL_TRIANGLES ) {
+                    v.push_back( base + 3 * t ); v.push_back( base + 3 * t + 1 ); v.push_back( base + 3 * t + 2 );
+                } else if( p_tp->type == GL_TRIANGLE_STRIP ) {
+                    v.push_back( base + t ); v.push_back( base + t + 1 ); v.push_back( base + t + 2 );
+                } else {
+                    v.push_back( base ); v.push_back( base + t + 1 ); v.push_back( base + t + 2 );
+                }
+            }
+        }
+        base += n;
+    }
+
+    if( v.size() > first ) {
+        S52GLAreaVBORange range;
+        range.vbo = obj->auxParm0;
+        range.x_origin = GetGLAreaXOrigin( rzRules, BBView );
+        range.y_origin = obj->y_origin;
+        range.x_rate = obj->x_rate;
+        range.y_rate = obj->y_rate;
+        range.first = first;
+        range.count = v.size() - first;
+        batch->vbo_ranges.push_back( range );
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+//      Symbols are batched as screen space triangles, using the same transform
+//      as the immediate path in RenderRasterSymbol():
+//      translate(r), rotate(-vp->rotation), translate(-pivot), scale
+void s52plib::AddGLSymbolBatch( unsigned int texture, const wxRect &texrect, const wxPoint &r,
+                                int pivot_x, int pivot_y, double scale_factor, ViewPort *vp )
+{
+#ifdef ocpnUSE_GL
+    extern GLenum       g_texture_rectangle_format;
+
+    float w = texrect.width, h = texrect.height;
+    float tx1 = texrect.x, ty1 = texrect.y;
+    float tx2 = tx1 + w, ty2 = ty1 + h;
+    if(g_texture_rectangle_format == GL_TEXTURE_2D) {
+        wxSize size = ChartSymbols::GLTextureSize();
+        tx1 /= size.x, tx2 /= size.x;
+        ty1 /= size.y, ty2 /= size.y;
+    }
+
+    float cr = 1, sr = 0;
+    if(fabs( vp->rotation ) > .01){
+        cr = cosf( vp->rotation );
+        sr = sinf( vp->rotation );
+    }
+
+    float corner[4][4] = { { 0, 0, tx1, ty1 }, { w, 0, tx2, ty1 },
+                           { w, h, tx2, ty2 }, { 0, h, tx1, ty2 } };
+    float xy[4][2];
+    for( int i = 0; i < 4; i++ ) {
+        float x = corner[i][0] * scale_factor - pivot_x;
+        float y = corner[i][1] * scale_factor - pivot_y;
+        xy[i][0] = r.x + x * cr + y * sr;
+        xy[i][1] = r.y - x * sr + y * cr;
+    }
+
+    S52GLSymbolBatch *batch = NULL;
+    for( size_t i = 0; i < m_symbol_batches.size(); i++ ) {
+        if( m_symbol_batches[i].texture == texture ) {
+            batch = &m_symbol_batches[i];
+            break;
+        }
+    }
+    if( !batch ) {
+        m_symbol_batches.push_back( S52GLSymbolBatch() );
+        batch = &m_symbol_batches.back();
+        batch->texture = texture;
+    }
+
+    static const int quad_tris[6] = { 0, 1, 2, 0, 2, 3 };
+    for( int i = 0; i < 6; i++ ) {
+        int k = quad_tris[i];
+        batch->vertices.push_back( xy[k][0] );
+        batch->vertices.push_back( xy[k][1] );
+        batch->vertices.push_back( corner[k][2] );
+        batch->vertices.push_back( corner[k][3] );
+    }
+#endif
+}
+
+//      Start accumulating GL geometry instead of drawing it per object.
+//      The caller must flush at least at every display priority change,
+//      and end the batch before any other GL rendering.
+//      Geometry drawn immediately while the batch is open flushes it first,
+//      so the S52 draw order within a priority is kept.
+void s52plib::BeginGLBatch( void )
+{
+    m_bGLBatch = true;
+}
+
+void s52plib::EndGLBatch( ViewPort *vp )
+{
+    FlushGLBatch( vp );
+    m_bGLBatch = false;
+}
+
+void s52plib::FlushGLBatch( ViewPort *vp )
+{
+#ifdef ocpnUSE_GL
+    //  Areas
+    if( m_area_batches.size() ) {
+        glEnableClientState(GL_VERTEX_ARRAY);
+        for( size_t i = 0; i < m_area_batches.size(); i++ ) {
+            S52GLAreaBatch &b = m_area_batches[i];
+            glColor3ub( b.R, b.G, b.B );
+
+            if( !b.vertices.empty() ) {
+                glPushMatrix();
+                glTranslatef( vp->pix_width / 2, vp->pix_height/2, 0 );
+                glScalef( vp->view_scale_ppm, -vp->view_scale_ppm, 0 );
+                glVertexPointer(2, GL_FLOAT, 2 * sizeof(float), &b.vertices[0]);
+                glDrawArrays(GL_TRIANGLES, 0, b.vertices.size() / 2);
+                glPopMatrix();
+            }
+
+#ifndef ocpnUSE_GLES
+            //  One draw per object VBO, with the transform of RenderToGLAC()
+            for( size_t j = 0; j < b.vbo_ranges.size(); j++ ) {
+                S52GLAreaVBORange &r = b.vbo_ranges[j];
+                glPushMatrix();
+                glTranslatef( vp->pix_width / 2, vp->pix_height/2, 0 );
+                glScalef( vp->view_scale_ppm, -vp->view_scale_ppm, 0 );
+                glTranslatef( -b.easting_vp_center, -b.northing_vp_center, 0 );
+                glTranslatef( r.x_origin, r.y_origin, 0);
+                glScalef( r.x_rate, r.y_rate, 0 );
+                (s_glBindBuffer)(GL_ARRAY_BUFFER, r.vbo);
+                glVertexPointer(2, GL_FLOAT, 2 * sizeof(float), 0);
+                glDrawElements(GL_TRIANGLES, r.count, GL_UNSIGNED_INT, &b.vbo_indices[r.first]);
+                glPopMatrix();
+            }
+            if( b.vbo_ranges.size() )
+                (s_glBindBuffer)(GL_ARRAY_BUFFER_ARB, 0);
+#endif
+        }
+        glDisableClientState(GL_VERTEX_ARRAY);
+        m_area_batches.clear();
+    }
+
+#ifndef ocpnUSE_GLES
+    //  Lines
+    if( m_line_batches.size() ) {
+        glDisable( GL_LINE_STIPPLE );
+        glEnableClientState(GL_VERTEX_ARRAY);
+        for( size_t i = 0; i < m_line_batches.size(); i++ ) {
+            S52GLLineBatch &b = m_line_batches[i];
+            if( b.indices.empty() )
+                continue;
+
+            glColor3ub( b.R, b.G, b.B );
+            glLineWidth( b.line_width );
+            if( b.b_smooth ) {
+                glEnable( GL_LINE_SMOOTH );
+                glEnable( GL_BLEND );
+            } else {
+                glDisable( GL_LINE_SMOOTH );
+                glDisable( GL_BLEND );
+            }
+
+            glPushMatrix();
+            glTranslatef( vp->pix_width / 2, vp->pix_height/2, 0 );
+            glScalef( vp->view_scale_ppm, -vp->view_scale_ppm, 0 );
+            glTranslatef( -b.easting_vp_center, -b.northing_vp_center, 0 );
+            glTranslatef( b.x_origin, b.y_origin, 0);
+            glScalef( b.x_rate, b.y_rate, 0 );
+
+            if( b.vbo ) {
+                (s_glBindBuffer)(GL_ARRAY_BUFFER, b.vbo);
+                glVertexPointer(2, GL_FLOAT, 2 * sizeof(float), 0);
+            }
+            else
+                glVertexPointer(2, GL_FLOAT, 2 * sizeof(float), b.vertex_buffer);
+
+            if( b.stipple ) {
+                //  One draw per strip, so that each starts the pattern afresh
+                glLineStipple( 1, b.stipple );
+                glEnable( GL_LINE_STIPPLE );
+                for( size_t j = 0; j < b.strips.size(); j++ ) {
+                    size_t end = ( j + 1 < b.strips.size() ) ? b.strips[j + 1] : b.indices.size();
+                    glDrawElements(GL_LINE_STRIP, end - b.strips[j], GL_UNSIGNED_INT, &b.indices[b.strips[j]]);
+                }
+                glDisable( GL_LINE_STIPPLE );
+            }
+            else
+                glDrawElements(GL_LINES, b.indices.size(), GL_UNSIGNED_INT, &b.indices[0]);
+
+            if( b.vbo )
+                (s_glBindBuffer)(GL_ARRAY_BUFFER_ARB, 0);
+
+            glPopMatrix();
+        }
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glDisable( GL_LINE_SMOOTH );
+        glDisable( GL_BLEND );
+        m_line_batches.clear();
+    }
+#endif
+
+    //  Symbols
+    if( m_symbol_batches.size() ) {
+        extern GLenum       g_texture_rectangle_format;
+
+        glEnable( GL_BLEND );
+        glEnable( g_texture_rectangle_format );
+        glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        for( size_t i = 0; i < m_symbol_batches.size(); i++ ) {
+            S52GLSymbolBatch &b = m_symbol_batches[i];
+            if( b.vertices.empty() )
+                continue;
+
+            glBindTexture( g_texture_rectangle_format, b.texture );
+            glVertexPointer(2, GL_FLOAT, 4 * sizeof(float), &b.vertices[0]);
+            glTexCoordPointer(2, GL_FLOAT, 4 * sizeof(float), &b.vertices[2]);
+            glDrawArrays(GL_TRIANGLES, 0, b.vertices.size() / 4);
+        }
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glDisable( g_texture_rectangle_format );
+        glDisable( GL_BLEND );
+        m_symbol_batches.clear();
+    }
+#endif
+}
+
 void s52plib::SetGLClipRect(const ViewPort &vp, const wxRect &rect)
 {
     bool b_clear = false;
@@ -7559,10 +8381,16 @@ void RotateToViewPort(const ViewPort &vp)
 
 int s52plib::RenderToGLAP( ObjRazRules *rzRules, Rules *rules, ViewPort *vp )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_AREAS );
+
 #ifdef ocpnUSE_GL
     if( rules->razRule == NULL )
         return 0;
 
+    //  Patterns overlay the colour fill of their area, so batched fills go first
+    if( m_bGLBatch )
+        FlushGLBatch( vp );
+
     int obj_xmin = 10000;
     int obj_xmax = -10000;
     int obj_ymin = 10000;
@@ -8265,8 +9093,10 @@ render_canvas_parms* s52plib::CreatePatternBufferSpec( ObjRazRules *rzRules, Rul
 
 
 int s52plib::RenderToBufferAP( ObjRazRules *rzRules, Rules *rules, ViewPort *vp,
-        render_canvas_parms *pb_spec )
+        std::vector<S52BufferFill> &fills )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_AREAS );
+
     if(vp->m_projection_type != PROJECTION_MERCATOR)
         return 1;
 
@@ -8287,34 +9117,49 @@ int s52plib::RenderToBufferAP( ObjRazRules *rzRules, Rules *rules, ViewPort *vp,
 
     } // Instantiation done
 
-    //  Render the Area using the pattern spec stored in the rules
-    render_canvas_parms *ppatt_spec = (render_canvas_parms *) rules->razRule->pixelPtr;
-
-    //  Set the pattern reference point
+    //  Fill the Area using a copy of the pattern spec stored in the rules,
+    //  carrying this object's pattern reference point
+    S52BufferFill fill;
+    fill.rzRules = rzRules;
+    fill.color.R = fill.color.G = fill.color.B = 0;
+    fill.b_pattern = true;
+    fill.patt = *( (render_canvas_parms *) rules->razRule->pixelPtr );
+    fill.x_origin_shift = 0.;
 
     wxPoint r;
     GetPointPixSingle( rzRules, rzRules->obj->y, rzRules->obj->x, &r, vp );
 
-    ppatt_spec->x = r.x - 2000000; // bias way down to avoid zero-crossing logic in dda
-    ppatt_spec->y = r.y - 2000000;
+    fill.patt.x = r.x - 2000000; // bias way down to avoid zero-crossing logic in dda
+    fill.patt.y = r.y - 2000000;
 
-    RenderToBufferFilledPolygon( rzRules, rzRules->obj, NULL, pb_spec, ppatt_spec, vp );
+    fills.push_back( fill );
 
     return 1;
 }
 
 int s52plib::RenderToBufferAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp,
-        render_canvas_parms *pb_spec )
+        std::vector<S52BufferFill> &fills )
 {
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_AREAS );
+
     if(vp->m_projection_type != PROJECTION_MERCATOR)
         return 1;
 
     S52color *c;
     char *str = (char*) rules->INSTstr;
 
-    c = getColor( str );
+    c = getRuleColor( rules, str );
+
+    S52BufferFill fill;
+    fill.rzRules = rzRules;
+    if( c )
+        fill.color = *c;
+    else
+        fill.color.R = fill.color.G = fill.color.B = 0;
+    fill.b_pattern = false;
+    fill.x_origin_shift = 0.;
 
-    RenderToBufferFilledPolygon( rzRules, rzRules->obj, c, pb_spec, NULL, vp );
+    fills.push_back( fill );
 
     //    At very small scales, the object could be visible on both the left and right sides of the screen.
     //    Identify this case......
@@ -8326,12 +9171,9 @@ int s52plib::RenderToBufferAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp,
             if( ( ( rzRules->obj->BBObj.GetMaxLon() + 360. ) > vp->GetBBox().GetMaxLon() )
                     && ( ( rzRules->obj->BBObj.GetMinLon() + 360. ) < vp->GetBBox().GetMaxLon() ) ) {
                 //  If so, this area oject should be drawn again, this time for the left side
-                //    Do this by temporarily adjusting the objects rendering offset
-                rzRules->obj->x_origin -= mercator_k0 * WGS84_semimajor_axis_meters * 2.0 * PI;
-                RenderToBufferFilledPolygon( rzRules, rzRules->obj, c, pb_spec,
-                        NULL, vp );
-                rzRules->obj->x_origin += mercator_k0 * WGS84_semimajor_axis_meters * 2.0 * PI;
-
+                //    Do this by adjusting the objects rendering offset for this fill
+                fill.x_origin_shift = -mercator_k0 * WGS84_semimajor_axis_meters * 2.0 * PI;
+                fills.push_back( fill );
             }
         }
     }
@@ -8342,6 +9184,22 @@ int s52plib::RenderToBufferAC( ObjRazRules *rzRules, Rules *rules, ViewPort *vp,
 int s52plib::RenderAreaToDC( wxDC *pdcin, ObjRazRules *rzRules, ViewPort *vp,
         render_canvas_parms *pb_spec )
 {
+    std::vector<S52BufferFill> fills;
+
+    if( !CollectAreaFills( pdcin, rzRules, vp, fills ) )
+        return 0;
+
+    RenderAreaFillsToBuffer( fills, vp, pb_spec, 1 );
+
+    return 1;
+}
+
+//      Resolve the area rules of an object into fills for the software rasterizer.
+//      All the lazy work (CS procedures, pattern instantiation) happens here,
+//      on the calling thread.
+int s52plib::CollectAreaFills( wxDC *pdcin, ObjRazRules *rzRules, ViewPort *vp,
+        std::vector<S52BufferFill> &fills )
+{
 
     if( !ObjectRenderCheckRules( rzRules, vp, true ) )
         return 0;
@@ -8352,10 +9210,10 @@ int s52plib::RenderAreaToDC( wxDC *pdcin, ObjRazRules *rzRules, ViewPort *vp,
     while( rules != NULL ) {
         switch( rules->ruleType ){
             case RUL_ARE_CO:
-                RenderToBufferAC( rzRules, rules, vp, pb_spec );
+                RenderToBufferAC( rzRules, rules, vp, fills );
                 break; // AC
             case RUL_ARE_PA:
-                RenderToBufferAP( rzRules, rules, vp, pb_spec );
+                RenderToBufferAP( rzRules, rules, vp, fills );
                 break; // AP
 
             case RUL_CND_SY: {
@@ -8375,10 +9233,10 @@ int s52plib::RenderAreaToDC( wxDC *pdcin, ObjRazRules *rzRules, ViewPort *vp,
                         //    When it faults here, look at new debug field obj->CSLUP
                         switch( rules->ruleType ){
                             case RUL_ARE_CO:
-                                RenderToBufferAC( rzRules, rules, vp, pb_spec );
+                                RenderToBufferAC( rzRules, rules, vp, fills );
                                 break;
                             case RUL_ARE_PA:
-                                RenderToBufferAP( rzRules, rules, vp, pb_spec );
+                                RenderToBufferAP( rzRules, rules, vp, fills );
                                 break;
                             case RUL_NONE:
                             default:
@@ -8405,17 +9263,114 @@ int s52plib::RenderAreaToDC( wxDC *pdcin, ObjRazRules *rzRules, ViewPort *vp,
 
 }
 
-void s52plib::GetAndAddCSRules( ObjRazRules *rzRules, Rules *rules )
+#define RASTER_BAND_MIN_ROWS    32
+#define RASTER_BANDS_PER_THREAD 4
+
+//      The view box, moved by 360 degrees to the longitudes of the chart data if needed
+static LLBBox GetBufferViewBox( ViewPort *vp )
 {
+    LLBBox BBView = vp->GetBBox();
+    if(BBView.GetMaxLon()+180 < vp->clon)
+        BBView.Set(BBView.GetMinLat(), BBView.GetMinLon() + 360,
+                   BBView.GetMaxLat(), BBView.GetMaxLon() + 360);
+    else if(BBView.GetMinLon()-180 > vp->clon)
+        BBView.Set(BBView.GetMinLat(), BBView.GetMinLon() - 360,
+                   BBView.GetMaxLat(), BBView.GetMaxLon() - 360);
 
-    LUPrec *NewLUP;
-    LUPrec *LUP;
-    LUPrec *LUPCandidate;
+    return BBView;
+}
+
+//      Scan convert a set of area fills, in order, into pb_spec.
+//      The buffer is split into horizontal bands which are rendered concurrently;
+//      each band owns its rows of the pixel buffer, so no locking is needed.
+void s52plib::RenderAreaFillsToBuffer( std::vector<S52BufferFill> &fills, ViewPort *vp,
+                                       render_canvas_parms *pb_spec, int nThreads )
+{
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_AREAS );
+
+    if( !fills.size() )
+        return;
+
+    //  Finish any deferred tesselation first, the bands only read the geometry
+    std::vector<PolyTessGeo *> tess_list;
+    for( size_t i = 0; i < fills.size(); i++ ) {
+        PolyTessGeo *ptg = fills[i].rzRules->obj->pPolyTessGeo;
+        if( ptg && !ptg->IsOk()
+                && ( std::find( tess_list.begin(), tess_list.end(), ptg ) == tess_list.end() ) )
+            tess_list.push_back( ptg );
+    }
+    if( tess_list.size() )
+        PolyTessGeo::BuildDeferredTessBatch( tess_list, nThreads );
+
+    LLBBox BBView = GetBufferViewBox( vp );
+
+    int nBands = wxMin( nThreads * RASTER_BANDS_PER_THREAD, pb_spec->height / RASTER_BAND_MIN_ROWS );
+    if( ( nThreads < 2 ) || ( nBands < 2 ) ) {
+        for( size_t i = 0; i < fills.size(); i++ )
+            RenderToBufferFilledPolygon( fills[i], BBView, pb_spec, vp );
+        return;
+    }
+
+    //  Each band gets its rows of the buffer, and, when screen rows follow
+    //  parallels, a view box narrowed to its latitudes so that triangles
+    //  wholly above or below the band are skipped before projection
+    bool b_clip_lat = ( vp->rotation == 0. ) && ( vp->skew == 0. );
+
+    std::vector<render_canvas_parms> bands( nBands, *pb_spec );
+    std::vector<LLBBox> band_boxes( nBands, BBView );
+    int row = 0;
+    for( int i = 0; i < nBands; i++ ) {
+        int rows = ( pb_spec->height - row ) / ( nBands - i );
+        bands[i].pix_buff = pb_spec->pix_buff + ( row * pb_spec->pb_pitch );
+        bands[i].y = pb_spec->y + row;
+        bands[i].height = rows;
+        row += rows;
+
+        if( b_clip_lat ) {
+            double lat_top, lat_bot, lon;
+            GetPixPointSingle( vp->pix_width / 2, bands[i].y - 2, &lat_top, &lon, vp );
+            GetPixPointSingle( vp->pix_width / 2, bands[i].y + bands[i].height + 2, &lat_bot, &lon, vp );
+            band_boxes[i].Set( wxMax( lat_bot, BBView.GetMinLat() ), BBView.GetMinLon(),
+                               wxMin( lat_top, BBView.GetMaxLat() ), BBView.GetMaxLon() );
+        }
+    }
+
+    std::atomic<int> next( 0 );
+    auto worker = [this, &fills, &bands, &band_boxes, &next, vp, nBands]() {
+        int i;
+        while( ( i = next++ ) < nBands ) {
+            for( size_t j = 0; j < fills.size(); j++ )
+                RenderToBufferFilledPolygon( fills[j], band_boxes[i], &bands[i], vp );
+        }
+    };
+
+    nThreads = wxMin( nThreads, nBands );
+    std::vector<std::thread> pool;
+    for( int i = 0; i < nThreads - 1; i++ )
+        pool.push_back( std::thread( worker ) );
+
+    worker();
+
+    for( size_t i = 0; i < pool.size(); i++ )
+        pool[i].join();
+}
+
+void s52plib::GetAndAddCSRules( ObjRazRules *rzRules, Rules *rules )
+{
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_RULES );
 
     char *rule_str1 = RenderCS( rzRules, rules );
     wxString cs_string( rule_str1, wxConvUTF8 );
     free( rule_str1 ); //delete rule_str1;
 
+    AddCSRules( rzRules, cs_string );
+}
+
+void s52plib::AddCSRules( ObjRazRules *rzRules, const wxString &cs_string )
+{
+    LUPrec *NewLUP;
+    LUPrec *LUP;
+
 //  Try to find a match for this object/attribute set in dynamic CS LUP Table
 
 //  Do this by checking each LUP in the CS LUPARRAY and checking....
@@ -8423,23 +9378,15 @@ void s52plib::GetAndAddCSRules( ObjRazRules *rzRules, Rules *rules )
 //  b) was LUP created earlier by exactly the same INSTruction string?
 //  c) does LUP have same Display Category and Priority?
 
-    wxArrayOfLUPrec *la = condSymbolLUPArray;
-    int index = 0;
-    int index_max = la->GetCount();
-    LUP = NULL;
+//  The table is indexed by a hash on exactly these three keys
 
-    while( ( index < index_max ) ) {
-        LUPCandidate = la->Item( index );
-        if( !strcmp( rzRules->LUP->OBCL, LUPCandidate->OBCL ) ) {
-            if( LUPCandidate->INST->IsSameAs( cs_string ) ) {
-                if( LUPCandidate->DISC == rzRules->LUP->DISC ) {
-                    LUP = LUPCandidate;
-                    break;
-                }
-            }
-        }
-        index++;
-    }
+    wxString cs_key( rzRules->LUP->OBCL, wxConvUTF8 );
+    cs_key << _T(":") << (int)rzRules->LUP->DISC << _T(":") << cs_string;
+
+    LUP = NULL;
+    CSLUPHash::iterator it = m_CSLUP_hash.find( cs_key );
+    if( it != m_CSLUP_hash.end() )
+        LUP = it->second;
 
 //  If not found, need to create a dynamic LUP and add to CS LUP Table
 
@@ -8465,6 +9412,7 @@ void s52plib::GetAndAddCSRules( ObjRazRules *rzRules, Rules *rules )
         wxArrayOfLUPrec *pLUPARRAYtyped = condSymbolLUPArray;
 
         pLUPARRAYtyped->Add( NewLUP );
+        m_CSLUP_hash[cs_key] = NewLUP;
 
         LUP = NewLUP;
 
@@ -8476,6 +9424,74 @@ void s52plib::GetAndAddCSRules( ObjRazRules *rzRules, Rules *rules )
 
 }
 
+void s52plib::PrepareCSRules( std::vector<ObjRazRules *> &list, int nThreads )
+{
+    S52StageTimer stage_timer( m_pRenderStats, S52_STAGE_RULES );
+
+    if( list.empty() )
+        return;
+
+    //  DEPCNT02 looks up the safety contour LUPs.
+    //  Make sure their index entries exist before the CS procedures run concurrently
+    S57Obj tempObj;
+    S52_LUPLookup( PLAIN_BOUNDARIES, "SAFECD", &tempObj, false );
+    S52_LUPLookup( PLAIN_BOUNDARIES, "SAFECN", &tempObj, false );
+
+    //  Run the CS procedures on all cores.
+    //  Each object is visited by exactly one thread, so their side effects
+    //  on the object (display category, SCAMIN) need no locking.
+    //  LIGHTS05/06 declutter the light descriptions against the previously evaluated light,
+    //  so the lights are left out here, and run afterwards on this thread, in list order
+    std::vector<char *> cs_strings( list.size(), (char *) NULL );
+    std::vector<Rules *> cs_rules( list.size(), (Rules *) NULL );
+    std::atomic<size_t> next( 0 );
+
+    auto evaluate = [&]( size_t i ) {
+        Rules *rules = list[i]->LUP->ruleList;
+        while( rules && ( rules->ruleType != RUL_CND_SY ) )
+            rules = rules->next;
+
+        if( rules ) {
+            cs_rules[i] = rules;
+            cs_strings[i] = RenderCS( list[i], rules );
+        }
+    };
+
+    auto worker = [&]() {
+        for( size_t i = next++; i < list.size(); i = next++ ) {
+            if( strncmp( list[i]->obj->FeatureName, "LIGHTS", 6 ) )
+                evaluate( i );
+        }
+    };
+
+    nThreads = wxMin( wxMax( nThreads, 1 ), (int) list.size() );
+    std::vector<std::thread> pool;
+    for( int t = 1; t < nThreads; t++ )
+        pool.push_back( std::thread( worker ) );
+
+    worker();
+
+    for( size_t i = 0; i < pool.size(); i++ )
+        pool[i].join();
+
+    for( size_t i = 0; i < list.size(); i++ ) {
+        if( !strncmp( list[i]->obj->FeatureName, "LIGHTS", 6 ) )
+            evaluate( i );
+    }
+
+    //  The CS LUP table is shared by all charts, so resolve the results here, serially
+    for( size_t i = 0; i < list.size(); i++ ) {
+        if( !cs_rules[i] )
+            continue;
+
+        wxString cs_string( cs_strings[i], wxConvUTF8 );
+        free( cs_strings[i] );
+
+        AddCSRules( list[i], cs_string );
+        list[i]->obj->bCS_Added = 1; // mark the object
+    }
+}
+
 bool s52plib::ObjectRenderCheck( ObjRazRules *rzRules, ViewPort *vp )
 {
     if( !ObjectRenderCheckPos( rzRules, vp ) ) return false;
@@ -8528,6 +9544,17 @@ bool s52plib::ObjectRenderCheckCat( ObjRazRules *rzRules, ViewPort *vp )
     
     if( rzRules->obj == NULL ) return false;
 
+    int filter = ObjectCategoryFilter( rzRules );
+    if( filter == S52_CMD_SCAMIN )
+        return ObjectRenderCheckScamin( rzRules, vp );
+
+    return filter == S52_CMD_SHOWN;
+}
+
+//  The display category part of ObjectRenderCheckCat(), which depends on the plib state only.
+//  Returns S52_CMD_HIDDEN, S52_CMD_SHOWN, or S52_CMD_SCAMIN if SCAMIN is still to be applied
+int s52plib::ObjectCategoryFilter( ObjRazRules *rzRules )
+{
     bool b_catfilter = true;
     bool b_visible = false;
 
@@ -8541,14 +9568,14 @@ bool s52plib::ObjectRenderCheckCat( ObjRazRules *rzRules, ViewPort *vp )
         if(OTHER == obj_cat){
             if( !strncmp( rzRules->LUP->OBCL, "M_", 2 ) )
                 if( !m_bShowMeta &&  strncmp( rzRules->LUP->OBCL, "M_QUAL", 6 ))
-                    return false;
+                    return S52_CMD_HIDDEN;
         }
     }
     else{
     // We want to filter out M_NSYS objects everywhere except "OTHER" category
         if( !strncmp( rzRules->LUP->OBCL, "M_", 2 ) )
             if( !m_bShowMeta )
-                return false;
+                return S52_CMD_HIDDEN;
     }
 
 
@@ -8587,62 +9614,67 @@ bool s52plib::ObjectRenderCheckCat( ObjRazRules *rzRules, ViewPort *vp )
     if( !strncmp( rzRules->LUP->OBCL, "SOUNDG", 6 ) )
         b_catfilter = m_bShowSoundg;
     
-    if( b_catfilter ) {
-        b_visible = true;
+    if( b_catfilter )
+        return S52_CMD_SCAMIN;
 
-//      SCAMIN Filtering
-        //      Implementation note:
-        //      According to S52 specs, SCAMIN must not apply to GROUP1 objects, Meta Objects
-        //      or DisplayCategoryBase objects.
-        //      Occasionally, an ENC will encode a spurious SCAMIN value for one of these objects.
-        //      see, for example, US5VA18M, in OpenCPN SENC as Feature 350(DEPARE), LNAM = 022608187ED20ACC.
-        //      We shall explicitly ignore SCAMIN filtering for these types of objects.
+    return b_visible ? S52_CMD_SHOWN : S52_CMD_HIDDEN;
+}
 
-        if( m_bUseSCAMIN ) {
+//  SCAMIN filtering, for an object its display category lets show
+bool s52plib::ObjectRenderCheckScamin( ObjRazRules *rzRules, ViewPort *vp )
+{
+    bool b_visible = true;
 
-               
-            if( ( DISPLAYBASE == rzRules->LUP->DISC ) || ( PRIO_GROUP1 == rzRules->LUP->DPRI ) )
-                b_visible = true;
-            else{
+    //      SCAMIN Filtering
+    //      Implementation note:
+    //      According to S52 specs, SCAMIN must not apply to GROUP1 objects, Meta Objects
+    //      or DisplayCategoryBase objects.
+    //      Occasionally, an ENC will encode a spurious SCAMIN value for one of these objects.
+    //      see, for example, US5VA18M, in OpenCPN SENC as Feature 350(DEPARE), LNAM = 022608187ED20ACC.
+    //      We shall explicitly ignore SCAMIN filtering for these types of objects.
+
+    if( m_bUseSCAMIN ) {
+
+           
+        if( ( DISPLAYBASE == rzRules->LUP->DISC ) || ( PRIO_GROUP1 == rzRules->LUP->DPRI ) )
+            b_visible = true;
+        else{
 //                if( vp->chart_scale > rzRules->obj->Scamin ) b_visible = false;
 
 
-                double zoom_mod = (double)g_chart_zoom_modifier_vector;
+            double zoom_mod = (double)g_chart_zoom_modifier_vector;
 
-                double modf = zoom_mod/5.;  // -1->1
-                double mod = pow(8., modf);
-                mod = wxMax(mod, .2);
-                mod = wxMin(mod, 8.0);
+            double modf = zoom_mod/5.;  // -1->1
+            double mod = pow(8., modf);
+            mod = wxMax(mod, .2);
+            mod = wxMin(mod, 8.0);
 
-                if(mod > 1){
-                    if( vp->chart_scale  > rzRules->obj->Scamin * mod )
-                        b_visible = false;                              // definitely invisible
-                    else{
-                        //  Theoretically invisible, however...
-                        //  In the "zoom modified" scale region,
-                        //  we render the symbol at reduced size, scaling down to no less than half normal size.
+            if(mod > 1){
+                if( vp->chart_scale  > rzRules->obj->Scamin * mod )
+                    b_visible = false;                              // definitely invisible
+                else{
+                    //  Theoretically invisible, however...
+                    //  In the "zoom modified" scale region,
+                    //  we render the symbol at reduced size, scaling down to no less than half normal size.
+                    
+                    if(vp->chart_scale  > rzRules->obj->Scamin){
+                        double xs = vp->chart_scale - rzRules->obj->Scamin;
+                        double xl = (rzRules->obj->Scamin * mod) - rzRules->obj->Scamin;
+                        g_scaminScale = 1.0 - (0.5 * xs / xl);
                         
-                        if(vp->chart_scale  > rzRules->obj->Scamin){
-                            double xs = vp->chart_scale - rzRules->obj->Scamin;
-                            double xl = (rzRules->obj->Scamin * mod) - rzRules->obj->Scamin;
-                            g_scaminScale = 1.0 - (0.5 * xs / xl);
-                            
-                        }
                     }
                 }
-                else{
-                    if(vp->chart_scale  > rzRules->obj->Scamin)
-                        b_visible = false;
-                }
             }
-
-            //      On the other hand, $TEXTS features need not really be displayed at all scales, always
-            //      To do so makes a very cluttered display
-            if( ( !strncmp( rzRules->LUP->OBCL, "$TEXTS", 6 ) )
-                    && ( vp->chart_scale > rzRules->obj->Scamin ) ) b_visible = false;
+            else{
+                if(vp->chart_scale  > rzRules->obj->Scamin)
+                    b_visible = false;
+            }
         }
 
-        return b_visible;
+        //      On the other hand, $TEXTS features need not really be displayed at all scales, always
+        //      To do so makes a very cluttered display
+        if( ( !strncmp( rzRules->LUP->OBCL, "$TEXTS", 6 ) )
+                && ( vp->chart_scale > rzRules->obj->Scamin ) ) b_visible = false;
     }
 
     return b_visible;
@@ -8701,7 +9733,7 @@ void s52plib::SetDisplayCategory(enum _DisCat cat)
     if(old != cat){
         ClearNoshow();
     }
-    GenerateStateHash();
+    UpdateStateHash();
 }
 
 
@@ -8720,6 +9752,7 @@ void s52plib::AddObjNoshow( const char *objcl )
         noshow_element element;
         memcpy(element.obj, objcl, 6);
         m_noshow_array.Add( element );
+        UpdateStateHash();
     }
 }
 
@@ -8728,6 +9761,7 @@ void s52plib::RemoveObjNoshow( const char *objcl )
     for(unsigned int i=0 ; i < m_noshow_array.GetCount() ; i++){
         if(!strncmp(m_noshow_array[i].obj, objcl, 6) ){
             m_noshow_array.RemoveAt(i);
+            UpdateStateHash();
             return;
         }
     }
@@ -8736,6 +9770,7 @@ void s52plib::RemoveObjNoshow( const char *objcl )
 void s52plib::ClearNoshow(void)
 {
     m_noshow_array.Clear();
+    UpdateStateHash();
 }
 
 void s52plib::PLIB_LoadS57Config()
@@ -9017,7 +10052,7 @@ void s52plib::SetQualityOfData(bool val)
 void s52plib::ClearTextList( void )
 {
     //      Clear the current text rectangle list
-    m_textObjList.Clear();
+    m_textGrid.Clear();
 
 }
 
@@ -9028,27 +10063,6 @@ bool s52plib::EnableGLLS(bool b_enable)
     return return_val;
 }
     
-void s52plib::AdjustTextList( int dx, int dy, int screenw, int screenh )
-{
-    return;
-    wxRect rScreen( 0, 0, screenw, screenh );
-    //    Iterate over the text rectangle list
-    //        1.  Apply the specified offset to the list elements
-    //        2.. Remove any list elements that are off screen after applied offset
-
-    TextObjList::Node *node = m_textObjList.GetFirst();
-    TextObjList::Node *next;
-    while( node ) {
-        next = node->GetNext();
-        wxRect *pcurrent = &( node->GetData()->rText );
-        pcurrent->Offset( dx, dy );
-        if( !pcurrent->Intersects( rScreen ) ) {
-            m_textObjList.DeleteNode( node );
-        }
-        node = next;
-    }
-}
-
 bool s52plib::GetPointPixArray( ObjRazRules *rzRules, wxPoint2DDouble* pd, wxPoint *pp, int nv, ViewPort *vp )
 {
         for( int i = 0; i < nv; i++ ) {
@@ -9058,12 +10072,13 @@ bool s52plib::GetPointPixArray( ObjRazRules *rzRules, wxPoint2DDouble* pd, wxPoi
     return true;
 }
 
-bool s52plib::GetPointPixSingle( ObjRazRules *rzRules, float north, float east, wxPoint *r, ViewPort *vp )
+bool s52plib::GetPointPixSingle( ObjRazRules *rzRules, float north, float east, wxPoint *r, ViewPort *vp,
+                                 double x_origin_shift )
 {
         if(vp->m_projection_type == PROJECTION_MERCATOR) {
             
             double xr =  rzRules->obj->x_rate;
-            double xo =  rzRules->obj->x_origin;
+            double xo =  rzRules->obj->x_origin + x_origin_shift;
             double yr =  rzRules->obj->y_rate;
             double yo =  rzRules->obj->y_origin;
             
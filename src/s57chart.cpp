@@ -34,6 +34,7 @@
 #include "wx/tokenzr.h"
 #include <wx/textfile.h>
 #include <wx/filename.h>
+#include <wx/ffile.h>
 
 #include "dychart.h"
 #include "OCPNPlatform.h"
@@ -210,6 +211,274 @@ render_canvas_parms::~render_canvas_parms( void )
 {
 }
 
+//----------------------------------------------------------------------------------
+//      RazRulesIndex Implementation
+//----------------------------------------------------------------------------------
+
+//      Lists shorter than this are simply walked
+#define RAZ_INDEX_MIN_OBJECTS   64
+#define RAZ_INDEX_MAX_GRID      64
+
+//      Symbols and text expand an object's BBObj as they are rendered, after the
+//      index was built.  The viewport query is widened by this many pixels to
+//      keep such objects visible at the viewport edges.
+#define RAZ_INDEX_MARGIN_PIXELS 512
+
+//      Render command sets kept per list, for canvases with different display settings
+#define RAZ_INDEX_COMMAND_SETS  2
+
+RazRulesIndex::RazRulesIndex()
+{
+    m_top = NULL;
+    m_bbuilt = false;
+    m_generation = 0;
+    m_nx = m_ny = 0;
+    m_minlat = m_minlon = 0.;
+    m_dlat = m_dlon = 1.;
+    m_command_clock = 0;
+}
+
+void RazRulesIndex::Clear()
+{
+    m_top = NULL;
+    m_bbuilt = false;
+    m_objs.clear();
+    m_always.clear();
+    m_cell_start.clear();
+    m_cell_items.clear();
+    m_mark.clear();
+    m_hits.clear();
+    m_generation = 0;
+    m_nx = m_ny = 0;
+    m_command_sets.clear();
+}
+
+void RazRulesIndex::CellRange( double lat, double lon, int &ix, int &iy ) const
+{
+    ix = (int) floor( ( lon - m_minlon ) / m_dlon );
+    iy = (int) floor( ( lat - m_minlat ) / m_dlat );
+    ix = wxMax( 0, wxMin( m_nx - 1, ix ) );
+    iy = wxMax( 0, wxMin( m_ny - 1, iy ) );
+}
+
+void RazRulesIndex::Build( ObjRazRules *top )
+{
+    Clear();
+    m_top = top;
+    m_bbuilt = true;
+
+    for( ObjRazRules *p = top; p; p = p->next )
+        m_objs.push_back( p );
+
+    int n = m_objs.size();
+    if( n < RAZ_INDEX_MIN_OBJECTS )
+        return;
+
+    //  Grid extent is the union of the object boxes
+    bool bvalid = false;
+    double minlat = 0, minlon = 0, maxlat = 0, maxlon = 0;
+    for( int k = 0; k < n; k++ ) {
+        S57Obj *obj = m_objs[k]->obj;
+        if( !obj || !obj->BBObj.GetValid() )
+            continue;
+        const LLBBox &b = obj->BBObj;
+        if( !bvalid ) {
+            minlat = b.GetMinLat(); maxlat = b.GetMaxLat();
+            minlon = b.GetMinLon(); maxlon = b.GetMaxLon();
+            bvalid = true;
+        } else {
+            minlat = wxMin( minlat, b.GetMinLat() ); maxlat = wxMax( maxlat, b.GetMaxLat() );
+            minlon = wxMin( minlon, b.GetMinLon() ); maxlon = wxMax( maxlon, b.GetMaxLon() );
+        }
+    }
+    if( !bvalid )
+        return;
+
+    int g = (int) sqrt( n / 4. );
+    g = wxMax( 4, wxMin( RAZ_INDEX_MAX_GRID, g ) );
+    m_nx = m_ny = g;
+    m_minlat = minlat;
+    m_minlon = minlon;
+    m_dlat = wxMax( ( maxlat - minlat ) / g, 1e-9 );
+    m_dlon = wxMax( ( maxlon - minlon ) / g, 1e-9 );
+
+    //  Objects with no box, or spanning a large part of the chart, are
+    //  always returned rather than entered into many cells
+    std::vector<int> span( 4 * n, -1 );
+    std::vector<int> count( g * g, 0 );
+    for( int k = 0; k < n; k++ ) {
+        S57Obj *obj = m_objs[k]->obj;
+        if( !obj || !obj->BBObj.GetValid() ) {
+            m_always.push_back( k );
+            continue;
+        }
+        int ix0, iy0, ix1, iy1;
+        CellRange( obj->BBObj.GetMinLat(), obj->BBObj.GetMinLon(), ix0, iy0 );
+        CellRange( obj->BBObj.GetMaxLat(), obj->BBObj.GetMaxLon(), ix1, iy1 );
+        if( ( ix1 - ix0 + 1 ) * ( iy1 - iy0 + 1 ) > ( g * g ) / 4 ) {
+            m_always.push_back( k );
+            continue;
+        }
+        span[4 * k] = ix0; span[4 * k + 1] = iy0; span[4 * k + 2] = ix1; span[4 * k + 3] = iy1;
+        for( int iy = iy0; iy <= iy1; iy++ )
+            for( int ix = ix0; ix <= ix1; ix++ )
+                count[iy * g + ix]++;
+    }
+
+    m_cell_start.resize( g * g + 1 );
+    m_cell_start[0] = 0;
+    for( int c = 0; c < g * g; c++ )
+        m_cell_start[c + 1] = m_cell_start[c] + count[c];
+
+    m_cell_items.resize( m_cell_start[g * g] );
+    std::vector<int> fill( m_cell_start.begin(), m_cell_start.end() - 1 );
+    for( int k = 0; k < n; k++ ) {
+        if( span[4 * k] < 0 )
+            continue;
+        for( int iy = span[4 * k + 1]; iy <= span[4 * k + 3]; iy++ )
+            for( int ix = span[4 * k]; ix <= span[4 * k + 2]; ix++ )
+                m_cell_items[fill[iy * g + ix]++] = k;
+    }
+
+    m_mark.assign( n, 0 );
+}
+
+//  Add the ordinals of objects in cells touched by the box to m_hits.
+//  Returns false if the box touches so much of the grid that walking
+//  the whole list is cheaper.
+bool RazRulesIndex::CollectRange( double minlat, double minlon, double maxlat, double maxlon )
+{
+    double gmaxlat = m_minlat + m_ny * m_dlat;
+    double gmaxlon = m_minlon + m_nx * m_dlon;
+    if( maxlat < m_minlat || minlat > gmaxlat || maxlon < m_minlon || minlon > gmaxlon )
+        return true;
+
+    int ix0, iy0, ix1, iy1;
+    CellRange( minlat, minlon, ix0, iy0 );
+    CellRange( maxlat, maxlon, ix1, iy1 );
+    if( ( ix1 - ix0 + 1 ) * ( iy1 - iy0 + 1 ) > ( m_nx * m_ny ) / 2 )
+        return false;
+
+    for( int iy = iy0; iy <= iy1; iy++ ) {
+        for( int ix = ix0; ix <= ix1; ix++ ) {
+            int c = iy * m_nx + ix;
+            for( int i = m_cell_start[c]; i < m_cell_start[c + 1]; i++ ) {
+                int k = m_cell_items[i];
+                if( m_mark[k] != m_generation ) {
+                    m_mark[k] = m_generation;
+                    m_hits.push_back( k );
+                }
+            }
+        }
+    }
+    return true;
+}
+
+//  Leave in m_hits the ordinals of the objects which may touch box, in list order.
+//  Returns false if all of them may.
+bool RazRulesIndex::QueryOrdinals( const LLBBox &box )
+{
+    if( !m_nx || !box.GetValid() )
+        return false;
+
+    if( ++m_generation == 0 ) {
+        m_mark.assign( m_mark.size(), 0 );
+        m_generation = 1;
+    }
+    m_hits.clear();
+
+    //  Match ObjectRenderCheckPos(), which also tries the box shifted by a revolution
+    double minlat = box.GetMinLat(), maxlat = box.GetMaxLat();
+    double minlon = box.GetMinLon(), maxlon = box.GetMaxLon();
+    if( !CollectRange( minlat, minlon, maxlat, maxlon )
+        || !CollectRange( minlat, minlon + 360., maxlat, maxlon + 360. )
+        || !CollectRange( minlat, minlon - 360., maxlat, maxlon - 360. ) )
+        return false;
+
+    m_hits.insert( m_hits.end(), m_always.begin(), m_always.end() );
+    std::sort( m_hits.begin(), m_hits.end() );
+    return true;
+}
+
+void RazRulesIndex::Query( const LLBBox &box, std::vector<ObjRazRules *> &result )
+{
+    result.clear();
+    if( !QueryOrdinals( box ) ) {
+        result = m_objs;
+        return;
+    }
+
+    result.reserve( m_hits.size() );
+    for( size_t i = 0; i < m_hits.size(); i++ )
+        result.push_back( m_objs[m_hits[i]] );
+}
+
+//  The command set for a plib state, the least recently used one making way for a new state
+RazRulesIndex::CommandSet &RazRulesIndex::GetCommandSet( long state_hash, int scheme )
+{
+    size_t lru = 0;
+    for( size_t i = 0; i < m_command_sets.size(); i++ ) {
+        CommandSet &set = m_command_sets[i];
+        if( set.state_hash == state_hash && set.scheme == scheme && set.filter.size() == m_objs.size() ) {
+            set.last_used = ++m_command_clock;
+            return set;
+        }
+        if( set.last_used < m_command_sets[lru].last_used )
+            lru = i;
+    }
+
+    if( m_command_sets.size() < RAZ_INDEX_COMMAND_SETS ) {
+        m_command_sets.push_back( CommandSet() );
+        lru = m_command_sets.size() - 1;
+    }
+
+    CommandSet &set = m_command_sets[lru];
+    set.state_hash = state_hash;
+    set.scheme = scheme;
+    set.last_used = ++m_command_clock;
+    set.filter.assign( m_objs.size(), S52_CMD_UNRESOLVED );
+    set.first.assign( m_objs.size(), 0 );
+    set.count.assign( m_objs.size(), 0 );
+    set.rules.clear();
+    return set;
+}
+
+//  Render commands of the objects which may touch box, in list order.
+//  Objects are resolved the first time they are queried in a state, and
+//  those the display filters hide are left out.
+void RazRulesIndex::QueryCommands( const LLBBox &box, long state_hash, int scheme,
+                                   std::vector<S52RenderCommand> &result )
+{
+    CommandSet &set = GetCommandSet( state_hash, scheme );
+
+    bool ball = !QueryOrdinals( box );
+    size_t n = ball ? m_objs.size() : m_hits.size();
+
+    //  Resolve all first, set.rules may be reallocated as it grows
+    for( size_t i = 0; i < n; i++ ) {
+        int k = ball ? i : m_hits[i];
+        if( set.filter[k] == S52_CMD_UNRESOLVED ) {
+            set.first[k] = set.rules.size();
+            set.filter[k] = ps52plib->ResolveRenderCommand( m_objs[k], set.rules );
+            set.count[k] = set.rules.size() - set.first[k];
+        }
+    }
+
+    result.clear();
+    for( size_t i = 0; i < n; i++ ) {
+        int k = ball ? i : m_hits[i];
+        if( set.filter[k] == S52_CMD_HIDDEN )
+            continue;
+
+        S52RenderCommand cmd;
+        cmd.rzRules = m_objs[k];
+        cmd.filter = set.filter[k];
+        cmd.rules = set.count[k] ? &set.rules[set.first[k]] : NULL;
+        cmd.nrules = set.count[k];
+        result.push_back( cmd );
+    }
+}
+
 //----------------------------------------------------------------------------------
 //      s57chart Implementation
 //----------------------------------------------------------------------------------
@@ -256,6 +525,7 @@ s57chart::s57chart()
 
     m_bLinePrioritySet = false;
     m_plib_state_hash = 0;
+    m_plib_prepare_hash = 0;
 
     m_btex_mem = false;
 
@@ -269,6 +539,8 @@ s57chart::s57chart()
     m_LineVBO_name = -1;
     m_line_vertex_buffer = 0;
     m_this_chart_context =  0;
+    for( int l = 0; l < LINE_LOD_LEVELS; l++ )
+        m_line_lod_tolerance[l] = 0.;
     m_Chart_Skew = 0;
     m_vbo_byte_length = 0;
     m_SENCthreadStatus = THREAD_INACTIVE;
@@ -478,6 +750,8 @@ static void free_mps(mps_container *mps)
 
 void s57chart::FreeObjectsAndRules()
 {
+    m_CS_results.clear();
+
 //      Delete the created ObjRazRules, including the S57Objs
 //      and any child lists
 //      The LUPs of base elements are deleted elsewhere ( void s52plib::DestroyLUPArray ( wxArrayOfLUPrec *pLUPArray ))
@@ -513,6 +787,7 @@ void s57chart::FreeObjectsAndRules()
                 free( top );
                 top = nxx;
             }
+            m_raz_index[i][j].Clear();
         }
     }
 }
@@ -1420,6 +1695,431 @@ void s57chart::AssembleLineGeometry( void )
 
 
 
+//    Line geometry cache
+//
+//    The product of AssembleLineGeometry() (the line vertex buffer, the edge and connector
+//    descriptors, and each object's line segment list) is saved next to the SENC on first use,
+//    and reloaded directly on later opens of the same SENC, skipping the assembly.
+
+static const char LGC_signature[] = "OCPNLGC1";
+
+typedef struct{
+    char                sig[8];
+    wxInt64             senc_size;
+    wxInt64             senc_mtime;
+    wxInt64             vbo_byte_length;
+    wxInt32             n_edges;
+    wxInt32             n_connectors;
+    wxInt32             n_objects;
+}LGC_header;
+
+typedef struct{
+    wxInt64             vbo_offset;
+    wxUint32            nCount;
+    wxUint32            index;
+    double              lat_min, lon_min, lat_max, lon_max;
+}LGC_edge;
+
+typedef struct{
+    wxInt32             vbo_offset;
+    float               cs_lat_avg;
+    float               cs_lon_avg;
+}LGC_connector;
+
+wxString s57chart::GetLineGeometryCacheName( void )
+{
+    wxFileName fn( m_SENCFileName );
+    fn.SetExt( _T("lgc") );
+    return fn.GetFullPath();
+}
+
+static bool GetSENCStamp( const wxString &senc_name, wxInt64 *size, wxInt64 *mtime )
+{
+    wxFileName fn( senc_name );
+    if( !fn.FileExists() )
+        return false;
+
+    *size = (wxInt64)fn.GetSize().GetValue();
+    *mtime = (wxInt64)fn.GetModificationTime().GetTicks();
+    return true;
+}
+
+//  Collect each object once, keyed by feature index.
+//  Objects with no line segments are included too, so the object set itself is validated on load.
+static void CollectRazObjects( ObjRazRules *razRules[PRIO_NUM][LUPNAME_NUM], std::map<int, S57Obj *> &objmap )
+{
+    for( int i = 0; i < PRIO_NUM; ++i ) {
+        for( int j = 0; j < LUPNAME_NUM; j++ ) {
+            ObjRazRules *top = razRules[i][j];
+            while( top != NULL ) {
+                objmap[top->obj->Index] = top->obj;
+                top = top->next;
+            }
+        }
+    }
+}
+
+void s57chart::SaveLineGeometryCache( void )
+{
+    LGC_header header;
+    memcpy( header.sig, LGC_signature, 8 );
+    if( !GetSENCStamp( m_SENCFileName, &header.senc_size, &header.senc_mtime ) )
+        return;
+
+    std::map<VE_Element *, wxUint32> edge_index;
+    for( unsigned int i = 0; i < m_pve_vector.size(); i++ )
+        edge_index[m_pve_vector[i]] = i;
+
+    std::map<connector_segment *, wxUint32> connector_index;
+    for( unsigned int i = 0; i < m_pcs_vector.size(); i++ )
+        connector_index[m_pcs_vector[i]] = i;
+
+    std::map<int, S57Obj *> objmap;
+    CollectRazObjects( razRules, objmap );
+
+    header.vbo_byte_length = m_vbo_byte_length;
+    header.n_edges = m_pve_vector.size();
+    header.n_connectors = m_pcs_vector.size();
+    header.n_objects = objmap.size();
+
+    wxString tmp_name = GetLineGeometryCacheName() + _T(".tmp");
+    wxFFile cf( tmp_name, _T("wb") );
+    if( !cf.IsOpened() )
+        return;
+
+    bool bok = ( cf.Write( &header, sizeof(header) ) == sizeof(header) );
+    if( bok && m_vbo_byte_length )
+        bok = ( cf.Write( m_line_vertex_buffer, m_vbo_byte_length ) == m_vbo_byte_length );
+
+    for( unsigned int i = 0; bok && i < m_pve_vector.size(); i++ ) {
+        VE_Element *pedge = m_pve_vector[i];
+        LGC_edge edge;
+        edge.vbo_offset = pedge->vbo_offset;
+        edge.nCount = pedge->nCount;
+        edge.index = pedge->index;
+        edge.lat_min = pedge->edgeBBox.GetMinLat();
+        edge.lon_min = pedge->edgeBBox.GetMinLon();
+        edge.lat_max = pedge->edgeBBox.GetMaxLat();
+        edge.lon_max = pedge->edgeBBox.GetMaxLon();
+        bok = ( cf.Write( &edge, sizeof(edge) ) == sizeof(edge) );
+    }
+
+    for( unsigned int i = 0; bok && i < m_pcs_vector.size(); i++ ) {
+        connector_segment *pcs = m_pcs_vector[i];
+        LGC_connector conn;
+        conn.vbo_offset = pcs->vbo_offset;
+        conn.cs_lat_avg = pcs->cs_lat_avg;
+        conn.cs_lon_avg = pcs->cs_lon_avg;
+        bok = ( cf.Write( &conn, sizeof(conn) ) == sizeof(conn) );
+    }
+
+    //  Per object: feature index, segment count, then (type, edge/connector index) per segment
+    std::vector<wxUint32> rec;
+    for( std::map<int, S57Obj *>::iterator it = objmap.begin(); bok && it != objmap.end(); ++it ) {
+        rec.clear();
+        rec.push_back( it->first );
+        rec.push_back( 0 );
+        line_segment_element *ls = it->second->m_ls_list;
+        while( ls ) {
+            rec.push_back( ls->ls_type );
+            if( (ls->ls_type == TYPE_EE) || (ls->ls_type == TYPE_EE_REV) )
+                rec.push_back( edge_index[ls->pedge] );
+            else
+                rec.push_back( connector_index[ls->pcs] );
+            rec[1]++;
+            ls = ls->next;
+        }
+        bok = ( cf.Write( &rec[0], rec.size() * sizeof(wxUint32) ) == rec.size() * sizeof(wxUint32) );
+    }
+
+    cf.Close();
+
+    if( bok )
+        bok = wxRenameFile( tmp_name, GetLineGeometryCacheName(), true );
+    if( !bok )
+        wxRemoveFile( tmp_name );
+}
+
+bool s57chart::LoadLineGeometryCache( void )
+{
+    wxString cache_name = GetLineGeometryCacheName();
+    if( !wxFileName::FileExists( cache_name ) )
+        return false;
+
+    wxInt64 senc_size, senc_mtime;
+    if( !GetSENCStamp( m_SENCFileName, &senc_size, &senc_mtime ) )
+        return false;
+
+    wxFFile cf( cache_name, _T("rb") );
+    if( !cf.IsOpened() )
+        return false;
+
+    LGC_header header;
+    if( cf.Read( &header, sizeof(header) ) != sizeof(header) )
+        return false;
+
+    if( strncmp( header.sig, LGC_signature, 8 ) || ( header.senc_size != senc_size ) ||
+        ( header.senc_mtime != senc_mtime ) || ( header.n_edges < 0 ) || ( header.n_connectors < 0 ) ||
+        ( header.vbo_byte_length < 0 ) )
+        return false;                                   // stale, or from another SENC
+
+    //  Read everything, and validate it against the object set, before touching the chart
+    float *vbuf = (float *)malloc( header.vbo_byte_length );
+    std::vector<LGC_edge> edges( header.n_edges );
+    std::vector<LGC_connector> connectors( header.n_connectors );
+
+    bool bok = ( vbuf != NULL ) || ( 0 == header.vbo_byte_length );
+    if( bok && header.vbo_byte_length )
+        bok = ( cf.Read( vbuf, header.vbo_byte_length ) == (size_t)header.vbo_byte_length );
+    if( bok && header.n_edges )
+        bok = ( cf.Read( &edges[0], edges.size() * sizeof(LGC_edge) ) == edges.size() * sizeof(LGC_edge) );
+    if( bok && header.n_connectors )
+        bok = ( cf.Read( &connectors[0], connectors.size() * sizeof(LGC_connector) ) == connectors.size() * sizeof(LGC_connector) );
+
+    std::map<int, S57Obj *> objmap;
+    CollectRazObjects( razRules, objmap );
+
+    std::vector< std::pair<S57Obj *, std::vector<wxUint32> > > objsegs;
+    for( int i = 0; bok && i < header.n_objects; i++ ) {
+        wxUint32 head[2];
+        bok = ( cf.Read( head, sizeof(head) ) == sizeof(head) ) && ( head[1] < (1 << 24) );
+        if( !bok )
+            break;
+
+        std::vector<wxUint32> segs( head[1] * 2 );
+        if( head[1] )
+            bok = ( cf.Read( &segs[0], segs.size() * sizeof(wxUint32) ) == segs.size() * sizeof(wxUint32) );
+
+        for( unsigned int k = 0; bok && k < segs.size(); k += 2 ) {
+            if( (segs[k] == TYPE_EE) || (segs[k] == TYPE_EE_REV) )
+                bok = ( segs[k + 1] < edges.size() );
+            else
+                bok = ( segs[k + 1] < connectors.size() );
+        }
+
+        std::map<int, S57Obj *>::iterator it = objmap.find( (int)head[0] );
+        if( bok && ( it != objmap.end() ) ) {
+            objsegs.push_back( std::make_pair( it->second, segs ) );
+            objmap.erase( it );
+        }
+    }
+
+    //  Any object not covered by the cache means it does not match this chart
+    if( bok && !objmap.empty() )
+        bok = false;
+
+    if( !bok ) {
+        free( vbuf );
+        return false;
+    }
+
+    //  Commit.  Build the edge and connector descriptors
+    std::vector<VE_Element *> pve( edges.size() );
+    for( unsigned int i = 0; i < edges.size(); i++ ) {
+        VE_Element *pedge = new VE_Element;
+        pedge->index = edges[i].index;
+        pedge->nCount = edges[i].nCount;
+        pedge->pPoints = NULL;
+        pedge->max_priority = 0;
+        pedge->vbo_offset = edges[i].vbo_offset;
+        pedge->edgeBBox.Set( edges[i].lat_min, edges[i].lon_min, edges[i].lat_max, edges[i].lon_max );
+        pve[i] = pedge;
+        m_pve_vector.push_back( pedge );
+    }
+
+    std::vector<connector_segment *> pcsv( connectors.size() );
+    for( unsigned int i = 0; i < connectors.size(); i++ ) {
+        connector_segment *pcs = new connector_segment;
+        pcs->vbo_offset = connectors[i].vbo_offset;
+        pcs->max_priority_cs = 0;
+        pcs->cs_lat_avg = connectors[i].cs_lat_avg;
+        pcs->cs_lon_avg = connectors[i].cs_lon_avg;
+        pcsv[i] = pcs;
+        m_pcs_vector.push_back( pcs );
+    }
+
+    //  Rebuild the per-object line segment lists
+    for( unsigned int i = 0; i < objsegs.size(); i++ ) {
+        S57Obj *obj = objsegs[i].first;
+        std::vector<wxUint32> &segs = objsegs[i].second;
+
+        line_segment_element list_top;
+        list_top.next = 0;
+        line_segment_element *le_current = &list_top;
+
+        for( unsigned int k = 0; k < segs.size(); k += 2 ) {
+            line_segment_element *pls = new line_segment_element;
+            pls->next = 0;
+            pls->priority = 0;
+            pls->ls_type = (SegmentType)segs[k];
+            if( (segs[k] == TYPE_EE) || (segs[k] == TYPE_EE_REV) )
+                pls->pedge = pve[segs[k + 1]];
+            else
+                pls->pcs = pcsv[segs[k + 1]];
+
+            le_current->next = pls;
+            le_current = pls;
+        }
+
+        obj->m_ls_list = list_top.next;
+        if( obj->m_ls_list == NULL )
+            obj->m_n_lsindex = 0;
+
+        free( obj->m_lsindex_array );
+        obj->m_lsindex_array = NULL;
+    }
+
+    free( m_line_vertex_buffer );
+    m_line_vertex_buffer = vbuf;
+    m_vbo_byte_length = header.vbo_byte_length;
+
+    //  The edge and connector node hashes from the SENC are no longer needed
+    for( VE_Hash::iterator it = m_ve_hash.begin(); it != m_ve_hash.end(); ++it ) {
+        VE_Element *pedge = it->second;
+        if(pedge){
+            free(pedge->pPoints);
+            delete pedge;
+        }
+    }
+    m_ve_hash.clear();
+
+    for( VC_Hash::iterator itc = m_vc_hash.begin(); itc != m_vc_hash.end(); ++itc ) {
+        VC_Element *pcs = itc->second;
+        if(pcs) {
+            free(pcs->pPoint);
+            delete pcs;
+        }
+    }
+    m_vc_hash.clear();
+
+    return true;
+}
+
+
+//    Line levels of detail
+//
+//    Each edge of the line vertex buffer is simplified (Douglas-Peucker) at LINE_LOD_LEVELS
+//    tolerances, each 4 times coarser than the last, starting at the width of LINE_LOD_PIXELS
+//    when the chart is viewed at 1/4 of its native scale.  A level is kept as a run of vertex
+//    indices into the edge, so the same vertex buffer (and VBO) serves every level.
+//    s52plib picks the coarsest level that stays within LINE_LOD_PIXELS at the current scale.
+
+#define LINE_LOD_NATIVE_PPM     3779.5          // display pixels per meter at 96 dpi
+
+static double LODSegDist2( const float *p, const float *a, const float *b )
+{
+    double dx = b[0] - a[0];
+    double dy = b[1] - a[1];
+    double px = p[0] - a[0];
+    double py = p[1] - a[1];
+
+    double len2 = dx * dx + dy * dy;
+    if( len2 > 0. ) {
+        double t = ( px * dx + py * dy ) / len2;
+        if( t > 1. ) {
+            px = p[0] - b[0];
+            py = p[1] - b[1];
+        } else if( t > 0. ) {
+            px -= t * dx;
+            py -= t * dy;
+        }
+    }
+    return px * px + py * py;
+}
+
+//  Mark the points of pts[0..n-1] to keep at tolerance tol, endpoints always kept
+static void LODSimplify( const float *pts, unsigned int n, double tol, std::vector<unsigned char> &keep )
+{
+    keep.assign( n, 0 );
+    keep[0] = keep[n - 1] = 1;
+
+    double tol2 = tol * tol;
+    std::vector< std::pair<unsigned int, unsigned int> > stack;
+    stack.push_back( std::make_pair( 0u, n - 1 ) );
+
+    while( !stack.empty() ) {
+        unsigned int a = stack.back().first;
+        unsigned int b = stack.back().second;
+        stack.pop_back();
+
+        double dmax = 0.;
+        unsigned int imax = a;
+        for( unsigned int i = a + 1; i < b; i++ ) {
+            double d = LODSegDist2( &pts[2 * i], &pts[2 * a], &pts[2 * b] );
+            if( d > dmax ) {
+                dmax = d;
+                imax = i;
+            }
+        }
+
+        if( dmax > tol2 ) {
+            keep[imax] = 1;
+            if( imax - a > 1 ) stack.push_back( std::make_pair( a, imax ) );
+            if( b - imax > 1 ) stack.push_back( std::make_pair( imax, b ) );
+        }
+    }
+}
+
+void s57chart::BuildLineLOD( void )
+{
+    m_line_lod_indices.clear();
+    for( int l = 0; l < LINE_LOD_LEVELS; l++ )
+        m_line_lod_tolerance[l] = 0.;
+
+    if( !m_line_vertex_buffer || ( GetNativeScale() <= 1. ) )
+        return;
+
+    //  Tolerance of each level, in vertex buffer units (meters)
+    double tol = LINE_LOD_PIXELS * GetNativeScale() / LINE_LOD_NATIVE_PPM;
+    for( int l = 0; l < LINE_LOD_LEVELS; l++ ) {
+        tol *= 4.;
+        m_line_lod_tolerance[l] = tol;
+    }
+
+    //  Offsets into m_line_lod_indices, fixed up into pointers once the pool is complete
+    std::vector<size_t> run_start( m_pve_vector.size() * LINE_LOD_LEVELS, (size_t)-1 );
+    std::vector<unsigned char> keep;
+
+    for( unsigned int ie = 0; ie < m_pve_vector.size(); ie++ ) {
+        VE_Element *pedge = m_pve_vector[ie];
+        unsigned int n_prev = pedge->nCount;
+        if( n_prev < 3 )
+            continue;
+
+        const float *pts = (const float *)( (unsigned char *)m_line_vertex_buffer + pedge->vbo_offset );
+
+        for( int l = 0; l < LINE_LOD_LEVELS; l++ ) {
+            LODSimplify( pts, pedge->nCount, m_line_lod_tolerance[l], keep );
+
+            unsigned int n = 0;
+            for( unsigned int i = 0; i < pedge->nCount; i++ )
+                n += keep[i];
+
+            //  Not worth a run of its own, the renderer falls back to the next finer level
+            if( n * 4 > n_prev * 3 )
+                continue;
+
+            run_start[ie * LINE_LOD_LEVELS + l] = m_line_lod_indices.size();
+            for( unsigned int i = 0; i < pedge->nCount; i++ ) {
+                if( keep[i] )
+                    m_line_lod_indices.push_back( i );
+            }
+            pedge->lod_count[l] = n;
+            n_prev = n;
+        }
+    }
+
+    for( unsigned int ie = 0; ie < m_pve_vector.size(); ie++ ) {
+        VE_Element *pedge = m_pve_vector[ie];
+        for( int l = 0; l < LINE_LOD_LEVELS; l++ ) {
+            size_t start = run_start[ie * LINE_LOD_LEVELS + l];
+            if( start != (size_t)-1 )
+                pedge->lod_index[l] = &m_line_lod_indices[start];
+        }
+    }
+}
+
+
 void s57chart::BuildLineVBO( void )
 {
 #ifdef ocpnUSE_GL
@@ -1544,15 +2244,16 @@ bool s57chart::DoRenderRegionViewOnGL( const wxGLContext &glc, const ViewPort& V
 
     ps52plib->PrepareForRender();
 
-    if( m_plib_state_hash != ps52plib->GetStateHash() ) {
+    if( m_plib_prepare_hash != ps52plib->GetPrepareHash() ) {
         m_bLinePrioritySet = false;                     // need to reset line priorities
         UpdateLUPs( this );                               // and update the LUPs
         ClearRenderedTextCache();                       // and reset the text renderer,
                                                         //for the case where depth(height) units change
         ResetPointBBoxes( m_last_vp, VPoint );
         SetSafetyContour();
+        PrepareCSRules();
 
-        m_plib_state_hash = ps52plib->GetStateHash();
+        m_plib_prepare_hash = ps52plib->GetPrepareHash();
 
     }
 
@@ -1606,65 +2307,105 @@ bool s57chart::DoRenderRegionViewOnGL( const wxGLContext &glc, const ViewPort& V
     return true;
 }
 
+//      Objects of one razRules list which may be visible in the viewport, in list order.
+//      The per-list index is rebuilt lazily whenever the list head changes,
+//      which covers _insertRules() at load, LUP updates, and cm93 cell attach.
+//  The viewport box grown by RAZ_INDEX_MARGIN_PIXELS, for the razRules index queries
+static LLBBox RazIndexQueryBox( ViewPort &vp )
+{
+    LLBBox box = vp.GetBBox();
+    if( box.GetValid() && ( vp.view_scale_ppm > 0 ) ) {
+        double margin_lat = RAZ_INDEX_MARGIN_PIXELS / vp.view_scale_ppm / 1852. / 60.;
+        double coslat = wxMax( cos( vp.clat * PI / 180. ), 0.01 );
+        double margin_lon = margin_lat / coslat;
+        box.Set( box.GetMinLat() - margin_lat, box.GetMinLon() - margin_lon,
+                 box.GetMaxLat() + margin_lat, box.GetMaxLon() + margin_lon );
+    }
+    return box;
+}
+
+const std::vector<ObjRazRules *> &s57chart::GetVisibleRazRules( int prio, int lup_type, ViewPort &vp )
+{
+    RazRulesIndex &index = m_raz_index[prio][lup_type];
+    if( !index.IsCurrent( razRules[prio][lup_type] ) )
+        index.Build( razRules[prio][lup_type] );
+
+    index.Query( RazIndexQueryBox( vp ), m_raz_visible );
+    return m_raz_visible;
+}
+
+const std::vector<S52RenderCommand> &s57chart::GetVisibleRenderCommands( int prio, int lup_type, ViewPort &vp )
+{
+    RazRulesIndex &index = m_raz_index[prio][lup_type];
+    if( !index.IsCurrent( razRules[prio][lup_type] ) )
+        index.Build( razRules[prio][lup_type] );
+
+    index.QueryCommands( RazIndexQueryBox( vp ), ps52plib->GetStateHash(),
+                         ps52plib->GetColorTableIndex(), m_raz_commands );
+    return m_raz_commands;
+}
+
 bool s57chart::DoRenderOnGL( const wxGLContext &glc, const ViewPort& VPoint )
 {
 #ifdef ocpnUSE_GL
 
     int i;
-    ObjRazRules *top;
-    ObjRazRules *crnt;
+    const std::vector<S52RenderCommand> *plist;
     ViewPort tvp = VPoint;                    // undo const  TODO fix this in PLIB
 
+    //      Geometry is batched by render state within each display priority
+    ps52plib->BeginGLBatch();
+
     //      Render the areas quickly
     for( i = 0; i < PRIO_NUM; ++i ) {
         if( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES )
-            top = razRules[i][4]; // Area Symbolized Boundaries
+            plist = &GetVisibleRenderCommands( i, 4, tvp ); // Area Symbolized Boundaries
         else
-            top = razRules[i][3]; // Area Plain Boundaries
+            plist = &GetVisibleRenderCommands( i, 3, tvp ); // Area Plain Boundaries
 
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;               // next object
-            crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderAreaToGL( glc, crnt, &tvp );
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            const S52RenderCommand &cmd = (*plist)[k];
+            cmd.rzRules->sm_transform_parms = &vp_transform;
+            ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_AREA );
         }
+        ps52plib->FlushGLBatch( &tvp );
     }
 
     //    Render the lines and points
     for( i = 0; i < PRIO_NUM; ++i ) {
         if( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES )
-            top = razRules[i][4]; // Area Symbolized Boundaries
+            plist = &GetVisibleRenderCommands( i, 4, tvp ); // Area Symbolized Boundaries
         else
-            top = razRules[i][3]; // Area Plain Boundaries
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;               // next object
-            crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderObjectToGL( glc, crnt, &tvp );
+            plist = &GetVisibleRenderCommands( i, 3, tvp ); // Area Plain Boundaries
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            const S52RenderCommand &cmd = (*plist)[k];
+            cmd.rzRules->sm_transform_parms = &vp_transform;
+            ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_OBJECT );
         }
 
-        top = razRules[i][2];           //LINES
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;
-            crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderObjectToGL( glc, crnt, &tvp );
+        plist = &GetVisibleRenderCommands( i, 2, tvp );           //LINES
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            const S52RenderCommand &cmd = (*plist)[k];
+            cmd.rzRules->sm_transform_parms = &vp_transform;
+            ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_OBJECT );
         }
 
         if( ps52plib->m_nSymbolStyle == SIMPLIFIED )
-            top = razRules[i][0];       //SIMPLIFIED Points
+            plist = &GetVisibleRenderCommands( i, 0, tvp );       //SIMPLIFIED Points
         else
-            top = razRules[i][1];           //Paper Chart Points Points
+            plist = &GetVisibleRenderCommands( i, 1, tvp );           //Paper Chart Points Points
 
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;
-            crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderObjectToGL( glc, crnt, &tvp );
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            const S52RenderCommand &cmd = (*plist)[k];
+            cmd.rzRules->sm_transform_parms = &vp_transform;
+            ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_OBJECT );
         }
 
+        ps52plib->FlushGLBatch( &tvp );
     }
 
+    ps52plib->EndGLBatch( &tvp );
+
 #endif          //#ifdef ocpnUSE_GL
 
     return true;
@@ -1675,63 +2416,63 @@ bool s57chart::DoRenderOnGLText( const wxGLContext &glc, const ViewPort& VPoint
 #ifdef ocpnUSE_GL
 
     int i;
-    ObjRazRules *top;
-    ObjRazRules *crnt;
+    const std::vector<S52RenderCommand> *plist;
     ViewPort tvp = VPoint;                    // undo const  TODO fix this in PLIB
 
 #if 0
     //      Render the areas quickly
     for( i = 0; i < PRIO_NUM; ++i ) {
         if( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES )
-            top = razRules[i][4]; // Area Symbolized Boundaries
+            plist = &GetVisibleRenderCommands( i, 4, tvp ); // Area Symbolized Boundaries
         else
-            top = razRules[i][3];           // Area Plain Boundaries
+            plist = &GetVisibleRenderCommands( i, 3, tvp );           // Area Plain Boundaries
 
-            while( top != NULL ) {
-                crnt = top;
-                top = top->next;               // next object
-                crnt->sm_transform_parms = &vp_transform;
-///                ps52plib->RenderAreaToGL( glc, crnt, &tvp );
+            for( size_t k = 0; k < plist->size(); k++ ) {
+                const S52RenderCommand &cmd = (*plist)[k];
+                cmd.rzRules->sm_transform_parms = &vp_transform;
+///                ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_AREA );
             }
     }
 #endif
 
+    //    Queue all the text glyphs, and draw them at once at the end
+    TexFontAtlas::Get().BeginBatch();
+
     //    Render the lines and points
     for( i = 0; i < PRIO_NUM; ++i ) {
         if( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES )
-            top = razRules[i][4]; // Area Symbolized Boundaries
+            plist = &GetVisibleRenderCommands( i, 4, tvp ); // Area Symbolized Boundaries
         else
-            top = razRules[i][3]; // Area Plain Boundaries
+            plist = &GetVisibleRenderCommands( i, 3, tvp ); // Area Plain Boundaries
 
-        while( top != NULL ) {
-                crnt = top;
-                top = top->next;               // next object
-                crnt->sm_transform_parms = &vp_transform;
-                ps52plib->RenderObjectToGLText( glc, crnt, &tvp );
+        for( size_t k = 0; k < plist->size(); k++ ) {
+                const S52RenderCommand &cmd = (*plist)[k];
+                cmd.rzRules->sm_transform_parms = &vp_transform;
+                ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_TEXT );
         }
 
-        top = razRules[i][2];           //LINES
-        while( top != NULL ) {
-                crnt = top;
-                top = top->next;
-                crnt->sm_transform_parms = &vp_transform;
-                ps52plib->RenderObjectToGLText( glc, crnt, &tvp );
+        plist = &GetVisibleRenderCommands( i, 2, tvp );           //LINES
+        for( size_t k = 0; k < plist->size(); k++ ) {
+                const S52RenderCommand &cmd = (*plist)[k];
+                cmd.rzRules->sm_transform_parms = &vp_transform;
+                ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_TEXT );
         }
 
         if( ps52plib->m_nSymbolStyle == SIMPLIFIED )
-            top = razRules[i][0];       //SIMPLIFIED Points
+            plist = &GetVisibleRenderCommands( i, 0, tvp );       //SIMPLIFIED Points
         else
-            top = razRules[i][1];           //Paper Chart Points Points
+            plist = &GetVisibleRenderCommands( i, 1, tvp );           //Paper Chart Points Points
 
-        while( top != NULL ) {
-                crnt = top;
-                top = top->next;
-                crnt->sm_transform_parms = &vp_transform;
-                ps52plib->RenderObjectToGLText( glc, crnt, &tvp );
+        for( size_t k = 0; k < plist->size(); k++ ) {
+                const S52RenderCommand &cmd = (*plist)[k];
+                cmd.rzRules->sm_transform_parms = &vp_transform;
+                ps52plib->RenderCommandToGL( glc, cmd, &tvp, S52_PASS_TEXT );
         }
 
     }
 
+    TexFontAtlas::Get().EndBatch();
+
 #endif          //#ifdef ocpnUSE_GL
 
     return true;
@@ -1828,13 +2569,16 @@ bool s57chart::DoRenderRegionViewOnDC( wxMemoryDC& dc, const ViewPort& VPoint,
 
     ps52plib->PrepareForRender();
 
-    if( m_plib_state_hash != ps52plib->GetStateHash() ) {
+    if( m_plib_prepare_hash != ps52plib->GetPrepareHash() ) {
         m_bLinePrioritySet = false;                     // need to reset line priorities
         UpdateLUPs( this );                               // and update the LUPs
         ClearRenderedTextCache();                       // and reset the text renderer,
                                                         //for the case where depth(height) units change
         ResetPointBBoxes( m_last_vp, VPoint );
         SetSafetyContour();
+        PrepareCSRules();
+
+        m_plib_prepare_hash = ps52plib->GetPrepareHash();
     }
 
     if( VPoint.view_scale_ppm != m_last_vp.view_scale_ppm ) {
@@ -1909,11 +2653,14 @@ bool s57chart::RenderViewOnDC( wxMemoryDC& dc, const ViewPort& VPoint )
 
     ps52plib->PrepareForRender();
 
-    if( m_plib_state_hash != ps52plib->GetStateHash() ) {
+    if( m_plib_prepare_hash != ps52plib->GetPrepareHash() ) {
         m_bLinePrioritySet = false;                     // need to reset line priorities
         UpdateLUPs( this );                               // and update the LUPs
         ClearRenderedTextCache();                       // and reset the text renderer
         SetSafetyContour();
+        PrepareCSRules();
+
+        m_plib_prepare_hash = ps52plib->GetPrepareHash();
     }
 
     SetLinePriorities();
@@ -2051,10 +2798,6 @@ bool s57chart::DoRenderViewOnDC( wxMemoryDC& dc, const ViewPort& VPoint, RenderT
 //        printf("reuse blit %d %d %d %d %d %d\n",desx, desy, wu, hu,  srcx, srcy);
         dc_new.Blit( desx, desy, wu, hu, (wxDC *) &dc_last, srcx, srcy, wxCOPY );
 
-        //        Ask the plib to adjust the persistent text rectangle list for this canvas shift
-        //        This ensures that, on pans, the list stays in registration with the new text renders to come
-        ps52plib->AdjustTextList( desx - srcx, desy - srcy, VPoint.pix_width, VPoint.pix_height );
-
         dc_new.SelectObject( wxNullBitmap );
         dc_last.SelectObject( wxNullBitmap );
 
@@ -2146,7 +2889,7 @@ int s57chart::DCRenderRect( wxMemoryDC& dcinput, const ViewPort& vp, wxRect* rec
 {
 
     int i;
-    ObjRazRules *top;
+    const std::vector<ObjRazRules *> *plist;
     ObjRazRules *crnt;
 
     wxASSERT(rect);
@@ -2204,20 +2947,26 @@ int s57chart::DCRenderRect( wxMemoryDC& dcinput, const ViewPort& vp, wxRect* rec
     }
 
 //      Render the areas quickly
+//      Resolve the area rules in priority order, then scan convert them by bands on all cores
+    std::vector<S52BufferFill> fills;
     for( i = 0; i < PRIO_NUM; ++i ) {
         if( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES )
-            top = razRules[i][4]; // Area Symbolized Boundaries
+            plist = &GetVisibleRazRules( i, 4, tvp ); // Area Symbolized Boundaries
         else
-            top = razRules[i][3]; // Area Plain Boundaries
+            plist = &GetVisibleRazRules( i, 3, tvp ); // Area Plain Boundaries
 
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;               // next object
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            crnt = (*plist)[k];
             crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderAreaToDC( &dcinput, crnt, &tvp, &pb_spec );
+            ps52plib->CollectAreaFills( &dcinput, crnt, &tvp, fills );
         }
     }
 
+    int nCPU = wxMax(1, wxThread::GetCPUCount());
+    if(g_nCPUCount > 0)
+        nCPU = g_nCPUCount;
+    ps52plib->RenderAreaFillsToBuffer( fills, &tvp, &pb_spec, nCPU );
+
 //      Convert the Private render canvas into a bitmap
 #ifdef ocpnUSE_ocpnBitmap
     ocpnBitmap *pREN = new ocpnBitmap( pb_spec.pix_buff, pb_spec.width, pb_spec.height,
@@ -2257,8 +3006,7 @@ int s57chart::DCRenderRect( wxMemoryDC& dcinput, const ViewPort& vp, wxRect* rec
 bool s57chart::DCRenderLPB( wxMemoryDC& dcinput, const ViewPort& vp, wxRect* rect )
 {
     int i;
-    ObjRazRules *top;
-    ObjRazRules *crnt;
+    const std::vector<S52RenderCommand> *plist;
     ViewPort tvp = vp;                    // undo const  TODO fix this in PLIB
 
     for( i = 0; i < PRIO_NUM; ++i ) {
@@ -2270,34 +3018,31 @@ bool s57chart::DCRenderLPB( wxMemoryDC& dcinput, const ViewPort& vp, wxRect* rec
         }
 
         if( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES )
-            top = razRules[i][4]; // Area Symbolized Boundaries
+            plist = &GetVisibleRenderCommands( i, 4, tvp ); // Area Symbolized Boundaries
         else
-            top = razRules[i][3];           // Area Plain Boundaries
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;               // next object
-            crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderObjectToDC( &dcinput, crnt, &tvp );
+            plist = &GetVisibleRenderCommands( i, 3, tvp );           // Area Plain Boundaries
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            const S52RenderCommand &cmd = (*plist)[k];
+            cmd.rzRules->sm_transform_parms = &vp_transform;
+            ps52plib->RenderCommandToDC( &dcinput, cmd, &tvp, S52_PASS_OBJECT );
         }
 
-        top = razRules[i][2];           //LINES
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;
-            crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderObjectToDC( &dcinput, crnt, &tvp );
+        plist = &GetVisibleRenderCommands( i, 2, tvp );           //LINES
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            const S52RenderCommand &cmd = (*plist)[k];
+            cmd.rzRules->sm_transform_parms = &vp_transform;
+            ps52plib->RenderCommandToDC( &dcinput, cmd, &tvp, S52_PASS_OBJECT );
         }
 
         if( ps52plib->m_nSymbolStyle == SIMPLIFIED )
-            top = razRules[i][0];       //SIMPLIFIED Points
+            plist = &GetVisibleRenderCommands( i, 0, tvp );       //SIMPLIFIED Points
         else
-            top = razRules[i][1];           //Paper Chart Points Points
+            plist = &GetVisibleRenderCommands( i, 1, tvp );           //Paper Chart Points Points
 
-        while( top != NULL ) {
-            crnt = top;
-            top = top->next;
-            crnt->sm_transform_parms = &vp_transform;
-            ps52plib->RenderObjectToDC( &dcinput, crnt, &tvp );
+        for( size_t k = 0; k < plist->size(); k++ ) {
+            const S52RenderCommand &cmd = (*plist)[k];
+            cmd.rzRules->sm_transform_parms = &vp_transform;
+            ps52plib->RenderCommandToDC( &dcinput, cmd, &tvp, S52_PASS_OBJECT );
         }
 
         //      Destroy Clipper
@@ -2317,42 +3062,38 @@ bool s57chart::DCRenderLPB( wxMemoryDC& dcinput, const ViewPort& vp, wxRect* rec
 bool s57chart::DCRenderText( wxMemoryDC& dcinput, const ViewPort& vp )
 {
     int i;
-    ObjRazRules *top;
-    ObjRazRules *crnt;
+    const std::vector<S52RenderCommand> *plist;
     ViewPort tvp = vp;                    // undo const  TODO fix this in PLIB
 
     for( i = 0; i < PRIO_NUM; ++i ) {
 
         if( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES )
-            top = razRules[i][4]; // Area Symbolized Boundaries
+            plist = &GetVisibleRenderCommands( i, 4, tvp ); // Area Symbolized Boundaries
         else
-            top = razRules[i][3]; // Area Plain Boundaries
+            plist = &GetVisibleRenderCommands( i, 3, tvp ); // Area Plain Boundaries
 
-        while( top != NULL ) {
-                crnt = top;
-                top = top->next;               // next object
-                crnt->sm_transform_parms = &vp_transform;
-                ps52plib->RenderObjectToDCText( &dcinput, crnt, &tvp );
+        for( size_t k = 0; k < plist->size(); k++ ) {
+                const S52RenderCommand &cmd = (*plist)[k];
+                cmd.rzRules->sm_transform_parms = &vp_transform;
+                ps52plib->RenderCommandToDC( &dcinput, cmd, &tvp, S52_PASS_TEXT );
         }
 
-        top = razRules[i][2];           //LINES
-        while( top != NULL ) {
-                crnt = top;
-                top = top->next;
-                crnt->sm_transform_parms = &vp_transform;
-                ps52plib->RenderObjectToDCText( &dcinput, crnt, &tvp );
+        plist = &GetVisibleRenderCommands( i, 2, tvp );           //LINES
+        for( size_t k = 0; k < plist->size(); k++ ) {
+                const S52RenderCommand &cmd = (*plist)[k];
+                cmd.rzRules->sm_transform_parms = &vp_transform;
+                ps52plib->RenderCommandToDC( &dcinput, cmd, &tvp, S52_PASS_TEXT );
         }
 
         if( ps52plib->m_nSymbolStyle == SIMPLIFIED )
-            top = razRules[i][0];       //SIMPLIFIED Points
+            plist = &GetVisibleRenderCommands( i, 0, tvp );       //SIMPLIFIED Points
         else
-            top = razRules[i][1];           //Paper Chart Points Points
+            plist = &GetVisibleRenderCommands( i, 1, tvp );           //Paper Chart Points Points
 
-        while( top != NULL ) {
-                crnt = top;
-                top = top->next;
-                crnt->sm_transform_parms = &vp_transform;
-                ps52plib->RenderObjectToDCText( &dcinput, crnt, &tvp );
+        for( size_t k = 0; k < plist->size(); k++ ) {
+                const S52RenderCommand &cmd = (*plist)[k];
+                cmd.rzRules->sm_transform_parms = &vp_transform;
+                ps52plib->RenderCommandToDC( &dcinput, cmd, &tvp, S52_PASS_TEXT );
         }
     }
 
@@ -2747,6 +3488,10 @@ InitReturn s57chart::PostInit( ChartInitFlag flags, ColorScheme cs )
 //    Build array of contour values for later use by conditional symbology
 
     BuildDepthContourArray();
+
+//    And evaluate the conditional symbology up front, on all cores
+    PrepareCSRules();
+
     m_RAZBuilt = true;
     bReadyToRender = true;
 
@@ -2841,6 +3586,95 @@ void s57chart::SetSafetyContour(void)
 
 }
 
+#define S57_CS_RESULT_SETS      4               // parameter sets remembered per chart
+
+void s57chart::PrepareCSRules(void)
+{
+    //  Evaluate the conditional symbology of every object in the current display style,
+    //  so the first render with a new set of mariner parameters does not have to.
+    //  The results are kept per parameter set, and simply patched back in when
+    //  the mariner returns to a set seen before.
+    if( !ps52plib )
+        return;
+
+    long key = ps52plib->GetCSParamKey();
+
+    int point_type = ( ps52plib->m_nSymbolStyle == SIMPLIFIED ) ? 0 : 1;
+    int area_type = ( ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES ) ? 4 : 3;
+    const int lup_types[3] = { point_type, 2, area_type };
+
+    for( size_t k = 0; k < m_CS_results.size(); k++ ) {
+        if( m_CS_results[k].key != key )
+            continue;
+
+        S57CSResultSet &set = m_CS_results[k];
+        for( size_t i = 0; i < set.objs.size(); i++ ) {
+            set.objs[i]->CSrules = set.CSrules[i];
+            set.objs[i]->m_DisplayCat = set.DisplayCat[i];
+            set.objs[i]->bCS_Added = 1;
+        }
+
+        if( k )
+            std::rotate( m_CS_results.begin(), m_CS_results.begin() + k, m_CS_results.begin() + k + 1 );
+        return;
+    }
+
+    std::vector<ObjRazRules *> list;
+    for( int i = 0; i < PRIO_NUM; ++i ) {
+        for( int j = 0; j < 3; j++ ) {
+            ObjRazRules *top = razRules[i][lup_types[j]];
+            while( top != NULL ) {
+                S57Obj *obj = top->obj;
+
+                //  Soundings are re-evaluated on each render, see s52plib::DoRenderObject()
+                if( !obj->bCS_Added && top->LUP && strncmp( obj->FeatureName, "SOUNDG", 6 ) ) {
+                    Rules *rules = top->LUP->ruleList;
+                    while( rules && ( rules->ruleType != RUL_CND_SY ) )
+                        rules = rules->next;
+                    if( rules )
+                        list.push_back( top );
+                }
+                top = top->next;
+            }
+        }
+    }
+
+    int nCPU = wxMax(1, wxThread::GetCPUCount());
+    if(g_nCPUCount > 0)
+        nCPU = g_nCPUCount;
+
+    //  UDWHAZ03 hit tests the group 1 areas, see GetAssociatedObjects().
+    //  Finish their deferred tesselation now, rather than from the concurrent CS procedures
+    std::vector<PolyTessGeo *> tess_list;
+    for( int j = 3; j < 5; j++ ) {
+        for( ObjRazRules *top = razRules[1][j]; top; top = top->next ) {
+            PolyTessGeo *ptg = top->obj->pPolyTessGeo;
+            if( top->obj->bIsAssociable && ptg && !ptg->IsOk()
+                    && ( std::find( tess_list.begin(), tess_list.end(), ptg ) == tess_list.end() ) )
+                tess_list.push_back( ptg );
+        }
+    }
+    if( list.size() && tess_list.size() )
+        PolyTessGeo::BuildDeferredTessBatch( tess_list, nCPU );
+
+    ps52plib->PrepareCSRules( list, nCPU );
+
+    S57CSResultSet set;
+    set.key = key;
+    for( size_t i = 0; i < list.size(); i++ ) {
+        S57Obj *obj = list[i]->obj;
+        if( !obj->bCS_Added )
+            continue;
+        set.objs.push_back( obj );
+        set.CSrules.push_back( obj->CSrules );
+        set.DisplayCat.push_back( obj->m_DisplayCat );
+    }
+
+    m_CS_results.insert( m_CS_results.begin(), set );
+    if( m_CS_results.size() > S57_CS_RESULT_SETS )
+        m_CS_results.pop_back();
+}
+
 void s57chart::InvalidateCache()
 {
     delete pDIB;
@@ -2938,6 +3772,7 @@ bool s57chart::BuildThumbnail( const wxString &bmpname )
     S52_setMarinerParam(S52_MAR_SAFETY_DEPTH, -100);
     double safety_contour = S52_getMarinerParam(S52_MAR_SAFETY_CONTOUR);
     S52_setMarinerParam(S52_MAR_SAFETY_CONTOUR, -100);
+    ps52plib->UpdateStateHash();                // set directly above, so the charts see a new state
 
 
 #ifdef ocpnUSE_DIBSECTION
@@ -2973,6 +3808,7 @@ bool s57chart::BuildThumbnail( const wxString &bmpname )
 
     S52_setMarinerParam(S52_MAR_SAFETY_DEPTH, safety_depth);
     S52_setMarinerParam(S52_MAR_SAFETY_CONTOUR, safety_contour);
+    ps52plib->UpdateStateHash();
 
 //      Reset the color scheme
     ps52plib->RestoreColorScheme();
@@ -4162,12 +4998,18 @@ int s57chart::BuildRAZFromSENCFile( const wxString& FullPath )
 
     ObjRazRules *top;
 
-    AssembleLineGeometry();
+    if( !LoadLineGeometryCache() ) {
+        AssembleLineGeometry();
+        SaveLineGeometryCache();
+    }
+    BuildLineLOD();
 
     //  Set up the chart context
     m_this_chart_context = (chart_context *)calloc( sizeof(chart_context), 1);
     m_this_chart_context->chart = this;
     m_this_chart_context->vertex_buffer = GetLineVertexBuffer();
+    for( int l = 0; l < LINE_LOD_LEVELS; l++ )
+        m_this_chart_context->line_lod_tolerance[l] = m_line_lod_tolerance[l];
 
     //  Loop and populate all the objects
     for( int i = 0; i < PRIO_NUM; ++i ) {
@@ -4410,6 +5252,7 @@ void s57chart::UpdateLUPs( s57chart *pOwner )
         //  so that the next render operation will re-evaluate the CS
 
         for( int j = 0; j < LUPNAME_NUM; j++ ) {
+            m_raz_index[i][j].ClearCommands();          // the resolved rules are stale too
             top = razRules[i][j];
             while( top != NULL ) {
                 top->obj->bCS_Added = 0;